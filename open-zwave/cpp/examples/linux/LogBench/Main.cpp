@@ -0,0 +1,156 @@
+//-----------------------------------------------------------------------------
+//
+//	Main.cpp
+//
+//	Measures how many Z-Wave messages a second the logging on the driver's
+//	hot path can keep up with, when logging at Info level.
+//
+//	For each message, the benchmark makes the same log calls as the driver
+//	does when it queues and sends a command and receives the reply: Detail
+//	messages that describe the message in hex, and Info messages that are
+//	written to the log file.  It runs them twice, once through OZW_LOG,
+//	which skips the Detail messages without building their arguments, and
+//	once through plain Log::Write, which builds them before they are thrown
+//	away.  The log is written to LogBench.txt in the current directory.
+//
+//	Usage: LogBench [<messages>]
+//
+//	Copyright (c) 2010 Mal Lansell <mal@openzwave.com>
+//
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "Defs.h"
+#include "Log.h"
+#include "Msg.h"
+#include "TimeStamp.h"
+
+using namespace OpenZWave;
+
+static uint8 const c_nodeId			= 5;
+static uint8 const c_commandClassId	= 0x31;		// COMMAND_CLASS_SENSOR_MULTILEVEL
+
+// A sensor multilevel report, as it arrives from the controller
+static uint8 const c_received[] = { 0x01, 0x0c, 0x00, 0x04, 0x00, 0x05, 0x06, 0x31, 0x05, 0x01, 0x22, 0x00, 0xe1, 0x0b };
+
+//-----------------------------------------------------------------------------
+// <LogGated>
+// Log one message the way the driver does, through OZW_LOG
+//-----------------------------------------------------------------------------
+void LogGated
+(
+	Msg* _msg
+)
+{
+	OZW_LOG( LogLevel_Detail, c_nodeId, "Queuing command: %s", _msg->GetAsString().c_str() );
+	OZW_LOG( LogLevel_Detail, c_nodeId, "WriteMsg %s m_currentMsg=%08x", "WriteNextMsg", _msg );
+	OZW_LOG( LogLevel_Info, c_nodeId, c_commandClassId, "Sending command (Callback ID=0x%.2x, Expected Reply=0x%.2x) - %s", _msg->GetCallbackId(), _msg->GetExpectedReply(), _msg->GetAsString().c_str() );
+	Log::WriteData( LogLevel_Detail, c_nodeId, "  Received: ", c_received, sizeof(c_received), c_commandClassId );
+	OZW_LOG( LogLevel_Info, c_nodeId, c_commandClassId, "Received SensorMultiLevel report from node %d, instance %d, Temperature: value=%s%s", c_nodeId, 1, "22.5", "C" );
+}
+
+//-----------------------------------------------------------------------------
+// <LogUngated>
+// Log one message with plain Log::Write, which builds every argument
+//-----------------------------------------------------------------------------
+void LogUngated
+(
+	Msg* _msg
+)
+{
+	Log::Write( LogLevel_Detail, c_nodeId, "Queuing command: %s", _msg->GetAsString().c_str() );
+	Log::Write( LogLevel_Detail, c_nodeId, "WriteMsg %s m_currentMsg=%08x", "WriteNextMsg", _msg );
+	Log::Write( LogLevel_Info, c_nodeId, c_commandClassId, "Sending command (Callback ID=0x%.2x, Expected Reply=0x%.2x) - %s", _msg->GetCallbackId(), _msg->GetExpectedReply(), _msg->GetAsString().c_str() );
+
+	// What WriteData did before it checked the level
+	string str;
+	char byteStr[8];
+	for( uint32 i=0; i<sizeof(c_received); ++i )
+	{
+		snprintf( byteStr, sizeof(byteStr), "0x%.2x, ", c_received[i] );
+		str += byteStr;
+	}
+	Log::Write( LogLevel_Detail, c_nodeId, c_commandClassId, "  Received: %s", str.c_str() );
+	Log::Write( LogLevel_Info, c_nodeId, c_commandClassId, "Received SensorMultiLevel report from node %d, instance %d, Temperature: value=%s%s", c_nodeId, 1, "22.5", "C" );
+}
+
+//-----------------------------------------------------------------------------
+// <Run>
+// Log a number of messages and print the rate
+//-----------------------------------------------------------------------------
+void Run
+(
+	char const* _name,
+	void (*_logMessage)( Msg* ),
+	Msg* _msg,
+	uint32 const _count
+)
+{
+	uint64 start = TimeStamp::GetMonotonicTime();
+	for( uint32 i=0; i<_count; ++i )
+	{
+		_logMessage( _msg );
+	}
+	uint64 elapsed = TimeStamp::GetMonotonicTime() - start;
+	if( elapsed == 0 )
+	{
+		elapsed = 1;
+	}
+
+	printf( "%-12s %9u messages in %6u ms = %9.0f messages/sec\n", _name, _count, (uint32)elapsed, (double)_count * 1000.0 / (double)elapsed );
+}
+
+//-----------------------------------------------------------------------------
+// <main>
+// Time the logging of messages at Info level
+//-----------------------------------------------------------------------------
+int main( int argc, char* argv[] )
+{
+	uint32 count = 200000;
+	if( argc > 1 )
+	{
+		count = (uint32)strtoul( argv[1], NULL, 0 );
+	}
+	if( ( argc > 2 ) || ( count == 0 ) )
+	{
+		fprintf( stderr, "Usage: %s [<messages>]\n", argv[0] );
+		return 1;
+	}
+
+	// Write and queue Info messages, as a production gateway would
+	Log::Create( "LogBench.txt", false, false, LogLevel_Info, LogLevel_Info, LogLevel_Warning, 500 );
+
+	Msg msg( "SensorMultilevelCmd_Get", c_nodeId, REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, c_commandClassId );
+	msg.Append( c_nodeId );
+	msg.Append( 2 );
+	msg.Append( c_commandClassId );
+	msg.Append( 0x04 );				// SensorMultilevelCmd_Get
+	msg.Append( TRANSMIT_OPTION_ACK | TRANSMIT_OPTION_AUTO_ROUTE | TRANSMIT_OPTION_EXPLORE );
+	msg.Finalize();
+
+	printf( "Logging at Info level, %u messages per run\n", count );
+	Run( "OZW_LOG", LogGated, &msg, count );
+	Run( "Log::Write", LogUngated, &msg, count );
+
+	Log::Destroy();
+	return 0;
+}
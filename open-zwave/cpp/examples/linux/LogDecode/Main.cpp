@@ -0,0 +1,80 @@
+//-----------------------------------------------------------------------------
+//
+//	Main.cpp
+//
+//	Decodes a log queue saved by OpenZWave::Log::QueueSave.
+//
+//	The queue of recent log messages is kept in a compact binary form,
+//	and is only turned into text when it is dumped.  An application can
+//	save it to a file instead, for example when it crashes, and this
+//	tool prints the messages in that file in the same form as the log.
+//
+//	Usage: LogDecode <file> [<file>...]
+//
+//	Copyright (c) 2010 Mal Lansell <mal@openzwave.com>
+//
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include "Defs.h"
+#include "FlightRecorder.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+// <OnEntry>
+// Print one decoded message
+//-----------------------------------------------------------------------------
+void OnEntry
+(
+	FlightRecorder::Entry const& _entry,
+	void* _context
+)
+{
+	char line[2048];
+	FlightRecorder::FormatEntry( _entry, line, sizeof(line) );
+	printf( "%s\n", line );
+}
+
+//-----------------------------------------------------------------------------
+// <main>
+// Decode each of the files named on the command line
+//-----------------------------------------------------------------------------
+int main( int argc, char* argv[] )
+{
+	if( argc < 2 )
+	{
+		fprintf( stderr, "Usage: %s <file> [<file>...]\n", argv[0] );
+		return 1;
+	}
+
+	int res = 0;
+	for( int i=1; i<argc; ++i )
+	{
+		if( !FlightRecorder::Load( argv[i], OnEntry, NULL ) )
+		{
+			fprintf( stderr, "%s: not a saved log queue, or could not be read\n", argv[i] );
+			res = 1;
+		}
+	}
+
+	return res;
+}
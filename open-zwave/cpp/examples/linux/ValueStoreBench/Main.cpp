@@ -0,0 +1,222 @@
+//-----------------------------------------------------------------------------
+//
+//	Main.cpp
+//
+//	Compares looking up and iterating through a node's values in the flat
+//	ValueStore with doing the same in a map, as the ValueStore used to.
+//
+//	Stores of several sizes are filled with the same values.  Lookups are
+//	made in a scattered order, as the reports from a node would make them,
+//	and are timed both without a reference being taken (BorrowValue) and
+//	with one (GetValue).  Iteration visits every value in key order, as
+//	WriteConfig and the poll setup do.
+//
+//	Usage: ValueStoreBench [<operations>]
+//
+//	Copyright (c) 2010 Mal Lansell <mal@openzwave.com>
+//
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <map>
+#include <vector>
+#include "Defs.h"
+#include "TimeStamp.h"
+#include "ValueStore.h"
+#include "ValueByte.h"
+
+using namespace OpenZWave;
+
+static uint32 const c_homeId	= 0x014d02a8;
+static uint8 const c_nodeId		= 5;
+
+// Command classes that a typical node's values belong to
+static uint8 const c_commandClassIds[] = { 0x20, 0x25, 0x26, 0x31, 0x32, 0x70, 0x71, 0x72, 0x80, 0x84, 0x86 };
+
+static uint32 const c_numLookups = 4096;		// Size of the table of keys to look up, which is used repeatedly
+
+//-----------------------------------------------------------------------------
+// <GetKey>
+// The key of a value in its node's ValueStore, made the same way as by
+// ValueID::GetValueStoreKey, which is only available to the library
+//-----------------------------------------------------------------------------
+uint32 GetKey
+(
+	uint8 const _commandClassId,
+	uint8 const _instance,
+	uint8 const _index
+)
+{
+	return( ( ( (uint32)_instance ) << 24 ) | ( ( (uint32)_commandClassId ) << 14 ) | ( ( (uint32)_index ) << 4 ) );
+}
+
+//-----------------------------------------------------------------------------
+// <Report>
+// Print the time taken per operation
+//-----------------------------------------------------------------------------
+void Report
+(
+	char const* _name,
+	uint64 const _start,
+	uint32 const _operations,
+	uint32 const _check
+)
+{
+	uint64 elapsed = TimeStamp::GetMonotonicTime() - _start;
+	printf( "    %-28s %8.2f ns/op  (check %u)\n", _name, (double)elapsed * 1000000.0 / (double)_operations, _check );
+}
+
+//-----------------------------------------------------------------------------
+// <Bench>
+// Time lookups and iteration for a node with the specified number of values
+//-----------------------------------------------------------------------------
+void Bench
+(
+	uint32 const _numValues,
+	uint32 const _operations
+)
+{
+	ValueStore store;
+	map<uint32,Value*> valueMap;
+	vector<uint32> keys;
+
+	// Spread the values over the command classes and instances, as a node would
+	uint32 numCommandClasses = sizeof(c_commandClassIds);
+	for( uint32 i=0; i<_numValues; ++i )
+	{
+		uint8 commandClassId = c_commandClassIds[i % numCommandClasses];
+		uint8 instance = (uint8)( 1 + ( i / numCommandClasses ) % 4 );
+		uint8 index = (uint8)( i / ( numCommandClasses * 4 ) );
+		ValueByte* value = new ValueByte( c_homeId, c_nodeId, ValueID::ValueGenre_User, commandClassId, instance, index, "Level", "", false, false, 0, 0 );
+		store.AddValue( value );
+		valueMap[GetKey( commandClassId, instance, index )] = value;
+		keys.push_back( GetKey( commandClassId, instance, index ) );
+		value->Release();
+	}
+
+	// Look the keys up in a scattered but repeatable order
+	vector<uint32> lookups( c_numLookups );
+	uint32 seed = 12345;
+	for( uint32 i=0; i<c_numLookups; ++i )
+	{
+		seed = seed * 1103515245 + 12345;
+		lookups[i] = keys[( seed >> 16 ) % _numValues];
+	}
+
+	printf( "  %u values\n", _numValues );
+
+	uint32 check = 0;
+	uint64 start = TimeStamp::GetMonotonicTime();
+	for( uint32 i=0; i<_operations; ++i )
+	{
+		map<uint32,Value*>::const_iterator it = valueMap.find( lookups[i % c_numLookups] );
+		check += it->second->GetID().GetCommandClassId();
+	}
+	Report( "map find", start, _operations, check );
+
+	check = 0;
+	start = TimeStamp::GetMonotonicTime();
+	for( uint32 i=0; i<_operations; ++i )
+	{
+		check += store.BorrowValue( lookups[i % c_numLookups] )->GetID().GetCommandClassId();
+	}
+	Report( "ValueStore::BorrowValue", start, _operations, check );
+
+	check = 0;
+	start = TimeStamp::GetMonotonicTime();
+	for( uint32 i=0; i<_operations; ++i )
+	{
+		map<uint32,Value*>::const_iterator it = valueMap.find( lookups[i % c_numLookups] );
+		Value* value = it->second;
+		value->AddRef();
+		check += value->GetID().GetCommandClassId();
+		value->Release();
+	}
+	Report( "map find + AddRef", start, _operations, check );
+
+	check = 0;
+	start = TimeStamp::GetMonotonicTime();
+	for( uint32 i=0; i<_operations; ++i )
+	{
+		Value* value = store.GetValue( lookups[i % c_numLookups] );
+		check += value->GetID().GetCommandClassId();
+		value->Release();
+	}
+	Report( "ValueStore::GetValue", start, _operations, check );
+
+	// Iterate often enough to visit about as many values as there were lookups
+	uint32 passes = _operations / _numValues;
+	if( passes == 0 )
+	{
+		passes = 1;
+	}
+
+	check = 0;
+	start = TimeStamp::GetMonotonicTime();
+	for( uint32 pass=0; pass<passes; ++pass )
+	{
+		for( map<uint32,Value*>::const_iterator it = valueMap.begin(); it != valueMap.end(); ++it )
+		{
+			check += it->second->GetID().GetCommandClassId();
+		}
+	}
+	Report( "map iteration", start, passes * _numValues, check );
+
+	check = 0;
+	start = TimeStamp::GetMonotonicTime();
+	for( uint32 pass=0; pass<passes; ++pass )
+	{
+		for( ValueStore::Iterator it = store.Begin(); it != store.End(); ++it )
+		{
+			check += it->second->GetID().GetCommandClassId();
+		}
+	}
+	Report( "ValueStore iteration", start, passes * _numValues, check );
+}
+
+//-----------------------------------------------------------------------------
+// <main>
+// Run the benchmark for nodes with a range of numbers of values
+//-----------------------------------------------------------------------------
+int main( int argc, char* argv[] )
+{
+	uint32 operations = 10000000;
+	if( argc > 1 )
+	{
+		operations = (uint32)strtoul( argv[1], NULL, 0 );
+	}
+	if( ( argc > 2 ) || ( operations == 0 ) )
+	{
+		fprintf( stderr, "Usage: %s [<operations>]\n", argv[0] );
+		return 1;
+	}
+
+	// There is no Manager, so the stores do not send notifications as values are added and removed
+	printf( "%u operations per test\n", operations );
+	uint32 const sizes[] = { 8, 32, 128, 512 };
+	for( uint32 i=0; i<sizeof(sizes)/sizeof(sizes[0]); ++i )
+	{
+		Bench( sizes[i], operations );
+	}
+
+	return 0;
+}
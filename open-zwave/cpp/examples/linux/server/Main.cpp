@@ -1,4 +1,4 @@
-e//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
 //
 //	Main.cpp
 //
@@ -72,6 +72,9 @@ static pthread_mutex_t g_criticalSection;
 static pthread_cond_t initCond = PTHREAD_COND_INITIALIZER;
 static pthread_mutex_t initMutex = PTHREAD_MUTEX_INITIALIZER;
 
+// Port on which the library's metrics are served over HTTP
+static const int METRICS_PORT = 6005;
+
 //-----------------------------------------------------------------------------
 // <GetNodeInfo>
 // Callback that is triggered when a value, group or node changes
@@ -187,7 +190,7 @@ void OnNotification(Notification const* _notification, void* _context) {
                 // TBD...                               
                 nodeInfo = nodeInfo;
                 nodeInfo->m_level = _notification->GetByte();
-                printf("\n\n\nReceived Node Event with value %s\n\n\n", nodeInfo->m_level);
+                printf("\n\n\nReceived Node Event with value %d\n\n\n", nodeInfo->m_level);
             }
             break;
         }
@@ -259,6 +262,41 @@ string trim(string s) {
     return s.erase(s.find_last_not_of(" \n\r\t") + 1);
 }
 
+//-----------------------------------------------------------------------------
+// <MetricsThread>
+// Serve the library's metrics over HTTP, in the text format that
+// Prometheus scrapes (for example, http://localhost:6005/metrics)
+//-----------------------------------------------------------------------------
+
+void* MetricsThread(void* _context) {
+    try {
+        ServerSocket server(METRICS_PORT);
+        while (true) {
+            ServerSocket new_sock;
+            server.accept(new_sock);
+            try {
+                // Every request gets the same answer, so the request itself is ignored
+                std::string request;
+                new_sock >> request;
+
+                string body = Manager::Get()->GetMetrics();
+                stringstream response;
+                response << "HTTP/1.0 200 OK\r\n"
+                        << "Content-Type: text/plain; version=0.0.4\r\n"
+                        << "Content-Length: " << body.size() << "\r\n"
+                        << "Connection: close\r\n\r\n"
+                        << body;
+                new_sock << response.str();
+            } catch (SocketException&) {
+            }
+        }
+    } catch (SocketException&) {
+        printf("Unable to serve metrics on port %d\n", METRICS_PORT);
+    }
+
+    return NULL;
+}
+
 //-----------------------------------------------------------------------------
 // <main>
 // Create the driver and then wait
@@ -293,6 +331,12 @@ int main(int argc, char* argv[]) {
     // avoid the need for the notification handler to be a static.
     Manager::Get()->AddWatcher(OnNotification, NULL);
 
+    // Serve the metrics from now on, so that the initialisation can be watched too
+    pthread_t metricsThread;
+    if (pthread_create(&metricsThread, NULL, MetricsThread, NULL) == 0) {
+        pthread_detach(metricsThread);
+    }
+
     // Add a Z-Wave Driver
     // Modify this line to set the correct serial port for your PC interface.
 
@@ -340,16 +384,21 @@ int main(int argc, char* argv[]) {
                         //give list of devices
                         if (trim(data.c_str()) == "ALIST") {
                             string device;
-                            for (list<NodeInfo*>::iterator it = g_nodes.begin(); it != g_nodes.end(); ++it) {
-                                NodeInfo* nodeInfo = *it;
-                                int nodeID = nodeInfo->m_nodeId;
-                                string nodeType = Manager::Get()->GetNodeType(g_homeId, nodeInfo->m_nodeId);
-                                string nodeName = Manager::Get()->GetNodeName(g_homeId, nodeInfo->m_nodeId);
-                                string nodeZone = Manager::Get()->GetNodeLocation(g_homeId, nodeInfo->m_nodeId);
+                            vector<Node::NodeInfo> nodes;
+                            Manager::Get()->GetAllNodeInfo(g_homeId, 0, &nodes);
+                            for (vector<Node::NodeInfo>::iterator nit = nodes.begin(); nit != nodes.end(); ++nit) {
+                                if (!nit->m_exists)
+                                    continue;
+                                int nodeID = nit->m_nodeId;
+                                string nodeType = nit->m_type;
+                                string nodeName = nit->m_name;
+                                string nodeZone = nit->m_location;
                                 int nodeLevel = 0;
 
-                                if (nodeInfo->m_level)
-                                    nodeLevel = nodeInfo->m_level;
+                                for (list<NodeInfo*>::iterator it = g_nodes.begin(); it != g_nodes.end(); ++it) {
+                                    if ((*it)->m_nodeId == nodeID)
+                                        nodeLevel = (*it)->m_level;
+                                }
 
                                 if (nodeName.size() == 0) nodeName = "Undefined";
 
@@ -394,6 +443,11 @@ int main(int argc, char* argv[]) {
                                 Type = v[3].c_str();
                                 Type = trim(Type);
 
+                                // Trace the command through to the node's confirmation
+                                stringstream ssTrace;
+                                ssTrace << "DEVICE node " << Node << " level " << Level;
+                                Manager::Get()->BeginTrace(ssTrace.str());
+
                                 if ((Type == "Multilevel Switch") || (Type == "Multilevel Power Switch")) {
                                     pthread_mutex_lock(&g_criticalSection);
                                     Manager::Get()->SetNodeLevel(g_homeId, Node, Level);
@@ -412,6 +466,8 @@ int main(int argc, char* argv[]) {
                                     pthread_mutex_unlock(&g_criticalSection);
                                 }
 
+                                Manager::Get()->SetCurrentTrace(0);
+
                                 stringstream ssNode, ssLevel;
                                 ssNode << Node;
                                 ssLevel << Level;
@@ -78,6 +78,11 @@ namespace OpenZWave
 #define snprintf sprintf_s
 #define strcasecmp _stricmp
 
+// Older compilers have no va_copy, but a va_list there is a plain pointer
+#ifndef va_copy
+#define va_copy( _dest, _src ) ( (_dest) = (_src) )
+#endif
+
 #endif
 
 // Modifications for MiNGW32 compiler
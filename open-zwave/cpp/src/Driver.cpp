@@ -52,6 +52,7 @@
 #include "ValueID.h"
 #include "Value.h"
 #include "ValueStore.h"
+#include "ValueLog.h"
 
 #include <algorithm>
 
@@ -89,6 +90,23 @@ static char const* c_transmitStatusNames[] =
 	"No route"
 };
 
+static char const* c_queueNames[] =
+{
+	"Command",
+	"WakeUp",
+	"Send",
+	"Query",
+	"Poll"
+};
+
+static int32 const c_pollResponseWindow = 10000;		// A report within this many ms of a poll is taken to be the reply to it
+static uint8 const c_pollBackoffThreshold = 3;			// Number of polls saved by self-reports before the poll period is stretched
+static uint8 const c_maxPollBackoff = 3;				// Self-reporting values are polled at least once every 2^3 poll periods
+
+static uint32 const c_minLinkSends = 8;					// Transmissions needed in the last 15 minutes before a node's link quality is judged
+static uint32 const c_poorLinkQuality = 50;				// A link is poor when fewer than this percentage of transmissions are delivered
+static uint32 const c_linkDownSends = 3;				// Messages are not retried to a node that has failed this many transmissions in the last minute, with none delivered
+
 //-----------------------------------------------------------------------------
 // <Driver::Driver>
 // Constructor
@@ -120,7 +138,12 @@ Driver::Driver
 	m_nodeMutex( new Mutex() ),
 	m_controllerReplication( NULL ),
 	m_sendMutex( new Mutex() ),
+	m_sendIdleEvent( new Event() ),
 	m_currentMsg( NULL ),
+	m_currentMsgQueue( MsgQueue_Count ),
+	m_currentMsgFirstSent( 0 ),
+	m_currentMsgLastSent( 0 ),
+	m_retryTimer( RetryTimerCallback, this ),
 	m_waitingForAck( false ),
 	m_expectedCallbackId( 0 ),
 	m_expectedReply( 0 ),
@@ -128,7 +151,9 @@ Driver::Driver
 	m_expectedNodeId( 0 ),
 	m_pollThread( new Thread( "poll" ) ),
 	m_pollMutex( new Mutex() ),
+	m_pollEvent( new Event() ),
 	m_bIntervalBetweenPolls( false ),				// if set to true (via SetPollInterval), the pollInterval will be interspersed between each poll (so a much smaller m_pollInterval like 100, 500, or 1,000 may be appropriate)
+	m_bAdaptivePolling( true ),
 	m_controllerState( ControllerState_Normal ),
 	m_controllerCommand( ControllerCommand_None ),
 	m_controllerCallback( NULL ),
@@ -138,6 +163,8 @@ Driver::Driver
 	m_controllerCommandArg( 0 ),
 	m_SUCNode( 0 ),
 	m_virtualNeighborsReceived( false ),
+	m_valueLog( NULL ),
+	m_valueLogTimer( ValueLogTimerCallback, this ),
 	m_notificationsEvent( new Event() ),
 	m_SOFCnt( 0 ),
 	m_ACKWaiting( 0 ),
@@ -158,10 +185,14 @@ Driver::Driver
 	m_nondelivery( 0 ),
 	m_routedbusy( 0 ),
 	m_broadcastReadCnt( 0 ),
-	m_broadcastWriteCnt( 0 )
+	m_broadcastWriteCnt( 0 ),
+	m_pollsSent( 0 ),
+	m_pollsSaved( 0 ),
+	m_verifyReads( 0 ),
+	m_changesFiltered( 0 )
 {
 	// set a timestamp to indicate when this driver started
-	TimeStamp m_startTime;
+	m_startTime.SetTime();
 
 	// Create the message queue events
 	for( int32 i=0; i<MsgQueue_Count; ++i )
@@ -169,9 +200,15 @@ Driver::Driver
 		m_queueEvent[i] = new Event();
 	}
 
+	// Nothing has been queued yet
+	m_sendIdleEvent->Set();
+
 	// Clear the nodes array
 	memset( m_nodes, 0, sizeof(Node*) * 256 );
 
+	// No node is confirming a traced command
+	memset( m_nodeTraceId, 0, sizeof(m_nodeTraceId) );
+
 	// Clear the virtual neighbors array
 	memset( m_virtualNeighbors, 0, NUM_NODE_BITFIELD_BYTES );
 
@@ -188,6 +225,7 @@ Driver::Driver
 	Options::Get()->GetOptionAsBool( "NotifyTransactions", &m_notifytransactions );
 	Options::Get()->GetOptionAsInt( "PollInterval", &m_pollInterval );
 	Options::Get()->GetOptionAsBool( "IntervalBetweenPolls", &m_bIntervalBetweenPolls );
+	Options::Get()->GetOptionAsBool( "AdaptivePolling", &m_bAdaptivePolling );
 }
 
 //-----------------------------------------------------------------------------
@@ -198,6 +236,8 @@ Driver::~Driver
 (
 )
 {
+	UnregisterMetrics();
+
 	// append final driver stats output to the log file
 	LogDriverStatistics();
 
@@ -222,8 +262,13 @@ Driver::~Driver
 	m_driverThread->Stop();
 	m_driverThread->Release();
 
+	// Nothing more can be logged now the driver thread has gone, so write out the last readings
+	delete m_valueLog;
+	m_valueLog = NULL;
+
 	m_sendMutex->Release();
 	m_pollMutex->Release();
+	m_pollEvent->Release();
 
 	m_controller->Close();
 	m_controller->Release();
@@ -248,6 +293,7 @@ Driver::~Driver
 
 		m_queueEvent[i]->Release();
 	}
+	m_sendIdleEvent->Release();
 
 	// Clear the node data
 	LockNodes();
@@ -326,46 +372,55 @@ void Driver::DriverThreadProc
 			waitObjects[6] = m_queueEvent[MsgQueue_Query];		// Node queries are pending.
 			waitObjects[7] = m_queueEvent[MsgQueue_Poll];		// Poll request is waiting.
 
-			TimeStamp retryTimeStamp;
-
 			while( true )
 			{
 				Log::Write( LogLevel_Debug, "Top of DriverThreadProc loop." );
+
+				// Fire any timeouts that have expired
+				m_timers.Service();
+
+				// Let the poll thread know whether the send pipeline has drained
+				m_sendMutex->Lock();
+				if( m_currentMsg == NULL
+					&& m_msgQueue[MsgQueue_Command].empty()
+					&& m_msgQueue[MsgQueue_Send].empty()
+					&& m_msgQueue[MsgQueue_Query].empty()
+					&& m_msgQueue[MsgQueue_Poll].empty() )
+				{
+					m_sendIdleEvent->Set();
+				}
+				else
+				{
+					m_sendIdleEvent->Reset();
+				}
+				m_sendMutex->Unlock();
+
 				uint32 count = 8;
-				int32 timeout = Wait::Timeout_Infinite;
 
 				// If we're waiting for a message to complete, we can only
 				// handle incoming data, notifications and exit events.
 				if( m_waitingForAck || m_expectedCallbackId || m_expectedReply )
 				{
 					count = 3;
-					timeout = retryTimeStamp.TimeRemaining();
-					if( timeout < 0 )
+					if( !m_retryTimer.IsPending() )
 					{
-						timeout = 0;
+						// Make sure we can never wait forever on a message that will not complete
+						m_timers.Schedule( &m_retryTimer, RETRY_TIMEOUT );
 					}
 				}
 				else
+				{
+					m_timers.Cancel( &m_retryTimer );			// the message completed, so there is nothing to retry
 					Log::QueueClear();							// clear the log queue when starting a new message
+				}
 
-				// Wait for something to do
-				int32 res = Wait::Multiple( waitObjects, count, timeout );
+				// Wait for something to do, or until the next timeout is due
+				int32 res = Wait::Multiple( waitObjects, count, m_timers.GetTimeout() );
 				switch( res )
 				{
 					case -1:
 					{
-						// Wait has timed out - time to resend
-						if( m_currentMsg != NULL )
-						{
-							Notification* notification = new Notification( Notification::Type_Notification );
-							notification->SetHomeAndNodeIds( m_homeId, m_currentMsg->GetTargetNodeId() );
-							notification->SetNotification( Notification::Code_Timeout );
-							QueueNotification( notification );
-						}
-						if( WriteMsg( "Wait Timeout" ) )
-						{
-							retryTimeStamp.SetTime( RETRY_TIMEOUT );
-						}
+						// Wait has timed out - the expired timers are serviced at the top of the loop
 						break;
 					}
 					case 0:
@@ -390,7 +445,7 @@ void Driver::DriverThreadProc
 						// All the other events are sending message queue items
 						if( WriteNextMsg( (MsgQueue)(res-3) ) )
 						{
-							retryTimeStamp.SetTime( RETRY_TIMEOUT );
+							m_timers.Schedule( &m_retryTimer, RETRY_TIMEOUT );
 						}
 						break;
 					}
@@ -431,6 +486,51 @@ void Driver::DriverThreadProc
 }
 
 
+//-----------------------------------------------------------------------------
+// <Driver::RetryTimerCallback>
+// Entry point for the retry timer
+//-----------------------------------------------------------------------------
+void Driver::RetryTimerCallback
+(
+	void* _context
+)
+{
+	Driver* driver = (Driver*)_context;
+	if( driver )
+	{
+		driver->HandleRetryTimeout();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::HandleRetryTimeout>
+// The current message has timed out - time to resend
+//-----------------------------------------------------------------------------
+void Driver::HandleRetryTimeout
+(
+)
+{
+	if( !( m_waitingForAck || m_expectedCallbackId || m_expectedReply ) )
+	{
+		// The message completed just as the timer expired
+		return;
+	}
+
+	if( m_currentMsg != NULL )
+	{
+		WriteFrameRecord( FrameLog::Event_Timeout );
+
+		Notification* notification = new Notification( Notification::Type_Notification );
+		notification->SetHomeAndNodeIds( m_homeId, m_currentMsg->GetTargetNodeId() );
+		notification->SetNotification( Notification::Code_Timeout );
+		QueueNotification( notification );
+	}
+	if( WriteMsg( "Wait Timeout" ) )
+	{
+		m_timers.Schedule( &m_retryTimer, RETRY_TIMEOUT );
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::Init>
 // Initialize the controller
@@ -577,7 +677,7 @@ bool Driver::ReadConfig
 			if( TIXML_SUCCESS == nodeElement->QueryIntAttribute( "id", &intVal ) )
 			{
 				uint8 nodeId = (uint8)intVal;
-				Node* node = new Node( m_homeId, nodeId );
+				Node* node = new Node( m_homeId, nodeId, &m_nodeSnapshots[nodeId] );
 				m_nodes[nodeId] = node;
 
 				Notification* notification = new Notification( Notification::Type_NodeAdded );
@@ -604,7 +704,7 @@ bool Driver::ReadConfig
 			{
 				Value* value = it->second;
 				if( value->m_pollIntensity != 0 )
-					EnablePoll( value->GetID(), value->m_pollIntensity );
+					EnablePoll( value->GetID(), value->m_pollIntensity, value->m_pollInterval );
 			}
 		}
 	}
@@ -768,7 +868,7 @@ void Driver::SendQueryStageComplete
 				{
 					// If the message is for a sleeping node, we queue it in the node itself.
 					Log::Write( LogLevel_Info, "" );
-					Log::Write( LogLevel_Detail, node->GetNodeId(), "Queuing Wake-Up Command: Query Stage Complete (%s)", node->GetQueryStageName( _stage ).c_str() );
+					OZW_LOG( LogLevel_Detail, node->GetNodeId(), "Queuing Wake-Up Command: Query Stage Complete (%s)", node->GetQueryStageName( _stage ).c_str() );
 					wakeUp->QueueMsg( item );
 					ReleaseNodes();
 					return;
@@ -777,10 +877,12 @@ void Driver::SendQueryStageComplete
 		}
 
 		// Non-sleeping node
-		Log::Write( LogLevel_Detail, node->GetNodeId(), "Queuing Command: Query Stage Complete (%s)", node->GetQueryStageName( _stage ).c_str() );
+		OZW_LOG( LogLevel_Detail, node->GetNodeId(), "Queuing Command: Query Stage Complete (%s)", node->GetQueryStageName( _stage ).c_str() );
 		m_sendMutex->Lock();
+		item.m_queued = TimeStamp::GetMonotonicTime();
 		m_msgQueue[MsgQueue_Query].push_back( item );
 		m_queueEvent[MsgQueue_Query]->Set();
+		m_sendIdleEvent->Reset();
 		m_sendMutex->Unlock();
 
 		ReleaseNodes();
@@ -813,7 +915,7 @@ void Driver::SendMsg
 				if( !wakeUp->IsAwake() )
 				{
 					Log::Write( LogLevel_Detail, "" );
-					Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Queuing Wake-Up Command: %s", _msg->GetAsString().c_str() );
+					OZW_LOG( LogLevel_Detail, GetNodeNumber( _msg ), "Queuing Wake-Up Command: %s", _msg->GetAsString().c_str() );
 					wakeUp->QueueMsg( item );
 					ReleaseNodes();
 					return;
@@ -824,10 +926,13 @@ void Driver::SendMsg
 		ReleaseNodes();
 	}
 
-	Log::Write( LogLevel_Detail, GetNodeNumber( _msg ), "Queuing command: %s", _msg->GetAsString().c_str() );
+	OZW_LOG( LogLevel_Detail, GetNodeNumber( _msg ), "Queuing command: %s", _msg->GetAsString().c_str() );
 	m_sendMutex->Lock();
+	item.m_queued = TimeStamp::GetMonotonicTime();
+	_msg->SetTraceTime( Trace::Stage_Queued );
 	m_msgQueue[_queue].push_back( item );
 	m_queueEvent[_queue]->Set();
+	m_sendIdleEvent->Reset();
 	m_sendMutex->Unlock();
 }
 
@@ -848,12 +953,22 @@ bool Driver::WriteNextMsg
 	{
 		// Send a message
 		m_currentMsg = item.m_msg;
+		m_currentMsg->SetTraceTime( Trace::Stage_Dequeued );
+		m_currentMsgQueue = _queue;
+		m_currentMsgFirstSent = 0;
+		m_queueWaitTime.Observe( (uint32)( TimeStamp::GetMonotonicTime() - item.m_queued ) );
 		m_msgQueue[_queue].pop_front();
 		if( m_msgQueue[_queue].empty() )
 		{
 			m_queueEvent[_queue]->Reset();
 		}
 		m_sendMutex->Unlock();
+
+		if( MsgQueue_Poll == _queue )
+		{
+			// The poll is only really made now, which may be long after it was queued
+			StampPolls( m_currentMsg->GetTargetNodeId(), true );
+		}
 		return WriteMsg( "WriteNextMsg" );
 	}
 
@@ -872,7 +987,7 @@ bool Driver::WriteNextMsg
 		Node* node = GetNodeUnsafe( item.m_nodeId );
 		if( node != NULL )
 		{
-			Log::Write( LogLevel_Detail, node->GetNodeId(), "Query Stage Complete (%s)", node->GetQueryStageName( stage ).c_str() );
+			OZW_LOG( LogLevel_Detail, node->GetNodeId(), "Query Stage Complete (%s)", node->GetQueryStageName( stage ).c_str() );
 			node->QueryStageComplete( stage );
 			node->AdvanceQueries();
 			return true;
@@ -888,10 +1003,10 @@ bool Driver::WriteNextMsg
 //-----------------------------------------------------------------------------
 bool Driver::WriteMsg
 (
-	string const msg
+	char const* _reason
 )
 {
-	Log::Write( LogLevel_Detail, GetNodeNumber( m_currentMsg ), "WriteMsg %s m_currentMsg=%08x", msg.c_str(), m_currentMsg );
+	OZW_LOG( LogLevel_Detail, GetNodeNumber( m_currentMsg ), "WriteMsg %s m_currentMsg=%08x", _reason, m_currentMsg );
 	if( !m_currentMsg )
 	{
 		return false;
@@ -909,6 +1024,8 @@ bool Driver::WriteMsg
 		{
 			// That's it - already tried to send GetMaxSendAttempt() times.
 			Log::Write( LogLevel_Error, nodeId, "ERROR: Dropping command, expected response not received after %d attempt(s)", m_currentMsg->GetMaxSendAttempts() );
+			WriteFrameRecord( FrameLog::Event_Drop );
+			FinishTracedMsg( false );
 			delete m_currentMsg;
 			m_currentMsg = NULL;
 
@@ -926,31 +1043,50 @@ bool Driver::WriteMsg
 			return false;
 		}
 
+		// Don't hold up the queue retrying a node that nothing is getting through to
+		if( ( attempts == 0 ) && ( node != NULL ) && ( m_currentMsg->GetMaxSendAttempts() > 1 ) )
+		{
+			LinkStatistics::Data link;
+			node->m_linkStats.GetData( LinkStatistics::Window_1Minute, &link );
+			if( ( link.m_sent >= c_linkDownSends ) && ( link.m_delivered == 0 ) )
+			{
+				Log::Write( LogLevel_Info, nodeId, "No messages delivered to node in the last minute, so this one will not be retried" );
+				m_currentMsg->SetMaxSendAttempts( 1 );
+			}
+		}
+
 		m_currentMsg->SetSendAttempts( ++attempts );
 		m_expectedCallbackId = m_currentMsg->GetCallbackId();
 		m_expectedCommandClassId = m_currentMsg->GetExpectedCommandClassId();
 		m_expectedNodeId = m_currentMsg->GetTargetNodeId();
 		m_expectedReply = m_currentMsg->GetExpectedReply();
 		m_waitingForAck = true;
-		string attemptsstr = "";
+		char attemptsStr[16] = "";
 		if( attempts > 1 )
 		{
-			char buf[15];
-			snprintf( buf, sizeof(buf), "Attempt %d, ", attempts );
-			attemptsstr = buf;
+			snprintf( attemptsStr, sizeof(attemptsStr), "Attempt %d, ", attempts );
 			m_retries++;
 			if( node != NULL )
 			{
 				node->m_retries++;
+				node->m_linkStats.RecordRetry();
 			}
 		}
 
 		Log::Write( LogLevel_Detail, "" );
-		Log::Write( LogLevel_Info, nodeId, "Sending command (%sCallback ID=0x%.2x, Expected Reply=0x%.2x) - %s", attemptsstr.c_str(), m_expectedCallbackId, m_expectedReply, m_currentMsg->GetAsString().c_str() );
+		OZW_LOG( LogLevel_Info, nodeId, m_currentMsg->GetSendingCommandClass(), "Sending command (%sCallback ID=0x%.2x, Expected Reply=0x%.2x) - %s", attemptsStr, m_expectedCallbackId, m_expectedReply, m_currentMsg->GetAsString().c_str() );
 
 		m_controller->Write( m_currentMsg->GetBuffer(), m_currentMsg->GetLength() );
 		m_writeCnt++;
 
+		m_currentMsgLastSent = TimeStamp::GetMonotonicTime();
+		if( m_currentMsgFirstSent == 0 )
+		{
+			m_currentMsgFirstSent = m_currentMsgLastSent;
+			m_currentMsg->SetTraceTime( Trace::Stage_Sent );
+		}
+		WriteFrameRecord( FrameLog::Event_Send );
+
 		if( nodeId == 0xff )
 		{
 			m_broadcastWriteCnt++; // not accurate since library uses 0xff for the controller too
@@ -1041,7 +1177,7 @@ bool Driver::MoveMessagesToWakeUpQueue
 						// commands to the pending queue.
 						if( !m_currentMsg->IsWakeUpNoMoreInformationCommand() )
 						{
-							Log::Write( LogLevel_Info, _targetNodeId, "Node not responding - moving message to Wake-Up queue: %s", m_currentMsg->GetAsString().c_str() );
+							OZW_LOG( LogLevel_Info, _targetNodeId, "Node not responding - moving message to Wake-Up queue: %s", m_currentMsg->GetAsString().c_str() );
 							MsgQueueItem item;
 							item.m_command = MsgQueueCmd_SendMsg;
 							item.m_msg = m_currentMsg;
@@ -1078,7 +1214,7 @@ bool Driver::MoveMessagesToWakeUpQueue
 								// commands to the pending queue.
 								if( !item.m_msg->IsWakeUpNoMoreInformationCommand() )
 								{
-									Log::Write( LogLevel_Info, item.m_msg->GetTargetNodeId(), "Node not responding - moving message to Wake-Up queue: %s", item.m_msg->GetAsString().c_str() );
+									OZW_LOG( LogLevel_Info, item.m_msg->GetTargetNodeId(), "Node not responding - moving message to Wake-Up queue: %s", item.m_msg->GetAsString().c_str() );
 									wakeUp->QueueMsg( item );
 								}
 								else
@@ -1307,25 +1443,15 @@ bool Driver::ReadMsg
 
 			uint32 length = buffer[1] + 2;
 
-			// Log the data
-			string str = "";
-			for( uint32 i=0; i<length; ++i )
-			{
-				if( i )
-				{
-					str += ", ";
-				}
-
-				char byteStr[8];
-				snprintf( byteStr, sizeof(byteStr), "0x%.2x", buffer[i] );
-				str += byteStr;
-			}
 			uint8 nodeId = NodeFromMessage( buffer );
 			if( nodeId == 0 )
 			{
 				nodeId = GetNodeNumber( m_currentMsg );
 			}
-			Log::Write( LogLevel_Detail, nodeId, "  Received: %s", str.c_str() );
+
+			// Log the data
+			uint8 commandClassId = CommandClassFromMessage( buffer );
+			Log::WriteData( LogLevel_Detail, nodeId, "  Received: ", buffer, length, commandClassId );
 
 			// Verify checksum
 			uint8 checksum = 0xff;
@@ -1341,6 +1467,16 @@ bool Driver::ReadMsg
 				m_controller->Write( &ack, 1 );
 				m_readCnt++;
 
+				if( FrameLog::IsEnabled() )
+				{
+					FrameLog::Record record( FrameLog::Event_Receive, m_homeId );
+					record.m_nodeId = NodeFromMessage( buffer );
+					record.m_functionId = buffer[3];
+					record.m_commandClassId = commandClassId;
+					record.m_length = length;
+					FrameLog::Write( record );
+				}
+
 				// Process the received message
 				ProcessMsg( &buffer[2] );
 			}
@@ -1363,6 +1499,7 @@ bool Driver::ReadMsg
 			// on very busy networks with lots of unsolicited messages being received. Increase the amount
 			// of retries but only up to a limit so we don't stay here forever.
 			Log::Write( LogLevel_Detail, GetNodeNumber( m_currentMsg ), "CAN received...triggering resend" );
+			WriteFrameRecord( FrameLog::Event_Can );
 			m_CANCnt++;
 			if( m_currentMsg != NULL )
 			{
@@ -1379,6 +1516,7 @@ bool Driver::ReadMsg
 		case NAK:
 		{
 			Log::Write( LogLevel_Warning, GetNodeNumber( m_currentMsg ), "WARNING: NAK received...triggering resend" );
+			WriteFrameRecord( FrameLog::Event_Nak );
 			m_NAKCnt++;
 			WriteMsg( "NAK" );
 			break;
@@ -1395,9 +1533,13 @@ bool Driver::ReadMsg
 			else
 			{
 				Log::Write( LogLevel_Detail, GetNodeNumber( m_currentMsg ), "  ACK received CallbackId 0x%.2x Reply 0x%.2x", m_expectedCallbackId, m_expectedReply );
+				WriteFrameRecord( FrameLog::Event_Ack );
+				m_currentMsg->SetTraceTime( Trace::Stage_Acked );
 				if( ( 0 == m_expectedCallbackId ) && ( 0 == m_expectedReply ) )
 				{
 					// Remove the message from the queue, now that it has been acknowledged.
+					WriteFrameRecord( FrameLog::Event_Complete );
+					FinishTracedMsg( true );
 					RemoveCurrentMsg();
 				}
 			}
@@ -1809,6 +1951,8 @@ void Driver::ProcessMsg
 				{
 					Log::Write( LogLevel_Detail, GetNodeNumber( m_currentMsg ), "  Expected callbackId was received" );
 					m_expectedCallbackId = 0;
+					m_callbackLatency.Observe( (uint32)( TimeStamp::GetMonotonicTime() - m_currentMsgLastSent ) );
+					m_currentMsg->SetTraceTime( Trace::Stage_Callback );
 				}
 			}
 			if( m_expectedReply )
@@ -1843,6 +1987,8 @@ void Driver::ProcessMsg
 			{
 				Log::Write( LogLevel_Detail, GetNodeNumber( m_currentMsg ), "  Message transaction complete" );
 				Log::Write( LogLevel_Detail, "" );
+				WriteFrameRecord( FrameLog::Event_Complete );
+				FinishTracedMsg( true );
 
 				uint8* msgdata = m_currentMsg->GetBuffer();
 				if( msgdata[3] == FUNC_ID_ZW_SEND_DATA && msgdata[6] == NoOperation::StaticGetCommandClassId() )
@@ -1920,7 +2066,7 @@ void Driver::HandleGetControllerCapabilitiesResponse
 			  ( m_controllerCaps & ControllerCaps_SUC ) ? " static update controller (SUC)" : " controller",
 			  ( m_controllerCaps & ControllerCaps_OnOtherNetwork ) ? " which is using a Home ID from another network" : "",
 			  ( m_controllerCaps & ControllerCaps_RealPrimary ) ? " and was the original primary before the SIS was added." : "." );
-		Log::Write( LogLevel_Info, GetNodeNumber( m_currentMsg ), str );
+		Log::Write( LogLevel_Info, GetNodeNumber( m_currentMsg ), "%s", str );
 
 	}
 	else
@@ -1930,7 +2076,7 @@ void Driver::HandleGetControllerCapabilitiesResponse
 			  ( m_controllerCaps & ControllerCaps_Secondary ) ? "secondary" : "primary",
 			  ( m_controllerCaps & ControllerCaps_SUC ) ? " static update controller (SUC)" : " controller",
 			  ( m_controllerCaps & ControllerCaps_OnOtherNetwork ) ? " which is using a Home ID from another network." : "." );
-		Log::Write( LogLevel_Info, GetNodeNumber( m_currentMsg ), str );
+		Log::Write( LogLevel_Info, GetNodeNumber( m_currentMsg ), "%s", str );
 	}
 }
 
@@ -2096,6 +2242,7 @@ void Driver::HandleMemoryGetIdResponse
 	m_homeId = ( ( (uint32)_data[2] )<<24 ) | ( ( (uint32)_data[3] )<<16 ) | ( ( (uint32)_data[4] )<<8 ) | ( (uint32)_data[5] );
 	m_nodeId = _data[6];
 	m_controllerReplication = static_cast<ControllerReplication*>(ControllerReplication::Create( m_homeId, m_nodeId ));
+	RegisterMetrics();
 }
 
 //-----------------------------------------------------------------------------
@@ -2117,6 +2264,8 @@ void Driver::HandleSerialAPIGetInitDataResponse
 
 		// Read the config file first, to get the last known state
 		ReadConfig();
+
+		CreateValueLog();
 	}
 
 	Log::Write( LogLevel_Info, GetNodeNumber( m_currentMsg ), "Received reply to FUNC_ID_SERIAL_API_GET_INIT_DATA:" );
@@ -2480,12 +2629,16 @@ void Driver::HandleSendDataRequest
 			if( _data[3] != 0 )
 			{
 				node->m_sentFailed++;
+				node->m_linkStats.RecordFailed();
 			}
 			else
 			{
 				node->m_lastRTT = -node->m_sentTS.TimeRemaining();
 				node->m_averageRTT = ( node->m_averageRTT + node->m_lastRTT ) >> 1;
+				node->m_rttHistogram.Observe( node->m_lastRTT );
+				node->m_linkStats.RecordDelivered( node->m_lastRTT );
 			}
+			UpdateLinkQuality( node );
 			ReleaseNodes();
 		}
 
@@ -2528,6 +2681,40 @@ void Driver::HandleSendDataRequest
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::UpdateLinkQuality>
+// Judge the link to a node from the outcome of its recent transmissions,
+// and warn when it becomes poor, since that usually means a bad route.
+//-----------------------------------------------------------------------------
+void Driver::UpdateLinkQuality
+(
+	Node* _node
+)
+{
+	LinkStatistics::Data link;
+	_node->m_linkStats.GetData( LinkStatistics::Window_15Minutes, &link );
+	if( link.m_sent < c_minLinkSends )
+	{
+		return;
+	}
+
+	_node->m_quality = (uint8)link.m_successRate;
+	bool poor = ( link.m_successRate < c_poorLinkQuality );
+	if( poor != _node->m_poorLink )
+	{
+		_node->m_poorLink = poor;
+		if( poor )
+		{
+			Log::Write( LogLevel_Warning, _node->GetNodeId(), "WARNING: Only %d%% of %d messages delivered in the last 15 minutes (%d%% retried), so the node will be polled less often",
+				    link.m_successRate, link.m_sent, link.m_retryRate );
+		}
+		else
+		{
+			Log::Write( LogLevel_Info, _node->GetNodeId(), "Link recovered: %d%% of %d messages delivered in the last 15 minutes", link.m_successRate, link.m_sent );
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::HandleNetworkUpdateRequest>
 // Process a response from the Z-Wave PC interface
@@ -2941,7 +3128,8 @@ void Driver::HandleApplicationCommandHandlerRequest
 	{
 		node->m_receivedCnt++;
 		int cmp = memcmp( _data, node->m_lastReceivedMessage, sizeof(node->m_lastReceivedMessage));
-		if( cmp == 0 && node->m_receivedTS.TimeRemaining() > -500 )
+		uint64 now = TimeStamp::GetMonotonicTime();
+		if( cmp == 0 && ( now - node->m_receivedTime ) < 500 )
 		{
 			// if the exact same sequence of bytes are received within 500ms
 			node->m_receivedDups++;
@@ -2951,6 +3139,7 @@ void Driver::HandleApplicationCommandHandlerRequest
 			memcpy( node->m_lastReceivedMessage, _data, sizeof(node->m_lastReceivedMessage) );
 		}
 		node->m_receivedTS.SetTime();
+		node->m_receivedTime = now;
 	}
 	if( ApplicationStatus::StaticGetCommandClassId() == classId )
 	{
@@ -3316,6 +3505,34 @@ void Driver::CommonAddNodeStatusRequestHandler
 //	Polling Z-Wave devices
 //-----------------------------------------------------------------------------
 
+//-----------------------------------------------------------------------------
+// <PollOffset>
+// Spread the first polls of values over their period, rather than having
+// every value enabled at the same time come due together.  The offset comes
+// from a hash of the value, so it is the same each time the value is enabled.
+//-----------------------------------------------------------------------------
+static int32 PollOffset
+(
+	ValueID const& _valueId,
+	int32 const _period
+)
+{
+	if( _period <= 1 )
+	{
+		return _period;
+	}
+
+	// Mix the bits of the ID (the finaliser of MurmurHash3), so that values
+	// that differ only in their index or instance are spread out too
+	uint64 hash = _valueId.GetId();
+	hash ^= hash >> 33;
+	hash *= 0xff51afd7ed558ccdULL;
+	hash ^= hash >> 33;
+	hash *= 0xc4ceb9fe1a85ec53ULL;
+	hash ^= hash >> 33;
+	return 1 + (int32)( hash % (uint64)_period );
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::EnablePoll>
 // Enable polling of a value
@@ -3323,7 +3540,8 @@ void Driver::CommonAddNodeStatusRequestHandler
 bool Driver::EnablePoll
 (
 	ValueID const _valueId,
-	uint8 const _intensity
+	uint8 const _intensity,
+	int32 const _interval
 )
 {
 	// make sure the polling thread doesn't lock the node while we're in this function
@@ -3335,22 +3553,28 @@ bool Driver::EnablePoll
 	if( node != NULL )
 	{
 		// confirm that this value is in the node's value store
-		if( Value* value = node->GetValue( _valueId ) )
+		if( Value* value = node->BorrowValue( _valueId ) )
 		{
-			// update the value's pollIntensity
+			// update the value's pollIntensity and interval
 			value->SetPollIntensity( _intensity );
+			value->SetPollInterval( _interval );
+			uint64 due = TimeStamp::GetMonotonicTime() + PollOffset( _valueId, GetPollPeriod( value ) );
+			ReleaseNodes();
 
-			// Add the valueid to the polling list
-			// See if the node is already in the poll list.
-			for( list<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
+			// See if the value is already in the poll list.
+			for( vector<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
 			{
 				if( (*it).m_id == _valueId )
 				{
-					// It is already in the poll list, so we have nothing to do.
+					// It is already in the poll list, so just make sure a shorter period takes effect straight away.
+					if( due < (*it).m_due )
+					{
+						(*it).m_due = due;
+						make_heap( m_pollList.begin(), m_pollList.end(), PollEntryLater() );
+						m_pollEvent->Set();
+					}
 					Log::Write( LogLevel_Detail, "EnablePoll not required to do anything (value is already in the poll list)" );
-					value->Release();
 					m_pollMutex->Unlock();
-					ReleaseNodes();
 					return true;
 				}
 			}
@@ -3358,11 +3582,15 @@ bool Driver::EnablePoll
 			// Not in the list, so we add it
 			PollEntry pe;
 			pe.m_id = _valueId;
-			pe.m_pollCounter = value->GetPollIntensity();
+			pe.m_due = due;
+			pe.m_polled = 0;
+			pe.m_queued = false;
+			pe.m_backoff = 0;
+			pe.m_selfReports = 0;
 			m_pollList.push_back( pe );
-			value->Release();
+			push_heap( m_pollList.begin(), m_pollList.end(), PollEntryLater() );
+			m_pollEvent->Set();
 			m_pollMutex->Unlock();
-			ReleaseNodes();
 
 			// send notification to indicate polling is enabled
 			Notification* notification = new Notification( Notification::Type_PollingEnabled );
@@ -3375,11 +3603,15 @@ bool Driver::EnablePoll
 
 		// allow the poll thread to continue
 		m_pollMutex->Unlock();
+		ReleaseNodes();
 
 		Log::Write( LogLevel_Info, nodeId, "EnablePoll failed - value not found for node %d", nodeId );
 		return false;
 	}
 
+	// allow the poll thread to continue
+	m_pollMutex->Unlock();
+
 	Log::Write( LogLevel_Info, "EnablePoll failed - node %d not found", nodeId );
 	return false;
 }
@@ -3402,18 +3634,19 @@ bool Driver::DisablePoll
 	if( node != NULL)
 	{
 		// See if the value is already in the poll list.
-		for( list<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
+		for( vector<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
 		{
 			if( (*it).m_id == _valueId )
 			{
 				// Found it
 				// remove it from the poll list
 				m_pollList.erase( it );
+				make_heap( m_pollList.begin(), m_pollList.end(), PollEntryLater() );
 
 				// get the value object and reset pollIntensity to zero (indicating no polling)
-				Value* value = GetValue( _valueId );
+				Value* value = BorrowValue( _valueId );
 				value->SetPollIntensity( 0 );
-				value->Release();
+				value->SetPollInterval( 0 );
 				m_pollMutex->Unlock();
 				ReleaseNodes();
 
@@ -3455,7 +3688,7 @@ bool Driver::isPolled
 	// make sure the polling thread doesn't lock the node while we're in this function
 	m_pollMutex->Lock();
 
-	Value* value = GetValue( _valueId );
+	Value* value = BorrowValue( _valueId );
 	if( value->GetPollIntensity() != 0 )
 	{
 		bPolled = true;
@@ -3465,8 +3698,6 @@ bool Driver::isPolled
 		bPolled = false;
 	}
 
-	value->Release();
-
 	/*
 	 * This code is retained for the moment as a belt-and-suspenders test to confirm that
 	 * the pollIntensity member of each value and the pollList contents do not get out
@@ -3479,7 +3710,7 @@ bool Driver::isPolled
 	{
 
 		// See if the value is already in the poll list.
-		for( list<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
+		for( vector<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
 		{
 			if( (*it).m_id == _valueId )
 			{
@@ -3554,6 +3785,19 @@ void Driver::PollThreadEntryPoint
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <PollNodeLess>
+// Order ValueIDs by node, for grouping the polls of each node together
+//-----------------------------------------------------------------------------
+static bool PollNodeLess
+(
+	ValueID const& _a,
+	ValueID const& _b
+)
+{
+	return( _a.GetNodeId() < _b.GetNodeId() );
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::PollThreadProc>
 // Thread for poll Z-Wave devices
@@ -3563,129 +3807,290 @@ void Driver::PollThreadProc
 	Event* _exitEvent
 )
 {
+	Wait* waitObjects[2];
+	waitObjects[0] = _exitEvent;
+	waitObjects[1] = m_pollEvent;					// The poll list has changed
+
 	while( 1 )
 	{
-		int32 pollInterval = m_pollInterval;
+		// don't poll until the awake nodes have been fully queried, but keep checking
+		int32 timeout = 500;
+		vector<ValueID> due;
 
-		if( m_awakeNodesQueried && !m_pollList.empty() )
+		if( m_awakeNodesQueried )
 		{
-			// We only bother getting the lock if the pollList is not empty
 			m_pollMutex->Lock();
+			m_pollEvent->Reset();
 
-			// Get the next value to be polled
-			PollEntry pe = m_pollList.front();
-			m_pollList.pop_front();
-			ValueID  valueId = pe.m_id;
-
-			// only execute this poll if pe.m_pollCounter == 1; otherwise decrement the counter and process the next polled value
-			if( pe.m_pollCounter != 1)
-			{
-				pe.m_pollCounter--;
-				m_pollList.push_back( pe );
-				m_pollMutex->Unlock();
-				continue;
-			}
-
-			// reset the poll counter to the full pollIntensity value and push it at the end of the list
-			// release the value object referenced; call GetNode to ensure the node objects are locked during this period
-			(void)GetNode( valueId.GetNodeId() );
-			Value* value = GetValue( valueId );
-			pe.m_pollCounter = value->GetPollIntensity();
-			m_pollList.push_back( pe );
-			value->Release();
-			ReleaseNodes();
-
-			// If the polling interval is for the whole poll list, calculate the time before the next poll,
-			// so that all polls can take place within the user-specified interval.
-			if( !m_bIntervalBetweenPolls )
+			// Take every value that is due off the heap, and work out when it will next be due
+			uint64 now = TimeStamp::GetMonotonicTime();
+			vector<PollEntry> rescheduled;
+			while( !m_pollList.empty() && ( m_pollList.front().m_due <= now ) )
 			{
-				if( pollInterval < 100 )
-				{
-					Log::Write( LogLevel_Info, "The pollInterval setting is only %d, which appears to be a legacy setting.  Multiplying by 1000 to convert to ms.", pollInterval );
-					pollInterval *= 1000;
-				}
-				pollInterval /= m_pollList.size();
-			}
+				pop_heap( m_pollList.begin(), m_pollList.end(), PollEntryLater() );
+				PollEntry pe = m_pollList.back();
+				m_pollList.pop_back();
 
-			// Request the state of the value from the node to which it belongs
-			if( Node* node = GetNode( valueId.GetNodeId() ) )
-			{
-				bool requestState = true;
-				if( !node->IsListeningDevice() )
+				// call GetNode to ensure the node objects are locked during this period
+				(void)GetNode( pe.m_id.GetNodeId() );
+				if( Value* value = BorrowValue( pe.m_id ) )
 				{
-					// The device is not awake all the time.  If it is not awake, we mark it
-					// as requiring a poll.  The poll will be done next time the node wakes up.
-					if( WakeUp* wakeUp = static_cast<WakeUp*>( node->GetCommandClass( WakeUp::StaticGetCommandClassId() ) ) )
+					if( !SkipPoll( pe, value, now ) )
 					{
-						if( !wakeUp->IsAwake() )
+						m_pollLag.Observe( (uint32)( now - pe.m_due ) );
+
+						// Keep to the schedule, unless we have fallen a whole period behind
+						int32 period = GetPollPeriod( value );
+						pe.m_due += period;
+						if( pe.m_due <= now )
 						{
-							wakeUp->SetPollRequired();
-							requestState = false;
+							pe.m_due = now + period;
 						}
+						pe.m_polled = now;
+						pe.m_queued = true;
+						due.push_back( pe.m_id );
 					}
+					rescheduled.push_back( pe );
 				}
-
-				if( requestState )
-				{
-					// Request an update of the value
-					CommandClass* cc = node->GetCommandClass( valueId.GetCommandClassId() );
-					uint8 index = valueId.GetIndex();
-					uint8 instance = valueId.GetInstance();
-					Log::Write( LogLevel_Detail, node->m_nodeId, "Polling: %s index = %d instance = %d (poll queue has %d messages)", cc->GetCommandClassName().c_str(), index, instance, m_msgQueue[MsgQueue_Poll].size() );
-					cc->RequestValue( 0, index, instance, MsgQueue_Poll );
-				}
-
 				ReleaseNodes();
 			}
 
+			for( vector<PollEntry>::iterator it = rescheduled.begin(); it != rescheduled.end(); ++it )
+			{
+				m_pollList.push_back( *it );
+				push_heap( m_pollList.begin(), m_pollList.end(), PollEntryLater() );
+			}
+
+			// Sleep until the next value is due, or the poll list changes
+			timeout = Wait::Timeout_Infinite;
+			if( !m_pollList.empty() )
+			{
+				timeout = (int32)( m_pollList.front().m_due - now );
+			}
 			m_pollMutex->Unlock();
+		}
+
+		if( due.empty() )
+		{
+			if( Wait::Multiple( waitObjects, 2, timeout ) == 0 )
+			{
+				// Exit has been called
+				return;
+			}
+			continue;
+		}
+
+		// Poll the values that are due, one node at a time, so that
+		// each node only has to be woken up once.
+		stable_sort( due.begin(), due.end(), PollNodeLess );
+		for( vector<ValueID>::iterator it = due.begin(); it != due.end(); )
+		{
+			uint8 nodeId = (*it).GetNodeId();
+			while( ( it != due.end() ) && ( (*it).GetNodeId() == nodeId ) )
+			{
+				PollValue( *it );
+				++it;
+			}
 
 			// Polling messages are only sent when there are no other messages waiting to be sent
 			// While this makes the polls much more variable and uncertain if some other activity dominates
 			// a send queue, that may be appropriate
 			// TODO we can have a debate about whether to test all four queues or just the Poll queue
-			// Wait until the library isn't actively sending messages (or in the midst of a transaction)
-			int i32;
-			int loopCount = 0;
-			while( !m_msgQueue[MsgQueue_Poll].empty()
-				|| !m_msgQueue[MsgQueue_Send].empty()
-				|| !m_msgQueue[MsgQueue_Command].empty()
-				|| !m_msgQueue[MsgQueue_Query].empty()
-				|| m_currentMsg != NULL )
-			{
-				i32 = Wait::Single( _exitEvent, 10);		// test conditions every 10ms
+			// Wait until the library isn't actively sending messages (or in the midst of a transaction).
+			// The driver thread signals m_sendIdleEvent once the queues have drained.
+			Wait* idleObjects[2];
+			idleObjects[0] = _exitEvent;
+			idleObjects[1] = m_sendIdleEvent;
+
+			int32 i32;
+			int32 idleTimeout = 10000;
+			while( ( i32 = Wait::Multiple( idleObjects, 2, idleTimeout ) ) != 1 )
+			{
 				if( i32 == 0 )
 				{
 					// Exit has been called
 					return;
 				}
-				loopCount++;
-				if( loopCount == 100*10 )		// 10 seconds worth of delay?
+
+				// 10 seconds worth of delay
+				Log::QueueDump();
+				idleTimeout = Wait::Timeout_Infinite;
+			}
+
+			// The requests to this node have all been sent
+			StampPolls( nodeId, false );
+
+			// If requested, insert the pollInterval delay before polling the next node
+			if( m_bIntervalBetweenPolls )
+			{
+				if( Wait::Single( _exitEvent, m_pollInterval ) == 0 )
 				{
-					Log::QueueDump();
-//					assert( 0 );
+					// Exit has been called
+					return;
 				}
 			}
+		}
+	}
+}
 
-			// ready for next poll...insert the pollInterval delay
-			i32 = Wait::Single( _exitEvent, pollInterval );
-			if( i32 == 0 )
+//-----------------------------------------------------------------------------
+// <Driver::PollValue>
+// Request the state of a value from the node to which it belongs
+//-----------------------------------------------------------------------------
+void Driver::PollValue
+(
+	ValueID const& _valueId
+)
+{
+	if( Node* node = GetNode( _valueId.GetNodeId() ) )
+	{
+		bool requestState = true;
+		if( !node->IsListeningDevice() )
+		{
+			// The device is not awake all the time.  If it is not awake, we mark it
+			// as requiring a poll.  The poll will be done next time the node wakes up.
+			if( WakeUp* wakeUp = static_cast<WakeUp*>( node->GetCommandClass( WakeUp::StaticGetCommandClassId() ) ) )
 			{
-				// Exit has been called
-				return;
+				if( !wakeUp->IsAwake() )
+				{
+					wakeUp->SetPollRequired();
+					requestState = false;
+				}
+			}
+		}
+
+		if( requestState )
+		{
+			// Request an update of the value
+			CommandClass* cc = node->GetCommandClass( _valueId.GetCommandClassId() );
+			if( cc != NULL )
+			{
+				uint8 index = _valueId.GetIndex();
+				uint8 instance = _valueId.GetInstance();
+				OZW_LOG( LogLevel_Detail, node->m_nodeId, "Polling: %s index = %d instance = %d (poll queue has %d messages)", cc->GetCommandClassName().c_str(), index, instance, m_msgQueue[MsgQueue_Poll].size() );
+				cc->RequestValue( 0, index, instance, MsgQueue_Poll );
+				m_pollsSent++;
 			}
 		}
-		else		// poll list is empty or awake nodes haven't been fully queried yet
+
+		ReleaseNodes();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::StampPolls>
+// Called when a poll request to a node is sent, to move the poll time of its
+// queued values up to the time of sending, so that a reply stuck behind a
+// backed-up queue is not mistaken for a report made by the device itself.
+// Called with _sent false once all of the node's requests have gone out.
+//-----------------------------------------------------------------------------
+void Driver::StampPolls
+(
+	uint8 const _nodeId,
+	bool const _sent
+)
+{
+	uint64 now = TimeStamp::GetMonotonicTime();
+	m_pollMutex->Lock();
+	for( vector<PollEntry>::iterator it = m_pollList.begin(); it != m_pollList.end(); ++it )
+	{
+		if( (*it).m_queued && ( (*it).m_id.GetNodeId() == _nodeId ) )
 		{
-			// don't poll just yet, wait for the pollInterval or exit before re-checking to see if the pollList has elements
-			int32 i32 = Wait::Single( _exitEvent, 500 );
-			if( i32 == 0 )
+			if( _sent )
 			{
-				// Exit has been called
-				return;
+				(*it).m_polled = now;
+			}
+			else
+			{
+				(*it).m_queued = false;
 			}
 		}
 	}
+	m_pollMutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::SkipPoll>
+// Decide whether a due poll is redundant because the device has already
+// reported the value by itself.  If so, the entry is rescheduled from the
+// time of that report.  Values that keep reporting by themselves have their
+// poll period stretched, up to 2^c_maxPollBackoff times, until a poll is
+// needed again.
+//-----------------------------------------------------------------------------
+bool Driver::SkipPoll
+(
+	PollEntry& _entry,
+	Value const* _value,
+	uint64 const _now
+)
+{
+	if( !m_bAdaptivePolling )
+	{
+		return false;
+	}
+
+	// A report that arrives soon after a poll is taken to be the reply to it
+	int32 period = GetPollPeriod( _value );
+	int32 window = ( period / 2 < c_pollResponseWindow ) ? period / 2 : c_pollResponseWindow;
+
+	uint64 reported = _value->m_reportTime;
+	if( ( reported > ( _entry.m_polled + window ) ) && ( ( reported + ( (uint64)period << _entry.m_backoff ) ) > _now ) )
+	{
+		// The device reported the value by itself within the (stretched) poll period
+		m_pollsSaved++;
+		if( ( ++_entry.m_selfReports >= c_pollBackoffThreshold ) && ( _entry.m_backoff < c_maxPollBackoff ) )
+		{
+			++_entry.m_backoff;
+			_entry.m_selfReports = 0;
+			Log::Write( LogLevel_Detail, _value->GetID().GetNodeId(), "Adaptive polling: value(cc=0x%02x,in=0x%02x,id=0x%02x) reports by itself, now polled every %d ms",
+				    _value->GetID().GetCommandClassId(), _value->GetID().GetInstance(), _value->GetID().GetIndex(), period << _entry.m_backoff );
+		}
+		_entry.m_due = reported + ( (uint64)period << _entry.m_backoff );
+		return true;
+	}
+
+	// The device has gone quiet, so go back to polling at the normal rate
+	_entry.m_backoff = 0;
+	_entry.m_selfReports = 0;
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetPollPeriod>
+// Get the time in milliseconds between polls of a value
+//-----------------------------------------------------------------------------
+int32 Driver::GetPollPeriod
+(
+	Value const* _value
+)
+{
+	int32 period = _value->GetPollInterval();
+	if( period <= 0 )
+	{
+		// Use the driver's poll interval, stretched by the value's intensity
+		period = m_pollInterval;
+		if( period < 100 )
+		{
+			// Legacy settings were in seconds
+			period *= 1000;
+		}
+		if( _value->GetPollIntensity() > 1 )
+		{
+			period *= _value->GetPollIntensity();
+		}
+	}
+
+	// Poll nodes with a poor link less often, so they don't tie up the network
+	if( Node* node = GetNodeUnsafe( _value->GetID().GetNodeId() ) )
+	{
+		if( node->m_poorLink )
+		{
+			period <<= ( node->m_quality < c_poorLinkQuality / 2 ) ? 2 : 1;
+		}
+	}
+
+	// Never poll a value more often than every 100ms
+	return( ( period < 100 ) ? 100 : period );
 }
 
 //-----------------------------------------------------------------------------
@@ -3743,7 +4148,7 @@ void Driver::InitNode
 	}
 
 	// Add the new node
-	m_nodes[_nodeId] = new Node( m_homeId, _nodeId );
+	m_nodes[_nodeId] = new Node( m_homeId, _nodeId, &m_nodeSnapshots[_nodeId] );
 	ReleaseNodes();
 
 	Notification* notification = new Notification( Notification::Type_NodeAdded );
@@ -3763,14 +4168,13 @@ bool Driver::IsNodeListeningDevice
 	 uint8 const _nodeId
 )
 {
-	bool res = false;
-	if( Node* node = GetNode( _nodeId ) )
+	NodeSnapshot::Info info;
+	if( m_nodeSnapshots[_nodeId].GetInfo( &info ) )
 	{
-		res = node->IsListeningDevice();
-		ReleaseNodes();
+		return info.m_listening;
 	}
 
-	return res;
+	return false;
 }
 
 //-----------------------------------------------------------------------------
@@ -3782,14 +4186,13 @@ bool Driver::IsNodeFrequentListeningDevice
 	 uint8 const _nodeId
 )
 {
-	bool res = false;
-	if( Node* node = GetNode( _nodeId ) )
+	NodeSnapshot::Info info;
+	if( m_nodeSnapshots[_nodeId].GetInfo( &info ) )
 	{
-		res = node->IsFrequentListeningDevice();
-		ReleaseNodes();
+		return info.m_frequentListening;
 	}
 
-	return res;
+	return false;
 }
 
 //-----------------------------------------------------------------------------
@@ -3801,14 +4204,13 @@ bool Driver::IsNodeBeamingDevice
 	 uint8 const _nodeId
 )
 {
-	bool res = false;
-	if( Node* node = GetNode( _nodeId ) )
+	NodeSnapshot::Info info;
+	if( m_nodeSnapshots[_nodeId].GetInfo( &info ) )
 	{
-		res = node->IsBeamingDevice();
-		ReleaseNodes();
+		return info.m_beaming;
 	}
 
-	return res;
+	return false;
 }
 
 //-----------------------------------------------------------------------------
@@ -3820,14 +4222,13 @@ bool Driver::IsNodeRoutingDevice
 	 uint8 const _nodeId
 )
 {
-	bool res = false;
-	if( Node* node = GetNode( _nodeId ) )
+	NodeSnapshot::Info info;
+	if( m_nodeSnapshots[_nodeId].GetInfo( &info ) )
 	{
-		res = node->IsRoutingDevice();
-		ReleaseNodes();
+		return info.m_routing;
 	}
 
-	return res;
+	return false;
 }
 
 //-----------------------------------------------------------------------------
@@ -3839,14 +4240,13 @@ bool Driver::IsNodeSecurityDevice
 	 uint8 const _nodeId
 )
 {
-	bool security = false;
-	if( Node* node = GetNode( _nodeId ) )
+	NodeSnapshot::Info info;
+	if( m_nodeSnapshots[_nodeId].GetInfo( &info ) )
 	{
-		security = node->IsSecurityDevice();
-		ReleaseNodes();
+		return info.m_security;
 	}
 
-	return security;
+	return false;
 }
 
 //-----------------------------------------------------------------------------
@@ -3858,14 +4258,13 @@ uint32 Driver::GetNodeMaxBaudRate
 	 uint8 const _nodeId
 )
 {
-	uint32 baud = 0;
-	if( Node* node = GetNode( _nodeId ) )
+	NodeSnapshot::Info info;
+	if( m_nodeSnapshots[_nodeId].GetInfo( &info ) )
 	{
-		baud = node->GetMaxBaudRate();
-		ReleaseNodes();
+		return info.m_maxBaudRate;
 	}
 
-	return baud;
+	return 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -3877,14 +4276,13 @@ uint8 Driver::GetNodeVersion
 	 uint8 const _nodeId
 )
 {
-	uint8 version = 0;
-	if( Node* node = GetNode( _nodeId ) )
+	NodeSnapshot::Info info;
+	if( m_nodeSnapshots[_nodeId].GetInfo( &info ) )
 	{
-		version = node->GetVersion();
-		ReleaseNodes();
+		return info.m_version;
 	}
 
-	return version;
+	return 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -3896,14 +4294,13 @@ uint8 Driver::GetNodeSecurity
 	 uint8 const _nodeId
 )
 {
-	uint8 security = 0;
-	if( Node* node = GetNode( _nodeId ) )
+	NodeSnapshot::Info info;
+	if( m_nodeSnapshots[_nodeId].GetInfo( &info ) )
 	{
-		security = node->GetSecurity();
-		ReleaseNodes();
+		return info.m_security;
 	}
 
-	return security;
+	return 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -3915,14 +4312,13 @@ uint8 Driver::GetNodeBasic
 	 uint8 const _nodeId
 )
 {
-	uint8 basic = 0;
-	if( Node* node = GetNode( _nodeId ) )
+	NodeSnapshot::Info info;
+	if( m_nodeSnapshots[_nodeId].GetInfo( &info ) )
 	{
-		basic = node->GetBasic();
-		ReleaseNodes();
+		return info.m_basic;
 	}
 
-	return basic;
+	return 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -3934,14 +4330,13 @@ uint8 Driver::GetNodeGeneric
 	 uint8 const _nodeId
 )
 {
-	uint8 genericType = 0;
-	if( Node* node = GetNode( _nodeId ) )
+	NodeSnapshot::Info info;
+	if( m_nodeSnapshots[_nodeId].GetInfo( &info ) )
 	{
-		genericType = node->GetGeneric();
-		ReleaseNodes();
+		return info.m_generic;
 	}
 
-	return genericType;
+	return 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -3953,14 +4348,13 @@ uint8 Driver::GetNodeSpecific
 	 uint8 const _nodeId
 )
 {
-	uint8 specific = 0;
-	if( Node* node = GetNode( _nodeId ) )
+	NodeSnapshot::Info info;
+	if( m_nodeSnapshots[_nodeId].GetInfo( &info ) )
 	{
-		specific = node->GetSpecific();
-		ReleaseNodes();
+		return info.m_specific;
 	}
 
-	return specific;
+	return 0;
 }
 
 //-----------------------------------------------------------------------------
@@ -3973,9 +4367,16 @@ string Driver::GetNodeType
 	uint8 const _nodeId
 )
 {
+	string str;
+	if( m_nodeSnapshots[_nodeId].GetString( NodeSnapshot::Field_Type, &str ) )
+	{
+		return str;
+	}
+
+	// The node is gone, or the string was too long for the snapshot
 	if( Node* node = GetNode( _nodeId ) )
 	{
-		string str = node->GetType();
+		str = node->GetType();
 		ReleaseNodes();
 		return str;
 	}
@@ -4013,9 +4414,16 @@ string Driver::GetNodeManufacturerName
 	uint8 const _nodeId
 )
 {
+	string str;
+	if( m_nodeSnapshots[_nodeId].GetString( NodeSnapshot::Field_ManufacturerName, &str ) )
+	{
+		return str;
+	}
+
+	// The node is gone, or the string was too long for the snapshot
 	if( Node* node = GetNode( _nodeId ) )
 	{
-		string str = node->GetManufacturerName();
+		str = node->GetManufacturerName();
 		ReleaseNodes();
 		return str;
 	}
@@ -4033,9 +4441,16 @@ string Driver::GetNodeProductName
 	uint8 const _nodeId
 )
 {
+	string str;
+	if( m_nodeSnapshots[_nodeId].GetString( NodeSnapshot::Field_ProductName, &str ) )
+	{
+		return str;
+	}
+
+	// The node is gone, or the string was too long for the snapshot
 	if( Node* node = GetNode( _nodeId ) )
 	{
-		string str = node->GetProductName();
+		str = node->GetProductName();
 		ReleaseNodes();
 		return str;
 	}
@@ -4053,9 +4468,16 @@ string Driver::GetNodeName
 	uint8 const _nodeId
 )
 {
+	string str;
+	if( m_nodeSnapshots[_nodeId].GetString( NodeSnapshot::Field_Name, &str ) )
+	{
+		return str;
+	}
+
+	// The node is gone, or the string was too long for the snapshot
 	if( Node* node = GetNode( _nodeId ) )
 	{
-		string str = node->GetNodeName();
+		str = node->GetNodeName();
 		ReleaseNodes();
 		return str;
 	}
@@ -4073,9 +4495,16 @@ string Driver::GetNodeLocation
 	uint8 const _nodeId
 )
 {
+	string str;
+	if( m_nodeSnapshots[_nodeId].GetString( NodeSnapshot::Field_Location, &str ) )
+	{
+		return str;
+	}
+
+	// The node is gone, or the string was too long for the snapshot
 	if( Node* node = GetNode( _nodeId ) )
 	{
-		string str = node->GetLocation();
+		str = node->GetLocation();
 		ReleaseNodes();
 		return str;
 	}
@@ -4093,9 +4522,16 @@ string Driver::GetNodeManufacturerId
 	uint8 const _nodeId
 )
 {
+	string str;
+	if( m_nodeSnapshots[_nodeId].GetString( NodeSnapshot::Field_ManufacturerId, &str ) )
+	{
+		return str;
+	}
+
+	// The node is gone, or the string was too long for the snapshot
 	if( Node* node = GetNode( _nodeId ) )
 	{
-		string str = node->GetManufacturerId();
+		str = node->GetManufacturerId();
 		ReleaseNodes();
 		return str;
 	}
@@ -4113,9 +4549,16 @@ string Driver::GetNodeProductType
 	uint8 const _nodeId
 )
 {
+	string str;
+	if( m_nodeSnapshots[_nodeId].GetString( NodeSnapshot::Field_ProductType, &str ) )
+	{
+		return str;
+	}
+
+	// The node is gone, or the string was too long for the snapshot
 	if( Node* node = GetNode( _nodeId ) )
 	{
-		string str = node->GetProductType();
+		str = node->GetProductType();
 		ReleaseNodes();
 		return str;
 	}
@@ -4133,9 +4576,16 @@ string Driver::GetNodeProductId
 	uint8 const _nodeId
 )
 {
+	string str;
+	if( m_nodeSnapshots[_nodeId].GetString( NodeSnapshot::Field_ProductId, &str ) )
+	{
+		return str;
+	}
+
+	// The node is gone, or the string was too long for the snapshot
 	if( Node* node = GetNode( _nodeId ) )
 	{
-		string str = node->GetProductId();
+		str = node->GetProductId();
 		ReleaseNodes();
 		return str;
 	}
@@ -4278,6 +4728,23 @@ Value* Driver::GetValue
 	return NULL;
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::BorrowValue>
+// Get a pointer to a Value object without adding a reference to it
+//-----------------------------------------------------------------------------
+Value* Driver::BorrowValue
+(
+	ValueID const& _id
+)
+{
+	if( Node* node = m_nodes[_id.GetNodeId()] )
+	{
+		return node->BorrowValue( _id );
+	}
+
+	return NULL;
+}
+
 //-----------------------------------------------------------------------------
 // Controller commands
 //-----------------------------------------------------------------------------
@@ -4963,6 +5430,41 @@ void Driver::RemoveAssociation
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::CreateValueLog>
+// Open the value log, if the options ask for one
+//-----------------------------------------------------------------------------
+void Driver::CreateValueLog
+(
+)
+{
+	if( m_valueLog == NULL )
+	{
+		m_valueLog = ValueLog::Create( m_homeId );
+		if( m_valueLog != NULL )
+		{
+			m_timers.Schedule( &m_valueLogTimer, m_valueLog->GetServiceInterval() );
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::ValueLogTimerCallback>
+// Write out the value log
+//-----------------------------------------------------------------------------
+void Driver::ValueLogTimerCallback
+(
+	void* _context
+)
+{
+	Driver* driver = (Driver*)_context;
+	if( driver && driver->m_valueLog )
+	{
+		driver->m_valueLog->Service();
+		driver->m_timers.Schedule( &driver->m_valueLogTimer, driver->m_valueLog->GetServiceInterval() );
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::QueueNotification>
 // Add a notification to the queue to be sent at a later, safe time.
@@ -4990,7 +5492,34 @@ void Driver::NotifyWatchers
 		Notification* notification = m_notifications.front();
 		m_notifications.pop_front();
 
+		// Let applications that refresh their view of the nodes know that this one has changed
+		if( ( notification->GetType() == Notification::Type_ValueAdded ) || ( notification->GetType() == Notification::Type_ValueRemoved ) || ( notification->GetType() == Notification::Type_ValueChanged ) )
+		{
+			m_nodeSnapshots[notification->GetNodeId()].Touch();
+		}
+
+		// A value reported by a node confirms any traced command that was sent to it
+		uint32 traceId = 0;
+		uint64 traceStart = 0;
+		if( ( notification->GetType() == Notification::Type_ValueChanged ) || ( notification->GetType() == Notification::Type_ValueRefreshed ) )
+		{
+			traceId = m_nodeTraceId[notification->GetNodeId()];
+			m_nodeTraceId[notification->GetNodeId()] = 0;
+			if( traceId != 0 )
+			{
+				traceStart = Trace::GetTime();
+			}
+		}
+
+		uint64 start = TimeStamp::GetMonotonicTime();
 		Manager::Get()->NotifyWatchers( notification );
+		m_notificationDispatchTime.Observe( (uint32)( TimeStamp::GetMonotonicTime() - start ) );
+
+		if( traceId != 0 )
+		{
+			Trace::Span( traceId, "notify", traceStart, Trace::GetTime() );
+			Trace::End( traceId, ( notification->GetType() == Notification::Type_ValueChanged ) ? "ValueChanged" : "ValueRefreshed" );
+		}
 
 		delete notification;
 		nit = m_notifications.begin();
@@ -5583,6 +6112,84 @@ uint8 Driver::NodeFromMessage
 	}
 	return nodeId;
 }
+
+//-----------------------------------------------------------------------------
+// <Driver::CommandClassFromMessage>
+// See if we can get the command class from the message data
+//-----------------------------------------------------------------------------
+uint8 Driver::CommandClassFromMessage
+(
+	uint8 const* buffer
+)
+{
+	if( ( buffer[1] >= 7 ) && ( buffer[3] == FUNC_ID_APPLICATION_COMMAND_HANDLER ) )
+	{
+		return buffer[7];
+	}
+	return 0;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::WriteFrameRecord>
+// Add a record about the current message to the frame log
+//-----------------------------------------------------------------------------
+void Driver::WriteFrameRecord
+(
+	FrameLog::Event const _event
+)
+{
+	if( !FrameLog::IsEnabled() || ( m_currentMsg == NULL ) )
+	{
+		return;
+	}
+
+	FrameLog::Record record( _event, m_homeId );
+	record.m_nodeId = m_currentMsg->GetTargetNodeId();
+	record.m_callbackId = m_currentMsg->GetCallbackId();
+	record.m_functionId = m_currentMsg->GetBuffer()[3];
+	record.m_commandClassId = m_currentMsg->GetSendingCommandClass();
+	if( m_currentMsgQueue < MsgQueue_Count )
+	{
+		record.m_queue = c_queueNames[m_currentMsgQueue];
+	}
+	record.m_attempt = m_currentMsg->GetSendAttempts();
+	if( ( _event != FrameLog::Event_Send ) && ( m_currentMsgFirstSent != 0 ) )
+	{
+		uint64 now = TimeStamp::GetMonotonicTime();
+		record.m_rtt = (int32)( now - m_currentMsgLastSent );
+		record.m_total = (int32)( now - m_currentMsgFirstSent );
+	}
+	FrameLog::Write( record );
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::FinishTracedMsg>
+// Write the stages of the current message to its trace
+//-----------------------------------------------------------------------------
+void Driver::FinishTracedMsg
+(
+	bool const _bDelivered
+)
+{
+	uint32 traceId = m_currentMsg->GetTraceId();
+	if( traceId == 0 )
+	{
+		return;
+	}
+
+	m_currentMsg->WriteTrace( _bDelivered ? "complete" : "dropped" );
+	if( _bDelivered )
+	{
+		// The trace ends when the node reports a value
+		m_nodeTraceId[m_currentMsg->GetTargetNodeId()] = traceId;
+	}
+	else
+	{
+		// The command will never be confirmed
+		Trace::End( traceId, "dropped" );
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::UpdateNodeRoutesCallback>
 // Handle node routing update controller response
@@ -5727,6 +6334,10 @@ void Driver::GetDriverStatistics
 	_data->m_routedbusy = m_routedbusy;
 	_data->m_broadcastReadCnt = m_broadcastReadCnt;
 	_data->m_broadcastWriteCnt = m_broadcastWriteCnt;
+	_data->m_pollsSent = m_pollsSent;
+	_data->m_pollsSaved = m_pollsSaved;
+	_data->m_verifyReads = m_verifyReads;
+	_data->m_changesFiltered = m_changesFiltered;
 }
 
 //-----------------------------------------------------------------------------
@@ -5747,6 +6358,242 @@ void Driver::GetNodeStatistics
 	ReleaseNodes();
 }
 
+//-----------------------------------------------------------------------------
+// <Driver::GetNodeLinkStatistics>
+// Return the statistics of the recent messages sent to a node
+//-----------------------------------------------------------------------------
+bool Driver::GetNodeLinkStatistics
+(
+	uint8 const _nodeId,
+	LinkStatistics::Window const _window,
+	LinkStatistics::Data* _data
+)
+{
+	if( Node* node = GetNode( _nodeId ) )
+	{
+		node->m_linkStats.GetData( _window, _data );
+		ReleaseNodes();
+		return true;
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetAllNodeInfo>
+// Return the description and user values of every node that has changed
+// since a generation, all from a single locking of the nodes
+//-----------------------------------------------------------------------------
+uint32 Driver::GetAllNodeInfo
+(
+	uint32 const _sinceGeneration,
+	vector<Node::NodeInfo>* _nodes
+)
+{
+	// Anything that changes from now on will be newer than this, so the
+	// caller can't miss it by asking for changes since this generation.
+	uint32 generation = NodeSnapshot::GetCurrentGeneration();
+
+	LockNodes();
+	for( int32 i=0; i<256; ++i )
+	{
+		uint32 nodeGeneration = m_nodeSnapshots[i].GetGeneration();
+		if( nodeGeneration <= _sinceGeneration )
+		{
+			continue;
+		}
+
+		_nodes->push_back( Node::NodeInfo() );
+		Node::NodeInfo& info = _nodes->back();
+		if( Node* node = m_nodes[i] )
+		{
+			node->GetNodeInfo( &info );
+		}
+		else
+		{
+			// The node has been removed
+			memset( &info.m_info, 0, sizeof(info.m_info) );
+			info.m_nodeId = (uint8)i;
+			info.m_exists = false;
+			info.m_generation = nodeGeneration;
+			info.m_infoReceived = false;
+			info.m_awake = false;
+		}
+	}
+	ReleaseNodes();
+
+	return generation;
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetValues>
+// Read the values with this driver's home ID, all from a single locking of
+// the nodes.  The results must already have an entry for each value.
+//-----------------------------------------------------------------------------
+void Driver::GetValues
+(
+	vector<ValueID> const& _ids,
+	Node::ValueResults* _results
+)
+{
+	LockNodes();
+	for( size_t i=0; i<_ids.size(); ++i )
+	{
+		ValueID const& id = _ids[i];
+		if( id.GetHomeId() != m_homeId )
+		{
+			continue;
+		}
+
+		if( Node* node = m_nodes[id.GetNodeId()] )
+		{
+			node->ReadValue( id, i, _results );
+		}
+	}
+	ReleaseNodes();
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::GetNodeValueSnapshot>
+// Read every value of a node, unless none have changed since the last read
+//-----------------------------------------------------------------------------
+bool Driver::GetNodeValueSnapshot
+(
+	uint8 const _nodeId,
+	Node::ValueSnapshot* _snapshot
+)
+{
+	// As in GetAllNodeInfo, the generation is read first so that a change
+	// made while the values are being read is never missed.
+	uint32 generation = m_nodeSnapshots[_nodeId].GetGeneration();
+	if( ( generation != 0 ) && ( generation == _snapshot->m_generation ) )
+	{
+		// Nothing has changed, so the caller's copy is still current
+		return true;
+	}
+
+	LockNodes();
+	Node* node = m_nodes[_nodeId];
+	if( node != NULL )
+	{
+		node->GetValueSnapshot( _snapshot );
+		_snapshot->m_generation = generation;
+	}
+	ReleaseNodes();
+
+	return( node != NULL );
+}
+
+// The statistics that are exported as counters
+Driver::CounterInfo const Driver::s_counterInfo[] =
+{
+	{ &Driver::m_SOFCnt,			"ozw_sof_received_total",			"Number of SOF bytes received" },
+	{ &Driver::m_ACKWaiting,		"ozw_ack_waiting_total",			"Number of unsolicited messages received while waiting for an ACK" },
+	{ &Driver::m_readAborts,		"ozw_read_aborts_total",			"Number of reads aborted due to timeouts" },
+	{ &Driver::m_badChecksum,		"ozw_bad_checksums_total",			"Number of messages received with a bad checksum" },
+	{ &Driver::m_readCnt,			"ozw_messages_received_total",		"Number of messages successfully received" },
+	{ &Driver::m_writeCnt,			"ozw_messages_sent_total",			"Number of messages sent" },
+	{ &Driver::m_CANCnt,			"ozw_can_received_total",			"Number of CAN bytes received from the controller" },
+	{ &Driver::m_NAKCnt,			"ozw_nak_received_total",			"Number of NAK bytes received from the controller" },
+	{ &Driver::m_ACKCnt,			"ozw_ack_received_total",			"Number of ACK bytes received from the controller" },
+	{ &Driver::m_OOFCnt,			"ozw_out_of_frame_total",			"Number of bytes received out of framing" },
+	{ &Driver::m_dropped,			"ozw_messages_dropped_total",		"Number of messages dropped and not delivered" },
+	{ &Driver::m_retries,			"ozw_retries_total",				"Number of messages retransmitted" },
+	{ &Driver::m_callbacks,			"ozw_unexpected_callbacks_total",	"Number of unexpected callbacks" },
+	{ &Driver::m_badroutes,			"ozw_bad_routes_total",				"Number of messages that failed due to a bad route" },
+	{ &Driver::m_noack,				"ozw_no_ack_total",					"Number of messages not acknowledged by the destination node" },
+	{ &Driver::m_netbusy,			"ozw_network_busy_total",			"Number of messages that failed because the network was busy" },
+	{ &Driver::m_nondelivery,		"ozw_non_delivery_total",			"Number of messages not delivered to the network" },
+	{ &Driver::m_routedbusy,		"ozw_routed_busy_total",			"Number of messages received with routed busy status" },
+	{ &Driver::m_broadcastReadCnt,	"ozw_broadcasts_received_total",	"Number of broadcasts received" },
+	{ &Driver::m_broadcastWriteCnt,	"ozw_broadcasts_sent_total",		"Number of broadcasts sent" },
+	{ &Driver::m_pollsSent,			"ozw_polls_sent_total",				"Number of values polled" },
+	{ &Driver::m_pollsSaved,		"ozw_polls_saved_total",			"Number of polls skipped because the device had recently reported the value by itself" },
+	{ &Driver::m_verifyReads,		"ozw_verify_reads_total",			"Number of extra reads made to check reported changes in values" },
+	{ &Driver::m_changesFiltered,	"ozw_changes_filtered_total",		"Number of reported changes dropped by a value's deadband or minimum interval" }
+};
+
+//-----------------------------------------------------------------------------
+// <Driver::RegisterMetrics>
+// Add the driver's statistics to the metrics registry
+//-----------------------------------------------------------------------------
+void Driver::RegisterMetrics
+(
+)
+{
+	// The home ID may change if the controller is reset
+	UnregisterMetrics();
+
+	char str[16];
+	snprintf( str, sizeof(str), "0x%.8x", m_homeId );
+	string home = Metrics::Label( "home", str );
+
+	for( uint32 i=0; i<sizeof(s_counterInfo)/sizeof(s_counterInfo[0]); ++i )
+	{
+		Metrics::Register( &(this->*s_counterInfo[i].m_counter), s_counterInfo[i].m_name, s_counterInfo[i].m_help, home );
+	}
+
+	Metrics::Register( &m_queueWaitTime, "ozw_queue_wait_seconds", "Time messages spend in the send queues before they are sent", home );
+	Metrics::Register( &m_callbackLatency, "ozw_callback_latency_seconds", "Time from sending a message to receiving its callback from the controller", home );
+	Metrics::Register( &m_notificationDispatchTime, "ozw_notification_dispatch_seconds", "Time taken by the watchers to handle each notification", home );
+	Metrics::Register( &m_pollLag, "ozw_poll_lag_seconds", "How late values are polled, compared to when they were due", home );
+	for( int32 i=0; i<MsgQueue_Count; ++i )
+	{
+		Metrics::Register( &m_queueLength[i], "ozw_send_queue_length", "Number of items waiting in each send queue", home + "," + Metrics::Label( "queue", c_queueNames[i] ) );
+	}
+	Metrics::Register( &m_pollListLength, "ozw_poll_list_length", "Number of values being polled", home );
+
+	Metrics::AddCollector( CollectMetrics, this );
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::UnregisterMetrics>
+// Remove the driver's statistics from the metrics registry
+//-----------------------------------------------------------------------------
+void Driver::UnregisterMetrics
+(
+)
+{
+	Metrics::RemoveCollector( CollectMetrics, this );
+
+	for( uint32 i=0; i<sizeof(s_counterInfo)/sizeof(s_counterInfo[0]); ++i )
+	{
+		Metrics::Unregister( &(this->*s_counterInfo[i].m_counter) );
+	}
+
+	Metrics::Unregister( &m_queueWaitTime );
+	Metrics::Unregister( &m_callbackLatency );
+	Metrics::Unregister( &m_notificationDispatchTime );
+	Metrics::Unregister( &m_pollLag );
+	for( int32 i=0; i<MsgQueue_Count; ++i )
+	{
+		Metrics::Unregister( &m_queueLength[i] );
+	}
+	Metrics::Unregister( &m_pollListLength );
+}
+
+//-----------------------------------------------------------------------------
+// <Driver::CollectMetrics>
+// Bring the gauges up to date before the metrics are exported
+//-----------------------------------------------------------------------------
+void Driver::CollectMetrics
+(
+	void* _context
+)
+{
+	Driver* driver = (Driver*)_context;
+
+	driver->m_sendMutex->Lock();
+	for( int32 i=0; i<MsgQueue_Count; ++i )
+	{
+		driver->m_queueLength[i].Set( (int32)driver->m_msgQueue[i].size() );
+	}
+	driver->m_sendMutex->Unlock();
+
+	driver->m_pollMutex->Lock();
+	driver->m_pollListLength.Set( (int32)driver->m_pollList.size() );
+	driver->m_pollMutex->Unlock();
+}
+
 //-----------------------------------------------------------------------------
 // <Driver::LogDriverStatistics>
 // Report driver statistics to the driver's log
@@ -5775,10 +6622,13 @@ void Driver::LogDriverStatistics
 	Log::Write( LogLevel_Always, "Total messages successfully received: . . . . . . . . . . %ld", data.m_readCnt );
 	Log::Write( LogLevel_Always, "Total Messages successfully sent: . . . . . . . . . . . . %ld", data.m_writeCnt );
 	Log::Write( LogLevel_Always, "ACKs received from controller:  . . . . . . . . . . . . . %ld", data.m_ACKCnt );
+	Log::Write( LogLevel_Always, "Values polled:  . . . . . . . . . . . . . . . . . . . . . %ld", data.m_pollsSent );
+	Log::Write( LogLevel_Always, "Polls saved by self-reporting devices:  . . . . . . . . . %ld", data.m_pollsSaved );
+	Log::Write( LogLevel_Always, "Extra reads to verify reported changes: . . . . . . . . . %ld", data.m_verifyReads );
+	Log::Write( LogLevel_Always, "Changes dropped by value filters: . . . . . . . . . . . . %ld", data.m_changesFiltered );
 	// Consider tracking and adding:
 	//		Initialization messages
 	//		Ad-hoc command messages
-	//		Polling messages
 	//		Messages inititated by network
 	//		Others?
 	Log::Write( LogLevel_Always, "*** Errors" );
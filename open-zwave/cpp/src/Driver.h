@@ -31,11 +31,15 @@
 #include <string>
 #include <map>
 #include <list>
+#include <vector>
 
 #include "Defs.h"
 #include "ValueID.h"
 #include "Node.h"
 #include "TimeStamp.h"
+#include "TimerWheel.h"
+#include "FrameLog.h"
+#include "Metrics.h"
 
 namespace OpenZWave
 {
@@ -47,6 +51,7 @@ namespace OpenZWave
 	class Thread;
 	class ControllerReplication;
 	class Notification;
+	class ValueLog;
 
 	/** \brief The Driver class handles communication between OpenZWave 
 	 *  and a device attached via a serial port (typically a controller).
@@ -247,6 +252,7 @@ namespace OpenZWave
 		uint8					m_nodeId;									// Z-Wave Controller's own node ID.
 		Node*					m_nodes[256];								// Array containing all the node objects.
 		Mutex*					m_nodeMutex;								// Serializes access to node data
+		NodeSnapshot			m_nodeSnapshots[256];						// Node descriptions that can be read without locking m_nodeMutex
 
 		ControllerReplication*	m_controllerReplication;					// Controller replication is handled separately from the other command classes, due to older hand-held controllers using invalid node IDs.
 
@@ -285,13 +291,15 @@ namespace OpenZWave
 		 *  RemoveNodeQuery, Node::AllQueriesCompleted
 		 */
 		bool WriteNextMsg( MsgQueue const _queue );							// Extracts the first message from the queue, and makes it the current one.
-		bool WriteMsg( string const str);									// Sends the current message to the Z-Wave network
+		bool WriteMsg( char const* _reason );									// Sends the current message to the Z-Wave network
 		void RemoveCurrentMsg();											// Deletes the current message and cleans up the callback etc states
 		bool MoveMessagesToWakeUpQueue(	uint8 const _targetNodeId );		// If a node does not respond, and is of a type that can sleep, this method is used to move all its pending messages to another queue ready for when it mext wakes up.
 		bool IsControllerCommand( uint8 const _command );					// identify controller commands
 		bool IsExpectedReply( uint8 const _nodeId );						// Determine if reply message is the one we are expecting
 		void SendQueryStageComplete( uint8 const _nodeId, Node::QueryStage const _stage, MsgQueue const _queue );
 		void CheckCompletedNodeQueries();									// Send notifications if all awake and/or sleeping nodes have completed their queries
+		void WriteFrameRecord( FrameLog::Event const _event );				// Add a record about the current message to the frame log
+		void FinishTracedMsg( bool const _bDelivered );						// Write the stages of the current message to its trace
 
 		// Requests to be sent to nodes are assigned to one of five queues.
 		// From highest to lowest priority, these are
@@ -345,13 +353,35 @@ namespace OpenZWave
 			Msg*				m_msg;
 			uint8				m_nodeId;
 			Node::QueryStage		m_queryStage;
+			uint64				m_queued;				// When the item was added to a send queue (monotonic milliseconds)
 		};
 
 		list<MsgQueueItem>			m_msgQueue[MsgQueue_Count];
 		Event*					m_queueEvent[MsgQueue_Count];				// Events for each queue, which are signalled when the queue is not empty
 		Mutex*					m_sendMutex;						// Serialize access to the queues
+		Event*					m_sendIdleEvent;					// Signalled when the send queues are empty and no message is in progress
 		Msg*					m_currentMsg;
-		TimeStamp				m_resendTimeStamp;
+		MsgQueue				m_currentMsgQueue;					// Queue the current message came from, or MsgQueue_Count if not known
+		uint64					m_currentMsgFirstSent;					// When the first attempt at sending the current message was made (monotonic milliseconds)
+		uint64					m_currentMsgLastSent;					// When the latest attempt was made
+		uint32					m_nodeTraceId[256];					// Traced command that each node is expected to confirm by reporting a value
+
+	//-----------------------------------------------------------------------------
+	//	Timeouts
+	//-----------------------------------------------------------------------------
+	private:
+		/**
+		 *  Entry point for the retry timer, called on the driver thread
+		 */
+		static void RetryTimerCallback( void* _context );
+		/**
+		 *  Called when the current message has not been acknowledged or completed
+		 *  within RETRY_TIMEOUT.  Sends a timeout notification and resends the message.
+		 */
+		void HandleRetryTimeout();
+
+		TimerWheel				m_timers;						// Timeouts, serviced by the driver thread
+		TimerWheel::Timer			m_retryTimer;						// Fires if the current message does not complete in time
 
 	//-----------------------------------------------------------------------------
 	//	Receiving Z-Wave messages
@@ -393,6 +423,7 @@ namespace OpenZWave
 		void HandleGetRoutingInfoResponse( uint8* _data );
 
 		void HandleSendDataRequest( uint8* _data, bool _replication );
+		void UpdateLinkQuality( Node* _node );
 		void HandleAddNodeToNetworkRequest( uint8* _data );
 		void HandleCreateNewPrimaryRequest( uint8* _data );
 		void HandleControllerChangeRequest( uint8* _data );
@@ -433,23 +464,38 @@ namespace OpenZWave
 	private:
 		int32 GetPollInterval(){ return m_pollInterval ; }
 		void SetPollInterval( int32 _milliseconds, bool _bIntervalBetweenPolls ){ m_pollInterval = _milliseconds; m_bIntervalBetweenPolls = _bIntervalBetweenPolls; }
-		bool EnablePoll( ValueID _valueId, uint8 _intensity = 1 );
+		bool EnablePoll( ValueID _valueId, uint8 _intensity = 1, int32 _interval = 0 );
 		bool DisablePoll( ValueID _valueId );
 		bool isPolled( ValueID _valueId );
 		void SetPollIntensity( ValueID _valueId, uint8 _intensity );
 		static void PollThreadEntryPoint( Event* _exitEvent, void* _context );
 		void PollThreadProc( Event* _exitEvent );
+		int32 GetPollPeriod( Value const* _value );
+		void PollValue( ValueID const& _valueId );
 
 		Thread*					m_pollThread;								// Thread for polling devices on the Z-Wave network
 		struct PollEntry
 		{
 			ValueID	m_id;
-			uint8	m_pollCounter;
+			uint64	m_due;										// Monotonic time in ms at which the value is next to be polled
+			uint64	m_polled;									// Monotonic time in ms at which the value was last polled
+			bool	m_queued;									// The poll request is on the poll queue, so m_polled is updated when it is sent
+			uint8	m_backoff;									// Adaptive polling stretches the poll period by 2^m_backoff
+			uint8	m_selfReports;								// Polls skipped since the backoff last changed, because the device reported by itself
+		};
+		struct PollEntryLater
+		{
+			bool operator()( PollEntry const& _a, PollEntry const& _b )const{ return _a.m_due > _b.m_due; }
 		};
-		list<PollEntry>			m_pollList;									// List of nodes that need to be polled
+		bool SkipPoll( PollEntry& _entry, Value const* _value, uint64 const _now );
+		void StampPolls( uint8 const _nodeId, bool const _sent );
+
+		vector<PollEntry>		m_pollList;									// Min-heap of values that need to be polled, soonest due first
 		Mutex*					m_pollMutex;								// Serialize access to the polling list
-		int32					m_pollInterval;								// Time interval during which all nodes must be polled
-		bool					m_bIntervalBetweenPolls;					// if true, the library intersperses m_pollInterval between polls; if false, the library attempts to complete all polls within m_pollInterval
+		Event*					m_pollEvent;								// Signalled when the polling list changes
+		int32					m_pollInterval;								// Default time between polls of a value (multiplied by its poll intensity)
+		bool					m_bIntervalBetweenPolls;					// if true, the library also waits m_pollInterval after each node is polled, to limit the polling traffic
+		bool					m_bAdaptivePolling;							// if true, polls are skipped or spread out for values that the device reports unprompted
 
 	//-----------------------------------------------------------------------------
 	//	Retrieving Node information
@@ -510,6 +556,7 @@ namespace OpenZWave
 		void SetNodeOff( uint8 const _nodeId );
 
 		Value* GetValue( ValueID const& _id );
+		Value* BorrowValue( ValueID const& _id );			// Like GetValue, but without adding a reference.  Only valid while the nodes are locked.
 
 		bool IsAPICallSupported( uint8 const _apinum )const{ return (( m_apiMask[( _apinum - 1 ) >> 3] & ( 1 << (( _apinum - 1 ) & 0x07 ))) != 0 ); }
 		void SetAPICall( uint8 const _apinum, bool _toSet )
@@ -524,6 +571,7 @@ namespace OpenZWave
 			}
 		}
 		uint8 NodeFromMessage( uint8 const* buffer );
+		uint8 CommandClassFromMessage( uint8 const* buffer );
 
 	//-----------------------------------------------------------------------------
 	// Controller commands
@@ -675,6 +723,17 @@ namespace OpenZWave
 		void AddAssociation( uint8 const _nodeId, uint8 const _groupIdx, uint8 const _targetNodeId );
 		void RemoveAssociation( uint8 const _nodeId, uint8 const _groupIdx, uint8 const _targetNodeId );
 
+	//-----------------------------------------------------------------------------
+	//	Value log
+	//-----------------------------------------------------------------------------
+	private:
+		ValueLog* GetValueLog()const{ return m_valueLog; }					// NULL unless the options ask for readings to be logged
+		void CreateValueLog();												// Open the value log, once the home ID is known
+		static void ValueLogTimerCallback( void* _context );				// Periodically writes out the value log, on the driver thread
+
+		ValueLog*				m_valueLog;
+		TimerWheel::Timer		m_valueLogTimer;
+
 	//-----------------------------------------------------------------------------
 	//	Notifications
 	//-----------------------------------------------------------------------------
@@ -711,6 +770,10 @@ namespace OpenZWave
 			uint32 m_routedbusy;			// Number of messages received with routed busy status
 			uint32 m_broadcastReadCnt;		// Number of broadcasts read
 			uint32 m_broadcastWriteCnt;		// Number of broadcasts sent
+			uint32 m_pollsSent;			// Number of values polled
+			uint32 m_pollsSaved;			// Number of polls skipped because the device had recently reported the value by itself
+			uint32 m_verifyReads;			// Number of extra reads made to check reported changes in values
+			uint32 m_changesFiltered;		// Number of reported changes dropped by a value's deadband or minimum interval
 		};
 
 		void LogDriverStatistics();
@@ -718,27 +781,53 @@ namespace OpenZWave
 	private:
 		void GetDriverStatistics( DriverData* _data );
 		void GetNodeStatistics( uint8 const _nodeId, Node::NodeData* _data );
+		bool GetNodeLinkStatistics( uint8 const _nodeId, LinkStatistics::Window const _window, LinkStatistics::Data* _data );
+		uint32 GetAllNodeInfo( uint32 const _sinceGeneration, vector<Node::NodeInfo>* _nodes );
+		void GetValues( vector<ValueID> const& _ids, Node::ValueResults* _results );
+		bool GetNodeValueSnapshot( uint8 const _nodeId, Node::ValueSnapshot* _snapshot );
+
+		void RegisterMetrics();
+		void UnregisterMetrics();
+		static void CollectMetrics( void* _context );						// Bring the gauges up to date before the metrics are exported
 
-		uint32 m_SOFCnt;			// Number of SOF bytes received
-		uint32 m_ACKWaiting;			// Number of unsolcited messages while waiting for an ACK
-		uint32 m_readAborts;			// Number of times read were aborted due to timeouts
-		uint32 m_badChecksum;			// Number of bad checksums
-		uint32 m_readCnt;			// Number of messages successfully read
-		uint32 m_writeCnt;			// Number of messages successfully sent
-		uint32 m_CANCnt;			// Number of CAN bytes received
-		uint32 m_NAKCnt;			// Number of NAK bytes received
-		uint32 m_ACKCnt;			// Number of ACK bytes received
-		uint32 m_OOFCnt;			// Number of bytes out of framing
-		uint32 m_dropped;			// Number of messages dropped & not delivered
-		uint32 m_retries;			// Number of retransmitted messages
-		uint32 m_callbacks;			// Number of unexpected callbacks
-		uint32 m_badroutes;			// Number of failed messages due to bad route response
-		uint32 m_noack;				// Number of no ACK returned errors
-		uint32 m_netbusy;			// Number of network busy/failure messages
-		uint32 m_nondelivery;			// Number of messages not delivered to network
-		uint32 m_routedbusy;			// Number of messages received with routed busy status
-		uint32 m_broadcastReadCnt;		// Number of broadcasts read
-		uint32 m_broadcastWriteCnt;		// Number of broadcasts sent
+		struct CounterInfo
+		{
+			Metrics::Counter Driver::*	m_counter;
+			char const*			m_name;
+			char const*			m_help;
+		};
+		static CounterInfo const s_counterInfo[];
+
+		Metrics::Counter m_SOFCnt;			// Number of SOF bytes received
+		Metrics::Counter m_ACKWaiting;			// Number of unsolcited messages while waiting for an ACK
+		Metrics::Counter m_readAborts;			// Number of times read were aborted due to timeouts
+		Metrics::Counter m_badChecksum;			// Number of bad checksums
+		Metrics::Counter m_readCnt;			// Number of messages successfully read
+		Metrics::Counter m_writeCnt;			// Number of messages successfully sent
+		Metrics::Counter m_CANCnt;			// Number of CAN bytes received
+		Metrics::Counter m_NAKCnt;			// Number of NAK bytes received
+		Metrics::Counter m_ACKCnt;			// Number of ACK bytes received
+		Metrics::Counter m_OOFCnt;			// Number of bytes out of framing
+		Metrics::Counter m_dropped;			// Number of messages dropped & not delivered
+		Metrics::Counter m_retries;			// Number of retransmitted messages
+		Metrics::Counter m_callbacks;			// Number of unexpected callbacks
+		Metrics::Counter m_badroutes;			// Number of failed messages due to bad route response
+		Metrics::Counter m_noack;				// Number of no ACK returned errors
+		Metrics::Counter m_netbusy;			// Number of network busy/failure messages
+		Metrics::Counter m_nondelivery;			// Number of messages not delivered to network
+		Metrics::Counter m_routedbusy;			// Number of messages received with routed busy status
+		Metrics::Counter m_broadcastReadCnt;		// Number of broadcasts read
+		Metrics::Counter m_broadcastWriteCnt;		// Number of broadcasts sent
+		Metrics::Counter m_pollsSent;			// Number of values polled
+		Metrics::Counter m_pollsSaved;			// Number of polls skipped because the device had recently reported the value by itself
+		Metrics::Counter m_verifyReads;			// Number of extra reads made to check reported changes in values
+		Metrics::Counter m_changesFiltered;		// Number of reported changes dropped by a value's deadband or minimum interval
+		Metrics::Histogram m_queueWaitTime;			// Time messages spend in the send queues
+		Metrics::Histogram m_callbackLatency;			// Time from sending a message to receiving its callback from the controller
+		Metrics::Histogram m_notificationDispatchTime;		// Time taken by the watchers to handle each notification
+		Metrics::Histogram m_pollLag;				// How late values are polled, compared to when they were due
+		Metrics::Gauge m_queueLength[MsgQueue_Count];		// Number of items in each send queue
+		Metrics::Gauge m_pollListLength;			// Number of values being polled
 		//time_t m_commandStart;	// Start time of last command
 		//time_t m_timeoutLost;		// Cumulative time lost to timeouts
 	};
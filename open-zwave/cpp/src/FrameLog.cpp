@@ -0,0 +1,179 @@
+//-----------------------------------------------------------------------------
+//
+//	FrameLog.cpp
+//
+//	Machine-readable record of the frames exchanged with the controller
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include "Defs.h"
+#include "FrameLog.h"
+#include "LogWriter.h"
+#include "TimeStamp.h"
+
+using namespace OpenZWave;
+
+LogWriter* FrameLog::s_writer = NULL;
+
+static char const* c_eventNames[] =
+{
+	"send",
+	"ack",
+	"nak",
+	"can",
+	"complete",
+	"timeout",
+	"drop",
+	"recv"
+};
+
+//-----------------------------------------------------------------------------
+// <FrameLog::Record::Record>
+// Constructor
+//-----------------------------------------------------------------------------
+FrameLog::Record::Record
+(
+	Event const _event,
+	uint32 const _homeId
+):
+	m_event( _event ),
+	m_homeId( _homeId ),
+	m_nodeId( 0 ),
+	m_callbackId( 0 ),
+	m_functionId( 0 ),
+	m_commandClassId( 0 ),
+	m_queue( NULL ),
+	m_attempt( 0 ),
+	m_length( 0 ),
+	m_rtt( -1 ),
+	m_total( -1 )
+{
+}
+
+//-----------------------------------------------------------------------------
+// <FrameLog::Create>
+// Start writing the frame log
+//-----------------------------------------------------------------------------
+void FrameLog::Create
+(
+	string const& _filename,
+	bool const _bAppend,
+	int32 const _flushInterval
+)
+{
+	if( s_writer == NULL )
+	{
+		s_writer = new LogWriter( _filename, _bAppend, _flushInterval );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <FrameLog::Destroy>
+// Stop writing the frame log
+//-----------------------------------------------------------------------------
+void FrameLog::Destroy
+(
+)
+{
+	delete s_writer;
+	s_writer = NULL;
+}
+
+//-----------------------------------------------------------------------------
+// <FrameLog::SetRotation>
+// Set when the frame log should be rotated
+//-----------------------------------------------------------------------------
+void FrameLog::SetRotation
+(
+	uint32 const _maxFileSize,
+	uint32 const _rotateInterval,
+	uint32 const _retainedFiles,
+	bool const _bCompress
+)
+{
+	if( s_writer != NULL )
+	{
+		s_writer->SetRotation( _maxFileSize, _rotateInterval, _retainedFiles, _bCompress );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <FrameLog::Write>
+// Add a record to the frame log as a line of JSON
+//-----------------------------------------------------------------------------
+void FrameLog::Write
+(
+	Record const& _record
+)
+{
+	if( s_writer == NULL )
+	{
+		return;
+	}
+
+	char line[256];
+	int len = snprintf( line, sizeof(line), "{\"t\":%lld,\"home\":%u,\"ev\":\"%s\"",
+		(long long)TimeStamp::GetWallClockTime(), _record.m_homeId, c_eventNames[_record.m_event] );
+
+	// Only the fields that apply are written.  The line cannot overflow,
+	// since every field has a bounded length.
+	if( _record.m_nodeId )
+	{
+		len += snprintf( line+len, sizeof(line)-len, ",\"node\":%d", _record.m_nodeId );
+	}
+	if( _record.m_callbackId )
+	{
+		len += snprintf( line+len, sizeof(line)-len, ",\"cb\":%d", _record.m_callbackId );
+	}
+	if( _record.m_functionId )
+	{
+		len += snprintf( line+len, sizeof(line)-len, ",\"func\":%d", _record.m_functionId );
+	}
+	if( _record.m_commandClassId )
+	{
+		len += snprintf( line+len, sizeof(line)-len, ",\"cc\":%d", _record.m_commandClassId );
+	}
+	if( _record.m_queue )
+	{
+		len += snprintf( line+len, sizeof(line)-len, ",\"queue\":\"%s\"", _record.m_queue );
+	}
+	if( _record.m_attempt )
+	{
+		len += snprintf( line+len, sizeof(line)-len, ",\"attempt\":%d", _record.m_attempt );
+	}
+	if( _record.m_length )
+	{
+		len += snprintf( line+len, sizeof(line)-len, ",\"len\":%u", _record.m_length );
+	}
+	if( _record.m_rtt >= 0 )
+	{
+		len += snprintf( line+len, sizeof(line)-len, ",\"rtt\":%d", _record.m_rtt );
+	}
+	if( _record.m_total >= 0 )
+	{
+		len += snprintf( line+len, sizeof(line)-len, ",\"total\":%d", _record.m_total );
+	}
+	snprintf( line+len, sizeof(line)-len, "}\n" );
+
+	s_writer->Write( line );
+}
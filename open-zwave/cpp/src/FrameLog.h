@@ -0,0 +1,136 @@
+//-----------------------------------------------------------------------------
+//
+//	FrameLog.h
+//
+//	Machine-readable record of the frames exchanged with the controller
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _FrameLog_H
+#define _FrameLog_H
+
+#include <string>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class LogWriter;
+
+	/** \brief Writes one compact record for each frame sent to or received from a controller.
+	 *
+	 * The text log is meant to be read by people.  The frame log is meant to be
+	 * read by programs, for example to measure how long nodes take to respond.
+	 * Each line of the file is a JSON object, such as
+	 *
+	 * {"t":1349449000123,"home":21824168,"ev":"complete","node":5,"cb":10,"func":19,"cc":37,"queue":"Send","attempt":1,"rtt":41,"total":41}
+	 *
+	 * The fields are:
+	 * - t: wall-clock time in milliseconds since 1970.
+	 * - home: Home ID of the controller.
+	 * - ev: what happened.  "send" (a frame was written to the controller), "ack", "nak"
+	 *   and "can" (the controller's response to it), "complete" (the expected callback or
+	 *   reply arrived, ending the transaction), "timeout" (no response in time, so the
+	 *   frame will be resent), "drop" (given up after too many attempts) or "recv" (a
+	 *   frame arrived from the controller).
+	 * - node: the node the frame is for or from.
+	 * - cb: the callback ID of the frame being sent.
+	 * - func: the Serial API function ID.
+	 * - cc: the command class carried by the frame.
+	 * - queue: the send queue the message came from.
+	 * - attempt: which attempt at sending the message this was.
+	 * - len: length of a received frame in bytes.
+	 * - rtt: milliseconds since this attempt was sent.
+	 * - total: milliseconds since the first attempt was sent.
+	 *
+	 * Fields that do not apply, or are not known, are left out.
+	 */
+	class FrameLog
+	{
+	public:
+		enum Event
+		{
+			Event_Send = 0,
+			Event_Ack,
+			Event_Nak,
+			Event_Can,
+			Event_Complete,
+			Event_Timeout,
+			Event_Drop,
+			Event_Receive
+		};
+
+		/** \brief The contents of one line of the frame log.
+		 */
+		struct Record
+		{
+			Record( Event const _event, uint32 const _homeId );
+
+			Event		m_event;
+			uint32		m_homeId;
+			uint8		m_nodeId;
+			uint8		m_callbackId;
+			uint8		m_functionId;
+			uint8		m_commandClassId;
+			char const*	m_queue;			/**< Name of the send queue, or NULL */
+			uint8		m_attempt;
+			uint32		m_length;
+			int32		m_rtt;				/**< Milliseconds, or -1 */
+			int32		m_total;			/**< Milliseconds, or -1 */
+		};
+
+		/**
+		 * Start writing the frame log.
+		 * \param _filename name of the file to write.
+		 * \param _bAppend if true, records are added to the end of any existing file.
+		 * \param _flushInterval milliseconds for which records may be held in memory before being written.
+		 */
+		static void Create( string const& _filename, bool const _bAppend, int32 const _flushInterval );
+
+		/**
+		 * Stop writing the frame log, and close the file.
+		 */
+		static void Destroy();
+
+		/**
+		 * Rotate the frame log once it reaches a certain size or age.
+		 * See Log::SetLogRotation for the meaning of the parameters.
+		 */
+		static void SetRotation( uint32 const _maxFileSize, uint32 const _rotateInterval, uint32 const _retainedFiles, bool const _bCompress );
+
+		/**
+		 * Test whether the frame log is being written, so that the caller can
+		 * avoid filling in records that would be thrown away.
+		 */
+		static bool IsEnabled(){ return( s_writer != NULL ); }
+
+		/**
+		 * Add a record to the frame log.
+		 */
+		static void Write( Record const& _record );
+
+	private:
+		static LogWriter*	s_writer;
+	};
+
+} // namespace OpenZWave
+
+#endif //_FrameLog_H
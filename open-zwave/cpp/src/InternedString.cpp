@@ -0,0 +1,145 @@
+//-----------------------------------------------------------------------------
+//
+//	InternedString.cpp
+//
+//	Shared copies of strings that many objects hold the same text in
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include "Defs.h"
+#include "InternedString.h"
+#include "Mutex.h"
+
+using namespace OpenZWave;
+
+// The table is never freed, since values may still be destroyed while the process exits
+InternedString::Table* InternedString::s_table = new InternedString::Table();
+Mutex* InternedString::s_mutex = new Mutex();
+string const InternedString::s_empty;
+
+//-----------------------------------------------------------------------------
+// <InternedString::operator =>
+// Share the text of another string
+//-----------------------------------------------------------------------------
+InternedString& InternedString::operator =
+(
+	InternedString const& _other
+)
+{
+	// Add the new reference first, in case it is to the entry already held
+	Entry* entry = AddRef( _other.m_entry );
+	Release( m_entry );
+	m_entry = entry;
+	return *this;
+}
+
+//-----------------------------------------------------------------------------
+// <InternedString::operator =>
+// Change the text
+//-----------------------------------------------------------------------------
+InternedString& InternedString::operator =
+(
+	string const& _str
+)
+{
+	// Labels are often set to the text they already have, so avoid the table in that case
+	if( Get() != _str )
+	{
+		Entry* entry = Intern( _str );
+		Release( m_entry );
+		m_entry = entry;
+	}
+	return *this;
+}
+
+//-----------------------------------------------------------------------------
+// <InternedString::GetCount>
+// Get the number of distinct strings in the table
+//-----------------------------------------------------------------------------
+uint32 InternedString::GetCount
+(
+)
+{
+	s_mutex->Lock();
+	uint32 count = (uint32)s_table->size();
+	s_mutex->Unlock();
+	return count;
+}
+
+//-----------------------------------------------------------------------------
+// <InternedString::Intern>
+// Find the entry for a text, adding it to the table if it is new
+//-----------------------------------------------------------------------------
+InternedString::Entry* InternedString::Intern
+(
+	string const& _str
+)
+{
+	if( _str.empty() )
+	{
+		return NULL;
+	}
+
+	s_mutex->Lock();
+	Table::iterator it = s_table->insert( Entry( _str, 0 ) ).first;
+	++it->second;
+	s_mutex->Unlock();
+	return &*it;
+}
+
+//-----------------------------------------------------------------------------
+// <InternedString::AddRef>
+// Add a reference to an entry
+//-----------------------------------------------------------------------------
+InternedString::Entry* InternedString::AddRef
+(
+	Entry* _entry
+)
+{
+	if( _entry != NULL )
+	{
+		s_mutex->Lock();
+		++_entry->second;
+		s_mutex->Unlock();
+	}
+	return _entry;
+}
+
+//-----------------------------------------------------------------------------
+// <InternedString::Release>
+// Remove a reference to an entry, and free it if it was the last
+//-----------------------------------------------------------------------------
+void InternedString::Release
+(
+	Entry* _entry
+)
+{
+	if( _entry != NULL )
+	{
+		s_mutex->Lock();
+		if( --_entry->second == 0 )
+		{
+			s_table->erase( s_table->find( _entry->first ) );
+		}
+		s_mutex->Unlock();
+	}
+}
@@ -0,0 +1,90 @@
+//-----------------------------------------------------------------------------
+//
+//	InternedString.h
+//
+//	Shared copies of strings that many objects hold the same text in
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _InternedString_H
+#define _InternedString_H
+
+#include <string>
+#include <map>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class Mutex;
+
+	/** \brief A string whose text is shared with every other InternedString
+	 * holding the same text.
+	 *
+	 * Values and nodes carry labels, units and descriptions that are mostly the
+	 * same from one node to the next ("Level", "Power", "kWh").  Each distinct text
+	 * is stored once, in a table shared by the whole library, and an InternedString
+	 * is just a pointer to its entry, so it is far smaller than a string and
+	 * copying it allocates nothing.  Entries are reference counted, and are freed
+	 * when the last InternedString using them goes away.
+	 *
+	 * The text of an InternedString cannot be changed in place; assigning a new
+	 * text looks it up in the table.  InternedStrings may be used on any thread.
+	 */
+	class InternedString
+	{
+	public:
+		InternedString(): m_entry( NULL ){}
+		InternedString( string const& _str ): m_entry( Intern( _str ) ){}
+		InternedString( InternedString const& _other ): m_entry( AddRef( _other.m_entry ) ){}
+		~InternedString(){ Release( m_entry ); }
+
+		InternedString& operator = ( InternedString const& _other );
+		InternedString& operator = ( string const& _str );
+
+		string const& Get()const{ return( m_entry ? m_entry->first : s_empty ); }
+		operator string const& ()const{ return Get(); }
+		char const* c_str()const{ return Get().c_str(); }
+		bool empty()const{ return( m_entry == NULL ); }
+
+		/**
+		 * Get the number of distinct strings in the table.
+		 */
+		static uint32 GetCount();
+
+	private:
+		typedef map<string,uint32> Table;			// Each text, and the number of InternedStrings holding it
+		typedef Table::value_type Entry;
+
+		static Entry* Intern( string const& _str );
+		static Entry* AddRef( Entry* _entry );
+		static void Release( Entry* _entry );
+
+		Entry*				m_entry;				// NULL for the empty string
+
+		static Table*		s_table;
+		static Mutex*		s_mutex;				// Serialises access to the table and the counts in it
+		static string const	s_empty;
+	};
+
+} // namespace OpenZWave
+
+#endif // _InternedString_H
@@ -0,0 +1,226 @@
+//-----------------------------------------------------------------------------
+//
+//	LinkStatistics.cpp
+//
+//	Rolling statistics of the link to a node
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <string.h>
+#include "Defs.h"
+#include "LinkStatistics.h"
+#include "Metrics.h"
+#include "TimeStamp.h"
+
+using namespace OpenZWave;
+
+// Number of buckets in each window
+static uint32 const c_windowBuckets[LinkStatistics::Window_Count] =
+{
+	2,
+	30,
+	120
+};
+
+// Round trip times up to 8ms share the first bucket of the metrics histogram that they fall in
+static uint32 const c_firstRttBucket = 5;
+
+//-----------------------------------------------------------------------------
+// <LinkStatistics::LinkStatistics>
+// Constructor
+//-----------------------------------------------------------------------------
+LinkStatistics::LinkStatistics
+(
+)
+{
+	memset( m_buckets, 0, sizeof(m_buckets) );
+}
+
+//-----------------------------------------------------------------------------
+// <LinkStatistics::RecordDelivered>
+// Record a transmission that was delivered
+//-----------------------------------------------------------------------------
+void LinkStatistics::RecordDelivered
+(
+	uint32 const _rtt
+)
+{
+	Bucket* bucket = GetCurrentBucket();
+	uint32 rttBucket = Metrics::Histogram::GetBucket( _rtt );
+	rttBucket = ( rttBucket < c_firstRttBucket ) ? 0 : rttBucket - c_firstRttBucket;
+	if( rttBucket >= RttBucketCount )
+	{
+		rttBucket = RttBucketCount - 1;
+	}
+
+	if( bucket->m_delivered < 0xffff )
+	{
+		++bucket->m_delivered;
+		++bucket->m_rtt[rttBucket];
+	}
+	uint16 rtt = ( _rtt < 0xffff ) ? (uint16)_rtt : 0xffff;
+	if( rtt > bucket->m_rttMax )
+	{
+		bucket->m_rttMax = rtt;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <LinkStatistics::RecordFailed>
+// Record a transmission that the controller could not deliver
+//-----------------------------------------------------------------------------
+void LinkStatistics::RecordFailed
+(
+)
+{
+	Bucket* bucket = GetCurrentBucket();
+	if( bucket->m_failed < 0xffff )
+	{
+		++bucket->m_failed;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <LinkStatistics::RecordRetry>
+// Record a message being sent again
+//-----------------------------------------------------------------------------
+void LinkStatistics::RecordRetry
+(
+)
+{
+	Bucket* bucket = GetCurrentBucket();
+	if( bucket->m_retries < 0xffff )
+	{
+		++bucket->m_retries;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <LinkStatistics::GetData>
+// Get the statistics for one of the windows
+//-----------------------------------------------------------------------------
+void LinkStatistics::GetData
+(
+	Window const _window,
+	Data* _data
+)const
+{
+	uint32 now = (uint32)( TimeStamp::GetMonotonicTime() / BucketDuration );
+	uint32 failed = 0;
+	uint32 rttMax = 0;
+	uint32 rtt[RttBucketCount];
+	memset( rtt, 0, sizeof(rtt) );
+	memset( _data, 0, sizeof(Data) );
+
+	for( uint32 i=0; i<BucketCount; ++i )
+	{
+		// Skip buckets that were last used before the window began
+		Bucket const& bucket = m_buckets[i];
+		if( ( now - bucket.m_index ) >= c_windowBuckets[_window] )
+		{
+			continue;
+		}
+
+		_data->m_delivered += bucket.m_delivered;
+		_data->m_retries += bucket.m_retries;
+		failed += bucket.m_failed;
+		if( bucket.m_rttMax > rttMax )
+		{
+			rttMax = bucket.m_rttMax;
+		}
+		for( uint32 j=0; j<RttBucketCount; ++j )
+		{
+			rtt[j] += bucket.m_rtt[j];
+		}
+	}
+
+	_data->m_sent = _data->m_delivered + failed;
+	_data->m_successRate = ( _data->m_sent == 0 ) ? 100 : ( _data->m_delivered * 100 ) / _data->m_sent;
+	_data->m_retryRate = ( _data->m_sent == 0 ) ? 0 : ( _data->m_retries * 100 ) / _data->m_sent;
+	_data->m_rttMedian = GetPercentile( rtt, _data->m_delivered, rttMax, 50 );
+	_data->m_rtt90 = GetPercentile( rtt, _data->m_delivered, rttMax, 90 );
+	_data->m_rtt99 = GetPercentile( rtt, _data->m_delivered, rttMax, 99 );
+}
+
+//-----------------------------------------------------------------------------
+// <LinkStatistics::GetCurrentBucket>
+// Get the bucket for the current time, emptying it if it was last used an hour ago
+//-----------------------------------------------------------------------------
+LinkStatistics::Bucket* LinkStatistics::GetCurrentBucket
+(
+)
+{
+	uint32 now = (uint32)( TimeStamp::GetMonotonicTime() / BucketDuration );
+	Bucket* bucket = &m_buckets[now % BucketCount];
+	if( bucket->m_index != now )
+	{
+		memset( bucket, 0, sizeof(Bucket) );
+		bucket->m_index = now;
+	}
+	return bucket;
+}
+
+//-----------------------------------------------------------------------------
+// <LinkStatistics::GetRttLimit>
+// Get the longest round trip time that falls in a bucket
+//-----------------------------------------------------------------------------
+uint32 LinkStatistics::GetRttLimit
+(
+	uint32 const _rttBucket
+)
+{
+	return Metrics::Histogram::GetBucketLimit( _rttBucket + c_firstRttBucket );
+}
+
+//-----------------------------------------------------------------------------
+// <LinkStatistics::GetPercentile>
+// Estimate a percentile of the round trip times, from the bucket it falls in
+//-----------------------------------------------------------------------------
+uint32 LinkStatistics::GetPercentile
+(
+	uint32 const* _rtt,
+	uint32 const _count,
+	uint32 const _max,
+	uint32 const _percent
+)
+{
+	if( _count == 0 )
+	{
+		return 0;
+	}
+
+	// Report the top of the bucket, since the times within it are not known,
+	// but never more than the slowest time that was actually seen.
+	uint32 rank = ( _count * _percent + 99 ) / 100;
+	uint32 count = 0;
+	for( uint32 i=0; i<RttBucketCount-1; ++i )
+	{
+		count += _rtt[i];
+		if( count >= rank )
+		{
+			uint32 limit = GetRttLimit( i );
+			return( ( limit < _max ) ? limit : _max );
+		}
+	}
+	return _max;
+}
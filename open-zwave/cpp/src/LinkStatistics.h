@@ -0,0 +1,123 @@
+//-----------------------------------------------------------------------------
+//
+//	LinkStatistics.h
+//
+//	Rolling statistics of the link to a node
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#ifndef _LinkStatistics_H
+#define _LinkStatistics_H
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief Statistics of the messages sent to a node over the last minute,
+	 * quarter of an hour and hour.
+	 *
+	 * The outcome of each transmission is added to a ring of buckets, each
+	 * covering BucketDuration milliseconds, so the memory used is fixed no
+	 * matter how busy the node is.  Round trip times are kept as a coarse
+	 * histogram in each bucket, so their percentiles can be estimated for
+	 * any of the windows.
+	 *
+	 * A node's statistics are only accessed with the driver's nodes locked,
+	 * so no locking is done here.
+	 */
+	class LinkStatistics
+	{
+	public:
+		enum Window
+		{
+			Window_1Minute = 0,
+			Window_15Minutes,
+			Window_1Hour,
+			Window_Count
+		};
+
+		struct Data
+		{
+			uint32 m_sent;					// Transmissions whose outcome was reported by the controller
+			uint32 m_delivered;				// Transmissions delivered to the node
+			uint32 m_retries;				// Messages sent again after a failure or timeout
+			uint32 m_successRate;			// Percentage of transmissions delivered, or 100 if there were none
+			uint32 m_retryRate;				// Retries as a percentage of transmissions
+			uint32 m_rttMedian;				// Round trip times, in ms, that half, nine tenths and
+			uint32 m_rtt90;					// ninety nine hundredths of the delivered transmissions
+			uint32 m_rtt99;					// were faster than, or zero if none were delivered
+		};
+
+		LinkStatistics();
+
+		/**
+		 * Record a transmission that was delivered.
+		 * \param _rtt milliseconds from sending the message to the controller reporting its delivery.
+		 */
+		void RecordDelivered( uint32 const _rtt );
+
+		/**
+		 * Record a transmission that the controller could not deliver.
+		 */
+		void RecordFailed();
+
+		/**
+		 * Record a message being sent again.
+		 */
+		void RecordRetry();
+
+		/**
+		 * Get the statistics for one of the windows.
+		 * \param _window the window, ending now.
+		 * \param _data structure to fill in.
+		 */
+		void GetData( Window const _window, Data* _data )const;
+
+	private:
+		enum
+		{
+			BucketDuration	= 30000,		// Milliseconds covered by each bucket
+			BucketCount		= 120,			// Enough buckets for the longest window
+			RttBucketCount	= 20			// Round trip times are kept to within half an octave, from 8ms up to 4s
+		};
+
+		struct Bucket
+		{
+			uint32	m_index;				// Time of the bucket, in units of BucketDuration
+			uint16	m_delivered;
+			uint16	m_failed;
+			uint16	m_retries;
+			uint16	m_rttMax;
+			uint16	m_rtt[RttBucketCount];
+		};
+
+		Bucket* GetCurrentBucket();
+		static uint32 GetRttLimit( uint32 const _rttBucket );
+		static uint32 GetPercentile( uint32 const* _rtt, uint32 const _count, uint32 const _max, uint32 const _percent );
+
+		Bucket	m_buckets[BucketCount];
+	};
+
+} // namespace OpenZWave
+
+#endif // _LinkStatistics_H
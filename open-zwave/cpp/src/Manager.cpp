@@ -40,6 +40,9 @@
 #include "Mutex.h"
 #include "Event.h"
 #include "Log.h"
+#include "FrameLog.h"
+#include "Metrics.h"
+#include "Trace.h"
 
 #include "CommandClasses.h"
 #include "CommandClass.h"
@@ -55,6 +58,7 @@
 #include "ValueSchedule.h"
 #include "ValueShort.h"
 #include "ValueString.h"
+#include "ValueHistory.h"
 
 using namespace OpenZWave;
 
@@ -85,6 +89,7 @@ Manager* Manager::Create
 	// Options have not been created and locked.
 	Log::Create( "", false, true, LogLevel_Debug, LogLevel_Debug, LogLevel_Debug );
 	Log::Write( LogLevel_Error, "Options have not been created and locked. Exiting..." );
+	Log::Destroy();
 	exit(1);
 	return NULL;
 }
@@ -142,9 +147,47 @@ Manager::Manager
 	int nDumpTrigger = (int) LogLevel_Warning;
 	Options::Get()->GetOptionAsInt( "DumpTriggerLevel", &nDumpTrigger );
 
+	int nFlushInterval = 500;
+	Options::Get()->GetOptionAsInt( "LogFlushInterval", &nFlushInterval );
+
+	int nMaxFileSize = 0;
+	Options::Get()->GetOptionAsInt( "LogMaxFileSize", &nMaxFileSize );
+
+	int nRotateInterval = 0;
+	Options::Get()->GetOptionAsInt( "LogRotateInterval", &nRotateInterval );
+
+	int nRetainedFiles = 5;
+	Options::Get()->GetOptionAsInt( "LogRetainedFiles", &nRetainedFiles );
+
+	bool bCompressRotated = false;
+	Options::Get()->GetOptionAsBool( "LogCompressRotated", &bCompressRotated );
+
+	uint32 maxFileSize = nMaxFileSize > 0 ? ( (uint32)nMaxFileSize ) * 1024 : 0;
+	uint32 rotateInterval = nRotateInterval > 0 ? ( (uint32)nRotateInterval ) * 60000 : 0;
+	uint32 retainedFiles = nRetainedFiles > 0 ? (uint32)nRetainedFiles : 0;
+
 	string logFilename = userPath + logFileNameBase;
-	Log::Create( logFilename, bAppend, bConsoleOutput, (LogLevel) nSaveLogLevel, (LogLevel) nQueueLogLevel, (LogLevel) nDumpTrigger );
+	Log::Create( logFilename, bAppend, bConsoleOutput, (LogLevel) nSaveLogLevel, (LogLevel) nQueueLogLevel, (LogLevel) nDumpTrigger, nFlushInterval );
 	Log::SetLoggingState( logging );
+	Log::SetLogRotation( maxFileSize, rotateInterval, retainedFiles, bCompressRotated );
+
+	string frameLogFileName = "";
+	Options::Get()->GetOptionAsString( "FrameLogFileName", &frameLogFileName );
+	if( !frameLogFileName.empty() )
+	{
+		FrameLog::Create( userPath + frameLogFileName, bAppend, nFlushInterval );
+		FrameLog::SetRotation( maxFileSize, rotateInterval, retainedFiles, bCompressRotated );
+	}
+
+	string traceFileName = "";
+	Options::Get()->GetOptionAsString( "TraceFileName", &traceFileName );
+	if( !traceFileName.empty() )
+	{
+		Trace::Create( userPath + traceFileName, nFlushInterval );
+	}
+
+	Metrics::Create();
+	ValueHistory::Create();
 
 	CommandClasses::RegisterCommandClasses();
 	Scene::ReadScenes();
@@ -193,6 +236,10 @@ Manager::~Manager
 		Node::s_genericDeviceClasses.erase( git );
 	}
 
+	ValueHistory::Destroy();
+	Metrics::Destroy();
+	Trace::Destroy();
+	FrameLog::Destroy();
 	Log::Destroy();
 }
 
@@ -557,12 +604,13 @@ void Manager::SetPollInterval
 bool Manager::EnablePoll
 ( 
 	ValueID const _valueId,
-	uint8 const _intensity
+	uint8 const _intensity,
+	int32 const _interval
 )
 {
 	if( Driver* driver = GetDriver( _valueId.GetHomeId() ) )
 	{
-		return( driver->EnablePoll( _valueId, _intensity ) );
+		return( driver->EnablePoll( _valueId, _intensity, _interval ) );
 	}
 
 	Log::Write( LogLevel_Info, "mgr,     EnablePoll failed - Driver with Home ID 0x%.8x is not available", _valueId.GetHomeId() );
@@ -1153,6 +1201,7 @@ void Manager::SetNodeOn
 	uint8 const _nodeId
 )
 {
+	Trace::Mark( Trace::GetCurrent(), "SetNodeOn" );
 	if( Driver* driver = GetDriver( _homeId ) )
 	{
 		driver->SetNodeOn( _nodeId );
@@ -1169,6 +1218,7 @@ void Manager::SetNodeOff
 	uint8 const _nodeId
 )
 {
+	Trace::Mark( Trace::GetCurrent(), "SetNodeOff" );
 	if( Driver* driver = GetDriver( _homeId ) )
 	{
 		driver->SetNodeOff( _nodeId );
@@ -1308,6 +1358,7 @@ void Manager::SetNodeLevel
 	uint8 const _level
 )
 {
+	Trace::Mark( Trace::GetCurrent(), "SetNodeLevel" );
 	if( Driver* driver = GetDriver( _homeId ) )
 	{
 		return driver->SetNodeLevel( _nodeId, _level );
@@ -1331,10 +1382,9 @@ string Manager::GetValueLabel
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			label = value->GetLabel();
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
@@ -1355,10 +1405,9 @@ void Manager::SetValueLabel
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			value->SetLabel( _value );
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
@@ -1377,10 +1426,9 @@ string Manager::GetValueUnits
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			units = value->GetUnits();
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
@@ -1401,10 +1449,9 @@ void Manager::SetValueUnits
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			value->SetUnits( _value );
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
@@ -1423,10 +1470,9 @@ string Manager::GetValueHelp
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			help = value->GetHelp();
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
@@ -1447,10 +1493,9 @@ void Manager::SetValueHelp
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			value->SetHelp( _value );
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
@@ -1469,10 +1514,9 @@ int32 Manager::GetValueMin
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			limit = value->GetMin();
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
@@ -1493,10 +1537,9 @@ int32 Manager::GetValueMax
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			limit = value->GetMax();
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
@@ -1517,10 +1560,9 @@ bool Manager::IsValueReadOnly
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			res = value->IsReadOnly();
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
@@ -1541,10 +1583,9 @@ bool Manager::IsValueWriteOnly
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			res = value->IsWriteOnly();
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
@@ -1565,10 +1606,9 @@ bool Manager::IsValueSet
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			res = value->IsSet();
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
@@ -1589,10 +1629,9 @@ bool Manager::IsValuePolled
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			res = value->IsPolled();
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
@@ -1619,10 +1658,9 @@ bool Manager::GetValueAsBool
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
 				driver->LockNodes();
-				if( ValueBool* value = static_cast<ValueBool*>( driver->GetValue( _id ) ) )
+				if( ValueBool* value = static_cast<ValueBool*>( driver->BorrowValue( _id ) ) )
 				{
 					*o_value = value->GetValue();
-					value->Release();
 					res = true;
 				}
 				driver->ReleaseNodes();
@@ -1633,10 +1671,9 @@ bool Manager::GetValueAsBool
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
 			    	driver->LockNodes();
-				if( ValueButton* value = static_cast<ValueButton*>( driver->GetValue( _id ) ) )
+				if( ValueButton* value = static_cast<ValueButton*>( driver->BorrowValue( _id ) ) )
 				{
 					*o_value = value->IsPressed();
-					value->Release();
 					res = true;
 				}
 				driver->ReleaseNodes();
@@ -1666,10 +1703,9 @@ bool Manager::GetValueAsByte
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
 				driver->LockNodes();
-				if( ValueByte* value = static_cast<ValueByte*>( driver->GetValue( _id ) ) )
+				if( ValueByte* value = static_cast<ValueByte*>( driver->BorrowValue( _id ) ) )
 				{
 					*o_value = value->GetValue();
-					value->Release();
 					res = true;
 				}
 				driver->ReleaseNodes();
@@ -1699,11 +1735,9 @@ bool Manager::GetValueAsFloat
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
 				driver->LockNodes();
-				if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->GetValue( _id ) ) )
+				if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->BorrowValue( _id ) ) )
 				{
-					string str = value->GetValue();
-					*o_value = (float)atof( str.c_str() );
-					value->Release();
+					*o_value = value->GetAsFloat();
 					res = true;
 				}
 				driver->ReleaseNodes();
@@ -1733,10 +1767,9 @@ bool Manager::GetValueAsInt
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
 				driver->LockNodes();
-				if( ValueInt* value = static_cast<ValueInt*>( driver->GetValue( _id ) ) )
+				if( ValueInt* value = static_cast<ValueInt*>( driver->BorrowValue( _id ) ) )
 				{
 					*o_value = value->GetValue();
-					value->Release();
 					res = true;
 				}
 				driver->ReleaseNodes();
@@ -1766,10 +1799,9 @@ bool Manager::GetValueAsShort
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
 				driver->LockNodes();
-				if( ValueShort* value = static_cast<ValueShort*>( driver->GetValue( _id ) ) )
+				if( ValueShort* value = static_cast<ValueShort*>( driver->BorrowValue( _id ) ) )
 				{
 					*o_value = value->GetValue();
-					value->Release();
 					res = true;
 				}
 				driver->ReleaseNodes();
@@ -1803,84 +1835,76 @@ bool Manager::GetValueAsString
 			{
 				case ValueID::ValueType_Bool:
 				{
-					if( ValueBool* value = static_cast<ValueBool*>( driver->GetValue( _id ) ) )
+					if( ValueBool* value = static_cast<ValueBool*>( driver->BorrowValue( _id ) ) )
 					{
 						*o_value = value->GetValue() ? "True" : "False";
-						value->Release();
 						res = true;
 					}
 					break;
 				}
 				case ValueID::ValueType_Byte:
 				{
-					if( ValueByte* value = static_cast<ValueByte*>( driver->GetValue( _id ) ) )
+					if( ValueByte* value = static_cast<ValueByte*>( driver->BorrowValue( _id ) ) )
 					{
 						snprintf( str, sizeof(str), "%u", value->GetValue() );
 						*o_value = str;
-						value->Release();
 						res = true;
 					}
 					break;
 				}
 				case ValueID::ValueType_Decimal:
 				{
-					if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->GetValue( _id ) ) )
+					if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->BorrowValue( _id ) ) )
 					{
 						*o_value = value->GetValue();
-						value->Release();
 						res = true;
 					}
 					break;
 				}
 				case ValueID::ValueType_Int:
 				{
-					if( ValueInt* value = static_cast<ValueInt*>( driver->GetValue( _id ) ) )
+					if( ValueInt* value = static_cast<ValueInt*>( driver->BorrowValue( _id ) ) )
 					{
 						snprintf( str, sizeof(str), "%d", value->GetValue() );
 						*o_value = str;
-						value->Release();
 						res = true;
 					}
 					break;
 				}
 				case ValueID::ValueType_List:
 				{
-					if( ValueList* value = static_cast<ValueList*>( driver->GetValue( _id ) ) )
+					if( ValueList* value = static_cast<ValueList*>( driver->BorrowValue( _id ) ) )
 					{
 						ValueList::Item const& item = value->GetItem();
 						*o_value = item.m_label;
-						value->Release();
 						res = true;
 					}
 					break;
 				}
 				case ValueID::ValueType_Short:
 				{
-					if( ValueShort* value = static_cast<ValueShort*>( driver->GetValue( _id ) ) )
+					if( ValueShort* value = static_cast<ValueShort*>( driver->BorrowValue( _id ) ) )
 					{
 						snprintf( str, sizeof(str), "%d", value->GetValue() );
 						*o_value = str;
-						value->Release();
 						res = true;
 					}
 					break;
 				}
 				case ValueID::ValueType_String:
 				{
-					if( ValueString* value = static_cast<ValueString*>( driver->GetValue( _id ) ) )
+					if( ValueString* value = static_cast<ValueString*>( driver->BorrowValue( _id ) ) )
 					{
 						*o_value = value->GetValue();
-						value->Release();
 						res = true;
 					}
 					break;
 				}
 				case ValueID::ValueType_Button:
 				{
-					if( ValueButton* value = static_cast<ValueButton*>( driver->GetValue( _id ) ) )
+					if( ValueButton* value = static_cast<ValueButton*>( driver->BorrowValue( _id ) ) )
 					{
 						*o_value = value->IsPressed() ? "True" : "False";
-						value->Release();
 						res = true;
 					}
 					break;
@@ -1918,7 +1942,7 @@ bool Manager::GetValueListSelection
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
 				driver->LockNodes();
-				if( ValueList* value = static_cast<ValueList*>( driver->GetValue( _id ) ) )
+				if( ValueList* value = static_cast<ValueList*>( driver->BorrowValue( _id ) ) )
 				{
 					ValueList::Item const& item = value->GetItem();
 					if( &item != NULL )
@@ -1926,7 +1950,6 @@ bool Manager::GetValueListSelection
 						*o_value = item.m_label;
 						res = true;
 					}
-					value->Release();
 				}
 				driver->ReleaseNodes();
 			}
@@ -1955,11 +1978,10 @@ bool Manager::GetValueListSelection
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
 				driver->LockNodes();
-				if( ValueList* value = static_cast<ValueList*>( driver->GetValue( _id ) ) )
+				if( ValueList* value = static_cast<ValueList*>( driver->BorrowValue( _id ) ) )
 				{
 					ValueList::Item const& item = value->GetItem();
 					*o_value = item.m_value;
-					value->Release();
 					res = true;
 				}
 				driver->ReleaseNodes();
@@ -1989,10 +2011,9 @@ bool Manager::GetValueListItems
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
 				driver->LockNodes();
-				if( ValueList* value = static_cast<ValueList*>( driver->GetValue( _id ) ) )
+				if( ValueList* value = static_cast<ValueList*>( driver->BorrowValue( _id ) ) )
 				{
 					res = value->GetItemLabels( o_value );
-					value->Release();
 				}
 				driver->ReleaseNodes();
 			}
@@ -2021,10 +2042,9 @@ bool Manager::GetValueFloatPrecision
 			if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 			{
 				driver->LockNodes();
-				if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->GetValue( _id ) ) )
+				if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->BorrowValue( _id ) ) )
 				{
 					*o_value = value->GetPrecision();
-					value->Release();
 					res = true;
 				}
 				driver->ReleaseNodes();
@@ -2052,10 +2072,9 @@ bool Manager::SetValue
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueBool* value = static_cast<ValueBool*>( driver->GetValue( _id ) ) )
+			if( ValueBool* value = static_cast<ValueBool*>( driver->BorrowValue( _id ) ) )
 			{
 				res = value->Set( _value );
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -2081,10 +2100,9 @@ bool Manager::SetValue
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueByte* value = static_cast<ValueByte*>( driver->GetValue( _id ) ) )
+			if( ValueByte* value = static_cast<ValueByte*>( driver->BorrowValue( _id ) ) )
 			{
 				res = value->Set( _value );
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -2110,30 +2128,14 @@ bool Manager::SetValue
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->GetValue( _id ) ) )
+			if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->BorrowValue( _id ) ) )
 			{
-				char str[256];
-				snprintf( str, sizeof(str), "%f", _value );
-
-				// remove trailing zeros (and the decimal point, if present)
-				// TODO: better way of figuring out which locale is being used ('.' or ',' to separate decimals)
-				int nLen;
-				if( ( strchr( str, '.' ) != NULL) || (strchr( str, ',' ) != NULL ) )
+				// Convert straight to fixed point, so the locale's decimal point doesn't matter
+				ValueDecimal::Fixed fixed;
+				if( ValueDecimal::FromFloat( _value, &fixed ) )
 				{
-					for( nLen = strlen( str ) - 1; nLen > 0; nLen-- )
-					{
-						if( str[nLen] == '0' ) 
-							str[nLen] = 0;
-						else
-							break;
-					}
-					if( (str[nLen] == '.') || (str[nLen] == ',') )
-						str[nLen] = 0;
+					res = value->Set( fixed );
 				}
-
-				// now set the value
-				res = value->Set( str );
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -2159,10 +2161,9 @@ bool Manager::SetValue
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueInt* value = static_cast<ValueInt*>( driver->GetValue( _id ) ) )
+			if( ValueInt* value = static_cast<ValueInt*>( driver->BorrowValue( _id ) ) )
 			{
 				res = value->Set( _value );
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -2188,10 +2189,9 @@ bool Manager::SetValue
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueShort* value = static_cast<ValueShort*>( driver->GetValue( _id ) ) )
+			if( ValueShort* value = static_cast<ValueShort*>( driver->BorrowValue( _id ) ) )
 			{
 				res = value->Set( _value );
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -2217,10 +2217,9 @@ bool Manager::SetValueListSelection
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueList* value = static_cast<ValueList*>( driver->GetValue( _id ) ) )
+			if( ValueList* value = static_cast<ValueList*>( driver->BorrowValue( _id ) ) )
 			{
 				res = value->SetByLabel( _selectedItem );
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -2249,7 +2248,7 @@ bool Manager::SetValue
 		{
 			case ValueID::ValueType_Bool:
 			{
-				if( ValueBool* value = static_cast<ValueBool*>( driver->GetValue( _id ) ) )
+				if( ValueBool* value = static_cast<ValueBool*>( driver->BorrowValue( _id ) ) )
 				{
 					if( !strcasecmp( "true", _value.c_str() ) )
 					{
@@ -2259,70 +2258,63 @@ bool Manager::SetValue
 					{
 						res = value->Set( false );
 					}
-					value->Release();
 				}
 				break;
 			}
 			case ValueID::ValueType_Byte:
 			{
-				if( ValueByte* value = static_cast<ValueByte*>( driver->GetValue( _id ) ) )
+				if( ValueByte* value = static_cast<ValueByte*>( driver->BorrowValue( _id ) ) )
 				{
 					uint32 val = (uint32)atoi( _value.c_str() );
 					if( val < 256 )
 					{
 						res = value->Set( (uint8)val );
 					}
-					value->Release();
 				}
 				break;
 			}
 			case ValueID::ValueType_Decimal:
 			{
-				if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->GetValue( _id ) ) )
+				if( ValueDecimal* value = static_cast<ValueDecimal*>( driver->BorrowValue( _id ) ) )
 				{
 					res = value->Set( _value );
-					value->Release();
 				}
 				break;
 			}
 			case ValueID::ValueType_Int:
 			{
-				if( ValueInt* value = static_cast<ValueInt*>( driver->GetValue( _id ) ) )
+				if( ValueInt* value = static_cast<ValueInt*>( driver->BorrowValue( _id ) ) )
 				{
 					int32 val = atoi( _value.c_str() );
 					res = value->Set( val );
-					value->Release();
 				}
 				break;
 			}
 			case ValueID::ValueType_List:
 			{
-				if( ValueList* value = static_cast<ValueList*>( driver->GetValue( _id ) ) )
+				if( ValueList* value = static_cast<ValueList*>( driver->BorrowValue( _id ) ) )
 				{
 					res = value->SetByLabel( _value );
-					value->Release();
 				}
 				break;
 			}
 			case ValueID::ValueType_Short:
 			{
-				if( ValueShort* value = static_cast<ValueShort*>( driver->GetValue( _id ) ) )
+				if( ValueShort* value = static_cast<ValueShort*>( driver->BorrowValue( _id ) ) )
 				{
 					int32 val = (uint32)atoi( _value.c_str() );
 					if( ( val < 32768 ) && ( val >= -32768 ) )
 					{
 						res = value->Set( (int16)val );
 					}
-					value->Release();
 				}
 				break;
 			}
 			case ValueID::ValueType_String:
 			{
-				if( ValueString* value = static_cast<ValueString*>( driver->GetValue( _id ) ) )
+				if( ValueString* value = static_cast<ValueString*>( driver->BorrowValue( _id ) ) )
 				{
 					res = value->Set( _value );
-					value->Release();
 				}
 				break;
 			}
@@ -2384,15 +2376,210 @@ void Manager::SetChangeVerified
 	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 	{
 		driver->LockNodes();
-		if( Value* value = driver->GetValue( _id ) )
+		if( Value* value = driver->BorrowValue( _id ) )
 		{
 			value->SetChangeVerified( _verify );
-			value->Release();
 		}
 		driver->ReleaseNodes();
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Manager::SetValueChangeFilter>
+// Set which reported changes in a value are dropped
+//-----------------------------------------------------------------------------
+bool Manager::SetValueChangeFilter
+(
+	ValueID const& _id,
+	double const _deadband,
+	int32 const _minInterval
+)
+{
+	bool res = false;
+
+	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
+	{
+		driver->LockNodes();
+		if( Value* value = driver->BorrowValue( _id ) )
+		{
+			res = value->SetChangeFilter( _deadband, _minInterval );
+		}
+		driver->ReleaseNodes();
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueChangeFilter>
+// Get which reported changes in a value are dropped
+//-----------------------------------------------------------------------------
+bool Manager::GetValueChangeFilter
+(
+	ValueID const& _id,
+	double* o_deadband,
+	int32* o_minInterval
+)
+{
+	bool res = false;
+
+	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
+	{
+		driver->LockNodes();
+		if( Value* value = driver->BorrowValue( _id ) )
+		{
+			*o_deadband = value->GetChangeDeadband();
+			*o_minInterval = value->GetChangeMinInterval();
+			res = true;
+		}
+		driver->ReleaseNodes();
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetValueHistorySize>
+// Set the number of recent readings kept for a value
+//-----------------------------------------------------------------------------
+bool Manager::SetValueHistorySize
+(
+	ValueID const& _id,
+	uint32 const _samples
+)
+{
+	bool res = false;
+
+	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
+	{
+		driver->LockNodes();
+		if( Value* value = driver->BorrowValue( _id ) )
+		{
+			res = value->SetHistorySize( _samples );
+		}
+		driver->ReleaseNodes();
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueHistory>
+// Get the recent readings of a value from a range of time
+//-----------------------------------------------------------------------------
+bool Manager::GetValueHistory
+(
+	ValueID const& _id,
+	uint64 const _from,
+	uint64 const _to,
+	vector<ValueHistory::Sample>* o_samples
+)
+{
+	bool res = false;
+
+	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
+	{
+		driver->LockNodes();
+		if( Value* value = driver->BorrowValue( _id ) )
+		{
+			if( ValueHistory const* history = value->GetHistory() )
+			{
+				history->GetSamples( _from, _to, o_samples );
+				res = true;
+			}
+		}
+		driver->ReleaseNodes();
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueHistorySummary>
+// Summarize the recent readings of a value from a range of time
+//-----------------------------------------------------------------------------
+bool Manager::GetValueHistorySummary
+(
+	ValueID const& _id,
+	uint64 const _from,
+	uint64 const _to,
+	ValueHistory::Summary* o_summary
+)
+{
+	bool res = false;
+
+	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
+	{
+		driver->LockNodes();
+		if( Value* value = driver->BorrowValue( _id ) )
+		{
+			if( ValueHistory const* history = value->GetHistory() )
+			{
+				res = history->GetSummary( _from, _to, o_summary );
+			}
+		}
+		driver->ReleaseNodes();
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValueHistoryDownsampled>
+// Summarize the recent readings of a value in each interval of a range of time
+//-----------------------------------------------------------------------------
+bool Manager::GetValueHistoryDownsampled
+(
+	ValueID const& _id,
+	uint64 const _from,
+	uint64 const _to,
+	uint32 const _interval,
+	vector<ValueHistory::Summary>* o_summaries
+)
+{
+	bool res = false;
+
+	if( Driver* driver = GetDriver( _id.GetHomeId() ) )
+	{
+		driver->LockNodes();
+		if( Value* value = driver->BorrowValue( _id ) )
+		{
+			if( ValueHistory const* history = value->GetHistory() )
+			{
+				history->GetDownsampled( _from, _to, _interval, o_summaries );
+				res = true;
+			}
+		}
+		driver->ReleaseNodes();
+	}
+
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::ReadValueLog>
+// Read the logged readings of a network from a range of time
+//-----------------------------------------------------------------------------
+bool Manager::ReadValueLog
+(
+	uint32 const _homeId,
+	int64 const _from,
+	int64 const _to,
+	ValueLog::pfnReadingCallback_t _callback,
+	void* _context
+)
+{
+	if( Driver* driver = GetDriver( _homeId ) )
+	{
+		if( ValueLog* valueLog = driver->GetValueLog() )
+		{
+			return valueLog->Scan( _from, _to, _callback, _context );
+		}
+	}
+
+	return false;
+}
+
 //-----------------------------------------------------------------------------
 // <Manager::PressButton>
 // Starts an activity in a device.
@@ -2409,10 +2596,9 @@ bool Manager::PressButton
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueButton* value = static_cast<ValueButton*>( driver->GetValue( _id ) ) )
+			if( ValueButton* value = static_cast<ValueButton*>( driver->BorrowValue( _id ) ) )
 			{
 				res = value->PressButton();
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -2437,10 +2623,9 @@ bool Manager::ReleaseButton
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueButton* value = static_cast<ValueButton*>( driver->GetValue( _id ) ) )
+			if( ValueButton* value = static_cast<ValueButton*>( driver->BorrowValue( _id ) ) )
 			{
 				res = value->ReleaseButton();
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -2470,10 +2655,9 @@ uint8 Manager::GetNumSwitchPoints
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueSchedule* value = static_cast<ValueSchedule*>( driver->GetValue( _id ) ) )
+			if( ValueSchedule* value = static_cast<ValueSchedule*>( driver->BorrowValue( _id ) ) )
 			{
 				numSwitchPoints = value->GetNumSwitchPoints();
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -2501,10 +2685,9 @@ bool Manager::SetSwitchPoint
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueSchedule* value = static_cast<ValueSchedule*>( driver->GetValue( _id ) ) )
+			if( ValueSchedule* value = static_cast<ValueSchedule*>( driver->BorrowValue( _id ) ) )
 			{
 				res = value->SetSwitchPoint( _hours, _minutes, _setback );
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -2531,7 +2714,7 @@ bool Manager::RemoveSwitchPoint
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueSchedule* value = static_cast<ValueSchedule*>( driver->GetValue( _id ) ) )
+			if( ValueSchedule* value = static_cast<ValueSchedule*>( driver->BorrowValue( _id ) ) )
 			{
 				uint8 idx;
 				res = value->FindSwitchPoint( _hours, _minutes, &idx );
@@ -2540,7 +2723,6 @@ bool Manager::RemoveSwitchPoint
 				{
 					res = value->RemoveSwitchPoint( idx );
 				}
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -2563,10 +2745,9 @@ void Manager::ClearSwitchPoints
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueSchedule* value = static_cast<ValueSchedule*>( driver->GetValue( _id ) ) )
+			if( ValueSchedule* value = static_cast<ValueSchedule*>( driver->BorrowValue( _id ) ) )
 			{
 				value->ClearSwitchPoints();
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -2593,10 +2774,9 @@ bool Manager::GetSwitchPoint
 		if( Driver* driver = GetDriver( _id.GetHomeId() ) )
 		{
 			driver->LockNodes();
-			if( ValueSchedule* value = static_cast<ValueSchedule*>( driver->GetValue( _id ) ) )
+			if( ValueSchedule* value = static_cast<ValueSchedule*>( driver->BorrowValue( _id ) ) )
 			{
 				res = value->GetSwitchPoint( _idx, o_hours, o_minutes, o_setback );
-				value->Release();
 			}
 			driver->ReleaseNodes();
 		}
@@ -3742,3 +3922,124 @@ void Manager::GetNodeStatistics
 	}
 
 }
+
+//-----------------------------------------------------------------------------
+// <Manager::GetNodeLinkStatistics>
+// Retrieve the statistics of the messages recently sent to a node
+//-----------------------------------------------------------------------------
+bool Manager::GetNodeLinkStatistics
+(
+	uint32 const _homeId,
+	uint8 const _nodeId,
+	LinkStatistics::Window const _window,
+	LinkStatistics::Data* _data
+)
+{
+	if( Driver* driver = GetDriver( _homeId ) )
+	{
+		return driver->GetNodeLinkStatistics( _nodeId, _window, _data );
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetAllNodeInfo>
+// Retrieve the description and user values of every node that has changed
+//-----------------------------------------------------------------------------
+uint32 Manager::GetAllNodeInfo
+(
+	uint32 const _homeId,
+	uint32 const _sinceGeneration,
+	vector<Node::NodeInfo>* _nodes
+)
+{
+	if( Driver* driver = GetDriver( _homeId ) )
+	{
+		return driver->GetAllNodeInfo( _sinceGeneration, _nodes );
+	}
+
+	return _sinceGeneration;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetValues>
+// Read many values with one locking of the nodes of each driver
+//-----------------------------------------------------------------------------
+void Manager::GetValues
+(
+	vector<ValueID> const& _ids,
+	Node::ValueResults* _results
+)
+{
+	_results->Resize( _ids.size() );
+
+	// Each driver reads the values that belong to it
+	vector<uint32> homeIds;
+	for( vector<ValueID>::const_iterator it = _ids.begin(); it != _ids.end(); ++it )
+	{
+		uint32 homeId = it->GetHomeId();
+		if( find( homeIds.begin(), homeIds.end(), homeId ) == homeIds.end() )
+		{
+			homeIds.push_back( homeId );
+			if( Driver* driver = GetDriver( homeId ) )
+			{
+				driver->GetValues( _ids, _results );
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetNodeValueSnapshot>
+// Read every value of a node, if any have changed
+//-----------------------------------------------------------------------------
+bool Manager::GetNodeValueSnapshot
+(
+	uint32 const _homeId,
+	uint8 const _nodeId,
+	Node::ValueSnapshot* _snapshot
+)
+{
+	if( Driver* driver = GetDriver( _homeId ) )
+	{
+		return driver->GetNodeValueSnapshot( _nodeId, _snapshot );
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::GetMetrics>
+// Retrieve the statistics of every driver and node as text
+//-----------------------------------------------------------------------------
+string Manager::GetMetrics
+(
+)
+{
+	return Metrics::Export();
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::BeginTrace>
+// Start tracing the commands made by the calling thread
+//-----------------------------------------------------------------------------
+uint32 Manager::BeginTrace
+(
+	string const& _name
+)
+{
+	return Trace::Begin( _name );
+}
+
+//-----------------------------------------------------------------------------
+// <Manager::SetCurrentTrace>
+// Choose the trace that commands made by the calling thread belong to
+//-----------------------------------------------------------------------------
+void Manager::SetCurrentTrace
+(
+	uint32 const _traceId
+)
+{
+	Trace::SetCurrent( _traceId );
+}
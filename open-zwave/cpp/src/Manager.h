@@ -38,6 +38,8 @@
 #include "Defs.h"
 #include "Driver.h"
 #include "ValueID.h"
+#include "ValueHistory.h"
+#include "ValueLog.h"
 
 namespace OpenZWave
 {
@@ -330,22 +332,27 @@ namespace OpenZWave
 		/**
 		 * \brief Set the time period between polls of a node's state.
 		 * Due to patent concerns, some devices do not report state changes automatically to the controller.
-		 * These devices need to have their state polled at regular intervals.  The length of the interval
-		 * is the same for all devices.  To even out the Z-Wave network traffic generated by polling, OpenZWave
-		 * divides the polling interval by the number of devices that have polling enabled, and polls each
-		 * in turn.  It is recommended that if possible, the interval should not be set shorter than the
-		 * number of polled devices in seconds (so that the network does not have to cope with more than one
-		 * poll per second).
-		 * \param _seconds The length of the polling interval in seconds.
+		 * These devices need to have their state polled at regular intervals.  This interval is used for
+		 * every polled value that was not given an interval of its own in EnablePoll.  Values that fall due
+		 * at the same time are polled together, one node at a time, and each poll waits for the library to
+		 * finish sending any other messages first.
+		 * \param _milliseconds The length of the polling interval in milliseconds.
+		 * \param _bIntervalBetweenPolls If true, the library also waits for the polling interval after
+		 * polling each node, to limit the amount of network traffic generated by polling.
 		 */
 		void SetPollInterval( int32 _milliseconds, bool _bIntervalBetweenPolls );
 
 		/**
 		 * \brief Enable the polling of a device's state.
 		 * \param _valueId The ID of the value to start polling.
+		 * \param _intensity Multiplies the poll interval when no _interval is given (1=every interval, 2=every other interval, etc).
+		 * \param _interval The time between polls of this value in milliseconds, or zero to use the
+		 * poll interval set by SetPollInterval.  Each value is polled on its own schedule, so for example
+		 * meters can be polled every 30 seconds and switches every 10 minutes.  The setting is saved
+		 * in the zwcfg file along with the rest of the value.
 		 * \return True if polling was enabled.
 		 */
-		bool EnablePoll( ValueID const _valueId, uint8 const _intensity = 1 );
+		bool EnablePoll( ValueID const _valueId, uint8 const _intensity = 1, int32 const _interval = 0 );
 
 		/**
 		 * \brief Disable the polling of a device's state.
@@ -362,7 +369,7 @@ namespace OpenZWave
 		bool isPolled( ValueID const _valueId );
 
 		/**
-		 * \brief Set the frequency of polling (0=none, 1=every time through the list, 2-every other time, etc)
+		 * \brief Set the frequency of polling (0=none, 1=every poll interval, 2=every other interval, etc)
 		 * \param _valueId The ID of the value whose intensity should be set
 		 */
 		void SetPollIntensity( ValueID const _valueId, uint8 const _intensity );
@@ -1035,12 +1042,105 @@ namespace OpenZWave
 		/**
 		 * \brief Sets a flag indicating whether value changes noted upon a refresh should be verified.  If so, the
 		 * library will immediately refresh the value a second time whenever a change is observed.  This helps to filter
-		 * out spurious data reported occasionally by some devices.
+		 * out spurious data reported occasionally by some devices.  The number of reads, the tolerance between them and
+		 * the size of change that is believed without checking are set per command class in the device configuration
+		 * (see CommandClass::VerifyPolicy).
 		 * \param _id The unique identifier of the value whose changes should or should not be verified.
 		 * \param _verify if true, verify changes; if false, don't verify changes.
 		 */
 		void SetChangeVerified( ValueID const& _id, bool _verify );
 
+		/**
+		 * \brief Sets which reported changes in a value are dropped before any notification is sent, so that
+		 * small fluctuations in sensor and meter readings don't flood the watchers.  A dropped change leaves the
+		 * value as it was, so a slow drift is notified once it has moved further than the deadband in all, and a change
+		 * dropped for coming too soon is picked up by the next report after the interval.  Dropped readings are
+		 * still added to the value's history and the value log.  The filter is saved in the network configuration file.
+		 * \param _id The unique identifier of the value.
+		 * Only byte, short, int and decimal values can be filtered.  Changes in bool, list and string values are
+		 * states rather than quantities, so they are always passed on.
+		 * \param _deadband Changes no larger than this are dropped.  Zero keeps every change.
+		 * \param _minInterval Changes reported less than this many milliseconds after the last notified change are dropped.  Zero keeps every change.
+		 * \return true if the filter was set.  Returns false if the value was not found, if either setting is negative,
+		 * or if a filter was given for a value that is not a number.
+		 * \see GetValueChangeFilter
+		 */
+		bool SetValueChangeFilter( ValueID const& _id, double const _deadband, int32 const _minInterval );
+
+		/**
+		 * \brief Gets the deadband and minimum interval set by SetValueChangeFilter.
+		 * \param _id The unique identifier of the value.
+		 * \param o_deadband Filled with the deadband, or zero if there is none.
+		 * \param o_minInterval Filled with the minimum interval in milliseconds, or zero if there is none.
+		 * \return true if the value was found.
+		 * \see SetValueChangeFilter
+		 */
+		bool GetValueChangeFilter( ValueID const& _id, double* o_deadband, int32* o_minInterval );
+
+		/**
+		 * \brief Sets the number of recent readings kept for a numeric value, so
+		 * that trends can be drawn without storing every report.  The ValueHistorySize
+		 * option sets the number kept for every value that isn't given its own.
+		 * \param _id The unique identifier of the value.
+		 * \param _samples Number of readings to keep, or zero to stop keeping them.
+		 * \return true if the size was changed.  Returns false if the value is not a
+		 * number, or if keeping that many readings would take more than the
+		 * ValueHistoryMaxSamples option allows for all values together.
+		 * \see GetValueHistory, GetValueHistorySummary, GetValueHistoryDownsampled
+		 */
+		bool SetValueHistorySize( ValueID const& _id, uint32 const _samples );
+
+		/**
+		 * \brief Gets the recent readings of a value from a range of time.
+		 * Times are in milliseconds on the monotonic clock, as returned by TimeStamp::GetMonotonicTime.
+		 * \param _id The unique identifier of the value.
+		 * \param _from The start of the range.
+		 * \param _to The end of the range, which is not included.
+		 * \param o_samples Vector to which the readings are added, oldest first.
+		 * \return true if readings of the value are being kept.
+		 * \see SetValueHistorySize
+		 */
+		bool GetValueHistory( ValueID const& _id, uint64 const _from, uint64 const _to, vector<ValueHistory::Sample>* o_samples );
+
+		/**
+		 * \brief Gets the minimum, maximum and average of the recent readings of a value from a range of time.
+		 * \param _id The unique identifier of the value.
+		 * \param _from The start of the range.
+		 * \param _to The end of the range, which is not included.
+		 * \param o_summary Filled with the summary of the readings.
+		 * \return true if there are any readings in the range.
+		 * \see SetValueHistorySize
+		 */
+		bool GetValueHistorySummary( ValueID const& _id, uint64 const _from, uint64 const _to, ValueHistory::Summary* o_summary );
+
+		/**
+		 * \brief Divides a range of time into intervals, and summarizes the recent
+		 * readings of a value in each, for drawing a graph with one point per interval.
+		 * \param _id The unique identifier of the value.
+		 * \param _from The start of the range.
+		 * \param _to The end of the range, which is not included.
+		 * \param _interval Length of each interval, in milliseconds.
+		 * \param o_summaries Vector to which a summary of each interval that has any readings is added, oldest first.
+		 * \return true if readings of the value are being kept.
+		 * \see SetValueHistorySize
+		 */
+		bool GetValueHistoryDownsampled( ValueID const& _id, uint64 const _from, uint64 const _to, uint32 const _interval, vector<ValueHistory::Summary>* o_summaries );
+
+		/**
+		 * \brief Reads the readings of a network that have been saved to its value log,
+		 * which survives restarts.  Only values of the command classes listed in the
+		 * ValueLogCommandClasses option are logged.  Blocks of readings outside the range
+		 * are skipped without being read, so the whole file is not loaded.
+		 * \param _homeId The Home ID of the Z-Wave controller that manages the network.
+		 * \param _from The start of the range, in milliseconds since 1970.
+		 * \param _to The end of the range, which is not included.
+		 * \param _callback Called once for each reading.  No more readings can be logged until the scan finishes, so it should return quickly.
+		 * \param _context Passed to the callback.
+		 * \return true if the log was read.  Returns false if no value log is being kept, or it could not be read.
+		 * \see ValueLog::Read
+		 */
+		bool ReadValueLog( uint32 const _homeId, int64 const _from, int64 const _to, ValueLog::pfnReadingCallback_t _callback, void* _context );
+
 		/**
 		 * \brief Starts an activity in a device.
 		 * Since buttons are write-only values that do not report a state, no notification callbacks are sent.
@@ -1823,6 +1923,86 @@ namespace OpenZWave
 		 */
 		void GetNodeStatistics( uint32 const _homeId, uint8 const _nodeId, Node::NodeData* _data );
 
+		/**
+		 * \brief Retrieve the delivery rate, retry rate and round trip times
+		 * of the messages recently sent to a node.
+		 * \param _homeId The Home ID of the driver for the node
+		 * \param _nodeId The node number
+		 * \param _window How far back to look: the last minute, 15 minutes or hour
+		 * \param _data Pointer to structure LinkStatistics::Data to return values
+		 * \return true if the node exists
+		 */
+		bool GetNodeLinkStatistics( uint32 const _homeId, uint8 const _nodeId, LinkStatistics::Window const _window, LinkStatistics::Data* _data );
+
+		/**
+		 * \brief Retrieve the description and current user values of every node
+		 * in one call, rather than asking for each field of each node in turn.
+		 * To keep a view of the network up to date, pass the generation returned
+		 * by the previous call, and only the nodes that have changed since then
+		 * (including any that have been removed) are returned.
+		 * \param _homeId The Home ID of the driver for the nodes
+		 * \param _sinceGeneration Only return nodes that have changed since this generation, or zero for every node
+		 * \param _nodes Vector to which a NodeInfo is added for each node
+		 * \return the generation to pass next time
+		 */
+		uint32 GetAllNodeInfo( uint32 const _homeId, uint32 const _sinceGeneration, vector<Node::NodeInfo>* _nodes );
+
+		/**
+		 * \brief Read many values at once.  The nodes are locked only once for
+		 * each driver, rather than once for every value, so this is much cheaper
+		 * than calling GetValueAsInt and the like for each value in turn.
+		 * \param _ids The values to read, which may belong to any driver
+		 * \param _results Filled with one entry per value, in the same order.
+		 * Each value is returned in the vector that matches its type, and
+		 * m_found is false for any value that does not exist.  Decimals are
+		 * returned as fixed-point numbers, so meter totals keep every digit;
+		 * use ValueDecimal::Format or ValueDecimal::ToFloat to convert them.
+		 */
+		void GetValues( vector<ValueID> const& _ids, Node::ValueResults* _results );
+
+		/**
+		 * \brief Read every value of a node at once.  If the snapshot has been
+		 * filled before and none of the node's values have changed since, it is
+		 * left alone without locking the nodes at all, so it is cheap to call
+		 * this for every node each time a dashboard is refreshed.
+		 * \param _homeId The Home ID of the driver for the node
+		 * \param _nodeId The node number
+		 * \param _snapshot The snapshot from the previous call, or a new one
+		 * \return true if the node exists
+		 */
+		bool GetNodeValueSnapshot( uint32 const _homeId, uint8 const _nodeId, Node::ValueSnapshot* _snapshot );
+
+		/**
+		 * \brief Retrieve the statistics of every driver and node, along with
+		 * histograms of queueing, round trip and callback times, poll lag and
+		 * notification dispatch time.
+		 * \return the statistics in the Prometheus text exposition format,
+		 * ready to be served to a monitoring system.
+		 */
+		string GetMetrics();
+
+		/**
+		 * \brief Start tracing a command, to find out how long each stage takes
+		 * from the request to the device's confirmation.
+		 * The trace becomes the current trace of the calling thread, and every message
+		 * sent as a result of the calls that thread makes to the Manager is timed as it
+		 * passes through the queues, the controller and the network.  The trace ends
+		 * when the node reports a value.  Traces are only kept if the TraceFileName
+		 * option is set, and are written to that file in the Chrome trace event format.
+		 * \param _name Description of the command, which is shown in the trace.
+		 * \return The ID of the trace, or zero if tracing is not enabled.
+		 * \see SetCurrentTrace
+		 */
+		uint32 BeginTrace( string const& _name );
+
+		/**
+		 * \brief Choose the trace that later calls from the calling thread belong to.
+		 * \param _traceId A trace ID returned by BeginTrace, or zero to stop tracing
+		 * the thread's calls.
+		 * \see BeginTrace
+		 */
+		void SetCurrentTrace( uint32 const _traceId );
+
 	};
 	/*@}*/
 } // namespace OpenZWave
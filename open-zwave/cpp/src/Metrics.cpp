@@ -0,0 +1,403 @@
+//-----------------------------------------------------------------------------
+//
+//	Metrics.cpp
+//
+//	Counters, gauges and histograms describing the health of the network
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include "Defs.h"
+#include "Metrics.h"
+#include "Mutex.h"
+
+using namespace OpenZWave;
+
+Metrics* Metrics::s_instance = NULL;
+
+static char const* c_typeNames[] =
+{
+	"counter",
+	"gauge",
+	"histogram"
+};
+
+//-----------------------------------------------------------------------------
+// <Metrics::Histogram::Histogram>
+// Constructor
+//-----------------------------------------------------------------------------
+Metrics::Histogram::Histogram
+(
+):
+	Metric( Type_Histogram ),
+	m_sum( 0 )
+{
+	memset( (void*)m_buckets, 0, sizeof(m_buckets) );
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::Histogram::Observe>
+// Record a duration
+//-----------------------------------------------------------------------------
+void Metrics::Histogram::Observe
+(
+	uint32 const _milliseconds
+)
+{
+	Atomic::Add( &m_buckets[GetBucket( _milliseconds )], 1 );
+	Atomic::Add( &m_sum, (uint64)_milliseconds );
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::Histogram::GetBucket>
+// Get the bucket that a duration falls in
+//-----------------------------------------------------------------------------
+uint32 Metrics::Histogram::GetBucket
+(
+	uint32 const _milliseconds
+)
+{
+	// Bucket 2n holds durations up to 3*2^(n-1), and bucket 2n+1 those up to 2^(n+1).
+	// The first two buckets hold 1ms and 2ms.
+	uint32 bucket;
+	if( _milliseconds <= 2 )
+	{
+		bucket = ( _milliseconds == 0 ) ? 0 : _milliseconds - 1;
+	}
+	else if( _milliseconds > GetBucketLimit( BucketCount - 1 ) )
+	{
+		bucket = BucketCount;
+	}
+	else
+	{
+		uint32 bit = 1;
+		while( ( ( _milliseconds - 1 ) >> ( bit + 1 ) ) != 0 )
+		{
+			++bit;
+		}
+		bucket = bit * 2;
+		if( _milliseconds > ( 3u << ( bit - 1 ) ) )
+		{
+			++bucket;
+		}
+	}
+	return bucket;
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::Histogram::GetBucketLimit>
+// Get the longest duration that falls in a bucket
+//-----------------------------------------------------------------------------
+uint32 Metrics::Histogram::GetBucketLimit
+(
+	uint32 const _bucket
+)
+{
+	if( _bucket < 2 )
+	{
+		return( _bucket + 1 );
+	}
+
+	uint32 base = 2u << ( ( _bucket - 2 ) >> 1 );
+	return( ( _bucket & 1 ) ? ( base << 1 ) : ( base + ( base >> 1 ) ) );
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::Metrics>
+// Constructor
+//-----------------------------------------------------------------------------
+Metrics::Metrics
+(
+):
+	m_mutex( new Mutex() ),
+	m_collectorMutex( new Mutex() )
+{
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::~Metrics>
+// Destructor
+//-----------------------------------------------------------------------------
+Metrics::~Metrics
+(
+)
+{
+	m_collectorMutex->Release();
+	m_mutex->Release();
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::Create>
+// Create the registry
+//-----------------------------------------------------------------------------
+void Metrics::Create
+(
+)
+{
+	if( s_instance == NULL )
+	{
+		s_instance = new Metrics();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::Destroy>
+// Destroy the registry
+//-----------------------------------------------------------------------------
+void Metrics::Destroy
+(
+)
+{
+	delete s_instance;
+	s_instance = NULL;
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::Register>
+// Add a metric to the registry
+//-----------------------------------------------------------------------------
+void Metrics::Register
+(
+	Metric* _metric,
+	string const& _name,
+	string const& _help,
+	string const& _labels
+)
+{
+	if( s_instance == NULL )
+	{
+		return;
+	}
+
+	Entry entry;
+	entry.m_metric = _metric;
+	entry.m_name = _name;
+	entry.m_help = _help;
+	entry.m_labels = _labels;
+
+	s_instance->m_mutex->Lock();
+	s_instance->m_entries.push_back( entry );
+	s_instance->m_mutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::Unregister>
+// Remove a metric from the registry
+//-----------------------------------------------------------------------------
+void Metrics::Unregister
+(
+	Metric* _metric
+)
+{
+	if( s_instance == NULL )
+	{
+		return;
+	}
+
+	s_instance->m_mutex->Lock();
+	for( list<Entry>::iterator it = s_instance->m_entries.begin(); it != s_instance->m_entries.end(); ++it )
+	{
+		if( it->m_metric == _metric )
+		{
+			s_instance->m_entries.erase( it );
+			break;
+		}
+	}
+	s_instance->m_mutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::AddCollector>
+// Add a function to be called before the metrics are exported
+//-----------------------------------------------------------------------------
+void Metrics::AddCollector
+(
+	pfnCollector_t _collector,
+	void* _context
+)
+{
+	if( s_instance == NULL )
+	{
+		return;
+	}
+
+	Collector collector;
+	collector.m_callback = _collector;
+	collector.m_context = _context;
+
+	s_instance->m_collectorMutex->Lock();
+	s_instance->m_collectors.push_back( collector );
+	s_instance->m_collectorMutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::RemoveCollector>
+// Remove a collector
+//-----------------------------------------------------------------------------
+void Metrics::RemoveCollector
+(
+	pfnCollector_t _collector,
+	void* _context
+)
+{
+	if( s_instance == NULL )
+	{
+		return;
+	}
+
+	s_instance->m_collectorMutex->Lock();
+	for( list<Collector>::iterator it = s_instance->m_collectors.begin(); it != s_instance->m_collectors.end(); ++it )
+	{
+		if( ( it->m_callback == _collector ) && ( it->m_context == _context ) )
+		{
+			s_instance->m_collectors.erase( it );
+			break;
+		}
+	}
+	s_instance->m_collectorMutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::Label>
+// Build a label, escaping the value as the text format requires
+//-----------------------------------------------------------------------------
+string Metrics::Label
+(
+	char const* _name,
+	string const& _value
+)
+{
+	string label = _name;
+	label += "=\"";
+	for( string::const_iterator it = _value.begin(); it != _value.end(); ++it )
+	{
+		switch( *it )
+		{
+			case '\\':	label += "\\\\";	break;
+			case '"':	label += "\\\"";	break;
+			case '\n':	label += "\\n";		break;
+			default:	label += *it;		break;
+		}
+	}
+	label += "\"";
+	return label;
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::Export>
+// Get every registered metric in the Prometheus text exposition format
+//-----------------------------------------------------------------------------
+string Metrics::Export
+(
+)
+{
+	string text;
+	if( s_instance == NULL )
+	{
+		return text;
+	}
+
+	// The collectors are run under their own lock, since they may need to take
+	// locks that are held elsewhere while metrics are being registered.
+	s_instance->m_collectorMutex->Lock();
+	for( list<Collector>::iterator it = s_instance->m_collectors.begin(); it != s_instance->m_collectors.end(); ++it )
+	{
+		it->m_callback( it->m_context );
+	}
+	s_instance->m_collectorMutex->Unlock();
+
+	s_instance->m_mutex->Lock();
+
+	// Every metric in a family has to be written together, under one header
+	list<Entry> entries = s_instance->m_entries;
+	entries.sort( EntryLess );
+
+	string const* family = NULL;
+	for( list<Entry>::iterator it = entries.begin(); it != entries.end(); ++it )
+	{
+		if( ( family == NULL ) || ( *family != it->m_name ) )
+		{
+			family = &it->m_name;
+			text += "# HELP " + it->m_name + " " + it->m_help + "\n";
+			text += "# TYPE " + it->m_name + " " + c_typeNames[it->m_metric->GetType()] + "\n";
+		}
+		ExportEntry( *it, &text );
+	}
+
+	s_instance->m_mutex->Unlock();
+	return text;
+}
+
+//-----------------------------------------------------------------------------
+// <Metrics::ExportEntry>
+// Add the lines for one metric to the exported text
+//-----------------------------------------------------------------------------
+void Metrics::ExportEntry
+(
+	Entry const& _entry,
+	string* _text
+)
+{
+	char str[128];
+	switch( _entry.m_metric->GetType() )
+	{
+		case Type_Counter:
+		{
+			snprintf( str, sizeof(str), " %u\n", (uint32)*static_cast<Counter*>( _entry.m_metric ) );
+			*_text += _entry.m_name + ( _entry.m_labels.empty() ? "" : "{" + _entry.m_labels + "}" ) + str;
+			break;
+		}
+		case Type_Gauge:
+		{
+			snprintf( str, sizeof(str), " %d\n", static_cast<Gauge*>( _entry.m_metric )->Get() );
+			*_text += _entry.m_name + ( _entry.m_labels.empty() ? "" : "{" + _entry.m_labels + "}" ) + str;
+			break;
+		}
+		case Type_Histogram:
+		{
+			Histogram const* histogram = static_cast<Histogram*>( _entry.m_metric );
+			string prefix = _entry.m_name + "_bucket{" + _entry.m_labels + ( _entry.m_labels.empty() ? "" : "," );
+
+			// Buckets are cumulative in the text format
+			uint32 count = 0;
+			for( uint32 i=0; i<Histogram::BucketCount; ++i )
+			{
+				count += histogram->GetBucketCount( i );
+				uint32 limit = Histogram::GetBucketLimit( i );
+				snprintf( str, sizeof(str), "le=\"%u.%03u\"} %u\n", limit / 1000, limit % 1000, count );
+				*_text += prefix + str;
+			}
+			count += histogram->GetBucketCount( Histogram::BucketCount );
+			snprintf( str, sizeof(str), "le=\"+Inf\"} %u\n", count );
+			*_text += prefix + str;
+
+			string labels = _entry.m_labels.empty() ? "" : "{" + _entry.m_labels + "}";
+			uint64 sum = histogram->GetSum();
+			snprintf( str, sizeof(str), " %llu.%03u\n", (unsigned long long)( sum / 1000 ), (uint32)( sum % 1000 ) );
+			*_text += _entry.m_name + "_sum" + labels + str;
+			snprintf( str, sizeof(str), " %u\n", count );
+			*_text += _entry.m_name + "_count" + labels + str;
+			break;
+		}
+	}
+}
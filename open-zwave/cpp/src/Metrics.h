@@ -0,0 +1,247 @@
+//-----------------------------------------------------------------------------
+//
+//	Metrics.h
+//
+//	Counters, gauges and histograms describing the health of the network
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _Metrics_H
+#define _Metrics_H
+
+#include <string>
+#include <list>
+#include "Defs.h"
+#include "Atomic.h"
+
+namespace OpenZWave
+{
+	class Mutex;
+
+	/** \brief A registry of counters, gauges and histograms that describe the
+	 * health of the library, which can be exported in the Prometheus text format.
+	 *
+	 * Each metric is owned by the object that updates it, usually as a plain
+	 * member, and is registered here only so that it can be exported.  Updates
+	 * are atomic and never take a lock, so they are cheap enough to make on the
+	 * driver thread.  An object must unregister its metrics before they are
+	 * destroyed.
+	 *
+	 * Metrics registered under the same name form a family, and are told apart
+	 * by their labels (for example, the node they describe).
+	 */
+	class Metrics
+	{
+	public:
+		enum Type
+		{
+			Type_Counter = 0,
+			Type_Gauge,
+			Type_Histogram
+		};
+
+		/** \brief Base class of the metric types.
+		 */
+		class Metric
+		{
+		public:
+			Type GetType()const{ return m_type; }
+
+		protected:
+			Metric( Type const _type ): m_type( _type ){}
+
+		private:
+			Metric( Metric const& );					// prevent copy
+			Metric& operator = ( Metric const& );		// prevent assignment
+
+			Type	m_type;
+		};
+
+		/** \brief A count of events, which only ever goes up.
+		 *
+		 * A counter can be used in place of a uint32 member, so existing
+		 * statistics can be exported without changing the code that updates them.
+		 */
+		class Counter: public Metric
+		{
+		public:
+			Counter( uint32 const _value = 0 ): Metric( Type_Counter ), m_value( _value ){}
+
+			void Increment( uint32 const _amount = 1 ){ Atomic::Add( &m_value, _amount ); }
+			uint32 operator ++ (){ return Atomic::Add( &m_value, 1 ); }
+			uint32 operator ++ ( int ){ return Atomic::Add( &m_value, 1 ) - 1; }
+			operator uint32()const{ return Atomic::Load( &m_value ); }
+
+		private:
+			uint32 volatile	m_value;
+		};
+
+		/** \brief A value that can go up and down, such as the length of a queue.
+		 */
+		class Gauge: public Metric
+		{
+		public:
+			Gauge( int32 const _value = 0 ): Metric( Type_Gauge ), m_value( (uint32)_value ){}
+
+			void Set( int32 const _value ){ Atomic::Store( &m_value, (uint32)_value ); }
+			void Add( int32 const _amount ){ Atomic::Add( &m_value, (uint32)_amount ); }
+			int32 Get()const{ return (int32)Atomic::Load( &m_value ); }
+
+		private:
+			uint32 volatile	m_value;
+		};
+
+		/** \brief The distribution of a duration, such as a round trip time.
+		 *
+		 * Durations are recorded in milliseconds, into buckets that grow
+		 * log-linearly (1, 2, 3, 4, 6, 8, 12, 16, 24...) up to a little over a minute,
+		 * so the relative error is the same for short and long durations.
+		 * They are exported in seconds, as Prometheus expects.
+		 */
+		class Histogram: public Metric
+		{
+		public:
+			enum
+			{
+				BucketCount = 32					/**< Number of buckets, not counting the one for longer durations */
+			};
+
+			Histogram();
+
+			/**
+			 * Record a duration.
+			 * \param _milliseconds the duration.
+			 */
+			void Observe( uint32 const _milliseconds );
+
+			/**
+			 * Get the number of durations recorded in a bucket.
+			 * \param _bucket index of the bucket, or BucketCount for durations longer than the last one.
+			 */
+			uint32 GetBucketCount( uint32 const _bucket )const{ return Atomic::Load( &m_buckets[_bucket] ); }
+
+			/**
+			 * Get the total of all the durations recorded, in milliseconds.
+			 */
+			uint64 GetSum()const{ return Atomic::Load( &m_sum ); }
+
+			/**
+			 * Get the bucket that a duration falls in.
+			 * \param _milliseconds the duration.
+			 * \return index of the bucket, or BucketCount if the duration is longer than the last one.
+			 */
+			static uint32 GetBucket( uint32 const _milliseconds );
+
+			/**
+			 * Get the longest duration, in milliseconds, that falls in a bucket.
+			 * \param _bucket index of the bucket, which must be less than BucketCount.
+			 */
+			static uint32 GetBucketLimit( uint32 const _bucket );
+
+		private:
+			uint32 volatile	m_buckets[BucketCount+1];
+			uint64 volatile	m_sum;
+		};
+
+		typedef void (*pfnCollector_t)( void* _context );
+
+		/**
+		 * Create the registry.  Until this is called, registrations are ignored.
+		 */
+		static void Create();
+
+		/**
+		 * Destroy the registry.
+		 */
+		static void Destroy();
+
+		/**
+		 * Add a metric to the registry.
+		 * \param _metric the metric, which must remain valid until it is unregistered.
+		 * \param _name name of the metric's family, such as "ozw_messages_sent_total".
+		 * \param _help one-line description of the family.
+		 * \param _labels labels that identify this metric within the family, built with Label.
+		 */
+		static void Register( Metric* _metric, string const& _name, string const& _help, string const& _labels = "" );
+
+		/**
+		 * Remove a metric from the registry.  Once this returns, the metric
+		 * will not be read again.
+		 */
+		static void Unregister( Metric* _metric );
+
+		/**
+		 * Add a function to be called just before the metrics are exported,
+		 * so that gauges whose values are expensive to track can be brought
+		 * up to date.  Collectors may not register or unregister metrics.
+		 */
+		static void AddCollector( pfnCollector_t _collector, void* _context );
+
+		/**
+		 * Remove a collector.  Once this returns, it will not be called again.
+		 */
+		static void RemoveCollector( pfnCollector_t _collector, void* _context );
+
+		/**
+		 * Build a label for use with Register.  Labels are joined with commas.
+		 * \param _name name of the label, such as "node".
+		 * \param _value value of the label, which is escaped as required.
+		 */
+		static string Label( char const* _name, string const& _value );
+
+		/**
+		 * Get every registered metric in the Prometheus text exposition format.
+		 */
+		static string Export();
+
+	private:
+		Metrics();
+		~Metrics();
+
+		struct Entry
+		{
+			Metric*	m_metric;
+			string	m_name;
+			string	m_help;
+			string	m_labels;
+		};
+
+		struct Collector
+		{
+			pfnCollector_t	m_callback;
+			void*			m_context;
+		};
+
+		static bool EntryLess( Entry const& _a, Entry const& _b ){ return( _a.m_name < _b.m_name ); }
+		static void ExportEntry( Entry const& _entry, string* _text );
+
+		Mutex*				m_mutex;				// Serialises access to the entries
+		list<Entry>			m_entries;
+		Mutex*				m_collectorMutex;		// Serialises access to the collectors, which may take locks of their own
+		list<Collector>		m_collectors;
+
+		static Metrics*		s_instance;
+	};
+
+} // namespace OpenZWave
+
+#endif // _Metrics_H
@@ -63,8 +63,12 @@ Msg::Msg
 	m_maxSendAttempts( MAX_TRIES ),
 	m_instance( 1 ),
 	m_endPoint( 0 ),
-	m_flags( 0 )
+	m_flags( 0 ),
+	m_traceId( Trace::GetCurrent() )
 {
+	memset( m_traceTimes, 0, sizeof(m_traceTimes) );
+	SetTraceTime( Trace::Stage_Created );
+
 	if( _bReplyRequired )
 	{
 		// Wait for this message before considering the transaction complete 
@@ -32,6 +32,7 @@
 #include <string>
 #include <string.h>
 #include "Defs.h"
+#include "Trace.h"
 
 namespace OpenZWave
 {
@@ -68,8 +69,32 @@ namespace OpenZWave
 		void SetSendAttempts( uint8 _count ){ m_sendAttempts = _count; }
 
 		uint8 GetMaxSendAttempts()const{ return m_maxSendAttempts; }
+
+		/**
+		 * Get the trace that the message belongs to.  This is the current trace
+		 * of the thread that created the message.
+		 * \return the trace ID, or zero if the message is not being traced.
+		 */
+		uint32 GetTraceId()const{ return m_traceId; }
+
+		/**
+		 * Record that the message has reached a stage, if it is being traced.
+		 */
+		void SetTraceTime( Trace::Stage const _stage ){ if( m_traceId ) m_traceTimes[_stage] = Trace::GetTime(); }
+
+		/**
+		 * Write the stages of the message to its trace, if it is being traced.
+		 * \param _outcome what happened to the message.
+		 */
+		void WriteTrace( char const* _outcome )const{ if( m_traceId ) Trace::WriteMsg( m_traceId, m_logText, m_traceTimes, m_sendAttempts, _outcome ); }
 		void SetMaxSendAttempts( uint8 _count ){ if( _count < MAX_MAX_TRIES ) m_maxSendAttempts = _count; }
 
+		/** The command class carried by a FUNC_ID_ZW_SEND_DATA message, or zero for other messages */
+		uint8 GetSendingCommandClass()const
+		{
+			return( ( m_bFinal && (m_length>7) && (m_buffer[3]==0x13) ) ? m_buffer[6] : 0 );
+		}
+
 		bool IsWakeUpNoMoreInformationCommand()
 		{
 			return( m_bFinal && (m_length==11) && (m_buffer[3]==0x13) && (m_buffer[6]==0x84) && (m_buffer[7]==0x08) );
@@ -108,6 +133,9 @@ namespace OpenZWave
 		uint8			m_endPoint;			// Endpoint to use if the message must be wrapped in a multiInstance or multiChannel command class
 		uint8			m_flags;
 
+		uint32			m_traceId;
+		uint64			m_traceTimes[Trace::Stage_Count];	// When the message reached each stage, if it is being traced
+
 		static uint8		s_nextCallbackId;		// counter to get a unique callback id
 	};
 
@@ -64,6 +64,7 @@
 #include "ValueShort.h"
 #include "ValueString.h"
 #include "ValueStore.h"
+#include "ValueRef.h"
 
 using namespace OpenZWave;
 
@@ -100,7 +101,8 @@ static char const* c_queryStageNames[] =
 Node::Node
 (
 	uint32 const _homeId,
-	uint8 const _nodeId
+	uint8 const _nodeId,
+	NodeSnapshot* _snapshot
 ):
 	m_queryStage( QueryStage_None ),
 	m_queryPending( false ),
@@ -122,15 +124,16 @@ Node::Node
 	m_basic( 0 ),
 	m_generic( 0 ),
 	m_specific( 0 ),
-	m_type( "" ),
+	m_type(),
 	m_numRouteNodes( 0 ),
-	m_manufacturerName( "" ),
-	m_productName( "" ),
+	m_manufacturerName(),
+	m_productName(),
 	m_nodeName( "" ),
 	m_location( "" ),
 	m_manufacturerId( "" ),
 	m_productType( "" ),
 	m_productId( "" ),
+	m_snapshot( _snapshot ),
 	m_values( new ValueStore() ),
 	m_sentCnt( 0 ),
 	m_sentFailed( 0 ),
@@ -138,12 +141,21 @@ Node::Node
 	m_receivedCnt( 0 ),
 	m_receivedDups( 0 ),
 	m_lastRTT( 0 ),
+	m_receivedTime( 0 ),
 	m_averageRTT( 0 ),
-	m_quality( 0 )
+	m_quality( 0 ),
+	m_poorLink( false )
 {
 	memset( m_neighbors, 0, sizeof(m_neighbors) );
 	memset( m_routeNodes, 0, sizeof(m_routeNodes) );
 	AddCommandClass( 0 );
+
+	char home[16];
+	char node[8];
+	snprintf( home, sizeof(home), "0x%.8x", _homeId );
+	snprintf( node, sizeof(node), "%d", _nodeId );
+	Metrics::Register( &m_rttHistogram, "ozw_node_rtt_seconds", "Time from sending a message to a node until the controller reports it was delivered", Metrics::Label( "home", home ) + "," + Metrics::Label( "node", node ) );
+	PublishSnapshot();
 }
 
 //-----------------------------------------------------------------------------
@@ -154,6 +166,9 @@ Node::~Node
 (
 )
 {
+	Metrics::Unregister( &m_rttHistogram );
+	m_snapshot->Clear();
+
 	// Delete the values
 	delete m_values;
 
@@ -690,6 +705,7 @@ void Node::ReadXML
 		if( m_queryStage > QueryStage_NodeInfo )
 		{
 			m_nodeInfoReceived = true;
+			TouchSnapshot();
 		}
 
 		if( m_queryStage > QueryStage_Instances )
@@ -840,6 +856,8 @@ void Node::ReadXML
 		child = child->NextSiblingElement();
 	}
 
+	PublishSnapshot();
+
 	if( m_nodeName.length() > 0 || m_location.length() > 0 || m_manufacturerId.length() > 0 )
 	{
 		// Notify the watchers of the name changes
@@ -1184,6 +1202,7 @@ void Node::UpdateNodeInfo
 
 		SetStaticRequests();
 		m_nodeInfoReceived = true;
+		TouchSnapshot();
 	}
 	else
 	{
@@ -1242,6 +1261,7 @@ void Node::SetNodeName
 )
 {
 	m_nodeName = _nodeName;
+	PublishSnapshot();
 	// Notify the watchers of the name changes
 	Notification* notification = new Notification( Notification::Type_NodeNaming );
 	notification->SetHomeAndNodeIds( m_homeId, m_nodeId );
@@ -1263,6 +1283,7 @@ void Node::SetLocation
 )
 {
 	m_location = _location;
+	PublishSnapshot();
 	// Notify the watchers of the name changes
 	Notification* notification = new Notification( Notification::Type_NodeNaming );
 	notification->SetHomeAndNodeIds( m_homeId, m_nodeId );
@@ -1397,37 +1418,38 @@ bool Node::SetConfigParam
 	if( Configuration* cc = static_cast<Configuration*>( GetCommandClass( Configuration::StaticGetCommandClassId() ) ) )
 	{
 		// First try to find an existing value representing the parameter, and set that.
-		if( Value* value = cc->GetValue( 1, _param ) )
+		ValueRef<Value> value( cc->GetValue( 1, _param ) );
+		if( value )
 		{
 			switch( value->GetID().GetType() )
 			{
 				case ValueID::ValueType_Bool:
 				{
-					ValueBool* valueBool = static_cast<ValueBool*>( value );
+					ValueBool* valueBool = static_cast<ValueBool*>( value.Get() );
 					valueBool->Set( _value != 0 );
 					break;
 				}
 				case ValueID::ValueType_Byte:
 				{
-					ValueByte* valueByte = static_cast<ValueByte*>( value );
+					ValueByte* valueByte = static_cast<ValueByte*>( value.Get() );
 					valueByte->Set( (uint8)_value );
 					break;
 				}
 				case ValueID::ValueType_Short:
 				{
-					ValueShort* valueShort = static_cast<ValueShort*>( value );
+					ValueShort* valueShort = static_cast<ValueShort*>( value.Get() );
 					valueShort->Set( (uint16)_value );
 					break;
 				}
 				case ValueID::ValueType_Int:
 				{
-					ValueInt* valueInt = static_cast<ValueInt*>( value );
+					ValueInt* valueInt = static_cast<ValueInt*>( value.Get() );
 					valueInt->Set( _value );
 					break;
 				}
 				case ValueID::ValueType_List:
 				{
-					ValueList* valueList = static_cast<ValueList*>( value );
+					ValueList* valueList = static_cast<ValueList*>( value.Get() );
 					valueList->SetByValue( _value );
 					break;
 				}
@@ -1938,10 +1960,10 @@ void Node::ReadValueFromXML
 	// Create it if it doesn't already exist.
 	if( ValueStore* store = GetValueStore() )
 	{
-		if( Value* value = store->GetValue( id.GetValueStoreKey() ) )
+		ValueRef<Value> value( store->GetValue( id.GetValueStoreKey() ) );
+		if( value )
 		{
 			value->ReadXML( m_homeId, m_nodeId, _commandClassId, _valueElement );
-			value->Release();
 		}
 		else
 		{
@@ -1981,6 +2003,32 @@ Value* Node::GetValue
 	return value;
 }
 
+//-----------------------------------------------------------------------------
+// <Node::BorrowValue>
+// Get the value object with the specified ID, without adding a reference
+//-----------------------------------------------------------------------------
+Value* Node::BorrowValue
+(
+	ValueID const& _id
+)
+{
+	return GetValueStore()->BorrowValue( _id.GetValueStoreKey() );
+}
+
+//-----------------------------------------------------------------------------
+// <Node::BorrowValue>
+// Get the value object with the specified settings, without adding a reference
+//-----------------------------------------------------------------------------
+Value* Node::BorrowValue
+(
+	uint8 const _commandClassId,
+	uint8 const _instance,
+	uint8 const _valueIndex
+)
+{
+	return GetValueStore()->BorrowValue( ValueID::GetValueStoreKey( _commandClassId, _instance, _valueIndex ) );
+}
+
 //-----------------------------------------------------------------------------
 // <Node::GetGroup>
 // Get a Group from the node's map
@@ -2293,6 +2341,9 @@ bool Node::SetDeviceClasses
 		Log::Write( LogLevel_Info, m_nodeId, "  No generic or specific device classes defined" );
 	}
 
+	// The capabilities are set just before this, when the protocol info arrives
+	PublishSnapshot();
+
 	// Deal with sleeping devices
 	if( !m_listening )
 	{
@@ -2471,8 +2522,8 @@ void Node::GetNodeStatistics
 	_data->m_receivedCnt = m_receivedCnt;
 	_data->m_receivedDups = m_receivedDups;
 	_data->m_lastRTT = m_lastRTT;
-	_data->m_sentTS = m_sentTS.GetAsString();
-	_data->m_receivedTS = m_receivedTS.GetAsString();
+	_data->m_sentTS = m_sentTS;
+	_data->m_receivedTS = m_receivedTS;
 	_data->m_averageRTT = m_averageRTT;
 	_data->m_quality = m_quality;
 	memcpy( _data->m_lastReceivedMessage, m_lastReceivedMessage, sizeof(m_lastReceivedMessage) );
@@ -2482,10 +2533,176 @@ void Node::GetNodeStatistics
 		ccData.m_commandClassId = it->second->GetCommandClassId();
 		ccData.m_sentCnt = it->second->GetSentCnt();
 		ccData.m_receivedCnt = it->second->GetReceivedCnt();
+		ccData.m_verifyReadCnt = it->second->GetVerifyReadCnt();
+		ccData.m_verifyConfirmedCnt = it->second->GetVerifyConfirmedCnt();
+		ccData.m_verifySpuriousCnt = it->second->GetVerifySpuriousCnt();
 		_data->m_ccData.push_back( ccData );
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <Node::GetNodeInfo>
+// Return the node's description and its current user values
+//-----------------------------------------------------------------------------
+void Node::GetNodeInfo
+(
+	NodeInfo* _info
+)
+{
+	_info->m_nodeId = m_nodeId;
+	_info->m_exists = true;
+	_info->m_generation = m_snapshot->GetGeneration();
+
+	_info->m_info.m_listening = m_listening;
+	_info->m_info.m_frequentListening = m_frequentListening;
+	_info->m_info.m_beaming = m_beaming;
+	_info->m_info.m_routing = m_routing;
+	_info->m_info.m_security = m_security;
+	_info->m_info.m_maxBaudRate = m_maxBaudRate;
+	_info->m_info.m_version = m_version;
+	_info->m_info.m_basic = m_basic;
+	_info->m_info.m_generic = m_generic;
+	_info->m_info.m_specific = m_specific;
+
+	_info->m_type = m_type;
+	_info->m_manufacturerName = m_manufacturerName;
+	_info->m_productName = m_productName;
+	_info->m_name = m_nodeName;
+	_info->m_location = m_location;
+	_info->m_manufacturerId = m_manufacturerId;
+	_info->m_productType = m_productType;
+	_info->m_productId = m_productId;
+
+	_info->m_infoReceived = m_nodeInfoReceived;
+	_info->m_awake = true;
+	if( WakeUp* wakeUp = static_cast<WakeUp*>( GetCommandClass( WakeUp::StaticGetCommandClassId() ) ) )
+	{
+		_info->m_awake = m_listening || wakeUp->IsAwake();
+	}
+
+	for( ValueStore::Iterator it = m_values->Begin(); it != m_values->End(); ++it )
+	{
+		Value const* value = it->second;
+		if( value->GetID().GetGenre() == ValueID::ValueGenre_User )
+		{
+			ValueInfo valueInfo;
+			valueInfo.m_id = value->GetID();
+			valueInfo.m_label = value->GetLabel();
+			valueInfo.m_units = value->GetUnits();
+			valueInfo.m_value = value->GetAsString();
+			_info->m_values.push_back( valueInfo );
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Node::GetValueSnapshot>
+// Read every one of the node's values
+//-----------------------------------------------------------------------------
+void Node::GetValueSnapshot
+(
+	ValueSnapshot* _snapshot
+)
+{
+	_snapshot->m_ids.clear();
+	for( ValueStore::Iterator it = m_values->Begin(); it != m_values->End(); ++it )
+	{
+		_snapshot->m_ids.push_back( it->second->GetID() );
+	}
+
+	_snapshot->m_values.Resize( _snapshot->m_ids.size() );
+	size_t i = 0;
+	for( ValueStore::Iterator it = m_values->Begin(); it != m_values->End(); ++it, ++i )
+	{
+		ReadValue( it->second, i, &_snapshot->m_values );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Node::ReadValue>
+// Copy one of the node's values into the results of a bulk read
+//-----------------------------------------------------------------------------
+bool Node::ReadValue
+(
+	ValueID const& _id,
+	size_t const _index,
+	ValueResults* _results
+)
+{
+	// The nodes are locked, so there is no need to add a reference to the value
+	if( Value const* value = m_values->FindValue( _id.GetValueStoreKey() ) )
+	{
+		ReadValue( value, _index, _results );
+		return true;
+	}
+
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <Node::ReadValue>
+// Copy a value into the results of a bulk read
+//-----------------------------------------------------------------------------
+void Node::ReadValue
+(
+	Value const* _value,
+	size_t const _index,
+	ValueResults* _results
+)
+{
+	_results->m_found[_index] = true;
+	switch( _value->GetID().GetType() )
+	{
+		case ValueID::ValueType_Bool:
+		{
+			_results->m_int[_index] = static_cast<ValueBool const*>( _value )->GetValue() ? 1 : 0;
+			break;
+		}
+		case ValueID::ValueType_Byte:
+		{
+			_results->m_int[_index] = static_cast<ValueByte const*>( _value )->GetValue();
+			break;
+		}
+		case ValueID::ValueType_Decimal:
+		{
+			_results->m_decimal[_index] = static_cast<ValueDecimal const*>( _value )->GetFixed();
+			break;
+		}
+		case ValueID::ValueType_Int:
+		{
+			_results->m_int[_index] = static_cast<ValueInt const*>( _value )->GetValue();
+			break;
+		}
+		case ValueID::ValueType_List:
+		{
+			ValueList::Item const& item = static_cast<ValueList const*>( _value )->GetItem();
+			_results->m_int[_index] = item.m_value;
+			_results->m_string[_index] = item.m_label;
+			break;
+		}
+		case ValueID::ValueType_Short:
+		{
+			_results->m_int[_index] = static_cast<ValueShort const*>( _value )->GetValue();
+			break;
+		}
+		case ValueID::ValueType_String:
+		{
+			_results->m_string[_index] = static_cast<ValueString const*>( _value )->GetValue();
+			break;
+		}
+		case ValueID::ValueType_Button:
+		{
+			_results->m_int[_index] = static_cast<ValueButton const*>( _value )->IsPressed() ? 1 : 0;
+			break;
+		}
+		case ValueID::ValueType_Schedule:
+		{
+			// Schedules have no single value to return
+			break;
+		}
+	}
+}
+
 //-----------------------------------------------------------------------------
 // <DeviceClass::DeviceClass>
 // Constructor
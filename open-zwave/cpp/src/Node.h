@@ -35,8 +35,13 @@
 #include "Defs.h"
 #include "ValueID.h"
 #include "ValueList.h"
+#include "ValueDecimal.h"
 #include "Msg.h"
 #include "TimeStamp.h"
+#include "Metrics.h"
+#include "LinkStatistics.h"
+#include "NodeSnapshot.h"
+#include "InternedString.h"
 
 class TiXmlElement;
 
@@ -85,6 +90,7 @@ namespace OpenZWave
 		friend class MeterPulse;
 		friend class MultiInstance;
 		friend class NodeNaming;
+		friend class NodeSnapshot;
 		friend class Protection;
 		friend class SensorAlarm;
 		friend class SensorBinary;
@@ -110,8 +116,9 @@ namespace OpenZWave
 		 *  network (_homeId) and network node (_nodeId).
 		 *  \param _homeId The homeId of the network to which this node is connected.
 		 *  \param _nodeId The nodeId of this node.
+		 *  \param _snapshot Where to publish the node's description, so it can be read without locking.
 		 */
-		Node( uint32 const _homeId, uint8 const _nodeId );
+		Node( uint32 const _homeId, uint8 const _nodeId, NodeSnapshot* _snapshot );
 		/** Destructor cleans up memory allocated to node and its child objects. 
 		*/
 		virtual ~Node();
@@ -292,7 +299,7 @@ namespace OpenZWave
 		uint8		m_basic;		//*< Basic device class (0x01-Controller, 0x02-Static Controller, 0x03-Slave, 0x04-Routing Slave
 		uint8		m_generic;
 		uint8		m_specific;
-		string		m_type;			// Label representing the specific/generic/basic value
+		InternedString	m_type;		// Label representing the specific/generic/basic value
 		uint8		m_neighbors[29];	// Bitmask containing the neighbouring nodes
 		uint8		m_numRouteNodes;	// number of node routes
 		uint8		m_routeNodes[5];	// nodes to route to
@@ -313,17 +320,20 @@ namespace OpenZWave
 		string GetProductType()const{ return m_productType; }	
 		string GetProductId()const{ return m_productId; }	
 
-		void SetManufacturerName( string const& _manufacturerName ){ m_manufacturerName = _manufacturerName; }
-		void SetProductName( string const& _productName ){ m_productName = _productName; }
+		void SetManufacturerName( string const& _manufacturerName ){ m_manufacturerName = _manufacturerName; PublishSnapshot(); }
+		void SetProductName( string const& _productName ){ m_productName = _productName; PublishSnapshot(); }
 		void SetNodeName( string const& _nodeName );
 		void SetLocation( string const& _location );
 
-		void SetManufacturerId( string const& _manufacturerId ){ m_manufacturerId = _manufacturerId; }
-		void SetProductType( string const& _productType ){ m_productType = _productType; }
-		void SetProductId( string const& _productId ){ m_productId = _productId; }
+		void SetManufacturerId( string const& _manufacturerId ){ m_manufacturerId = _manufacturerId; PublishSnapshot(); }
+		void SetProductType( string const& _productType ){ m_productType = _productType; PublishSnapshot(); }
+		void SetProductId( string const& _productId ){ m_productId = _productId; PublishSnapshot(); }
+
+		void PublishSnapshot(){ m_snapshot->Publish( this ); }
+		void TouchSnapshot(){ m_snapshot->Touch(); }		// For changes to state that GetNodeInfo reads from the node itself
 		
-		string		m_manufacturerName;
-		string		m_productName;
+		InternedString	m_manufacturerName;
+		InternedString	m_productName;
 		string		m_nodeName;
 		string		m_location;
 
@@ -331,6 +341,8 @@ namespace OpenZWave
 		string		m_productType;
 		string		m_productId;
 
+		NodeSnapshot*	m_snapshot;		// Copy of the names, type and capabilities that applications read without locking
+
 	//-----------------------------------------------------------------------------
 	// Command Classes
 	//-----------------------------------------------------------------------------
@@ -391,6 +403,11 @@ namespace OpenZWave
 		Value* GetValue( ValueID const& _id );
 		Value* GetValue( uint8 const _commandClassId, uint8 const _instance, uint8 const _valueIndex );
 
+		// Like GetValue, but without adding a reference, so there is nothing to release.
+		// Only valid while the nodes are locked, or on the driver thread.
+		Value* BorrowValue( ValueID const& _id );
+		Value* BorrowValue( uint8 const _commandClassId, uint8 const _instance, uint8 const _valueIndex );
+
 		// Helpers for creating values
 		bool CreateValueBool( ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint8 const _valueIndex, string const& _label, string const& _units, bool const _readOnly, bool const _writeOnly, bool const _default, uint8 const _pollIntensity );
 		bool CreateValueButton( ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint8 const _valueIndex, string const& _label, uint8 const _pollIntensity );
@@ -499,6 +516,9 @@ namespace OpenZWave
 			uint8 m_commandClassId;
 			uint32 m_sentCnt;
 			uint32 m_receivedCnt;
+			uint32 m_verifyReadCnt;			// Extra reads made to check reported changes
+			uint32 m_verifyConfirmedCnt;		// Reported changes that the checks confirmed
+			uint32 m_verifySpuriousCnt;		// Reported changes that the checks found to be spurious
 		};
 
 		struct NodeData
@@ -509,8 +529,8 @@ namespace OpenZWave
 			uint32 m_receivedCnt;
 			uint32 m_receivedDups;
 			uint32 m_rtt;					// last round trip if successful in ms
-			string m_sentTS;
-			string m_receivedTS;
+			TimeStamp m_sentTS;				// call GetAsString() or Format() for display
+			TimeStamp m_receivedTS;
 			uint32 m_lastRTT;
 			uint32 m_averageRTT;				// ms
 			uint8 m_quality;				// Node quality measure
@@ -521,6 +541,70 @@ namespace OpenZWave
 	private:
 		void GetNodeStatistics( NodeData* _data );
 
+	//-----------------------------------------------------------------------------
+	//	Bulk queries
+	//-----------------------------------------------------------------------------
+	public:
+		struct ValueInfo
+		{
+			ValueID m_id;
+			string m_label;
+			string m_units;
+			string m_value;					// The value as a string, as from Manager::GetValueAsString
+		};
+
+		struct NodeInfo
+		{
+			uint8 m_nodeId;
+			bool m_exists;					// False if the node has been removed
+			uint32 m_generation;				// Generation at which the node last changed
+			NodeSnapshot::Info m_info;			// Capabilities and device classes
+			string m_type;
+			string m_manufacturerName;
+			string m_productName;
+			string m_name;
+			string m_location;
+			string m_manufacturerId;
+			string m_productType;
+			string m_productId;
+			bool m_infoReceived;				// True once the node's command classes are known
+			bool m_awake;					// False while a sleeping node is asleep
+			list<ValueInfo> m_values;			// Current values of the user genre
+		};
+
+		/** Typed values read by Manager::GetValues, with one entry in each vector per value asked for */
+		struct ValueResults
+		{
+			vector<bool> m_found;				// False if there is no such value
+			vector<int32> m_int;				// Bool, byte, short, int and button values, and the value of a list's selected item
+			vector<ValueDecimal::Fixed> m_decimal;		// Decimal values, exactly as they are stored
+			vector<string> m_string;			// String values, and the label of a list's selected item
+
+			void Resize( size_t const _count )
+			{
+				m_found.assign( _count, false );
+				m_int.assign( _count, 0 );
+				m_decimal.assign( _count, ValueDecimal::Fixed() );
+				m_string.assign( _count, string() );
+			}
+		};
+
+		/** Every value of a node, as read by Manager::GetNodeValueSnapshot */
+		struct ValueSnapshot
+		{
+			ValueSnapshot(): m_generation( 0 ){}
+
+			uint32 m_generation;				// Generation of the node when the values were read, or zero if they never have been
+			vector<ValueID> m_ids;				// The values, in the same order as the results
+			ValueResults m_values;
+		};
+
+	private:
+		void GetNodeInfo( NodeInfo* _info );
+		void GetValueSnapshot( ValueSnapshot* _snapshot );
+		bool ReadValue( ValueID const& _id, size_t const _index, ValueResults* _results );
+		static void ReadValue( Value const* _value, size_t const _index, ValueResults* _results );
+
 		uint32 m_sentCnt;				// Number of messages sent from this node.
 		uint32 m_sentFailed;				// Number of sent messages failed
 		uint32 m_retries;				// Number of message retries
@@ -529,8 +613,12 @@ namespace OpenZWave
 		uint32 m_lastRTT;					// Last message rtt
 		TimeStamp m_sentTS;				// Last message sent time
 		TimeStamp m_receivedTS;				// Last message received time
+		uint64 m_receivedTime;				// Monotonic time in ms of the last message received, for spotting duplicates
 		uint32 m_averageRTT;				// Average round trip time.
-		uint8 m_quality;				// Node quality measure
+		Metrics::Histogram m_rttHistogram;		// Distribution of the round trip times
+		LinkStatistics m_linkStats;			// Outcome of recent transmissions
+		uint8 m_quality;				// Percentage of messages delivered in the last 15 minutes
+		bool m_poorLink;				// True while too few messages are being delivered
 		uint8 m_lastReceivedMessage[254];		// Place to hold last received message
 	};
 
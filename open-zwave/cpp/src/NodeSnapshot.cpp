@@ -0,0 +1,233 @@
+//-----------------------------------------------------------------------------
+//
+//	NodeSnapshot.cpp
+//
+//	Copy of a node's description that can be read without locking
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include <string.h>
+#include "Defs.h"
+#include "NodeSnapshot.h"
+#include "Node.h"
+#include "Atomic.h"
+
+using namespace OpenZWave;
+
+uint32 volatile NodeSnapshot::s_generation = 0;
+
+//-----------------------------------------------------------------------------
+// <NodeSnapshot::NodeSnapshot>
+// Constructor
+//-----------------------------------------------------------------------------
+NodeSnapshot::NodeSnapshot
+(
+):
+	m_sequence( 0 ),
+	m_generation( 0 ),
+	m_exists( false )
+{
+	memset( &m_info, 0, sizeof(m_info) );
+	memset( m_lengths, 0, sizeof(m_lengths) );
+	memset( m_strings, 0, sizeof(m_strings) );
+}
+
+//-----------------------------------------------------------------------------
+// <NodeSnapshot::Publish>
+// Copy the node's description into the snapshot
+//-----------------------------------------------------------------------------
+void NodeSnapshot::Publish
+(
+	Node const* _node
+)
+{
+	// Gather everything first, so the snapshot is only unreadable for as
+	// long as it takes to copy it in.
+	Info info;
+	memset( &info, 0, sizeof(info) );
+	info.m_listening = _node->IsListeningDevice();
+	info.m_frequentListening = _node->IsFrequentListeningDevice();
+	info.m_beaming = _node->IsBeamingDevice();
+	info.m_routing = _node->IsRoutingDevice();
+	info.m_security = _node->IsSecurityDevice();
+	info.m_maxBaudRate = _node->GetMaxBaudRate();
+	info.m_version = _node->GetVersion();
+	info.m_basic = _node->GetBasic();
+	info.m_generic = _node->GetGeneric();
+	info.m_specific = _node->GetSpecific();
+
+	string strings[Field_Count];
+	strings[Field_Type] = _node->GetType();
+	strings[Field_ManufacturerName] = _node->GetManufacturerName();
+	strings[Field_ProductName] = _node->GetProductName();
+	strings[Field_Name] = _node->GetNodeName();
+	strings[Field_Location] = _node->GetLocation();
+	strings[Field_ManufacturerId] = _node->GetManufacturerId();
+	strings[Field_ProductType] = _node->GetProductType();
+	strings[Field_ProductId] = _node->GetProductId();
+
+	BeginWrite();
+	m_exists = true;
+	m_info = info;
+	for( int32 i=0; i<Field_Count; ++i )
+	{
+		if( strings[i].length() > MaxStringLength )
+		{
+			m_lengths[i] = 0xff;
+			continue;
+		}
+		m_lengths[i] = (uint8)strings[i].length();
+		memcpy( m_strings[i], strings[i].c_str(), m_lengths[i] );
+	}
+	EndWrite();
+	Touch();
+}
+
+//-----------------------------------------------------------------------------
+// <NodeSnapshot::Clear>
+// Mark the node as no longer existing
+//-----------------------------------------------------------------------------
+void NodeSnapshot::Clear
+(
+)
+{
+	BeginWrite();
+	m_exists = false;
+	EndWrite();
+	Touch();
+}
+
+//-----------------------------------------------------------------------------
+// <NodeSnapshot::GetInfo>
+// Read the node's capabilities and device classes
+//-----------------------------------------------------------------------------
+bool NodeSnapshot::GetInfo
+(
+	Info* _info
+)const
+{
+	bool exists;
+	uint32 sequence;
+	do
+	{
+		sequence = BeginRead();
+		exists = m_exists;
+		*_info = m_info;
+	}
+	while( !EndRead( sequence ) );
+
+	return exists;
+}
+
+//-----------------------------------------------------------------------------
+// <NodeSnapshot::GetString>
+// Read one of the node's strings
+//-----------------------------------------------------------------------------
+bool NodeSnapshot::GetString
+(
+	Field const _field,
+	string* _str
+)const
+{
+	// The copy may be torn if a writer gets in, in which case it is
+	// thrown away, so it must not be trusted until EndRead agrees.
+	char str[MaxStringLength+1];
+	bool exists;
+	uint8 length;
+	uint32 sequence;
+	do
+	{
+		sequence = BeginRead();
+		exists = m_exists;
+		length = m_lengths[_field];
+		if( exists && ( length <= MaxStringLength ) )
+		{
+			memcpy( str, m_strings[_field], length );
+		}
+	}
+	while( !EndRead( sequence ) );
+
+	if( !exists || ( length > MaxStringLength ) )
+	{
+		return false;
+	}
+
+	_str->assign( str, length );
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <NodeSnapshot::BeginRead>
+// Wait until no writer is busy, and get the sequence number
+//-----------------------------------------------------------------------------
+uint32 NodeSnapshot::BeginRead
+(
+)const
+{
+	uint32 sequence;
+	while( ( sequence = Atomic::Load( &m_sequence ) ) & 1 )
+	{
+	}
+	return sequence;
+}
+
+//-----------------------------------------------------------------------------
+// <NodeSnapshot::EndRead>
+// Check that nothing was written while the snapshot was being read
+//-----------------------------------------------------------------------------
+bool NodeSnapshot::EndRead
+(
+	uint32 const _sequence
+)const
+{
+	return( Atomic::Load( &m_sequence ) == _sequence );
+}
+
+//-----------------------------------------------------------------------------
+// <NodeSnapshot::BeginWrite>
+// Make the sequence number odd, waiting for any other writer to finish first
+//-----------------------------------------------------------------------------
+void NodeSnapshot::BeginWrite
+(
+)
+{
+	while( true )
+	{
+		uint32 sequence = Atomic::Load( &m_sequence );
+		if( !( sequence & 1 ) && Atomic::CompareExchange( &m_sequence, sequence, sequence + 1 ) )
+		{
+			return;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <NodeSnapshot::EndWrite>
+// Make the sequence number even again, so readers can trust what they copy
+//-----------------------------------------------------------------------------
+void NodeSnapshot::EndWrite
+(
+)
+{
+	Atomic::Add( &m_sequence, 1 );
+}
@@ -0,0 +1,158 @@
+//-----------------------------------------------------------------------------
+//
+//	NodeSnapshot.h
+//
+//	Copy of a node's description that can be read without locking
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#ifndef _NodeSnapshot_H
+#define _NodeSnapshot_H
+
+#include <string>
+#include "Defs.h"
+#include "Atomic.h"
+
+namespace OpenZWave
+{
+	class Node;
+
+	/** \brief A copy of a node's description (its names, type and capabilities)
+	 * that applications can read without waiting for the driver's nodes to be
+	 * unlocked.
+	 *
+	 * The node publishes a new copy whenever its description changes.  The copy
+	 * is guarded by a sequence number that is odd while it is being written, so a
+	 * reader simply copies what it needs and tries again if the sequence number
+	 * changed meanwhile.  Writers are rare, so they just wait for each other.
+	 *
+	 * The driver keeps one snapshot for every node ID for as long as it exists,
+	 * so a reader can never be left holding a snapshot that has been freed.
+	 * Strings are kept in fixed buffers; when one does not fit, the reader is
+	 * told to ask the node itself instead.
+	 *
+	 * Every change to a node, including to its values, stamps its snapshot with
+	 * a new generation, so an application can ask for just the nodes that have
+	 * changed since it last looked.  Generations are shared by all the drivers,
+	 * and only ever increase.
+	 */
+	class NodeSnapshot
+	{
+	public:
+		enum Field
+		{
+			Field_Type = 0,
+			Field_ManufacturerName,
+			Field_ProductName,
+			Field_Name,
+			Field_Location,
+			Field_ManufacturerId,
+			Field_ProductType,
+			Field_ProductId,
+			Field_Count
+		};
+
+		struct Info
+		{
+			bool	m_listening;
+			bool	m_frequentListening;
+			bool	m_beaming;
+			bool	m_routing;
+			bool	m_security;
+			uint32	m_maxBaudRate;
+			uint8	m_version;
+			uint8	m_basic;
+			uint8	m_generic;
+			uint8	m_specific;
+		};
+
+		NodeSnapshot();
+
+		/**
+		 * Copy the node's description into the snapshot.  Called by the node
+		 * whenever any part of its description changes.
+		 */
+		void Publish( Node const* _node );
+
+		/**
+		 * Mark the node as no longer existing.
+		 */
+		void Clear();
+
+		/**
+		 * Read the node's capabilities and device classes.
+		 * \param _info structure to fill in.
+		 * \return false if the node does not exist.
+		 */
+		bool GetInfo( Info* _info )const;
+
+		/**
+		 * Read one of the node's strings.
+		 * \param _field the string to read.
+		 * \param _str string to fill in.
+		 * \return false if the node does not exist, or the string was too long
+		 * to keep in the snapshot.
+		 */
+		bool GetString( Field const _field, string* _str )const;
+
+		/**
+		 * Record that one of the node's values has changed, without changing
+		 * its description.
+		 */
+		void Touch(){ Atomic::Store( &m_generation, Atomic::Add( &s_generation, 1 ) ); }
+
+		/**
+		 * Get the generation at which the node last changed.
+		 * \return the generation, or zero if the node has never existed.
+		 */
+		uint32 GetGeneration()const{ return Atomic::Load( &m_generation ); }
+
+		/**
+		 * Get the latest generation of any node.
+		 */
+		static uint32 GetCurrentGeneration(){ return Atomic::Load( &s_generation ); }
+
+	private:
+		enum
+		{
+			MaxStringLength = 63			// Longer strings have to be read from the node itself
+		};
+
+		uint32 BeginRead()const;
+		bool EndRead( uint32 const _sequence )const;
+		void BeginWrite();
+		void EndWrite();
+
+		uint32 volatile	m_sequence;									// Odd while the snapshot is being written
+		uint32 volatile	m_generation;								// Generation at which the node last changed
+		bool			m_exists;
+		Info			m_info;
+		uint8			m_lengths[Field_Count];						// Length of each string, or 0xff if it did not fit
+		char			m_strings[Field_Count][MaxStringLength+1];
+
+		static uint32 volatile	s_generation;
+	};
+
+} // namespace OpenZWave
+
+#endif // _NodeSnapshot_H
@@ -39,6 +39,7 @@
 using namespace OpenZWave;
 
 Options* Options::s_instance = NULL;
+uint32 Options::s_generation = 1;
 
 //-----------------------------------------------------------------------------
 // <Options::Create>
@@ -71,6 +72,7 @@ Options* Options::Create
 		{
 			Log::Create( "", false, true, LogLevel_Debug, LogLevel_Debug, LogLevel_Debug );
 			Log::Write( LogLevel_Error, "Cannot find a path to the configuration files at %s. Exiting...", configPath.c_str() );
+			Log::Destroy();
 			exit( 1 );
 		}
 		s_instance = new Options( configPath, userPath, _commandLine );
@@ -86,6 +88,13 @@ Options* Options::Create
 		s_instance->AddOptionInt(		"SaveLogLevel",				LogLevel_Detail );			// Save (to file) log messages equal to or above LogLevel_Detail
 		s_instance->AddOptionInt(		"QueueLogLevel",			LogLevel_Debug );			// Save (in RAM) log messages equal to or above LogLevel_Debug
 		s_instance->AddOptionInt(		"DumpTriggerLevel",			LogLevel_None );			// Default is to never dump RAM-stored log messages
+		s_instance->AddOptionInt(		"LogFlushInterval",			500 );						// Milliseconds that log output may be held in memory before being written to disk (0 = as soon as possible)
+		s_instance->AddOptionInt(		"LogMaxFileSize",			0 );						// Kilobytes the log file may reach before it is rotated (0 = no limit)
+		s_instance->AddOptionInt(		"LogRotateInterval",		0 );						// Minutes after which the log file is rotated (0 = never)
+		s_instance->AddOptionInt(		"LogRetainedFiles",			5 );						// Number of rotated log files to keep
+		s_instance->AddOptionBool(		"LogCompressRotated",		false );					// Compress rotated log files with gzip
+		s_instance->AddOptionString(	"FrameLogFileName",			string(""),		false );	// Name of a file to receive a machine-readable record of every frame (empty = no frame log)
+		s_instance->AddOptionString(	"TraceFileName",			string(""),		false );	// Name of a file to receive timing traces of commands started with Manager::BeginTrace (empty = no tracing)
 
 		s_instance->AddOptionBool(		"Associate",				true );						// Enable automatic association of the controller with group one of every device.
 		s_instance->AddOptionString(	"Exclude",					string(""),		true );		// Remove support for the listed command classes.
@@ -95,10 +104,17 @@ Options* Options::Create
 		s_instance->AddOptionBool(		"SaveConfiguration",		true );						// Save the XML configuration upon driver close.
 		s_instance->AddOptionInt(		"DriverMaxAttempts",		0);
 
-		s_instance->AddOptionInt(		"PollInterval",				30000);						// 30 seconds (can easily poll 30 values in this time; ~120 values is the effective limit for 30 seconds)
-		s_instance->AddOptionBool(		"IntervalBetweenPolls",		false );					// if false, try to execute the entire poll list within the PollInterval time frame
-																								// if true, wait for PollInterval milliseconds between polls
+		s_instance->AddOptionInt(		"PollInterval",				30000);						// 30 seconds between polls of each value, unless the value has its own poll interval
+		s_instance->AddOptionBool(		"IntervalBetweenPolls",		false );					// if true, also wait PollInterval milliseconds after polling each node
+		s_instance->AddOptionBool(		"AdaptivePolling",			true );						// if true, skip polls of values the device has recently reported unprompted, and poll consistently self-reporting values less often
 		s_instance->AddOptionBool(		"SuppressValueRefresh",		false );					// if true, notifications for refreshed (but unchanged) values will not be sent
+		s_instance->AddOptionInt(		"ValueHistorySize",			0 );						// Recent readings kept for each numeric value (0 = only for values given a size with Manager::SetValueHistorySize)
+		s_instance->AddOptionInt(		"ValueHistoryMaxSamples",	262144 );					// Most readings kept for all values together, at 16 bytes each
+		s_instance->AddOptionString(	"ValueLogCommandClasses",	string(""),		false );	// Command classes whose readings are saved to the value log, such as COMMAND_CLASS_METER,COMMAND_CLASS_SENSOR_MULTILEVEL (empty = no value log)
+		s_instance->AddOptionString(	"ValueLogGenres",			string("user"),	false );	// Genres of value saved to the value log (basic, user, config and system)
+		s_instance->AddOptionInt(		"ValueLogFlushInterval",	300 );						// Seconds that readings may be held in memory before being written to the value log
+		s_instance->AddOptionInt(		"ValueLogRetention",		30 );						// Days that readings are kept in the value log (0 = forever)
+		s_instance->AddOptionInt(		"ValueLogCompactInterval",	24 );						// Hours between compactions of the value log
 	}
 
 	return s_instance;
@@ -122,6 +138,9 @@ bool Options::Destroy
 	delete s_instance;
 	s_instance = NULL;
 
+	// Handles must not read the deleted options
+	++s_generation;
+
 	return true;
 }
 
@@ -330,6 +349,9 @@ bool Options::Lock
 	ParseOptionsString( m_commandLine );
 	m_locked = true;
 
+	// Any handle read before now may have missed options added since
+	++s_generation;
+
 	return true;
 }
 
@@ -517,6 +539,28 @@ Options::Option* Options::Find
 	return NULL;
 }
 
+//-----------------------------------------------------------------------------
+// <Options::Resolve>
+// Find an option for a Handle
+//-----------------------------------------------------------------------------
+Options::Option const* Options::Resolve
+(
+	char const* _name
+)
+{
+	if( s_instance == NULL )
+	{
+		return NULL;
+	}
+
+	Option const* option = s_instance->Find( _name );
+	if( option == NULL )
+	{
+		Log::Write( LogLevel_Warning, "Specified option [%s] was not found.", _name );
+	}
+	return option;
+}
+
 //-----------------------------------------------------------------------------
 // <Options::Option::SetValueFromString>
 // Find an option by name
@@ -213,6 +213,53 @@ namespace OpenZWave
 		 */
 		bool AreLocked()const{ return m_locked; }
 
+	private:
+		class Option;
+
+	public:
+		/** \brief A typed reference to an option, for code that reads it often.
+		 *
+		 * GetOptionAsBool and its siblings look the option up by name on every
+		 * call.  A handle does that once, the first time it is read after the
+		 * options are locked, and then reads the option directly.  Handles are
+		 * usually static, and may be created before the Options object is.
+		 * \code
+		 * static Options::Handle<bool> s_associate( "Associate" );
+		 * if( s_associate.Get() ) ...
+		 * \endcode
+		 * T must be bool, int32 or string, matching the type of the option.
+		 */
+		template<class T> class Handle
+		{
+		public:
+			explicit Handle( char const* _name ): m_name( _name ), m_option( NULL ), m_generation( 0 ){}
+
+			/**
+			 * Get the value of the option.
+			 * \return the value, or false, zero or an empty string if the option
+			 * does not exist or is of a different type.
+			 */
+			T Get()const
+			{
+				T value = T();
+				if( m_generation != s_generation )
+				{
+					m_option = Resolve( m_name );
+					m_generation = s_generation;
+				}
+				if( m_option )
+				{
+					m_option->GetValue( &value );
+				}
+				return value;
+			}
+
+		private:
+			char const*				m_name;
+			mutable Option const*	m_option;
+			mutable uint32			m_generation;		// Value of s_generation when m_option was found
+		};
+
 
 	private:
 		class Option
@@ -223,6 +270,11 @@ namespace OpenZWave
 			Option( string const& _name ):  m_name( _name ), m_append( false ){}
 			bool SetValueFromString( string const& _value );
 
+			// Used by Handle::Get, which leaves the value alone if the type does not match
+			void GetValue( bool* o_value )const{ if( OptionType_Bool == m_type ) *o_value = m_valueBool; }
+			void GetValue( int32* o_value )const{ if( OptionType_Int == m_type ) *o_value = m_valueInt; }
+			void GetValue( string* o_value )const{ if( OptionType_String == m_type ) *o_value = m_valueString; }
+
 			Options::OptionType	m_type;
 			string				m_name;
 			bool				m_valueBool;
@@ -238,12 +290,14 @@ namespace OpenZWave
 		bool ParseOptionsXML( string const& _filename );					// Parse an XML file containing program options.
 		Option* AddOption( string const& _name );							// check lock and create (or open existing) option
 		Option* Find( string const& _name );
+		static Option const* Resolve( char const* _name );					// Find an option for a Handle
 
 		map<string,Option*>	m_options;										// Map of option names to values.
 		string				m_xml;											// Path to XML options file.
 		string				m_commandLine;									// String containing command line options.
 		bool				m_locked;										// If true, the options are final and AddOption can no longer be called.
 		static Options*		s_instance;
+		static uint32		s_generation;									// Changes whenever handles must look up their options again
 	};
 } // namespace OpenZWave
 
@@ -0,0 +1,359 @@
+//-----------------------------------------------------------------------------
+//
+//	Trace.cpp
+//
+//	Timing of commands as they pass through the library
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include "Defs.h"
+#include "Trace.h"
+#include "LogWriter.h"
+#include "Mutex.h"
+#include "Atomic.h"
+#include "TimeStamp.h"
+
+using namespace OpenZWave;
+
+LogWriter* Trace::s_writer = NULL;
+Mutex* Trace::s_mutex = NULL;
+map<uint32,Trace::OpenTrace> Trace::s_openTraces;
+uint32 volatile Trace::s_nextTraceId = 0;
+uint32 volatile Trace::s_nextLane = 0;
+
+// The current trace of each thread
+#ifdef _MSC_VER
+static __declspec( thread ) uint32 s_currentTraceId = 0;
+#else
+static __thread uint32 s_currentTraceId = 0;
+#endif
+
+static uint32 const c_maxOpenTraces = 256;		// Traces that are never confirmed are forgotten once there are this many
+
+// Name of the span that starts at each stage of a message
+static char const* c_stageNames[] =
+{
+	"build",
+	"queue",
+	"write",
+	"await ack",
+	"await callback",
+	"await reply"
+};
+
+//-----------------------------------------------------------------------------
+// <EscapeString>
+// Make a string safe to write inside quotes in JSON
+//-----------------------------------------------------------------------------
+static string EscapeString
+(
+	string const& _str
+)
+{
+	string result;
+	for( string::const_iterator it = _str.begin(); it != _str.end(); ++it )
+	{
+		if( ( *it == '"' ) || ( *it == '\\' ) )
+		{
+			result += '\\';
+			result += *it;
+		}
+		else if( (uint8)*it >= 0x20 )
+		{
+			result += *it;
+		}
+	}
+	return result;
+}
+
+//-----------------------------------------------------------------------------
+// <Trace::Create>
+// Start writing traces
+//-----------------------------------------------------------------------------
+void Trace::Create
+(
+	string const& _filename,
+	int32 const _flushInterval
+)
+{
+	if( s_writer == NULL )
+	{
+		s_mutex = new Mutex();
+		s_writer = new LogWriter( _filename, false, _flushInterval );
+
+		// The closing bracket of the array is optional in this format,
+		// so each event can be written out as soon as it is known.
+		s_writer->Write( "[\n" );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Trace::Destroy>
+// Stop writing traces
+//-----------------------------------------------------------------------------
+void Trace::Destroy
+(
+)
+{
+	if( s_writer != NULL )
+	{
+		delete s_writer;
+		s_writer = NULL;
+		s_openTraces.clear();
+		s_mutex->Release();
+		s_mutex = NULL;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Trace::Begin>
+// Start a new trace, and make it current on the calling thread
+//-----------------------------------------------------------------------------
+uint32 Trace::Begin
+(
+	string const& _name
+)
+{
+	if( s_writer == NULL )
+	{
+		s_currentTraceId = 0;
+		return 0;
+	}
+
+	uint32 traceId = Atomic::Add( &s_nextTraceId, 1 );
+
+	OpenTrace trace;
+	trace.m_start = GetTime();
+	trace.m_name = _name;
+
+	s_mutex->Lock();
+	if( s_openTraces.size() >= c_maxOpenTraces )
+	{
+		s_openTraces.erase( s_openTraces.begin() );
+	}
+	s_openTraces[traceId] = trace;
+	s_mutex->Unlock();
+
+	WriteEvent( "M", traceId, 0, "process_name", 0, 0, "\"name\":\"" + EscapeString( _name ) + "\"" );
+	WriteEvent( "M", traceId, 0, "thread_name", 0, 0, "\"name\":\"command\"" );
+
+	s_currentTraceId = traceId;
+	return traceId;
+}
+
+//-----------------------------------------------------------------------------
+// <Trace::End>
+// Finish a trace
+//-----------------------------------------------------------------------------
+void Trace::End
+(
+	uint32 const _traceId,
+	char const* _reason
+)
+{
+	if( ( s_writer == NULL ) || ( _traceId == 0 ) )
+	{
+		return;
+	}
+
+	s_mutex->Lock();
+	map<uint32,OpenTrace>::iterator it = s_openTraces.find( _traceId );
+	if( it == s_openTraces.end() )
+	{
+		s_mutex->Unlock();
+		return;
+	}
+	OpenTrace trace = it->second;
+	s_openTraces.erase( it );
+	s_mutex->Unlock();
+
+	WriteEvent( "X", _traceId, 0, trace.m_name, trace.m_start, GetTime() - trace.m_start, string( "\"end\":\"" ) + _reason + "\"" );
+}
+
+//-----------------------------------------------------------------------------
+// <Trace::GetCurrent>
+// Get the current trace of the calling thread
+//-----------------------------------------------------------------------------
+uint32 Trace::GetCurrent
+(
+)
+{
+	return s_currentTraceId;
+}
+
+//-----------------------------------------------------------------------------
+// <Trace::SetCurrent>
+// Set the current trace of the calling thread
+//-----------------------------------------------------------------------------
+void Trace::SetCurrent
+(
+	uint32 const _traceId
+)
+{
+	s_currentTraceId = _traceId;
+}
+
+//-----------------------------------------------------------------------------
+// <Trace::Mark>
+// Record a moment in a trace
+//-----------------------------------------------------------------------------
+void Trace::Mark
+(
+	uint32 const _traceId,
+	char const* _name
+)
+{
+	if( ( s_writer != NULL ) && ( _traceId != 0 ) )
+	{
+		WriteEvent( "i", _traceId, 0, _name, GetTime(), 0, "" );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Trace::Span>
+// Record a stage of a trace
+//-----------------------------------------------------------------------------
+void Trace::Span
+(
+	uint32 const _traceId,
+	char const* _name,
+	uint64 const _start,
+	uint64 const _end
+)
+{
+	if( ( s_writer != NULL ) && ( _traceId != 0 ) )
+	{
+		WriteEvent( "X", _traceId, 0, _name, _start, _end - _start, "" );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Trace::WriteMsg>
+// Record the stages of a message
+//-----------------------------------------------------------------------------
+void Trace::WriteMsg
+(
+	uint32 const _traceId,
+	string const& _description,
+	uint64 const* _times,
+	uint32 const _attempts,
+	char const* _outcome
+)
+{
+	if( ( s_writer == NULL ) || ( _traceId == 0 ) )
+	{
+		return;
+	}
+
+	// Each message gets a row of its own, so that its stages nest
+	// properly even when several messages are in flight at once.
+	uint32 lane = Atomic::Add( &s_nextLane, 1 );
+	WriteEvent( "M", _traceId, lane, "thread_name", 0, 0, "\"name\":\"" + EscapeString( _description ) + "\"" );
+
+	uint64 end = GetTime();
+	char args[64];
+	snprintf( args, sizeof(args), "\"attempts\":%u,\"outcome\":\"%s\"", _attempts, _outcome );
+	WriteEvent( "X", _traceId, lane, "message", _times[Stage_Created], end - _times[Stage_Created], args );
+
+	// Each stage lasts until the next one that happened
+	for( int32 i=0; i<Stage_Count; ++i )
+	{
+		if( _times[i] == 0 )
+		{
+			continue;
+		}
+
+		uint64 next = end;
+		for( int32 j=i+1; j<Stage_Count; ++j )
+		{
+			if( _times[j] != 0 )
+			{
+				next = _times[j];
+				break;
+			}
+		}
+
+		char const* name = c_stageNames[i];
+		if( ( i == Stage_Acked ) && ( _times[Stage_Callback] == 0 ) )
+		{
+			// No callback came, so the message was waiting for its reply
+			name = c_stageNames[Stage_Callback];
+		}
+		WriteEvent( "X", _traceId, lane, name, _times[i], next - _times[i], "" );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Trace::GetTime>
+// Read the clock used for traces
+//-----------------------------------------------------------------------------
+uint64 Trace::GetTime
+(
+)
+{
+	return TimeStamp::GetMonotonicTimeMicroseconds();
+}
+
+//-----------------------------------------------------------------------------
+// <Trace::WriteEvent>
+// Write one event in the Chrome trace event format
+//-----------------------------------------------------------------------------
+void Trace::WriteEvent
+(
+	char const* _phase,
+	uint32 const _traceId,
+	uint32 const _lane,
+	string const& _name,
+	uint64 const _start,
+	uint64 const _duration,
+	string const& _args
+)
+{
+	char str[128];
+	string line = "{\"name\":\"" + EscapeString( _name ) + "\",\"cat\":\"ozw\",\"ph\":\"" + _phase + "\"";
+
+	snprintf( str, sizeof(str), ",\"pid\":%u,\"tid\":%u", _traceId, _lane );
+	line += str;
+
+	if( _phase[0] != 'M' )
+	{
+		snprintf( str, sizeof(str), ",\"ts\":%llu", (unsigned long long)_start );
+		line += str;
+	}
+	if( _phase[0] == 'X' )
+	{
+		snprintf( str, sizeof(str), ",\"dur\":%llu", (unsigned long long)_duration );
+		line += str;
+	}
+	if( _phase[0] == 'i' )
+	{
+		line += ",\"s\":\"t\"";
+	}
+	if( !_args.empty() )
+	{
+		line += ",\"args\":{" + _args + "}";
+	}
+	line += "},\n";
+
+	s_writer->Write( line.c_str() );
+}
@@ -0,0 +1,163 @@
+//-----------------------------------------------------------------------------
+//
+//	Trace.h
+//
+//	Timing of commands as they pass through the library
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _Trace_H
+#define _Trace_H
+
+#include <string>
+#include <map>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class LogWriter;
+	class Mutex;
+
+	/** \brief Follows commands through the library, from the application's
+	 * request to the device's confirmation, and records how long each stage took.
+	 *
+	 * An application starts a trace with Begin, which makes it the current trace
+	 * of the calling thread.  Every message created by that thread while the trace
+	 * is current carries its ID, and the driver records when each message was
+	 * queued, sent, acknowledged and so on.  The trace ends when the node that
+	 * the messages were sent to next reports a value.
+	 *
+	 * The trace is written in the Chrome trace event format, which can be viewed
+	 * in chrome://tracing or ui.perfetto.dev.  Each trace is shown as a process,
+	 * with the whole command on its first row and each message on a row of its own.
+	 * Records are written on a thread of their own, so tracing never waits for
+	 * the disk.
+	 */
+	class Trace
+	{
+	public:
+		/** The stages that a message passes through.  The time of each is stored in the message. */
+		enum Stage
+		{
+			Stage_Created = 0,							/**< The message was built */
+			Stage_Queued,								/**< It was added to a send queue */
+			Stage_Dequeued,								/**< It reached the front of the queue */
+			Stage_Sent,									/**< It was first written to the controller */
+			Stage_Acked,								/**< The controller acknowledged it */
+			Stage_Callback,								/**< The controller reported the outcome of the transmission */
+			Stage_Count
+		};
+
+		/**
+		 * Start writing traces.
+		 * \param _filename name of the file to write.  Any existing file is replaced.
+		 * \param _flushInterval milliseconds for which records may be held in memory before being written.
+		 */
+		static void Create( string const& _filename, int32 const _flushInterval );
+
+		/**
+		 * Stop writing traces, and close the file.
+		 */
+		static void Destroy();
+
+		/**
+		 * Test whether traces are being written.
+		 */
+		static bool IsEnabled(){ return( s_writer != NULL ); }
+
+		/**
+		 * Start a new trace, and make it the current trace of the calling thread.
+		 * \param _name description of the command being traced.
+		 * \return the ID of the trace, or zero if tracing is not enabled.
+		 */
+		static uint32 Begin( string const& _name );
+
+		/**
+		 * Finish a trace.  Does nothing if the trace has already finished.
+		 * \param _traceId the trace to finish.
+		 * \param _reason what finished the trace, such as the notification that confirmed the command.
+		 */
+		static void End( uint32 const _traceId, char const* _reason );
+
+		/**
+		 * Get the current trace of the calling thread.
+		 * \return the ID of the trace, or zero if there is none.
+		 */
+		static uint32 GetCurrent();
+
+		/**
+		 * Set the current trace of the calling thread.
+		 * \param _traceId the trace, or zero so that messages are no longer traced.
+		 */
+		static void SetCurrent( uint32 const _traceId );
+
+		/**
+		 * Record a moment in a trace, on the row of the whole command.
+		 * \param _traceId the trace, or zero to do nothing.
+		 * \param _name what happened, which must be a string literal.
+		 */
+		static void Mark( uint32 const _traceId, char const* _name );
+
+		/**
+		 * Record a stage of a trace, on the row of the whole command.
+		 * \param _traceId the trace, or zero to do nothing.
+		 * \param _name what was happening, which must be a string literal.
+		 * \param _start when the stage started, from GetTime.
+		 * \param _end when the stage ended, from GetTime.
+		 */
+		static void Span( uint32 const _traceId, char const* _name, uint64 const _start, uint64 const _end );
+
+		/**
+		 * Record the stages of a message, once it is finished with.
+		 * \param _traceId the trace that the message belongs to, or zero to do nothing.
+		 * \param _description description of the message.
+		 * \param _times the time of each stage, from GetTime, or zero for stages that did not happen.
+		 * \param _attempts number of times the message was sent.
+		 * \param _outcome what happened to the message, such as "complete" or "dropped".
+		 */
+		static void WriteMsg( uint32 const _traceId, string const& _description, uint64 const* _times, uint32 const _attempts, char const* _outcome );
+
+		/**
+		 * Read the clock used for traces.
+		 * \return microseconds on the monotonic clock.
+		 */
+		static uint64 GetTime();
+
+	private:
+		struct OpenTrace
+		{
+			uint64	m_start;
+			string	m_name;
+		};
+
+		static void WriteEvent( char const* _phase, uint32 const _traceId, uint32 const _lane, string const& _name, uint64 const _start, uint64 const _duration, string const& _args );
+
+		static LogWriter*				s_writer;
+		static Mutex*					s_mutex;				// Serialises access to the open traces
+		static map<uint32,OpenTrace>	s_openTraces;			// Traces that have begun but not yet ended
+		static uint32 volatile			s_nextTraceId;
+		static uint32 volatile			s_nextLane;
+	};
+
+} // namespace OpenZWave
+
+#endif // _Trace_H
@@ -0,0 +1,1042 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueLog.cpp
+//
+//	Compact log of value readings that is kept across restarts
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#include <stdio.h>
+#include <string.h>
+#include "Defs.h"
+#include "ValueLog.h"
+#include "Options.h"
+#include "Mutex.h"
+#include "Event.h"
+#include "Thread.h"
+#include "Log.h"
+#include "TimeStamp.h"
+#include "CommandClasses.h"
+#include "Value.h"
+
+using namespace OpenZWave;
+
+//
+// The file starts with a 16 byte header: "OZWVALUE", the format version and the
+// home ID.  Each block that follows has a 40 byte header, then its readings,
+// padded with zeros to a multiple of 8 bytes so that every header is aligned.
+// All integers in the headers are little-endian.
+//
+//		offset	size
+//		0		4		magic number, c_blockMagic
+//		4		4		length of the readings in bytes, not counting the padding
+//		8		4		number of readings
+//		12		4		FNV-1a checksum of the readings
+//		16		8		time of the first reading
+//		24		8		earliest time of any reading
+//		32		8		latest time of any reading
+//
+// Each reading is a sequence of variable-length integers (seven bits to a byte,
+// least significant first, with the top bit set on all but the last byte):
+//
+//		key			slot << 2 for a value already seen in the block, or just 1 for a new one
+//		value ID	only for a new value, as returned by ValueID::GetId
+//		places		a single byte, only if bit 1 of the key is set, when the number of
+//					decimal places differs from the value's previous reading
+//		time		change from the previous reading in the block, zigzag encoded
+//		value		change from the previous reading of the same value, zigzag encoded
+//
+
+static char const		c_fileMagic[8]	= { 'O', 'Z', 'W', 'V', 'A', 'L', 'U', 'E' };
+static uint32 const		c_fileVersion	= 1;
+static uint32 const		c_blockMagic	= 0x4b4c4256;		// "VBLK"
+static int64 const		c_endOfTime		= 0x7fffffffffffffffLL;
+
+//-----------------------------------------------------------------------------
+// <PutUInt32>
+// Store a 32-bit integer in little-endian order
+//-----------------------------------------------------------------------------
+static void PutUInt32
+(
+	uint8* _buffer,
+	uint32 const _value
+)
+{
+	for( int i=0; i<4; ++i )
+	{
+		_buffer[i] = (uint8)( _value >> ( i * 8 ) );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <PutInt64>
+// Store a 64-bit integer in little-endian order
+//-----------------------------------------------------------------------------
+static void PutInt64
+(
+	uint8* _buffer,
+	int64 const _value
+)
+{
+	for( int i=0; i<8; ++i )
+	{
+		_buffer[i] = (uint8)( (uint64)_value >> ( i * 8 ) );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <GetUInt32>
+// Read a 32-bit integer stored in little-endian order
+//-----------------------------------------------------------------------------
+static uint32 GetUInt32
+(
+	uint8 const* _buffer
+)
+{
+	uint32 value = 0;
+	for( int i=3; i>=0; --i )
+	{
+		value = ( value << 8 ) | _buffer[i];
+	}
+	return value;
+}
+
+//-----------------------------------------------------------------------------
+// <GetInt64>
+// Read a 64-bit integer stored in little-endian order
+//-----------------------------------------------------------------------------
+static int64 GetInt64
+(
+	uint8 const* _buffer
+)
+{
+	uint64 value = 0;
+	for( int i=7; i>=0; --i )
+	{
+		value = ( value << 8 ) | _buffer[i];
+	}
+	return (int64)value;
+}
+
+//-----------------------------------------------------------------------------
+// <Checksum>
+// FNV-1a hash of a block's readings
+//-----------------------------------------------------------------------------
+static uint32 Checksum
+(
+	uint8 const* _data,
+	size_t _length
+)
+{
+	uint32 hash = 2166136261u;
+	for( size_t i=0; i<_length; ++i )
+	{
+		hash = ( hash ^ _data[i] ) * 16777619u;
+	}
+	return hash;
+}
+
+//-----------------------------------------------------------------------------
+// <ReadVarInt>
+// Read a variable-length integer, returning false if it runs past the end
+//-----------------------------------------------------------------------------
+static bool ReadVarInt
+(
+	uint8 const* _data,
+	size_t _length,
+	size_t* _pos,
+	uint64* o_value
+)
+{
+	uint64 value = 0;
+	for( uint32 shift=0; ( *_pos < _length ) && ( shift < 64 ); shift += 7 )
+	{
+		uint8 byte = _data[(*_pos)++];
+		value |= (uint64)( byte & 0x7f ) << shift;
+		if( ( byte & 0x80 ) == 0 )
+		{
+			*o_value = value;
+			return true;
+		}
+	}
+	return false;
+}
+
+//-----------------------------------------------------------------------------
+// <ZigZag>
+// Map a signed integer onto an unsigned one, so that small changes in either
+// direction make small numbers
+//-----------------------------------------------------------------------------
+static uint64 ZigZag
+(
+	int64 const _value
+)
+{
+	return( ( (uint64)_value << 1 ) ^ (uint64)( _value >> 63 ) );
+}
+
+//-----------------------------------------------------------------------------
+// <UnZigZag>
+// Undo ZigZag
+//-----------------------------------------------------------------------------
+static int64 UnZigZag
+(
+	uint64 const _value
+)
+{
+	return( (int64)( _value >> 1 ) ^ -(int64)( _value & 1 ) );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Create>
+// Open the log of a network, if the options ask for one
+//-----------------------------------------------------------------------------
+ValueLog* ValueLog::Create
+(
+	uint32 const _homeId
+)
+{
+	string commandClasses;
+	Options::Get()->GetOptionAsString( "ValueLogCommandClasses", &commandClasses );
+	if( commandClasses.empty() )
+	{
+		return NULL;
+	}
+
+	string userPath;
+	Options::Get()->GetOptionAsString( "UserPath", &userPath );
+
+	char str[32];
+	snprintf( str, sizeof(str), "zwvalues_0x%08x.bin", _homeId );
+	return new ValueLog( userPath + str, _homeId );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::ValueLog>
+// Constructor
+//-----------------------------------------------------------------------------
+ValueLog::ValueLog
+(
+	string const& _filename,
+	uint32 const _homeId
+):
+	m_mutex( new Mutex() ),
+	m_compactThread( new Thread( "value log" ) ),
+	m_compactEvent( new Event() ),
+	m_filename( _filename ),
+	m_homeId( _homeId ),
+	m_file( NULL ),
+	m_length( 0 ),
+	m_lastCompacted( TimeStamp::GetMonotonicTime() ),
+	m_genres( 0 )
+{
+	memset( m_commandClasses, 0, sizeof(m_commandClasses) );
+
+	// Both lists are comma-separated, like the Include and Exclude options
+	string list;
+	Options::Get()->GetOptionAsString( "ValueLogCommandClasses", &list );
+	list += ',';
+	for( size_t start = 0, pos; ( pos = list.find( ',', start ) ) != string::npos; start = pos + 1 )
+	{
+		string name = list.substr( start, pos - start );
+		if( name.empty() )
+		{
+			continue;
+		}
+
+		uint8 commandClassId = CommandClasses::GetIdFromName( name );
+		if( commandClassId == 0xff )
+		{
+			Log::Write( LogLevel_Warning, "ValueLogCommandClasses - unknown command class %s", name.c_str() );
+			continue;
+		}
+		m_commandClasses[commandClassId>>5] |= ( 1u << ( commandClassId & 0x1f ) );
+	}
+
+	Options::Get()->GetOptionAsString( "ValueLogGenres", &list );
+	list += ',';
+	for( size_t start = 0, pos; ( pos = list.find( ',', start ) ) != string::npos; start = pos + 1 )
+	{
+		string name = list.substr( start, pos - start );
+		for( int32 genre=0; genre<ValueID::ValueGenre_Count; ++genre )
+		{
+			if( name == Value::GetGenreNameFromEnum( (ValueID::ValueGenre)genre ) )
+			{
+				m_genres |= ( 1u << genre );
+			}
+		}
+	}
+
+	int32 intVal = 0;
+	Options::Get()->GetOptionAsInt( "ValueLogFlushInterval", &intVal );
+	m_flushInterval = ( intVal > 0 ) ? intVal * 1000 : 1000;
+	intVal = 0;
+	Options::Get()->GetOptionAsInt( "ValueLogRetention", &intVal );
+	m_retention = (int64)intVal * 24 * 60 * 60 * 1000;
+	intVal = 0;
+	Options::Get()->GetOptionAsInt( "ValueLogCompactInterval", &intVal );
+	m_compactInterval = (uint64)( ( intVal > 0 ) ? intVal : 1 ) * 60 * 60 * 1000;
+
+	// Check the existing file, so that anything after a damaged block is not lost
+	bool bDamaged = false;
+	if( FILE* file = fopen( m_filename.c_str(), "rb" ) )
+	{
+		long validLength;
+		bDamaged = !ReadFile( file, -1, 0, 0, NULL, NULL, &validLength );
+		m_length = GetFileLength( file );
+		fclose( file );
+	}
+	else if( ( m_file = fopen( m_filename.c_str(), "wb" ) ) != NULL )
+	{
+		WriteFileHeader( m_file, m_homeId );
+		fflush( m_file );
+		m_length = FileHeaderSize;
+	}
+
+	if( bDamaged )
+	{
+		Log::Write( LogLevel_Warning, "Value log %s is damaged - keeping the readings that can be recovered", m_filename.c_str() );
+		Compact( NULL );
+	}
+	else if( m_file == NULL )
+	{
+		m_file = fopen( m_filename.c_str(), "ab" );
+	}
+
+	if( m_file == NULL )
+	{
+		Log::Write( LogLevel_Warning, "Unable to open value log %s", m_filename.c_str() );
+	}
+
+	m_compactThread->Start( ValueLog::CompactThreadEntryPoint, this );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::~ValueLog>
+// Destructor
+//-----------------------------------------------------------------------------
+ValueLog::~ValueLog
+(
+)
+{
+	m_compactThread->Stop();
+	m_compactThread->Release();
+	m_compactEvent->Release();
+
+	m_mutex->Lock();
+	Flush();
+	if( m_file != NULL )
+	{
+		fclose( m_file );
+		m_file = NULL;
+	}
+	m_mutex->Unlock();
+	m_mutex->Release();
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Record>
+// Add the current reading of a value, if its command class and genre are logged
+//-----------------------------------------------------------------------------
+void ValueLog::Record
+(
+	Value const* _value
+)
+{
+	ValueID const& valueId = _value->GetID();
+	if( !IsLogged( valueId ) )
+	{
+		return;
+	}
+
+	ValueDecimal::Fixed value;
+	switch( valueId.GetType() )
+	{
+		case ValueID::ValueType_Decimal:
+		{
+			value = static_cast<ValueDecimal const*>( _value )->GetFixed();
+			break;
+		}
+		case ValueID::ValueType_Bool:
+		case ValueID::ValueType_Byte:
+		case ValueID::ValueType_Short:
+		case ValueID::ValueType_Int:
+		case ValueID::ValueType_List:
+		{
+			double number;
+			if( !_value->GetAsDouble( &number ) )
+			{
+				return;
+			}
+			value = ValueDecimal::Fixed( (int32)number, 0 );
+			break;
+		}
+		default:
+		{
+			return;
+		}
+	}
+	Append( valueId, value );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Record>
+// Add a reading that was not stored in its value
+//-----------------------------------------------------------------------------
+void ValueLog::Record
+(
+	ValueID const& _valueId,
+	ValueDecimal::Fixed const& _reading
+)
+{
+	if( IsLogged( _valueId ) )
+	{
+		Append( _valueId, _reading );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::IsLogged>
+// Check whether readings of a value are logged
+//-----------------------------------------------------------------------------
+bool ValueLog::IsLogged
+(
+	ValueID const& _valueId
+)const
+{
+	uint8 commandClassId = _valueId.GetCommandClassId();
+	return( ( ( m_commandClasses[commandClassId>>5] & ( 1u << ( commandClassId & 0x1f ) ) ) != 0 )
+		&& ( ( m_genres & ( 1u << _valueId.GetGenre() ) ) != 0 ) );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Append>
+// Add a reading to the block being gathered
+//-----------------------------------------------------------------------------
+void ValueLog::Append
+(
+	ValueID const& _valueId,
+	ValueDecimal::Fixed const& _value
+)
+{
+	Reading reading;
+	reading.m_time = TimeStamp::GetWallClockTime();
+	reading.m_valueId = _valueId.GetId();
+	reading.m_value = _value;
+
+	m_mutex->Lock();
+	m_block.Append( reading );
+	if( m_block.IsFull() )
+	{
+		Flush();
+	}
+	m_mutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Service>
+// Write out the readings held in memory, and compact the file if it is due
+//-----------------------------------------------------------------------------
+void ValueLog::Service
+(
+)
+{
+	m_mutex->Lock();
+	Flush();
+	uint64 now = TimeStamp::GetMonotonicTime();
+	if( now - m_lastCompacted >= m_compactInterval )
+	{
+		m_lastCompacted = now;
+		m_compactEvent->Set();
+	}
+	m_mutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Scan>
+// Read the readings from a range of time, including those not yet written
+//-----------------------------------------------------------------------------
+bool ValueLog::Scan
+(
+	int64 const _from,
+	int64 const _to,
+	pfnReadingCallback_t _callback,
+	void* _context
+)
+{
+	// Only take copies under the lock, so that the driver thread is not held
+	// up while the file is read.  Blocks appended after this are not read, and
+	// the open file is unaffected if a compaction replaces it.
+	m_mutex->Lock();
+	Block pending = m_block;
+	long length = m_length;
+	FILE* file = fopen( m_filename.c_str(), "rb" );
+	m_mutex->Unlock();
+
+	bool res = false;
+	if( file != NULL )
+	{
+		long validLength;
+		res = ReadFile( file, length, _from, _to, _callback, _context, &validLength );
+		fclose( file );
+	}
+
+	if( !pending.IsEmpty() )
+	{
+		pending.Decode( _from, _to, _callback, _context );
+	}
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Read>
+// Read the readings from a range of time out of a log file
+//-----------------------------------------------------------------------------
+bool ValueLog::Read
+(
+	string const& _filename,
+	int64 const _from,
+	int64 const _to,
+	pfnReadingCallback_t _callback,
+	void* _context
+)
+{
+	FILE* file = fopen( _filename.c_str(), "rb" );
+	if( file == NULL )
+	{
+		return false;
+	}
+
+	long validLength;
+	bool res = ReadFile( file, -1, _from, _to, _callback, _context, &validLength );
+	fclose( file );
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::ReadFile>
+// Pass the readings from a range of time to a callback, reading only the
+// blocks that cover part of the range.  Only the first _length bytes are
+// read, or the whole file if _length is negative.
+//-----------------------------------------------------------------------------
+bool ValueLog::ReadFile
+(
+	FILE* _file,
+	long const _length,
+	int64 const _from,
+	int64 const _to,
+	pfnReadingCallback_t _callback,
+	void* _context,
+	long* o_validLength
+)
+{
+	*o_validLength = 0;
+
+	long fileLength = ( _length < 0 ) ? GetFileLength( _file ) : _length;
+	if( fileLength < 0 )
+	{
+		return false;
+	}
+	rewind( _file );
+
+	uint8 header[BlockHeaderSize];
+	if( ( fread( header, 1, FileHeaderSize, _file ) != FileHeaderSize )
+		|| memcmp( header, c_fileMagic, sizeof(c_fileMagic) )
+		|| ( GetUInt32( &header[8] ) != c_fileVersion ) )
+	{
+		return false;
+	}
+
+	long pos = FileHeaderSize;
+	vector<uint8> data;
+	while( pos < fileLength )
+	{
+		if( ( fileLength - pos < BlockHeaderSize )
+			|| ( fread( header, 1, BlockHeaderSize, _file ) != BlockHeaderSize )
+			|| ( GetUInt32( &header[0] ) != c_blockMagic ) )
+		{
+			break;
+		}
+
+		uint32 length = GetUInt32( &header[4] );
+		uint32 paddedLength = ( length + 7 ) & ~7u;
+		if( ( length == 0 ) || ( (uint32)( fileLength - pos - BlockHeaderSize ) < paddedLength ) )
+		{
+			break;
+		}
+
+		int64 min = GetInt64( &header[24] );
+		int64 max = GetInt64( &header[32] );
+		if( ( max < _from ) || ( min >= _to ) )
+		{
+			// Nothing wanted from this block
+			if( fseek( _file, (long)paddedLength, SEEK_CUR ) != 0 )
+			{
+				break;
+			}
+		}
+		else
+		{
+			data.resize( paddedLength );
+			if( ( fread( &data[0], 1, paddedLength, _file ) != paddedLength )
+				|| ( Checksum( &data[0], length ) != GetUInt32( &header[12] ) ) )
+			{
+				break;
+			}
+			Decode( &data[0], length, GetInt64( &header[16] ), _from, _to, _callback, _context );
+		}
+
+		pos += BlockHeaderSize + paddedLength;
+	}
+
+	*o_validLength = pos;
+	return( pos == fileLength );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Decode>
+// Pass the readings in a block that fall in a range of time to a callback
+//-----------------------------------------------------------------------------
+void ValueLog::Decode
+(
+	uint8 const* _data,
+	size_t _length,
+	int64 const _start,
+	int64 const _from,
+	int64 const _to,
+	pfnReadingCallback_t _callback,
+	void* _context
+)
+{
+	vector<Slot> slots;
+	Reading reading;
+	reading.m_time = _start;
+
+	size_t pos = 0;
+	while( pos < _length )
+	{
+		uint64 key;
+		if( !ReadVarInt( _data, _length, &pos, &key ) )
+		{
+			return;
+		}
+
+		size_t index = (size_t)( key >> 2 );
+		if( key & 1 )
+		{
+			Slot slot;
+			slot.m_value = 0;
+			slot.m_places = 0;
+			if( !ReadVarInt( _data, _length, &pos, &slot.m_valueId ) )
+			{
+				return;
+			}
+			index = slots.size();
+			slots.push_back( slot );
+		}
+		else if( index >= slots.size() )
+		{
+			return;
+		}
+
+		Slot& slot = slots[index];
+		if( key & 2 )
+		{
+			if( pos >= _length )
+			{
+				return;
+			}
+			slot.m_places = _data[pos++];
+		}
+
+		uint64 timeChange;
+		uint64 valueChange;
+		if( !ReadVarInt( _data, _length, &pos, &timeChange ) || !ReadVarInt( _data, _length, &pos, &valueChange ) )
+		{
+			return;
+		}
+		reading.m_time += UnZigZag( timeChange );
+		slot.m_value = (int32)( slot.m_value + UnZigZag( valueChange ) );
+
+		if( ( reading.m_time >= _from ) && ( reading.m_time < _to ) )
+		{
+			reading.m_valueId = slot.m_valueId;
+			reading.m_value = ValueDecimal::Fixed( slot.m_value, slot.m_places );
+			_callback( reading, _context );
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::WriteFileHeader>
+// Start a new log file
+//-----------------------------------------------------------------------------
+bool ValueLog::WriteFileHeader
+(
+	FILE* _file,
+	uint32 const _homeId
+)
+{
+	uint8 header[FileHeaderSize];
+	memcpy( header, c_fileMagic, sizeof(c_fileMagic) );
+	PutUInt32( &header[8], c_fileVersion );
+	PutUInt32( &header[12], _homeId );
+	return( fwrite( header, 1, FileHeaderSize, _file ) == FileHeaderSize );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::GetFileLength>
+// Get the length of an open file, or -1 if it cannot be found
+//-----------------------------------------------------------------------------
+long ValueLog::GetFileLength
+(
+	FILE* _file
+)
+{
+	if( fseek( _file, 0, SEEK_END ) != 0 )
+	{
+		return -1;
+	}
+	return ftell( _file );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::CopyBlocks>
+// Append a range of a log file, which must hold whole blocks, to another file
+//-----------------------------------------------------------------------------
+bool ValueLog::CopyBlocks
+(
+	string const& _filename,
+	long const _from,
+	long const _to,
+	FILE* _dest
+)
+{
+	FILE* file = fopen( _filename.c_str(), "rb" );
+	if( file == NULL )
+	{
+		return false;
+	}
+
+	bool res = ( fseek( file, _from, SEEK_SET ) == 0 );
+	uint8 data[BlockSize];
+	for( long pos = _from; res && ( pos < _to ); )
+	{
+		size_t count = ( _to - pos < (long)BlockSize ) ? (size_t)( _to - pos ) : (size_t)BlockSize;
+		res = ( fread( data, 1, count, file ) == count ) && ( fwrite( data, 1, count, _dest ) == count );
+		pos += (long)count;
+	}
+	fclose( file );
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Flush>
+// Append the readings held in memory to the file.  The caller must hold m_mutex.
+//-----------------------------------------------------------------------------
+void ValueLog::Flush
+(
+)
+{
+	if( m_block.IsEmpty() )
+	{
+		return;
+	}
+
+	if( ( m_file == NULL ) || !m_block.Write( m_file ) || ( fflush( m_file ) != 0 ) )
+	{
+		Log::Write( LogLevel_Warning, "Unable to write to value log %s - readings have been lost", m_filename.c_str() );
+	}
+	if( m_file != NULL )
+	{
+		m_length = ftell( m_file );
+	}
+	m_block.Clear();
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Compact>
+// Rewrite the file without readings that are past their retention time, and
+// with the rest packed into full blocks.  The new file is written without
+// holding m_mutex, so that readings can still be logged in the meantime, and
+// the lock is only taken to swap it in.
+//-----------------------------------------------------------------------------
+bool ValueLog::Compact
+(
+	Event* _exitEvent
+)
+{
+	string newFilename = m_filename + ".new";
+	CompactContext context;
+	context.m_exitEvent = _exitEvent;
+	context.m_file = fopen( newFilename.c_str(), "wb" );
+	if( context.m_file == NULL )
+	{
+		Log::Write( LogLevel_Warning, "Unable to compact value log %s", m_filename.c_str() );
+		return false;
+	}
+
+	// Compact the file as it is now.  Blocks written after this are copied across unchanged when the files are swapped.
+	m_mutex->Lock();
+	Flush();
+	long length = m_length;
+	FILE* file = fopen( m_filename.c_str(), "rb" );
+	m_mutex->Unlock();
+
+	int64 from = ( m_retention > 0 ) ? TimeStamp::GetWallClockTime() - m_retention : 0;
+	context.m_bOk = ( file != NULL ) && WriteFileHeader( context.m_file, m_homeId );
+	if( file != NULL )
+	{
+		long validLength;
+		ReadFile( file, length, from, c_endOfTime, CompactCallback, &context, &validLength );
+		fclose( file );
+	}
+	if( context.m_bOk && !context.m_block.IsEmpty() )
+	{
+		context.m_bOk = context.m_block.Write( context.m_file );
+	}
+
+	m_mutex->Lock();
+	Flush();
+	if( context.m_bOk && ( m_length > length ) )
+	{
+		context.m_bOk = CopyBlocks( m_filename, length, m_length, context.m_file );
+	}
+	if( fclose( context.m_file ) != 0 )
+	{
+		context.m_bOk = false;
+	}
+
+	// The file is reopened afterwards, since it cannot be replaced while open on some platforms
+	if( m_file != NULL )
+	{
+		fclose( m_file );
+		m_file = NULL;
+	}
+
+	if( context.m_bOk )
+	{
+		remove( m_filename.c_str() );
+		context.m_bOk = ( rename( newFilename.c_str(), m_filename.c_str() ) == 0 );
+	}
+	if( !context.m_bOk )
+	{
+		Log::Write( LogLevel_Warning, "Unable to compact value log %s", m_filename.c_str() );
+		remove( newFilename.c_str() );
+	}
+
+	m_file = fopen( m_filename.c_str(), "ab" );
+	m_length = ( m_file != NULL ) ? GetFileLength( m_file ) : 0;
+	m_mutex->Unlock();
+	return context.m_bOk;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::CompactCallback>
+// Copy a reading into the compacted file
+//-----------------------------------------------------------------------------
+void ValueLog::CompactCallback
+(
+	Reading const& _reading,
+	void* _context
+)
+{
+	CompactContext* context = (CompactContext*)_context;
+	context->m_block.Append( _reading );
+	if( context->m_block.IsFull() )
+	{
+		if( context->m_bOk && ( context->m_exitEvent != NULL ) && ( Wait::Single( context->m_exitEvent, 0 ) == 0 ) )
+		{
+			// The log is being closed, so give up
+			context->m_bOk = false;
+		}
+		if( context->m_bOk )
+		{
+			context->m_bOk = context->m_block.Write( context->m_file );
+		}
+		context->m_block.Clear();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::CompactThreadEntryPoint>
+// Entry point of the thread that compacts the file
+//-----------------------------------------------------------------------------
+void ValueLog::CompactThreadEntryPoint
+(
+	Event* _exitEvent,
+	void* _context
+)
+{
+	ValueLog* valueLog = (ValueLog*)_context;
+	if( valueLog )
+	{
+		valueLog->CompactThreadProc( _exitEvent );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::CompactThreadProc>
+// Compact the file each time Service finds that it is due
+//-----------------------------------------------------------------------------
+void ValueLog::CompactThreadProc
+(
+	Event* _exitEvent
+)
+{
+	Wait* waitObjects[2];
+	waitObjects[0] = _exitEvent;
+	waitObjects[1] = m_compactEvent;
+
+	while( Wait::Multiple( waitObjects, 2 ) != 0 )
+	{
+		m_compactEvent->Reset();
+		Compact( _exitEvent );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Block::Clear>
+// Empty the block, ready for the next one
+//-----------------------------------------------------------------------------
+void ValueLog::Block::Clear
+(
+)
+{
+	m_data.clear();
+	m_slots.clear();
+	m_slotMap.clear();
+	m_start = 0;
+	m_end = 0;
+	m_min = 0;
+	m_max = 0;
+	m_count = 0;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Block::Append>
+// Encode a reading onto the end of the block
+//-----------------------------------------------------------------------------
+void ValueLog::Block::Append
+(
+	Reading const& _reading
+)
+{
+	uint64 key;
+	uint32 index;
+	map<uint64,uint32>::iterator it = m_slotMap.find( _reading.m_valueId );
+	if( it == m_slotMap.end() )
+	{
+		Slot slot;
+		slot.m_valueId = _reading.m_valueId;
+		slot.m_value = 0;
+		slot.m_places = 0;
+
+		index = (uint32)m_slots.size();
+		m_slots.push_back( slot );
+		m_slotMap[_reading.m_valueId] = index;
+		key = 1;
+	}
+	else
+	{
+		index = it->second;
+		key = (uint64)index << 2;
+	}
+
+	Slot& slot = m_slots[index];
+	if( _reading.m_value.m_places != slot.m_places )
+	{
+		key |= 2;
+	}
+
+	if( m_count == 0 )
+	{
+		m_start = m_end = m_min = m_max = _reading.m_time;
+	}
+
+	AppendVarInt( key );
+	if( key & 1 )
+	{
+		AppendVarInt( _reading.m_valueId );
+	}
+	if( key & 2 )
+	{
+		m_data.push_back( _reading.m_value.m_places );
+		slot.m_places = _reading.m_value.m_places;
+	}
+	AppendVarInt( ZigZag( _reading.m_time - m_end ) );
+	AppendVarInt( ZigZag( (int64)_reading.m_value.m_value - slot.m_value ) );
+	slot.m_value = _reading.m_value.m_value;
+
+	m_end = _reading.m_time;
+	if( _reading.m_time < m_min )
+	{
+		m_min = _reading.m_time;
+	}
+	if( _reading.m_time > m_max )
+	{
+		m_max = _reading.m_time;
+	}
+	++m_count;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Block::Write>
+// Write the block, with its header and padding, in a single call
+//-----------------------------------------------------------------------------
+bool ValueLog::Block::Write
+(
+	FILE* _file
+)const
+{
+	uint32 length = (uint32)m_data.size();
+	uint32 paddedLength = ( length + 7 ) & ~7u;
+
+	vector<uint8> buffer( BlockHeaderSize + paddedLength, 0 );
+	PutUInt32( &buffer[0], c_blockMagic );
+	PutUInt32( &buffer[4], length );
+	PutUInt32( &buffer[8], m_count );
+	PutUInt32( &buffer[12], Checksum( &m_data[0], length ) );
+	PutInt64( &buffer[16], m_start );
+	PutInt64( &buffer[24], m_min );
+	PutInt64( &buffer[32], m_max );
+	memcpy( &buffer[BlockHeaderSize], &m_data[0], length );
+
+	return( fwrite( &buffer[0], 1, buffer.size(), _file ) == buffer.size() );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueLog::Block::AppendVarInt>
+// Encode an integer in as few bytes as it needs
+//-----------------------------------------------------------------------------
+void ValueLog::Block::AppendVarInt
+(
+	uint64 _value
+)
+{
+	while( _value >= 0x80 )
+	{
+		m_data.push_back( (uint8)( _value | 0x80 ) );
+		_value >>= 7;
+	}
+	m_data.push_back( (uint8)_value );
+}
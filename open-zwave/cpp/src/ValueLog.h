@@ -0,0 +1,231 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueLog.h
+//
+//	Compact log of value readings that is kept across restarts
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+#ifndef _ValueLog_H
+#define _ValueLog_H
+
+#include <stdio.h>
+#include <string>
+#include <map>
+#include <vector>
+#include "Defs.h"
+#include "ValueDecimal.h"
+
+namespace OpenZWave
+{
+	class Mutex;
+	class Event;
+	class Thread;
+	class Value;
+
+	/** \brief An append-only binary file holding the readings of selected values,
+	 * so that meter and sensor data survives a restart without bloating the
+	 * XML configuration.
+	 *
+	 * There is one file per network, named zwvalues_0x<home id>.bin and kept in
+	 * the user path.  Only values of the command classes listed in the
+	 * ValueLogCommandClasses option, and the genres in ValueLogGenres, are logged.
+	 *
+	 * Readings are collected in memory into blocks of a few kilobytes, and each
+	 * block is appended to the file in one write once it is full, or once it has
+	 * waited ValueLogFlushInterval seconds, so the file is written rarely and in
+	 * large pieces.  Within a block, each reading is stored as the change in time
+	 * and value from the previous reading of the same value, as variable-length
+	 * integers, so a typical meter reading takes five or six bytes.  Every block
+	 * starts with a fixed-size header giving its length and the range of times it
+	 * covers, so a reader can skip straight past blocks outside the range it wants.
+	 *
+	 * The file is compacted every ValueLogCompactInterval hours: readings older
+	 * than ValueLogRetention days are dropped, and the rest are rewritten into full
+	 * blocks.  The new file is written by a thread of its own, and the driver thread
+	 * is only held up while it is swapped in.  A damaged block at the end of the file, such as one left by a power
+	 * failure part-way through a write, is removed the same way when the file is opened.
+	 *
+	 * The log belongs to a driver.  Readings are recorded on the driver thread, and
+	 * may be read from any thread.
+	 */
+	class ValueLog
+	{
+	public:
+		/** \brief One reading, as passed to a pfnReadingCallback_t.
+		 */
+		struct Reading
+		{
+			int64				m_time;				/**< Wall-clock time in milliseconds (see TimeStamp::GetWallClockTime) */
+			uint64				m_valueId;			/**< The value, as returned by ValueID::GetId */
+			ValueDecimal::Fixed	m_value;			/**< The reading.  Only decimals have decimal places, and lists give the index of the selected item. */
+		};
+
+		typedef void (*pfnReadingCallback_t)( Reading const& _reading, void* _context );
+
+		/**
+		 * Open the log of a network, if the options ask for one.
+		 * \param _homeId the network.
+		 * \return the log, or NULL if no values are to be logged.
+		 */
+		static ValueLog* Create( uint32 const _homeId );
+
+		/**
+		 * Destructor.
+		 * Writes out any readings still held in memory and closes the file.
+		 */
+		~ValueLog();
+
+		/**
+		 * Add the current reading of a value, if its command class and genre are logged.
+		 * \param _value the value, which has just been refreshed.
+		 */
+		void Record( Value const* _value );
+
+		/**
+		 * Add a reading that has not been stored in its value, if the value's command class and genre are logged.
+		 * \param _valueId the value.
+		 * \param _reading the reading.
+		 */
+		void Record( ValueID const& _valueId, ValueDecimal::Fixed const& _reading );
+
+		/**
+		 * Write out the readings held in memory, and compact the file if it is due.  Called every GetServiceInterval milliseconds.
+		 */
+		void Service();
+
+		/**
+		 * Get the number of milliseconds between calls to Service.
+		 */
+		int32 GetServiceInterval()const{ return m_flushInterval; }
+
+		/**
+		 * Read the readings from a range of time, including those not yet written
+		 * to the file.  Readings are passed to the callback oldest block first, but
+		 * may be slightly out of order if the wall clock has been changed.
+		 * \param _from the start of the range.
+		 * \param _to the end of the range, which is not included.
+		 * \param _callback called once for each reading.
+		 * \param _context passed to the callback.
+		 * \return false if the file could not be read.
+		 */
+		bool Scan( int64 const _from, int64 const _to, pfnReadingCallback_t _callback, void* _context );
+
+		/**
+		 * Read the readings from a range of time out of a log file, for example in a separate tool.
+		 * \param _filename name of the file to read.
+		 * \param _from the start of the range.
+		 * \param _to the end of the range, which is not included.
+		 * \param _callback called once for each reading.
+		 * \param _context passed to the callback.
+		 * \return false if the file could not be opened, or is damaged.  Readings from
+		 * before the damage are still passed to the callback.
+		 */
+		static bool Read( string const& _filename, int64 const _from, int64 const _to, pfnReadingCallback_t _callback, void* _context );
+
+	private:
+		ValueLog( string const& _filename, uint32 const _homeId );
+		ValueLog( ValueLog const& );					// prevent copy
+		ValueLog& operator = ( ValueLog const& );		// prevent assignment
+
+		enum
+		{
+			FileHeaderSize		= 16,
+			BlockHeaderSize		= 40,
+			BlockSize			= 4096					// Blocks are written once their readings take this many bytes
+		};
+
+		struct Slot
+		{
+			uint64	m_valueId;
+			int32	m_value;							// The last reading of the value, which the next is stored relative to
+			uint8	m_places;
+		};
+
+		/** \brief Readings being gathered into a block, encoded as they arrive.
+		 */
+		class Block
+		{
+		public:
+			Block(){ Clear(); }
+
+			void Clear();
+			bool IsEmpty()const{ return( m_count == 0 ); }
+			bool IsFull()const{ return( m_data.size() >= BlockSize ); }
+			void Append( Reading const& _reading );
+			bool Write( FILE* _file )const;
+			void Decode( int64 const _from, int64 const _to, pfnReadingCallback_t _callback, void* _context )const{ ValueLog::Decode( &m_data[0], m_data.size(), m_start, _from, _to, _callback, _context ); }
+
+		private:
+			void AppendVarInt( uint64 _value );
+
+			vector<uint8>		m_data;
+			vector<Slot>		m_slots;				// Each value in the block, in order of first appearance
+			map<uint64,uint32>	m_slotMap;				// Index of each value's slot
+			int64				m_start;				// Time of the first reading
+			int64				m_end;					// Time of the latest reading
+			int64				m_min;
+			int64				m_max;
+			uint32				m_count;
+		};
+
+		struct CompactContext
+		{
+			FILE*	m_file;
+			Block	m_block;
+			Event*	m_exitEvent;							// Compaction is abandoned once this is signalled
+			bool	m_bOk;
+		};
+
+		static bool ReadFile( FILE* _file, long const _length, int64 const _from, int64 const _to, pfnReadingCallback_t _callback, void* _context, long* o_validLength );
+		static long GetFileLength( FILE* _file );
+		static bool CopyBlocks( string const& _filename, long const _from, long const _to, FILE* _dest );
+		static void Decode( uint8 const* _data, size_t _length, int64 const _start, int64 const _from, int64 const _to, pfnReadingCallback_t _callback, void* _context );
+		static bool WriteFileHeader( FILE* _file, uint32 const _homeId );
+		static void CompactCallback( Reading const& _reading, void* _context );
+		static void CompactThreadEntryPoint( Event* _exitEvent, void* _context );
+		void CompactThreadProc( Event* _exitEvent );
+
+		bool IsLogged( ValueID const& _valueId )const;
+		void Append( ValueID const& _valueId, ValueDecimal::Fixed const& _value );
+		void Flush();
+		bool Compact( Event* _exitEvent );
+
+		Mutex*			m_mutex;							// Serialises access to the file and the block below
+		Thread*			m_compactThread;
+		Event*			m_compactEvent;						// Signalled when the file is due to be compacted
+		string			m_filename;
+		uint32			m_homeId;
+		FILE*			m_file;
+		long			m_length;							// Bytes in the file, up to the end of the last block written
+		Block			m_block;							// Readings not yet written to the file
+		uint64			m_lastCompacted;					// When the file was last compacted (monotonic milliseconds)
+		uint32			m_commandClasses[8];				// One bit for each command class that is logged
+		uint32			m_genres;							// One bit for each genre that is logged
+		int32			m_flushInterval;					// Milliseconds that readings may be held in memory
+		int64			m_retention;						// Milliseconds that readings are kept in the file
+		uint64			m_compactInterval;					// Milliseconds between compactions
+	};
+
+} // namespace OpenZWave
+
+#endif // _ValueLog_H
@@ -109,18 +109,16 @@ bool Alarm::HandleMsg
 	if (AlarmCmd_Report == (AlarmCmd)_data[0])
 	{
 		// We have received a report from the Z-Wave device
-		Log::Write( LogLevel_Info, GetNodeId(), "Received Alarm report: type=%d, level=%d", _data[1], _data[2] );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Alarm report: type=%d, level=%d", _data[1], _data[2] );
 
 		ValueByte* value;
-		if( (value = static_cast<ValueByte*>( GetValue( _instance, AlarmIndex_Type ) )) )
+		if( (value = static_cast<ValueByte*>( BorrowValue( _instance, AlarmIndex_Type ) )) )
 		{
 			value->OnValueRefreshed( _data[1] );
-			value->Release();
 		}
-		if( (value = static_cast<ValueByte*>( GetValue( _instance, AlarmIndex_Level ) )) )
+		if( (value = static_cast<ValueByte*>( BorrowValue( _instance, AlarmIndex_Level ) )) )
 		{
 			value->OnValueRefreshed( _data[2] );
-			value->Release();
 		}
 		return true;
 	}
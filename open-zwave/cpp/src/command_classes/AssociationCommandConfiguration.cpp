@@ -145,44 +145,39 @@ bool AssociationCommandConfiguration::HandleMsg
 		int16 numFreeCommands			= (((int16)_data[2])<<16) | (int16)_data[3];
 		int16 maxCommands				= (((int16)_data[4])<<16) | (int16)_data[5];
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received AssociationCommandConfiguration Supported Records Report:" );
-		Log::Write( LogLevel_Info, GetNodeId(), "    Maximum command length = %d bytes", maxCommandLength );
-		Log::Write( LogLevel_Info, GetNodeId(), "    Maximum number of commands = %d", maxCommands );
-		Log::Write( LogLevel_Info, GetNodeId(), "    Number of free commands = %d", numFreeCommands );
-		Log::Write( LogLevel_Info, GetNodeId(), "    Commands are %s and are %s", commandsAreValues ? "values" : "not values", commandsAreConfigurable ? "configurable" : "not configurable" );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received AssociationCommandConfiguration Supported Records Report:" );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Maximum command length = %d bytes", maxCommandLength );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Maximum number of commands = %d", maxCommands );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Number of free commands = %d", numFreeCommands );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Commands are %s and are %s", commandsAreValues ? "values" : "not values", commandsAreConfigurable ? "configurable" : "not configurable" );
 
 		ValueBool* valueBool;
 		ValueByte* valueByte;
 		ValueShort* valueShort;
 
-		if( (valueByte = static_cast<ValueByte*>( GetValue( _instance, AssociationCommandConfigurationIndex_MaxCommandLength ) )) )
+		if( (valueByte = static_cast<ValueByte*>( BorrowValue( _instance, AssociationCommandConfigurationIndex_MaxCommandLength ) )) )
 		{
 			valueByte->OnValueRefreshed( maxCommandLength );
-			valueByte->Release();
 		}
 
-		if( (valueBool = static_cast<ValueBool*>( GetValue( _instance, AssociationCommandConfigurationIndex_CommandsAreValues ) )) )
+		if( (valueBool = static_cast<ValueBool*>( BorrowValue( _instance, AssociationCommandConfigurationIndex_CommandsAreValues ) )) )
 		{
 			valueBool->OnValueRefreshed( commandsAreValues );
-			valueBool->Release();
 		}
 
-		if( (valueBool = static_cast<ValueBool*>( GetValue( _instance, AssociationCommandConfigurationIndex_CommandsAreConfigurable ) )) )
+		if( (valueBool = static_cast<ValueBool*>( BorrowValue( _instance, AssociationCommandConfigurationIndex_CommandsAreConfigurable ) )) )
 		{
 			valueBool->OnValueRefreshed( commandsAreConfigurable );
-			valueBool->Release();
 		}
 
-		if( (valueShort = static_cast<ValueShort*>( GetValue( _instance, AssociationCommandConfigurationIndex_NumFreeCommands ) )) )
+		if( (valueShort = static_cast<ValueShort*>( BorrowValue( _instance, AssociationCommandConfigurationIndex_NumFreeCommands ) )) )
 		{
 			valueShort->OnValueRefreshed( numFreeCommands );
-			valueShort->Release();
 		}
 
-		if( (valueShort = static_cast<ValueShort*>( GetValue( _instance, AssociationCommandConfigurationIndex_MaxCommands ) )) )
+		if( (valueShort = static_cast<ValueShort*>( BorrowValue( _instance, AssociationCommandConfigurationIndex_MaxCommands ) )) )
 		{
 			valueShort->OnValueRefreshed( maxCommands );
-			valueShort->Release();
 		}
 		return true;
 	}
@@ -194,8 +189,8 @@ bool AssociationCommandConfiguration::HandleMsg
 		bool  firstReports	= ( ( _data[3] & 0x80 ) != 0 );		// True if this is the first message containing commands for this group and node.
 		uint8 numReports	= _data[3] & 0x0f;
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received AssociationCommandConfiguration Report from:" );
-		Log::Write( LogLevel_Info, GetNodeId(), "    Commands for node %d in group %d,", nodeIdx, groupIdx );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received AssociationCommandConfiguration Report from:" );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Commands for node %d in group %d,", nodeIdx, groupIdx );
 
 		if( Node* node = GetNodeUnsafe() )
 		{
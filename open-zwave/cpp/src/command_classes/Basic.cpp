@@ -102,11 +102,10 @@ bool Basic::HandleMsg
 	if( BasicCmd_Report == (BasicCmd)_data[0] )
 	{
 		// Level
-		Log::Write( LogLevel_Info, GetNodeId(), "Received Basic report from node %d: level=%d", GetNodeId(), _data[1] );
-		if( ValueByte* value = static_cast<ValueByte*>( GetValue( _instance, 0 ) ) )
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Basic report from node %d: level=%d", GetNodeId(), _data[1] );
+		if( ValueByte* value = static_cast<ValueByte*>( BorrowValue( _instance, 0 ) ) )
 		{
 			value->OnValueRefreshed( _data[1] );
-			value->Release();
 		}
 		return true;
 	}
@@ -114,7 +113,7 @@ bool Basic::HandleMsg
 	if( BasicCmd_Set == (BasicCmd)_data[0] )
 	{
 		// Commmand received from the node.  Handle as a notification event
-		Log::Write( LogLevel_Info, GetNodeId(), "Received Basic set from node %d: level=%d.  Sending event notification.", GetNodeId(), _data[1] );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Basic set from node %d: level=%d.  Sending event notification.", GetNodeId(), _data[1] );
 
 		Notification* notification = new Notification( Notification::Type_NodeEvent );
 		notification->SetHomeNodeIdAndInstance( GetHomeId(), GetNodeId(), _instance );
@@ -139,7 +138,7 @@ bool Basic::SetValue
 	{
 		ValueByte const* value = static_cast<ValueByte const*>(&_value);
 	
-		Log::Write( LogLevel_Info, GetNodeId(), "Basic::Set - Setting node %d to level %d", GetNodeId(), value->GetValue() );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Basic::Set - Setting node %d to level %d", GetNodeId(), value->GetValue() );
 		Msg* msg = new Msg( "Basic Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );		
 		msg->SetInstance( this, _value.GetID().GetInstance() );
 		msg->Append( GetNodeId() );
@@ -205,7 +204,7 @@ bool Basic::SetMapping
 		{
 			if( CommandClass* cc = node->GetCommandClass( _commandClassId ) )
 			{
-				Log::Write( LogLevel_Info, GetNodeId(), "    COMMAND_CLASS_BASIC will be mapped to %s", cc->GetCommandClassName().c_str() );
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    COMMAND_CLASS_BASIC will be mapped to %s", cc->GetCommandClassName().c_str() );
 				m_mapping = _commandClassId;
 				res = true;
 			}
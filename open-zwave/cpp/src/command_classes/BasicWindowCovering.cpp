@@ -70,7 +70,7 @@ bool BasicWindowCovering::SetValue
 
 		if( button && button->IsPressed() )
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "BasicWindowCovering - Start Level Change (%s)", action ? "Open" : "Close" );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "BasicWindowCovering - Start Level Change (%s)", action ? "Open" : "Close" );
 			Msg* msg = new Msg( "Basic Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );		
 			msg->SetInstance( this, _value.GetID().GetInstance() );
 			msg->Append( GetNodeId() );
@@ -84,7 +84,7 @@ bool BasicWindowCovering::SetValue
 		}
 		else
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "BasicWindowCovering - Stop Level Change" );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "BasicWindowCovering - Stop Level Change" );
 			Msg* msg = new Msg( "Basic Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );		
 			msg->SetInstance( this, _value.GetID().GetInstance() );
 			msg->Append( GetNodeId() );
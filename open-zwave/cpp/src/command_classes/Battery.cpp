@@ -111,12 +111,11 @@ bool Battery::HandleMsg
 			batteryLevel = 0;
 		}
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received Battery report from node %d: level=%d", GetNodeId(), batteryLevel );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Battery report from node %d: level=%d", GetNodeId(), batteryLevel );
 
-		if( ValueByte* value = static_cast<ValueByte*>( GetValue( _instance, 0 ) ) )
+		if( ValueByte* value = static_cast<ValueByte*>( BorrowValue( _instance, 0 ) ) )
 		{
 			value->OnValueRefreshed( batteryLevel );
-			value->Release();
 		}
 		return true;
 	}
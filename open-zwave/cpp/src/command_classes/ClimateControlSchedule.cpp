@@ -170,9 +170,9 @@ bool ClimateControlSchedule::HandleMsg
 	{
 		uint8 day = _data[1] & 0x07;
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received climate control schedule report for %s", c_dayNames[day] );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received climate control schedule report for %s", c_dayNames[day] );
 
-		if( ValueSchedule* value = static_cast<ValueSchedule*>( GetValue( _instance, day ) ) )
+		if( ValueSchedule* value = static_cast<ValueSchedule*>( BorrowValue( _instance, day ) ) )
 		{
 			// Remove any existing data
 			value->ClearSwitchPoints();
@@ -192,15 +192,15 @@ bool ClimateControlSchedule::HandleMsg
 
 				if( setback == 0x79 )
 				{
-					Log::Write( LogLevel_Info, GetNodeId(), "  Switch point at %02d:%02d, Frost Protection Mode", hours, minutes, c_dayNames[day] );				
+					Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Switch point at %02d:%02d, Frost Protection Mode", hours, minutes, c_dayNames[day] );				
 				}
 				else if( setback == 0x7a )
 				{
-					Log::Write( LogLevel_Info, GetNodeId(), "  Switch point at %02d:%02d, Energy Saving Mode", hours, minutes, c_dayNames[day] );				
+					Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Switch point at %02d:%02d, Energy Saving Mode", hours, minutes, c_dayNames[day] );				
 				}
 				else
 				{
-					Log::Write( LogLevel_Info, GetNodeId(), "  Switch point at %02d:%02d, Setback %+.1fC", hours, minutes, ((float)setback)*0.1f );
+					Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Switch point at %02d:%02d, Setback %+.1fC", hours, minutes, ((float)setback)*0.1f );
 				}
 
 				value->SetSwitchPoint( hours, minutes, setback );
@@ -208,12 +208,11 @@ bool ClimateControlSchedule::HandleMsg
 
 			if( !value->GetNumSwitchPoints() )
 			{
-				Log::Write( LogLevel_Info, GetNodeId(), "  No Switch points have been set" );		
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  No Switch points have been set" );		
 			}
 
 			// Notify the user
 			value->OnValueRefreshed();
-			value->Release();
 		}
 
 		return true;
@@ -221,7 +220,7 @@ bool ClimateControlSchedule::HandleMsg
 
 	if( ClimateControlScheduleCmd_ChangedReport == (ClimateControlScheduleCmd)_data[0] )
 	{
-		Log::Write( LogLevel_Info, GetNodeId(), "Received climate control schedule changed report:" );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received climate control schedule changed report:" );
 
 		if( _data[1] )
 		{
@@ -264,13 +263,12 @@ bool ClimateControlSchedule::HandleMsg
 	{
 		uint8 overrideState = _data[1] & 0x03;
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received climate control schedule override report:" );
-		Log::Write( LogLevel_Info, GetNodeId(), "  Override State: %s:", c_overrideStateNames[overrideState] );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received climate control schedule override report:" );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Override State: %s:", c_overrideStateNames[overrideState] );
 
-		if( ValueList* valueList = static_cast<ValueList*>( GetValue( _instance, ClimateControlScheduleIndex_OverrideState ) ) )
+		if( ValueList* valueList = static_cast<ValueList*>( BorrowValue( _instance, ClimateControlScheduleIndex_OverrideState ) ) )
 		{
 			valueList->OnValueRefreshed( (int)overrideState );
-			valueList->Release();
 		}
 
 		uint8 setback = _data[2];
@@ -278,22 +276,21 @@ bool ClimateControlSchedule::HandleMsg
 		{
 			if( setback == 0x79 )
 			{
-				Log::Write( LogLevel_Info, GetNodeId(), "  Override Setback: Frost Protection Mode" );				
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Override Setback: Frost Protection Mode" );				
 			}
 			else if( setback == 0x7a )
 			{
-				Log::Write( LogLevel_Info, GetNodeId(), "  Override Setback: Energy Saving Mode" );				
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Override Setback: Energy Saving Mode" );				
 			}
 			else
 			{
-				Log::Write( LogLevel_Info, GetNodeId(), "  Override Setback: %+.1fC", ((float)setback)*0.1f );
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Override Setback: %+.1fC", ((float)setback)*0.1f );
 			}
 		}
 
-		if( ValueByte* valueByte = static_cast<ValueByte*>( GetValue( _instance, ClimateControlScheduleIndex_OverrideSetback ) ) )
+		if( ValueByte* valueByte = static_cast<ValueByte*>( BorrowValue( _instance, ClimateControlScheduleIndex_OverrideSetback ) ) )
 		{
 			valueByte->OnValueRefreshed( setback );
-			valueByte->Release();
 		}
 
 		return true;
@@ -123,23 +123,20 @@ bool Clock::HandleMsg
 		uint8 hour = _data[1] & 0x1f;
 		uint8 minute = _data[2];
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received Clock report: %s %.2d:%.2d", c_dayNames[day], hour, minute );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Clock report: %s %.2d:%.2d", c_dayNames[day], hour, minute );
 
 
-		if( ValueList* dayValue = static_cast<ValueList*>( GetValue( _instance, ClockIndex_Day ) ) )
+		if( ValueList* dayValue = static_cast<ValueList*>( BorrowValue( _instance, ClockIndex_Day ) ) )
 		{
 			dayValue->OnValueRefreshed( day );
-			dayValue->Release();
 		}
-		if( ValueByte* hourValue = static_cast<ValueByte*>( GetValue( _instance, ClockIndex_Hour ) ) )
+		if( ValueByte* hourValue = static_cast<ValueByte*>( BorrowValue( _instance, ClockIndex_Hour ) ) )
 		{
 			hourValue->OnValueRefreshed( hour );
-			hourValue->Release();
 		}
-		if( ValueByte* minuteValue = static_cast<ValueByte*>( GetValue( _instance, ClockIndex_Minute ) ) )
+		if( ValueByte* minuteValue = static_cast<ValueByte*>( BorrowValue( _instance, ClockIndex_Minute ) ) )
 		{
 			minuteValue->OnValueRefreshed( minute );
-			minuteValue->Release();
 		}
 		return true;
 	}
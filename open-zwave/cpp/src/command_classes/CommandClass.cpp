@@ -63,7 +63,10 @@ CommandClass::CommandClass
 	m_getSupported( true ),
 	m_staticRequests( 0 ),
 	m_sentCnt( 0 ),
-	m_receivedCnt( 0 )
+	m_receivedCnt( 0 ),
+	m_verifyReadCnt( 0 ),
+	m_verifyConfirmedCnt( 0 ),
+	m_verifySpuriousCnt( 0 )
 {
 }
 
@@ -122,6 +125,24 @@ Value* CommandClass::GetValue
 	return value;
 }
 
+//-----------------------------------------------------------------------------
+// <CommandClass::BorrowValue>
+// Get a pointer to a value without adding a reference to it
+//-----------------------------------------------------------------------------
+Value* CommandClass::BorrowValue
+(
+	uint8 const _instance,
+	uint8 const _index
+)
+{
+	Value* value = NULL;
+	if( Node* node = GetNodeUnsafe() )
+	{
+		value = node->BorrowValue( GetCommandClassId(), _instance, _index );
+	}
+	return value;
+}
+
 //-----------------------------------------------------------------------------
 // <CommandClass::SetInstances>
 // Instances as set by the MultiInstance V1 command class
@@ -211,6 +232,22 @@ void CommandClass::ReadXML
 		m_getSupported = !strcmp( str, "true" );
 	}
 
+	if( TIXML_SUCCESS == _ccElement->QueryIntAttribute( "verify_reads", &intVal ) && ( intVal >= 2 ) && ( intVal <= 255 ) )
+	{
+		m_verifyPolicy.m_reads = (uint8)intVal;
+	}
+
+	double doubleVal;
+	if( TIXML_SUCCESS == _ccElement->QueryDoubleAttribute( "verify_tolerance", &doubleVal ) && ( doubleVal >= 0 ) )
+	{
+		m_verifyPolicy.m_tolerance = doubleVal;
+	}
+
+	if( TIXML_SUCCESS == _ccElement->QueryDoubleAttribute( "verify_threshold", &doubleVal ) && ( doubleVal >= 0 ) )
+	{
+		m_verifyPolicy.m_threshold = doubleVal;
+	}
+
 	// Setting the instance count will create all the values.
 	SetInstances( instances );
 
@@ -293,6 +330,25 @@ void CommandClass::WriteXML
 		_ccElement->SetAttribute( "getsupported", "false" );
 	}
 
+	VerifyPolicy const defaultPolicy;
+	if( m_verifyPolicy.m_reads != defaultPolicy.m_reads )
+	{
+		snprintf( str, sizeof(str), "%d", m_verifyPolicy.m_reads );
+		_ccElement->SetAttribute( "verify_reads", str );
+	}
+
+	if( m_verifyPolicy.m_tolerance != defaultPolicy.m_tolerance )
+	{
+		snprintf( str, sizeof(str), "%g", m_verifyPolicy.m_tolerance );
+		_ccElement->SetAttribute( "verify_tolerance", str );
+	}
+
+	if( m_verifyPolicy.m_threshold != defaultPolicy.m_threshold )
+	{
+		snprintf( str, sizeof(str), "%g", m_verifyPolicy.m_threshold );
+		_ccElement->SetAttribute( "verify_threshold", str );
+	}
+
 	// Write out the instances
 	for( Bitfield::Iterator it = m_instances.Begin(); it != m_instances.End(); ++ it )
 	{
@@ -328,7 +384,7 @@ void CommandClass::WriteXML
 // <CommandClass::ExtractValue>
 // Read a value from a variable length sequence of bytes
 //-----------------------------------------------------------------------------
-string CommandClass::ExtractValue
+int32 CommandClass::ExtractValue
 (
 	uint8 const* _data,
 	uint8* _scale,
@@ -358,11 +414,8 @@ string CommandClass::ExtractValue
 	}
 
 	// Deal with sign extension.  All values are signed
-	string res;
 	if( _data[_valueOffset] & 0x80 )
 	{
-		res = "-";
-
 		// MSB is signed
 		if( size == 1 )
 		{
@@ -374,54 +427,10 @@ string CommandClass::ExtractValue
 		}
 	}
 
-	// Convert the integer to a decimal string.  We avoid
-	// using floats to prevent accuracy issues.
-	char numBuf[12];
-
-	if( precision == 0 )
-	{
-		// The precision is zero, so we can just print the number directly into the string.
-		snprintf( numBuf, 12, "%d", (signed long)value );
-		res = numBuf;
-	}
-	else
-	{
-		// We'll need to insert a decimal point and include any necessary leading zeros.
-
-		// Fill the buffer with the value padded with leading zeros.
-		snprintf( numBuf, 12, "%011d", (signed long)value );
-
-		// Calculate the position of the decimal point in the buffer
-		int32 decimal = 10-precision;
-
-		// Shift the characters to make space for the decimal point.
-		// We don't worry about overwriting any minus sign since that is
-		// already written into the res string. While we're shifting, we 
-		// also look for the real starting position of the number so we 
-		// can copy it into the res string later.
-		int32 start = -1;
-		for( int32 i=0; i<decimal; ++i )
-		{
-			numBuf[i] = numBuf[i+1];
-			if( ( start<0 ) && ( numBuf[i] != '0' ) )
-			{
-				start = i;
-			}
-		}
-		if( start<0 )
-		{
-			start = decimal-1;
-		}
-
-		// Insert the decimal point
-		struct lconv const* locale = localeconv();
-		numBuf[decimal] = *(locale->decimal_point);
-
-		// Copy the buffer into res
-		res += &numBuf[start];
-	}
-
-	return res;
+	// The value is returned as an integer, to be read as a fixed-point number
+	// with precision digits after the decimal point.  We avoid using floats to
+	// prevent accuracy issues.
+	return (int32)value;
 }
 
 //-----------------------------------------------------------------------------
@@ -434,10 +443,27 @@ void CommandClass::AppendValue
 	string const& _value,
 	uint8 const _scale
 )const
+{
+	uint8 precision;
+	int32 val = ValueToInteger( _value, &precision, NULL );
+	AppendValue( _msg, val, precision, _scale );
+}
+
+//-----------------------------------------------------------------------------
+// <CommandClass::AppendValue>
+// Add a fixed-point value to a message as a sequence of bytes
+//-----------------------------------------------------------------------------
+void CommandClass::AppendValue
+(
+	Msg* _msg,
+	int32 const _value,
+	uint8 const _precision,
+	uint8 const _scale
+)const
 {
 	uint8 precision;
 	uint8 size;
-	int32 val = ValueToInteger( _value, &precision, &size );
+	int32 val = ValueToInteger( _value, _precision, &precision, &size );
 
 	_msg->Append( (precision<<c_precisionShift) | (_scale<<c_scaleShift) | size );
 
@@ -462,6 +488,21 @@ uint8 const CommandClass::GetAppendValueSize
 	return size;
 }
 
+//-----------------------------------------------------------------------------
+// <CommandClass::GetAppendValueSize>
+// Get the number of bytes that would be added by a call to AppendValue
+//-----------------------------------------------------------------------------
+uint8 const CommandClass::GetAppendValueSize
+(
+	int32 const _value,
+	uint8 const _precision
+)const
+{
+	uint8 size;
+	ValueToInteger( _value, _precision, NULL, &size );
+	return size;
+}
+
 //-----------------------------------------------------------------------------
 // <CommandClass::ValueToInteger>
 // Convert a decimal string to an integer and report the precision and
@@ -499,6 +540,25 @@ int32 CommandClass::ValueToInteger
 		val = atol( str.c_str() );
 	}
 
+	return ValueToInteger( val, precision, o_precision, o_size );
+}
+
+//-----------------------------------------------------------------------------
+// <CommandClass::ValueToInteger>
+// Apply any precision override to a fixed-point value and report the
+// precision and number of bytes required to store the value.
+//-----------------------------------------------------------------------------
+int32 CommandClass::ValueToInteger
+(
+	int32 const _value,
+	uint8 const _precision,
+	uint8* o_precision,
+	uint8* o_size
+)const
+{
+	int32 val = _value;
+	uint8 precision = _precision;
+
 	if ( m_overridePrecision > 0 )
 	{
 		while ( precision < m_overridePrecision ) {
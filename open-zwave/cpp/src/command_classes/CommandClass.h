@@ -82,6 +82,7 @@ namespace OpenZWave
 		Driver* GetDriver()const;
 		Node* GetNodeUnsafe()const;
 		Value* GetValue( uint8 const _instance, uint8 const _index );
+		Value* BorrowValue( uint8 const _instance, uint8 const _index );		// Like GetValue, but without adding a reference.  For use while handling a message.
 		uint8 GetEndPoint( uint8 const _instance ){
 			map<uint8,uint8>::iterator it = m_endPointMap.find( _instance );
 			return( it == m_endPointMap.end() ? 0 : it->second );
@@ -106,7 +107,17 @@ namespace OpenZWave
 		bool IsGetSupported()const{ return m_getSupported; }
 
 		// Helper methods
-		string ExtractValue( uint8 const* _data, uint8* _scale, uint8* _precision, uint8 _valueOffset = 1 )const;
+		/**
+		 *  Read a value from a message.
+		 *  \param _data The message data, starting at the byte that holds the size, scale and precision of the value.
+		 *  \param _scale Receives the scale of the value.
+		 *  \param _precision Receives the number of digits after the decimal point.
+		 *  \param _valueOffset Offset of the value from the start of the data.
+		 *  \return The value as a whole number of units of 10^-precision.
+		 *  Store it in a variable before using _precision: if both were passed to the same call,
+		 *  such as a ValueDecimal::Fixed constructor, _precision could be read before it is set.
+		 */
+		int32 ExtractValue( uint8 const* _data, uint8* _scale, uint8* _precision, uint8 _valueOffset = 1 )const;
 
 		/**
 		 *  Append a floating-point value to a message.
@@ -116,8 +127,11 @@ namespace OpenZWave
 		 *  \see Msg
 		 */
 		void AppendValue( Msg* _msg, string const& _value, uint8 const _scale )const;
+		void AppendValue( Msg* _msg, int32 const _value, uint8 const _precision, uint8 const _scale )const;
 		uint8 const GetAppendValueSize( string const& _value )const;
+		uint8 const GetAppendValueSize( int32 const _value, uint8 const _precision )const;
 		int32 ValueToInteger( string const& _value, uint8* o_precision, uint8* o_size )const;
+		int32 ValueToInteger( int32 const _value, uint8 const _precision, uint8* o_precision, uint8* o_size )const;
 
 	protected:
 		virtual void CreateVars( uint8 const _instance ){}
@@ -155,6 +169,29 @@ namespace OpenZWave
 	private:
 		uint8   m_staticRequests;
 
+	//-----------------------------------------------------------------------------
+	//	Verification of reported changes
+	//-----------------------------------------------------------------------------
+	public:
+		/** \brief How an apparent change in one of this command class's values is checked
+		 * before it is believed, for values that have verification turned on.  Set with
+		 * the verify_reads, verify_tolerance and verify_threshold attributes of the
+		 * CommandClass element in a device's configuration file.
+		 */
+		struct VerifyPolicy
+		{
+			VerifyPolicy(): m_reads( 2 ), m_tolerance( 0 ), m_threshold( 0 ){}
+
+			uint8	m_reads;				// Reads that vote on a change, counting the one that reported it.  A majority of them must agree, so 2 is the classic double check.
+			double	m_tolerance;			// Numeric readings no further apart than this count as the same
+			double	m_threshold;			// Numeric changes no larger than this are believed without being checked
+		};
+
+		VerifyPolicy const& GetVerifyPolicy()const{ return m_verifyPolicy; }
+
+	private:
+		VerifyPolicy	m_verifyPolicy;
+
 	//-----------------------------------------------------------------------------
 	//	Statistics
 	//-----------------------------------------------------------------------------
@@ -163,10 +200,19 @@ namespace OpenZWave
 		uint32 GetReceivedCnt()const{ return m_receivedCnt; }
 		void SentCntIncr(){ m_sentCnt++; }
 		void ReceivedCntIncr(){ m_receivedCnt++; }
+		uint32 GetVerifyReadCnt()const{ return m_verifyReadCnt; }
+		uint32 GetVerifyConfirmedCnt()const{ return m_verifyConfirmedCnt; }
+		uint32 GetVerifySpuriousCnt()const{ return m_verifySpuriousCnt; }
+		void VerifyReadCntIncr(){ m_verifyReadCnt++; }
+		void VerifyConfirmedCntIncr(){ m_verifyConfirmedCnt++; }
+		void VerifySpuriousCntIncr(){ m_verifySpuriousCnt++; }
 
 	private:
 		uint32 m_sentCnt;				// Number of messages sent from this command class.
 		uint32 m_receivedCnt;				// Number of messages received from this commandclass.
+		uint32 m_verifyReadCnt;				// Number of extra reads made to check reported changes
+		uint32 m_verifyConfirmedCnt;			// Number of reported changes that the checks confirmed
+		uint32 m_verifySpuriousCnt;			// Number of reported changes that the checks found to be spurious
 	};
 
 } // namespace OpenZWave
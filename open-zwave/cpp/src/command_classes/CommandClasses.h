@@ -47,6 +47,7 @@ namespace OpenZWave
 		static CommandClass* CreateCommandClass( uint8 const _commandClassId, uint32 const _homeId, uint8 const _nodeId );
 
 		static bool IsSupported( uint8 const _commandClassId );
+		static uint8 GetIdFromName( string const& _name ){ return Get().GetCommandClassId( _name ); }	// Returns 0xff if the name is not known
 
 	private:
 		CommandClasses();										
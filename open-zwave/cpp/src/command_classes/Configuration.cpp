@@ -70,7 +70,7 @@ bool Configuration::HandleMsg
 			paramValue |= (int32)_data[i+3];
 		}
 
-		if ( Value* value = GetValue( 1, parameter ) ) 
+		if ( Value* value = BorrowValue( 1, parameter ) ) 
 		{
 			switch ( value->GetID().GetType() ) 
 			{
@@ -106,10 +106,9 @@ bool Configuration::HandleMsg
 				}
 				default:
 				{
-					Log::Write( LogLevel_Info, GetNodeId(), "Invalid type (%d) for configuration parameter %d", value->GetID().GetType(), parameter );
+					Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Invalid type (%d) for configuration parameter %d", value->GetID().GetType(), parameter );
 				}
 			}
-			value->Release();
 		}
 		else
 		{
@@ -138,13 +137,13 @@ bool Configuration::HandleMsg
 					}
 					default:
 					{
-						Log::Write( LogLevel_Info, GetNodeId(), "Invalid size of %d bytes for configuration parameter %d", size, parameter );
+						Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Invalid size of %d bytes for configuration parameter %d", size, parameter );
 					}
 				}
 			}
 		}
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received Configuration report: Parameter=%d, Value=%d", parameter, paramValue );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Configuration report: Parameter=%d, Value=%d", parameter, paramValue );
 		return true;
 	}
 
@@ -198,7 +197,7 @@ bool Configuration::SetValue
 		}
 	}
 
-	Log::Write( LogLevel_Info, GetNodeId(), "Configuration::Set failed (bad value or value type) - Parameter=%d", param );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Configuration::Set failed (bad value or value type) - Parameter=%d", param );
 	return false;
 }
 
@@ -234,7 +233,7 @@ void Configuration::Set
 	uint8 const _size
 )
 {
-	Log::Write( LogLevel_Info, GetNodeId(), "Configuration::Set - Parameter=%d, Value=%d Size=%d", _parameter, _value, _size );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Configuration::Set - Parameter=%d, Value=%d Size=%d", _parameter, _value, _size );
 
 	Msg* msg = new Msg( "ConfigurationCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );
 	msg->Append( GetNodeId() );
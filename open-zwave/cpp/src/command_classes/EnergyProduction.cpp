@@ -95,7 +95,7 @@ bool EnergyProduction::RequestValue
 	Driver::MsgQueue const _queue
 )
 {
-	Log::Write( LogLevel_Info, GetNodeId(), "Requesting the %s value", c_energyParameterNames[_valueEnum] );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Requesting the %s value", c_energyParameterNames[_valueEnum] );
 	Msg* msg = new Msg( "EnergyProductionCmd_Get", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true, true, FUNC_ID_APPLICATION_COMMAND_HANDLER, GetCommandClassId() );
 	msg->SetInstance( this, _instance );
 	msg->Append( GetNodeId() );
@@ -123,17 +123,17 @@ bool EnergyProduction::HandleMsg
 	{
 		uint8 scale;
 		uint8 precision = 0;
-		string value = ExtractValue( &_data[2], &scale, &precision );
+		int32 rawValue = ExtractValue( &_data[2], &scale, &precision );
+		ValueDecimal::Fixed value( rawValue, precision );
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received an Energy production report: %s = %s", c_energyParameterNames[_data[1]], value.c_str() );
-		if( ValueDecimal* decimalValue = static_cast<ValueDecimal*>( GetValue( _instance, _data[1] ) ) )
+		OZW_LOG( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received an Energy production report: %s = %s", c_energyParameterNames[_data[1]], ValueDecimal::Format( value ).c_str() );
+		if( ValueDecimal* decimalValue = static_cast<ValueDecimal*>( BorrowValue( _instance, _data[1] ) ) )
 		{
 			decimalValue->OnValueRefreshed( value );
 			if( decimalValue->GetPrecision() != precision )
 			{
 				decimalValue->SetPrecision( precision );
 			}
-			decimalValue->Release();
 		}
 		return true;
 	}
@@ -122,18 +122,16 @@ bool Language::HandleMsg
 		country[1] = _data[5];
 		country[2] = 0;
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received Language report: Language=%s, Country=%s", language, country );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Language report: Language=%s, Country=%s", language, country );
 		ClearStaticRequest( StaticRequest_Values );
 
-		if( ValueString* languageValue = static_cast<ValueString*>( GetValue( _instance, LanguageIndex_Language ) ) )
+		if( ValueString* languageValue = static_cast<ValueString*>( BorrowValue( _instance, LanguageIndex_Language ) ) )
 		{
 			languageValue->OnValueRefreshed( language );
-			languageValue->Release();
 		}
-		if( ValueString* countryValue = static_cast<ValueString*>( GetValue( _instance, LanguageIndex_Country ) ) )
+		if( ValueString* countryValue = static_cast<ValueString*>( BorrowValue( _instance, LanguageIndex_Country ) ) )
 		{
 			countryValue->OnValueRefreshed( country );
-			countryValue->Release();
 		}
 		return true;
 	}
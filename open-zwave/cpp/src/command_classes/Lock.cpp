@@ -99,12 +99,11 @@ bool Lock::HandleMsg
 {
 	if( LockCmd_Report == (LockCmd)_data[0] )
 	{
-		Log::Write( LogLevel_Info, GetNodeId(), "Received Lock report: Lock is %s", _data[1] ? "Locked" : "Unlocked" );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Lock report: Lock is %s", _data[1] ? "Locked" : "Unlocked" );
 
-		if( ValueBool* value = static_cast<ValueBool*>( GetValue( _instance, 0 ) ) )
+		if( ValueBool* value = static_cast<ValueBool*>( BorrowValue( _instance, 0 ) ) )
 		{
 			value->OnValueRefreshed( _data[1] != 0 );
-			value->Release();
 		}
 		return true;
 	}
@@ -125,7 +124,7 @@ bool Lock::SetValue
 	{
 		ValueBool const* value = static_cast<ValueBool const*>(&_value);
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Lock::Set - Requesting lock to be %s", value->GetValue() ? "Locked" : "Unlocked" );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Lock::Set - Requesting lock to be %s", value->GetValue() ? "Locked" : "Unlocked" );
 		Msg* msg = new Msg( "LockCmd_Get", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );
 		msg->SetInstance( this, _value.GetID().GetInstance() );
 		msg->Append( GetNodeId() );
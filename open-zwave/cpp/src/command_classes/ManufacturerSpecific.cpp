@@ -193,7 +193,7 @@ bool ManufacturerSpecific::HandleMsg
 				LoadConfigXML( node, configPath );
 			}
 
-			Log::Write( LogLevel_Info, GetNodeId(), "Received manufacturer specific report from node %d: Manufacturer=%s, Product=%s", 
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received manufacturer specific report from node %d: Manufacturer=%s, Product=%s", 
 				    GetNodeId(), node->GetManufacturerName().c_str(), node->GetProductName().c_str() );
 			ClearStaticRequest( StaticRequest_Values );
 			node->m_manufacturerSpecificClassReceived = true;
@@ -273,11 +273,10 @@ bool Meter::HandleSupportedReport
 				{
 					case MeterType_Electric:
 					{
-						if( ValueDecimal* value = static_cast<ValueDecimal*>( GetValue( _instance, baseIndex ) ) )
+						if( ValueDecimal* value = static_cast<ValueDecimal*>( BorrowValue( _instance, baseIndex ) ) )
 						{
 							value->SetLabel( c_electricityLabels[i] );
 							value->SetUnits( c_electricityUnits[i] );
-							value->Release();
 						}
 						else
 						{
@@ -290,11 +289,10 @@ bool Meter::HandleSupportedReport
 					}
 					case MeterType_Gas:
 					{
-						if( ValueDecimal* value = static_cast<ValueDecimal*>( GetValue( _instance, baseIndex ) ) )
+						if( ValueDecimal* value = static_cast<ValueDecimal*>( BorrowValue( _instance, baseIndex ) ) )
 						{
 							value->SetLabel( c_meterTypes[MeterType_Gas] );
 							value->SetUnits( c_gasUnits[i] );
-							value->Release();
 						}
 						else
 						{
@@ -307,11 +305,10 @@ bool Meter::HandleSupportedReport
 					}
 					case MeterType_Water:
 					{
-						if( ValueDecimal* value = static_cast<ValueDecimal*>( GetValue( _instance, baseIndex ) ) )
+						if( ValueDecimal* value = static_cast<ValueDecimal*>( BorrowValue( _instance, baseIndex ) ) )
 						{
 							value->SetLabel( c_meterTypes[MeterType_Water] );
 							value->SetUnits( c_waterUnits[i] );
-							value->Release();
 						}
 						else
 						{
@@ -339,7 +336,7 @@ bool Meter::HandleSupportedReport
 			node->CreateValueButton( ValueID::ValueGenre_System, GetCommandClassId(), _instance, MeterIndex_Reset, "Reset", 0 );
 		}
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received Meter supported report from node %d, %s", GetNodeId(), msg.c_str() );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Meter supported report from node %d, %s", GetNodeId(), msg.c_str() );
 		return true;
 	}
 
@@ -362,17 +359,17 @@ bool Meter::HandleReport
 	if( GetVersion() > 1 )
 	{
 		exporting = ((_data[1] & 0x60) == 0x40 );
-		if( ValueBool* value = static_cast<ValueBool*>( GetValue( _instance, MeterIndex_Exporting ) ) )
+		if( ValueBool* value = static_cast<ValueBool*>( BorrowValue( _instance, MeterIndex_Exporting ) ) )
 		{
 			value->OnValueRefreshed( exporting );
-			value->Release();
 		}
 	}
 
 	// Get the value and scale
 	uint8 scale;
 	uint8 precision = 0;
-	string valueStr = ExtractValue( &_data[2], &scale, &precision );
+	int32 rawValue = ExtractValue( &_data[2], &scale, &precision );
+	ValueDecimal::Fixed reading( rawValue, precision );
 
 	if( GetVersion() == 1 )
 	{
@@ -409,17 +406,16 @@ bool Meter::HandleReport
 			}
 		}
 
-		if( ValueDecimal* value = static_cast<ValueDecimal*>( GetValue( _instance, 0 ) ) )
+		if( ValueDecimal* value = static_cast<ValueDecimal*>( BorrowValue( _instance, 0 ) ) )
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "Received Meter report from node %d: %s=%s%s", GetNodeId(), label.c_str(), valueStr.c_str(), units.c_str() );
+			OZW_LOG( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Meter report from node %d: %s=%s%s", GetNodeId(), label.c_str(), ValueDecimal::Format( reading ).c_str(), units.c_str() );
 			value->SetLabel( label );
 			value->SetUnits( units );
-			value->OnValueRefreshed( valueStr );
+			value->OnValueRefreshed( reading );
 			if( value->GetPrecision() != precision )
 			{
 				value->SetPrecision( precision );
 			}
-			value->Release();
 		}
 	}
 	else
@@ -433,15 +429,14 @@ bool Meter::HandleReport
 			baseIndex = scale << 2;
 		}
 
-		if( ValueDecimal* value = static_cast<ValueDecimal*>( GetValue( _instance, baseIndex ) ) )
+		if( ValueDecimal* value = static_cast<ValueDecimal*>( BorrowValue( _instance, baseIndex ) ) )
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "Received Meter report from node %d: %s%s=%s%s", GetNodeId(), exporting ? "Exporting ": "", value->GetLabel().c_str(), valueStr.c_str(), value->GetUnits().c_str() );
-			value->OnValueRefreshed( valueStr );
+			OZW_LOG( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Meter report from node %d: %s%s=%s%s", GetNodeId(), exporting ? "Exporting ": "", value->GetLabel().c_str(), ValueDecimal::Format( reading ).c_str(), value->GetUnits().c_str() );
+			value->OnValueRefreshed( reading );
 			if( value->GetPrecision() != precision )
 			{
 				value->SetPrecision( precision );
 			}
-			value->Release();
 
 			// Read any previous value and time delta
 			uint8 size = _data[2] & 0x07;
@@ -450,44 +445,43 @@ bool Meter::HandleReport
 			if( delta )
 			{
 				// There is only a previous value if the time delta is non-zero
-				ValueDecimal* previous = static_cast<ValueDecimal*>( GetValue( _instance, baseIndex+1 ) );
+				ValueDecimal* previous = static_cast<ValueDecimal*>( BorrowValue( _instance, baseIndex+1 ) );
 				if( NULL == previous )
 				{
 					// We need to create a value to hold the previous
 					if( Node* node = GetNodeUnsafe() )
 					{
 						node->CreateValueDecimal( ValueID::ValueGenre_User, GetCommandClassId(), _instance, baseIndex+1, "Previous Reading", value->GetUnits().c_str(), true, false, "0.0", 0 );
-						previous = static_cast<ValueDecimal*>( GetValue( _instance, baseIndex+1 ) );
+						previous = static_cast<ValueDecimal*>( BorrowValue( _instance, baseIndex+1 ) );
 					}
 				}
 				if( previous )
 				{
 					precision = 0;
-					valueStr = ExtractValue( &_data[2], &scale, &precision, 3+size );
-					Log::Write( LogLevel_Info, GetNodeId(), "    Previous value was %s%s, received %d seconds ago.", valueStr.c_str(), previous->GetUnits().c_str(), delta );
-					previous->OnValueRefreshed( valueStr );
+					reading.m_value = ExtractValue( &_data[2], &scale, &precision, 3+size );
+					reading.m_places = precision;
+					OZW_LOG( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Previous value was %s%s, received %d seconds ago.", ValueDecimal::Format( reading ).c_str(), previous->GetUnits().c_str(), delta );
+					previous->OnValueRefreshed( reading );
 					if( previous->GetPrecision() != precision )
 					{
 						previous->SetPrecision( precision );
 					}
-					previous->Release();
 				}
 
 				// Time delta
-				ValueInt* interval = static_cast<ValueInt*>( GetValue( _instance, baseIndex+2 ) );
+				ValueInt* interval = static_cast<ValueInt*>( BorrowValue( _instance, baseIndex+2 ) );
 				if( NULL == interval )
 				{
 					// We need to create a value to hold the time delta
 					if( Node* node = GetNodeUnsafe() )
 					{
 						node->CreateValueInt( ValueID::ValueGenre_User, GetCommandClassId(), _instance, baseIndex+2, "Interval", "seconds", true, false, 0, 0 );
-						interval = static_cast<ValueInt*>( GetValue( _instance, baseIndex+2 ) );
+						interval = static_cast<ValueInt*>( BorrowValue( _instance, baseIndex+2 ) );
 					}
 				}
 				if( interval )
 				{
 		 			interval->OnValueRefreshed( (int32)delta );
-					interval->Release();
 				}
 			}
 		}
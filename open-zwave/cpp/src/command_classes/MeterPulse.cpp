@@ -105,11 +105,10 @@ bool MeterPulse::HandleMsg
 			count |= (uint32)_data[i+1];
 		}
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received a meter pulse count: Count=%d", count );
-		if( ValueInt* value = static_cast<ValueInt*>( GetValue( _instance, 0 ) ) )
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received a meter pulse count: Count=%d", count );
+		if( ValueInt* value = static_cast<ValueInt*>( BorrowValue( _instance, 0 ) ) )
 		{
 			value->OnValueRefreshed( count );
-			value->Release();
 		}
 
 		return true;
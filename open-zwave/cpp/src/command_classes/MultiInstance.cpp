@@ -125,7 +125,7 @@ void MultiInstance::ReadXML
 		}
 		else
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "Bad value for mapping: %s", str);
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Bad value for mapping: %s", str);
 		}
 	}
 
@@ -300,7 +300,7 @@ void MultiInstance::HandleMultiInstanceReport
 
 		if( CommandClass* pCommandClass = node->GetCommandClass( commandClassId ) )
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "Received MultiInstanceReport from node %d for %s: Number of instances = %d", GetNodeId(), pCommandClass->GetCommandClassName().c_str(), instances );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received MultiInstanceReport from node %d for %s: Number of instances = %d", GetNodeId(), pCommandClass->GetCommandClassName().c_str(), instances );
 			pCommandClass->SetInstances( instances );
 			pCommandClass->ClearStaticRequest( StaticRequest_Instances );
 		}
@@ -328,7 +328,7 @@ void MultiInstance::HandleMultiInstanceEncap
 
 		if( CommandClass* pCommandClass = node->GetCommandClass( commandClassId ) )
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "Received a MultiInstanceEncap from node %d, instance %d, for Command Class %s", GetNodeId(), instance, pCommandClass->GetCommandClassName().c_str() );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received a MultiInstanceEncap from node %d, instance %d, for Command Class %s", GetNodeId(), instance, pCommandClass->GetCommandClassName().c_str() );
 			pCommandClass->HandleMsg( &_data[3], _length-3, instance );
 		}
 	}
@@ -363,11 +363,11 @@ void MultiInstance::HandleMultiChannelEndPointReport
 	if( m_endPointsAreSameClass ) // only need to check single end point
 	{
 		len = 1;
-		Log::Write( LogLevel_Info, GetNodeId(), "Received MultiChannelEndPointReport from node %d. All %d endpoints are the same.", GetNodeId(), m_numEndPoints );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received MultiChannelEndPointReport from node %d. All %d endpoints are the same.", GetNodeId(), m_numEndPoints );
 	}
 	else
 	{
-		Log::Write( LogLevel_Info, GetNodeId(), "Received MultiChannelEndPointReport from node %d. %d endpoints are not all the same.", GetNodeId(), m_numEndPoints );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received MultiChannelEndPointReport from node %d. %d endpoints are not all the same.", GetNodeId(), m_numEndPoints );
 	}
 
 	// This code assumes the endpoints are all in numeric sequential order.
@@ -404,9 +404,9 @@ void MultiInstance::HandleMultiChannelCapabilityReport
 		uint8 endPoint = _data[1] & 0x7f;
 		bool dynamic = ((_data[1] & 0x80)!=0);
 
-		Log::Write( LogLevel_Info, GetNodeId(), "Received MultiChannelCapabilityReport from node %d for endpoint %d", GetNodeId(), endPoint );
-		Log::Write( LogLevel_Info, GetNodeId(), "    Endpoint is%sdynamic, and is a %s", dynamic ? " " : " not ", node->GetEndPointDeviceClassLabel( _data[2], _data[3] ).c_str() );
-		Log::Write( LogLevel_Info, GetNodeId(), "    Command classes supported by the endpoint are:" );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received MultiChannelCapabilityReport from node %d for endpoint %d", GetNodeId(), endPoint );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Endpoint is%sdynamic, and is a %s", dynamic ? " " : " not ", node->GetEndPointDeviceClassLabel( _data[2], _data[3] ).c_str() );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Command classes supported by the endpoint are:" );
 
 		// Store the command classes for later use
 		bool afterMark = false;
@@ -435,7 +435,7 @@ void MultiInstance::HandleMultiChannelCapabilityReport
 			}
 			if( cc )
 			{
-				Log::Write( LogLevel_Info, GetNodeId(), "        %s", cc->GetCommandClassName().c_str() );
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "        %s", cc->GetCommandClassName().c_str() );
 			}
  		}
 
@@ -523,7 +523,7 @@ void MultiInstance::HandleMultiChannelEndPointFindReport
 	uint32 const _length
 )
 {
-	Log::Write( LogLevel_Info, GetNodeId(), "Received MultiChannelEndPointFindReport from node %d", GetNodeId() );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received MultiChannelEndPointFindReport from node %d", GetNodeId() );
 	uint8 numEndPoints = _length - 5;
 	for( uint8 i=0; i<numEndPoints; ++i )
 	{
@@ -540,7 +540,7 @@ void MultiInstance::HandleMultiChannelEndPointFindReport
 					CommandClass* cc = node->GetCommandClass( commandClassId );
 					if( cc )
 					{	
-						Log::Write( LogLevel_Info, GetNodeId(), "    Endpoint %d: Adding %s", endPoint, cc->GetCommandClassName().c_str() );
+						Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Endpoint %d: Adding %s", endPoint, cc->GetCommandClassName().c_str() );
 						cc->SetInstance( endPoint );
 					}
 				}
@@ -610,11 +610,11 @@ void MultiInstance::HandleMultiChannelEncap
 			uint8 instance = pCommandClass->GetInstance( endPoint );
 			if( instance == 0 )
 			{
-				Log::Write( LogLevel_Error, GetNodeId(), "Cannot find endpoint map to instance for Command Class %s endpoint %d", pCommandClass->GetCommandClassName().c_str(), endPoint );
+				Log::Write( LogLevel_Error, GetNodeId(), GetCommandClassId(), "Cannot find endpoint map to instance for Command Class %s endpoint %d", pCommandClass->GetCommandClassName().c_str(), endPoint );
 			}
 			else
 			{
-				Log::Write( LogLevel_Info, GetNodeId(), "Received a MultiChannelEncap from node %d, endpoint %d for Command Class %s", GetNodeId(), endPoint, pCommandClass->GetCommandClassName().c_str() );
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received a MultiChannelEncap from node %d, endpoint %d for Command Class %s", GetNodeId(), endPoint, pCommandClass->GetCommandClassName().c_str() );
 				pCommandClass->HandleMsg( &_data[4], _length-4, instance );
 			}
 		}
@@ -47,7 +47,7 @@ bool NoOperation::HandleMsg
 )
 {
 	// We have received a no operation from the Z-Wave device.
-	Log::Write( LogLevel_Info, GetNodeId(), "Received NoOperation command from node %d", GetNodeId() );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received NoOperation command from node %d", GetNodeId() );
 	return true;
 }
 
@@ -60,7 +60,7 @@ void NoOperation::Set
 	bool const _route
 )
 {
-	Log::Write( LogLevel_Info, GetNodeId(), "NoOperation::Set - Routing=%s", _route ? "true" : "false" );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "NoOperation::Set - Routing=%s", _route ? "true" : "false" );
 
 	Msg* msg = new Msg( "NoOperation_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );
 	msg->Append( GetNodeId() );
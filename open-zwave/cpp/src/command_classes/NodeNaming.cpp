@@ -294,7 +294,7 @@ bool NodeNaming::HandleMsg
 			{
 				// We only overwrite the name if it is empty
 				node->m_nodeName = name;
-				Log::Write( LogLevel_Info, GetNodeId(), "Received the name: %s.", name.c_str() );
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received the name: %s.", name.c_str() );
 				updated = true;
 			}
 		}
@@ -305,10 +305,15 @@ bool NodeNaming::HandleMsg
 			{
 				// We only overwrite the location if it is empty
 				node->m_location = location;
-				Log::Write( LogLevel_Info, GetNodeId(), "Received the location: %s.", location.c_str() );
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received the location: %s.", location.c_str() );
 				updated = true;
 			}
 		}
+
+		if( updated )
+		{
+			node->PublishSnapshot();
+		}
  	}
 
 	if( updated )
@@ -336,7 +341,7 @@ void NodeNaming::SetName
 		length = 16;
 	}
 
-	Log::Write( LogLevel_Info, GetNodeId(), "NodeNaming::Set - Naming to '%s'", _name.c_str() );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "NodeNaming::Set - Naming to '%s'", _name.c_str() );
 	Msg* msg = new Msg( "NodeNaming Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );		
 	msg->Append( GetNodeId() );
 	msg->Append( (uint8)(length + 3) );
@@ -368,7 +373,7 @@ void NodeNaming::SetLocation
 		length = 16;
 	}
 
-	Log::Write( LogLevel_Info, GetNodeId(), "NodeNaming::SetLocation - Setting location to '%s'", _location.c_str() );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "NodeNaming::SetLocation - Setting location to '%s'", _location.c_str() );
 	Msg* msg = new Msg( "NodeNaming Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );		
 	msg->Append( GetNodeId() );
 	msg->Append( (uint8)(length + 3) );
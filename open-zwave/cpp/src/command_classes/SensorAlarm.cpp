@@ -158,15 +158,14 @@ bool SensorAlarm::HandleMsg
 	if( SensorAlarmCmd_Report == (SensorAlarmCmd)_data[0] )
 	{
 		// We have received an alarm state report from the Z-Wave device
-		if( ValueByte* value = static_cast<ValueByte*>( GetValue( _instance, _data[2] ) ) )
+		if( ValueByte* value = static_cast<ValueByte*>( BorrowValue( _instance, _data[2] ) ) )
 		{
 			uint8 sourceNodeId = _data[1];
 			uint8 state = _data[3];
 			// uint16 time = (((uint16)_data[4])<<8) | (uint16)_data[5];  Don't know what to do with this yet.
 
 			value->OnValueRefreshed( state );
-			value->Release();
-			Log::Write( LogLevel_Info, GetNodeId(), "Received alarm state report from node %d: %s = %d", sourceNodeId, value->GetLabel().c_str(), state );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received alarm state report from node %d: %s = %d", sourceNodeId, value->GetLabel().c_str(), state );
 		}
 
 		return true;
@@ -177,7 +176,7 @@ bool SensorAlarm::HandleMsg
 		if( Node* node = GetNodeUnsafe() )
 		{
 			// We have received the supported alarm types from the Z-Wave device
-			Log::Write( LogLevel_Info, GetNodeId(), "Received supported alarm types" );		
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received supported alarm types" );		
 
 			// Parse the data for the supported alarm types
 			uint8 numBytes = _data[1];
@@ -192,7 +191,7 @@ bool SensorAlarm::HandleMsg
 						if( index < SensorAlarm_Count )
 						{
 						  	node->CreateValueByte( ValueID::ValueGenre_User, GetCommandClassId(), _instance, index, c_alarmTypeName[index], "", true, false, 0, 0 );
-							Log::Write( LogLevel_Info, GetNodeId(), "    Added alarm type: %s", c_alarmTypeName[index] );
+							Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Added alarm type: %s", c_alarmTypeName[index] );
 						}
 					}
 				}
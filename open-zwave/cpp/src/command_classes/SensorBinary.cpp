@@ -98,12 +98,11 @@ bool SensorBinary::HandleMsg
 {
 	if (SensorBinaryCmd_Report == (SensorBinaryCmd)_data[0])
 	{
-		Log::Write( LogLevel_Info, GetNodeId(), "Received SensorBinary report: State=%s", _data[1] ? "On" : "Off" );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received SensorBinary report: State=%s", _data[1] ? "On" : "Off" );
 
-		if( ValueBool* value = static_cast<ValueBool*>( GetValue( _instance, 0 ) ) )
+		if( ValueBool* value = static_cast<ValueBool*>( BorrowValue( _instance, 0 ) ) )
 		{
 			value->OnValueRefreshed( _data[1] != 0 );
-			value->Release();
 		}
 		return true;
 	}
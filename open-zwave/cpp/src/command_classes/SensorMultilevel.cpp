@@ -166,7 +166,8 @@ bool SensorMultilevel::HandleMsg
 		uint8 scale;
 		uint8 precision = 0;
 		uint8 sensorType = _data[1];
-		string valueStr = ExtractValue( &_data[2], &scale, &precision );
+		int32 rawValue = ExtractValue( &_data[2], &scale, &precision );
+		ValueDecimal::Fixed reading( rawValue, precision );
 
 		Node* node = GetNodeUnsafe();
 		if( node != NULL )
@@ -197,24 +198,23 @@ bool SensorMultilevel::HandleMsg
 				default:																		break;
 			}
 
-			ValueDecimal* value = static_cast<ValueDecimal*>( GetValue( _instance, sensorType ) );
+			ValueDecimal* value = static_cast<ValueDecimal*>( BorrowValue( _instance, sensorType ) );
 			if( value == NULL)
 			{
 				node->CreateValueDecimal(  ValueID::ValueGenre_User, GetCommandClassId(), _instance, sensorType, c_sensorTypeNames[sensorType], units, true, false, "0.0", 0  );
-				value = static_cast<ValueDecimal*>( GetValue( _instance, sensorType ) );
+				value = static_cast<ValueDecimal*>( BorrowValue( _instance, sensorType ) );
 			}
 			else 
 			{
 				value->SetUnits(units);
 			}
 
-			Log::Write( LogLevel_Info, GetNodeId(), "Received SensorMultiLevel report from node %d, instance %d: value=%s%s", GetNodeId(), _instance, valueStr.c_str(), value->GetUnits().c_str() );
+			OZW_LOG( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received SensorMultiLevel report from node %d, instance %d: value=%s%s", GetNodeId(), _instance, ValueDecimal::Format( reading ).c_str(), value->GetUnits().c_str() );
 			if( value->GetPrecision() != precision )
 			{
 				value->SetPrecision( precision );
 			}
-			value->OnValueRefreshed( valueStr );
-			value->Release();
+			value->OnValueRefreshed( reading );
 			return true;
 		}
 	}
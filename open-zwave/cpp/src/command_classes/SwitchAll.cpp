@@ -109,11 +109,10 @@ bool SwitchAll::HandleMsg
 {
 	if (SwitchAllCmd_Report == (SwitchAllCmd)_data[0])
 	{
-		if( ValueList* value = static_cast<ValueList*>( GetValue( _instance, 0 ) ) )
+		if( ValueList* value = static_cast<ValueList*>( BorrowValue( _instance, 0 ) ) )
 		{
 			value->OnValueRefreshed( (int32)_data[1] );
-			value->Release();
-			Log::Write( LogLevel_Info, GetNodeId(), "Received SwitchAll report from node %d: %s", GetNodeId(), value->GetItem().m_label.c_str() );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received SwitchAll report from node %d: %s", GetNodeId(), value->GetItem().m_label.c_str() );
 		}
  		return true;
 	}
@@ -135,7 +134,7 @@ bool SwitchAll::SetValue
 		ValueList const* value = static_cast<ValueList const*>(&_value);
 		ValueList::Item const& item = value->GetItem();
 
-		Log::Write( LogLevel_Info, GetNodeId(), "SwitchAll::Set - %s on node %d", item.m_label.c_str(), GetNodeId() );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "SwitchAll::Set - %s on node %d", item.m_label.c_str(), GetNodeId() );
 		Msg* msg = new Msg( "SwitchAllCmd_Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );		
 		msg->SetInstance( this, _value.GetID().GetInstance() );
 		msg->Append( GetNodeId() );
@@ -158,12 +158,11 @@ bool SwitchMultilevel::HandleMsg
 {
 	if( SwitchMultilevelCmd_Report == (SwitchMultilevelCmd)_data[0] )
 	{
-		Log::Write( LogLevel_Info, GetNodeId(), "Received SwitchMultiLevel report: level=%d", _data[1] );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received SwitchMultiLevel report: level=%d", _data[1] );
 
-		if( ValueByte* value = static_cast<ValueByte*>( GetValue( _instance, SwitchMultilevelIndex_Level ) ) )
+		if( ValueByte* value = static_cast<ValueByte*>( BorrowValue( _instance, SwitchMultilevelIndex_Level ) ) )
 		{
 			value->OnValueRefreshed( _data[1] );
-			value->Release();
 		}
 		return true;
 	}
@@ -173,7 +172,7 @@ bool SwitchMultilevel::HandleMsg
 		uint8 switchType1 = _data[1] & 0x1f;
 		uint8 switchType2 = _data[2] & 0x1f;
 		
-		Log::Write( LogLevel_Info, GetNodeId(), "Received SwitchMultiLevel supported report: Switch1=%s/%s, Switch2=%s/%s", c_switchLabelsPos[switchType1], c_switchLabelsNeg[switchType1], c_switchLabelsPos[switchType2], c_switchLabelsNeg[switchType2] );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received SwitchMultiLevel supported report: Switch1=%s/%s, Switch2=%s/%s", c_switchLabelsPos[switchType1], c_switchLabelsNeg[switchType1], c_switchLabelsPos[switchType2], c_switchLabelsNeg[switchType2] );
 		ClearStaticRequest( StaticRequest_Version );
 
 		// Set the labels on the values
@@ -181,29 +180,25 @@ bool SwitchMultilevel::HandleMsg
 
 		if( switchType1 )
 		{
-			if( NULL != ( button = static_cast<ValueButton*>( GetValue( _instance, SwitchMultilevelIndex_Bright ) ) ) )
+			if( NULL != ( button = static_cast<ValueButton*>( BorrowValue( _instance, SwitchMultilevelIndex_Bright ) ) ) )
 			{
 				button->SetLabel( c_switchLabelsPos[switchType1] );
-				button->Release();
 			}
-			if( NULL != ( button = static_cast<ValueButton*>( GetValue( _instance, SwitchMultilevelIndex_Dim ) ) ) )
+			if( NULL != ( button = static_cast<ValueButton*>( BorrowValue( _instance, SwitchMultilevelIndex_Dim ) ) ) )
 			{
 				button->SetLabel( c_switchLabelsNeg[switchType1] );
-				button->Release();
 			}
 		}
 		
 		if( switchType2 )
 		{
-			if( NULL != ( button = static_cast<ValueButton*>( GetValue( _instance, SwitchMultilevelIndex_Inc ) ) ) )
+			if( NULL != ( button = static_cast<ValueButton*>( BorrowValue( _instance, SwitchMultilevelIndex_Inc ) ) ) )
 			{
 				button->SetLabel( c_switchLabelsPos[switchType2] );
-				button->Release();
 			}
-			if( NULL != ( button = static_cast<ValueButton*>( GetValue( _instance, SwitchMultilevelIndex_Dec ) ) ) )
+			if( NULL != ( button = static_cast<ValueButton*>( BorrowValue( _instance, SwitchMultilevelIndex_Dec ) ) ) )
 			{
 				button->SetLabel( c_switchLabelsNeg[switchType2] );
-				button->Release();
 			}
 		}
 		return true;
@@ -375,7 +370,7 @@ bool SwitchMultilevel::SetLevel
 	uint8 const _level
 )
 {
-	Log::Write( LogLevel_Info, GetNodeId(), "SwitchMultilevel::Set - Setting to level %d", _level );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "SwitchMultilevel::Set - Setting to level %d", _level );
 	Msg* msg = new Msg( "SwitchMultiLevel Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );		
 	msg->SetInstance( this, _instance );
 	msg->Append( GetNodeId() );
@@ -386,15 +381,15 @@ bool SwitchMultilevel::SetLevel
 		durationValue->Release();
 		if( duration == 0xff )
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "  Duration: Default" );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Duration: Default" );
 		}
 		else if( duration >= 0x80 )
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "  Duration: %d minutes", duration - 0x7f );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Duration: %d minutes", duration - 0x7f );
 		}
 		else
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "  Duration: %d seconds", duration );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Duration: %d seconds", duration );
 		}
 
 		msg->Append( 4 );
@@ -426,11 +421,11 @@ bool SwitchMultilevel::StartLevelChange
 	SwitchMultilevelDirection const _direction
 )
 {
-	Log::Write( LogLevel_Info, GetNodeId(), "SwitchMultilevel::StartLevelChange - Starting a level change" );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "SwitchMultilevel::StartLevelChange - Starting a level change" );
 
 	uint8 length = 4;
 	uint8 direction = c_directionParams[_direction];
-	Log::Write( LogLevel_Info, GetNodeId(), "  Direction:          %s", c_directionDebugLabels[_direction] );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Direction:          %s", c_directionDebugLabels[_direction] );
 
 	if( ValueBool* ignoreStartLevel = static_cast<ValueBool*>( GetValue( _instance, SwitchMultilevelIndex_IgnoreStartLevel ) ) )
 	{
@@ -441,7 +436,7 @@ bool SwitchMultilevel::StartLevelChange
 			direction |= 0x20;
 		}
 	}
-	Log::Write( LogLevel_Info, GetNodeId(), "  Ignore Start Level: %s", (direction & 0x20) ? "True" : "False" );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Ignore Start Level: %s", (direction & 0x20) ? "True" : "False" );
 
 	uint8 startLevel = 0;
 	if( ValueByte* startLevelValue = static_cast<ValueByte*>( GetValue( _instance, SwitchMultilevelIndex_StartLevel ) ) )
@@ -449,7 +444,7 @@ bool SwitchMultilevel::StartLevelChange
 		startLevel = startLevelValue->GetValue();
 		startLevelValue->Release();
 	}
-	Log::Write( LogLevel_Info, GetNodeId(), "  Start Level:        %d", startLevel );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Start Level:        %d", startLevel );
 
 	uint8 duration = 0;
 	if( ValueByte* durationValue = static_cast<ValueByte*>( GetValue( _instance, SwitchMultilevelIndex_Duration ) ) )
@@ -457,7 +452,7 @@ bool SwitchMultilevel::StartLevelChange
 		length = 5;
 		duration = durationValue->GetValue();
 		durationValue->Release();
-		Log::Write( LogLevel_Info, GetNodeId(), "  Duration:           %d", duration );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Duration:           %d", duration );
 	}
 
 	uint8 step = 0;
@@ -468,7 +463,7 @@ bool SwitchMultilevel::StartLevelChange
 			length = 6;
 			step = stepValue->GetValue();
 			stepValue->Release();
-			Log::Write( LogLevel_Info, GetNodeId(), "  Step Size:          %d", step );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Step Size:          %d", step );
 		}
 	}
 	
@@ -505,7 +500,7 @@ bool SwitchMultilevel::StopLevelChange
 	uint8 const _instance
 )
 {
-	Log::Write( LogLevel_Info, GetNodeId(), "SwitchMultilevel::StopLevelChange - Stopping the level change" );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "SwitchMultilevel::StopLevelChange - Stopping the level change" );
 	Msg* msg = new Msg( "SwitchMultilevel StopLevelChange", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );		
 	msg->SetInstance( this, _instance );
 	msg->Append( GetNodeId() );
@@ -99,12 +99,11 @@ bool SwitchToggleBinary::HandleMsg
 {
 	if( SwitchToggleBinaryCmd_Report == (SwitchToggleBinaryCmd)_data[0] )
 	{
-		Log::Write( LogLevel_Info, GetNodeId(), "Received SwitchToggleBinary report: %s", _data[1] ? "On" : "Off" );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received SwitchToggleBinary report: %s", _data[1] ? "On" : "Off" );
 
-		if( ValueBool* value = static_cast<ValueBool*>( GetValue( _instance, 0 ) ) )
+		if( ValueBool* value = static_cast<ValueBool*>( BorrowValue( _instance, 0 ) ) )
 		{
 			value->OnValueRefreshed( _data[1] != 0 );
-			value->Release();
 		}
 		return true;
 	}
@@ -121,7 +120,7 @@ bool SwitchToggleBinary::SetValue
 	Value const& _value
 )
 {
-	Log::Write( LogLevel_Info, GetNodeId(), "SwitchToggleBinary::Set - Toggling the state" );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "SwitchToggleBinary::Set - Toggling the state" );
 	Msg* msg = new Msg( "SwitchToggleBinary Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );		
 	msg->SetInstance( this, _value.GetID().GetInstance() );
 	msg->Append( GetNodeId() );
@@ -102,12 +102,11 @@ bool SwitchToggleMultilevel::HandleMsg
 {
 	if( SwitchToggleMultilevelCmd_Report == (SwitchToggleMultilevelCmd)_data[0] )
 	{
-		Log::Write( LogLevel_Info, GetNodeId(), "Received SwitchToggleMultiLevel report: level=%d", _data[1] );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received SwitchToggleMultiLevel report: level=%d", _data[1] );
 
-		if( ValueByte* value = static_cast<ValueByte*>( GetValue( _instance, 0 ) ) )
+		if( ValueByte* value = static_cast<ValueByte*>( BorrowValue( _instance, 0 ) ) )
 		{
 			value->OnValueRefreshed( _data[1] );
-			value->Release();
 		}
 		return true;
 	}
@@ -124,7 +123,7 @@ bool SwitchToggleMultilevel::SetValue
 	Value const& _value
 )
 {
-	Log::Write( LogLevel_Info, GetNodeId(), "SwitchToggleMultilevel::Set - Toggling the state" );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "SwitchToggleMultilevel::Set - Toggling the state" );
 	Msg* msg = new Msg( "SwitchToggleMultilevel Set", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );		
 	msg->SetInstance( this, _value.GetID().GetInstance() );
 	msg->Append( GetNodeId() );
@@ -151,7 +150,7 @@ void SwitchToggleMultilevel::StartLevelChange
 	param |= ( _bIgnoreStartLevel ? 0x20 : 0x00 );
 	param |= ( _bRollover ? 0x80 : 0x00 );
 
-	Log::Write( LogLevel_Info, GetNodeId(), "SwitchMultilevel::StartLevelChange - Starting a level change, Direction=%d, IgnoreStartLevel=%s and rollover=%s", (_direction==SwitchToggleMultilevelDirection_Up) ? "Up" : "Down", _bIgnoreStartLevel ? "True" : "False", _bRollover ? "True" : "False" );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "SwitchMultilevel::StartLevelChange - Starting a level change, Direction=%d, IgnoreStartLevel=%s and rollover=%s", (_direction==SwitchToggleMultilevelDirection_Up) ? "Up" : "Down", _bIgnoreStartLevel ? "True" : "False", _bRollover ? "True" : "False" );
 	Msg* msg = new Msg( "SwitchMultilevel StartLevelChange", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );		
 	msg->Append( GetNodeId() );
 	msg->Append( 3 );
@@ -169,7 +168,7 @@ void SwitchToggleMultilevel::StopLevelChange
 (
 )
 {
-	Log::Write( LogLevel_Info, GetNodeId(), "SwitchToggleMultilevel::StopLevelChange - Stopping the level change" );
+	Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "SwitchToggleMultilevel::StopLevelChange - Stopping the level change" );
 	Msg* msg = new Msg( "SwitchToggleMultilevel StopLevelChange", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );		
 	msg->Append( GetNodeId() );
 	msg->Append( 2 );
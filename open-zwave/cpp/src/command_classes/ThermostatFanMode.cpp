@@ -225,20 +225,19 @@ bool ThermostatFanMode::HandleMsg
 		if( mode < m_supportedModes.size() )
 		{
 			// We have received the thermostat mode from the Z-Wave device
-			if( ValueList* valueList = static_cast<ValueList*>( GetValue( _instance, 0 ) ) )
+			if( ValueList* valueList = static_cast<ValueList*>( BorrowValue( _instance, 0 ) ) )
 			{
 				valueList->OnValueRefreshed( (int32)_data[1] );
-				Log::Write( LogLevel_Info, GetNodeId(), "Received thermostat fan mode: %s", valueList->GetItem().m_label.c_str() );		
-				valueList->Release();
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received thermostat fan mode: %s", valueList->GetItem().m_label.c_str() );		
 			}
 			else
 			{
-				Log::Write( LogLevel_Info, GetNodeId(), "Received thermostat fan mode: index %d", mode );
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received thermostat fan mode: index %d", mode );
 		  }
 		}
 		else
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "Received unknown thermostat fan mode: %d", mode );		
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received unknown thermostat fan mode: %d", mode );		
 		}
 		return true;
 	}
@@ -246,7 +245,7 @@ bool ThermostatFanMode::HandleMsg
 	if( ThermostatFanModeCmd_SupportedReport == (ThermostatFanModeCmd)_data[0] )
 	{
 		// We have received the supported thermostat fan modes from the Z-Wave device
-		Log::Write( LogLevel_Info, GetNodeId(), "Received supported thermostat fan modes" );		
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received supported thermostat fan modes" );		
 
 		m_supportedModes.clear();
 		for( uint32 i=1; i<_length-1; ++i )
@@ -260,14 +259,14 @@ bool ThermostatFanMode::HandleMsg
 					
 					if ((size_t)item.m_value >= sizeof(c_modeName)/sizeof(*c_modeName))
 					{
-						Log::Write( LogLevel_Info, GetNodeId(), "Received unknown fan mode: 0x%x", item.m_value);
+						Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received unknown fan mode: 0x%x", item.m_value);
 					}
 					else
 					{
 						item.m_label = c_modeName[item.m_value];
 						m_supportedModes.push_back( item );
 
-						Log::Write( LogLevel_Info, GetNodeId(), "    Added fan mode: %s", c_modeName[item.m_value].c_str() );
+						Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Added fan mode: %s", c_modeName[item.m_value].c_str() );
 					}
 				}
 			}
@@ -120,11 +120,10 @@ bool ThermostatFanState::HandleMsg
 	if( ThermostatFanStateCmd_Report == (ThermostatFanStateCmd)_data[0] )
 	{
 		// We have received the thermostat fan state from the Z-Wave device
-		if( ValueString* valueString = static_cast<ValueString*>( GetValue( _instance, 0 ) ) )
+		if( ValueString* valueString = static_cast<ValueString*>( BorrowValue( _instance, 0 ) ) )
 		{
 			valueString->OnValueRefreshed( c_stateName[_data[1]&0x0f] );
-			valueString->Release();
-			Log::Write( LogLevel_Info, GetNodeId(), "Received thermostat fan state: %s", valueString->GetValue().c_str() );		
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received thermostat fan state: %s", valueString->GetValue().c_str() );		
 		}
 		return true;
 	}
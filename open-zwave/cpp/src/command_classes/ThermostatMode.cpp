@@ -236,20 +236,19 @@ bool ThermostatMode::HandleMsg
 		if( mode < m_supportedModes.size() )
 		{
 			// We have received the thermostat mode from the Z-Wave device
-			if( ValueList* valueList = static_cast<ValueList*>( GetValue( _instance, 0 ) ) )
+			if( ValueList* valueList = static_cast<ValueList*>( BorrowValue( _instance, 0 ) ) )
 			{
 				valueList->OnValueRefreshed( mode );
-				Log::Write( LogLevel_Info, GetNodeId(), "Received thermostat mode: %s", valueList->GetItem().m_label.c_str() );
-				valueList->Release();
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received thermostat mode: %s", valueList->GetItem().m_label.c_str() );
 			}
 			else
 			{
-				Log::Write( LogLevel_Info, GetNodeId(), "Received thermostat mode: index %d", mode );
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received thermostat mode: index %d", mode );
 			}
 		}
 		else
 		{
-			 Log::Write( LogLevel_Info, GetNodeId(), "Received unknown thermostat mode: index %d", mode );
+			 Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received unknown thermostat mode: index %d", mode );
 		}
 		return true;
 	}
@@ -259,7 +258,7 @@ bool ThermostatMode::HandleMsg
 		// We have received the supported thermostat modes from the Z-Wave device
 		// these values are used to populate m_supportedModes which, in turn, is used to "seed" the values
 		// for each m_modes instance
-		Log::Write( LogLevel_Info, GetNodeId(), "Received supported thermostat modes" );		
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received supported thermostat modes" );		
 
 		m_supportedModes.clear();
 		for( uint32 i=1; i<_length-1; ++i )
@@ -273,14 +272,14 @@ bool ThermostatMode::HandleMsg
 					
 					if ((size_t)item.m_value >= sizeof(c_modeName)/sizeof(*c_modeName))
 					{
-						Log::Write( LogLevel_Info, GetNodeId(), "Received unknown thermostat mode: 0x%x", item.m_value);
+						Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received unknown thermostat mode: 0x%x", item.m_value);
 					}
 					else
 					{
 						item.m_label = c_modeName[item.m_value];
 						m_supportedModes.push_back( item );
 
-						Log::Write( LogLevel_Info, GetNodeId(), "    Added mode: %s", c_modeName[item.m_value] );
+						Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Added mode: %s", c_modeName[item.m_value] );
 					}
 				}
 			}
@@ -118,11 +118,10 @@ bool ThermostatOperatingState::HandleMsg
 	if( ThermostatOperatingStateCmd_Report == (ThermostatOperatingStateCmd)_data[0] )
 	{
 		// We have received the thermostat operating state from the Z-Wave device
-		if( ValueString* valueString = static_cast<ValueString*>( GetValue( _instance, 0 ) ) )
+		if( ValueString* valueString = static_cast<ValueString*>( BorrowValue( _instance, 0 ) ) )
 		{
 			valueString->OnValueRefreshed( c_stateName[_data[1]&0x0f] );
-			valueString->Release();
-			Log::Write( LogLevel_Info, GetNodeId(), "Received thermostat operating state: %s", valueString->GetValue().c_str() );		
+			OZW_LOG( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received thermostat operating state: %s", valueString->GetValue().c_str() );		
 		}
 		return true;
 	}
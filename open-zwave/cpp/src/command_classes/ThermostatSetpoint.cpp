@@ -218,11 +218,12 @@ bool ThermostatSetpoint::HandleMsg
 	if( ThermostatSetpointCmd_Report == (ThermostatSetpointCmd)_data[0] )
 	{
 		// We have received a thermostat setpoint value from the Z-Wave device
-		if( ValueDecimal* value = static_cast<ValueDecimal*>( GetValue( _instance, _data[1] ) ) )
+		if( ValueDecimal* value = static_cast<ValueDecimal*>( BorrowValue( _instance, _data[1] ) ) )
 		{
 			uint8 scale;
 			uint8 precision = 0;
-			string temperature = ExtractValue( &_data[2], &scale, &precision );
+			int32 rawValue = ExtractValue( &_data[2], &scale, &precision );
+			ValueDecimal::Fixed temperature( rawValue, precision );
 
 			value->SetUnits( scale ? "F" : "C" );
 			value->OnValueRefreshed( temperature );
@@ -230,9 +231,8 @@ bool ThermostatSetpoint::HandleMsg
 			{
 				value->SetPrecision( precision );
 			}
-			value->Release();
 
-			Log::Write( LogLevel_Info, GetNodeId(), "Received thermostat setpoint report: Setpoint %s = %s%s", value->GetLabel().c_str(), value->GetValue().c_str(), value->GetUnits().c_str() );		
+			OZW_LOG( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received thermostat setpoint report: Setpoint %s = %s%s", value->GetLabel().c_str(), value->GetValue().c_str(), value->GetUnits().c_str() );		
 		}
 		return true;
 	}
@@ -242,7 +242,7 @@ bool ThermostatSetpoint::HandleMsg
 		if( Node* node = GetNodeUnsafe() )
 		{
 			// We have received the supported thermostat setpoints from the Z-Wave device
-			Log::Write( LogLevel_Info, GetNodeId(), "Received supported thermostat setpoints" );		
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received supported thermostat setpoints" );		
 
 			// Parse the data for the supported setpoints
 			for( uint32 i=1; i<_length-1; ++i )
@@ -256,7 +256,7 @@ bool ThermostatSetpoint::HandleMsg
 						if( index < ThermostatSetpoint_Count )
 						{
 						  	node->CreateValueDecimal( ValueID::ValueGenre_User, GetCommandClassId(), _instance, index, c_setpointName[index], "C", false, false, "0.0", 0 );
-							Log::Write( LogLevel_Info, GetNodeId(), "    Added setpoint: %s", c_setpointName[index] );
+							Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "    Added setpoint: %s", c_setpointName[index] );
 						}
 					}
 				}
@@ -287,11 +287,12 @@ bool ThermostatSetpoint::SetValue
 		Msg* msg = new Msg( "Set Thermostat Setpoint", GetNodeId(), REQUEST, FUNC_ID_ZW_SEND_DATA, true );
 		msg->SetInstance( this, _value.GetID().GetInstance() );
 		msg->Append( GetNodeId() );
-		msg->Append( 4 + GetAppendValueSize( value->GetValue() ) );
+		ValueDecimal::Fixed const& setpoint = value->GetFixed();
+		msg->Append( 4 + GetAppendValueSize( setpoint.m_value, setpoint.m_places ) );
 		msg->Append( GetCommandClassId() );
 		msg->Append( ThermostatSetpointCmd_Set );
 		msg->Append( value->GetID().GetIndex() );
-		AppendValue( msg, value->GetValue(), scale );
+		AppendValue( msg, setpoint.m_value, setpoint.m_places, scale );
 		msg->Append( TRANSMIT_OPTION_ACK | TRANSMIT_OPTION_AUTO_ROUTE );
 		GetDriver()->SendMsg( msg, Driver::MsgQueue_Send );
 		return true;
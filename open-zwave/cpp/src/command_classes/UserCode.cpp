@@ -176,19 +176,18 @@ bool UserCode::HandleMsg
 		ClearStaticRequest( StaticRequest_Values );
 		if( m_userCodeCount == 0 )
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "Received User Number report from node %d: Not supported", GetNodeId() );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received User Number report from node %d: Not supported", GetNodeId() );
 		}
 		else
 		{
-			Log::Write( LogLevel_Info, GetNodeId(), "Received User Number report from node %d: Supported Codes %d (%d)", GetNodeId(), m_userCodeCount, _data[1] );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received User Number report from node %d: Supported Codes %d (%d)", GetNodeId(), m_userCodeCount, _data[1] );
 		}
 
 		// Hopefully the user code number doesn't change or this code will need to
 		ValueByte *value;
-		if( ( value = static_cast<ValueByte*>( GetValue( _instance, m_userCodeCount ) ) ) != NULL )
+		if( ( value = static_cast<ValueByte*>( BorrowValue( _instance, m_userCodeCount ) ) ) != NULL )
 		{
 			value->OnValueRefreshed( m_userCodeCount );
-			value->Release();
 		}
 
 		if( Node* node = GetNodeUnsafe() )
@@ -219,15 +218,14 @@ bool UserCode::HandleMsg
 		{
 			i = m_userCodeCount + 1;
 		}
-		if( ValueString* value = static_cast<ValueString*>( GetValue( _instance, i ) ) )
+		if( ValueString* value = static_cast<ValueString*>( BorrowValue( _instance, i ) ) )
 		{
 			uint8 size = _length - 3;
 			m_userCodesStatus[i-1] = _data[2];
 			memcpy( str, &_data[3], size );
 			value->OnValueRefreshed( str );
-			value->Release();
 		}
-		Log::Write( LogLevel_Info, GetNodeId(), "Received User Code Report from node %d for User Code %d", GetNodeId(), i);
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received User Code Report from node %d for User Code %d", GetNodeId(), i);
 		return true;
 	}
 
@@ -136,23 +136,20 @@ bool Version::HandleMsg
 			snprintf( protocol, sizeof(protocol), "%d.%.2d", _data[2], _data[3] );
 			snprintf( application, sizeof(application), "%d.%.2d", _data[4], _data[5] );
 
-			Log::Write( LogLevel_Info, GetNodeId(), "Received Version report from node %d: Library=%s, Protocol=%s, Application=%s", GetNodeId(), library, protocol, application );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Version report from node %d: Library=%s, Protocol=%s, Application=%s", GetNodeId(), library, protocol, application );
 			ClearStaticRequest( StaticRequest_Values );
 
-			if( ValueString* libraryValue = static_cast<ValueString*>( GetValue( _instance, VersionIndex_Library ) ) )
+			if( ValueString* libraryValue = static_cast<ValueString*>( BorrowValue( _instance, VersionIndex_Library ) ) )
 			{
 				libraryValue->OnValueRefreshed( library );
-				libraryValue->Release();
 			}
-			if( ValueString* protocolValue = static_cast<ValueString*>( GetValue( _instance, VersionIndex_Protocol ) ) )
+			if( ValueString* protocolValue = static_cast<ValueString*>( BorrowValue( _instance, VersionIndex_Protocol ) ) )
 			{
 				protocolValue->OnValueRefreshed( protocol );
-				protocolValue->Release();
 			}
-			if( ValueString* applicationValue = static_cast<ValueString*>( GetValue( _instance, VersionIndex_Application ) ) )
+			if( ValueString* applicationValue = static_cast<ValueString*>( BorrowValue( _instance, VersionIndex_Application ) ) )
 			{
 				applicationValue->OnValueRefreshed( application );
-				applicationValue->Release();
 			}
 
 			return true;
@@ -162,7 +159,7 @@ bool Version::HandleMsg
 		{
 			if( CommandClass* pCommandClass = node->GetCommandClass( _data[1] ) )
 			{
-				Log::Write( LogLevel_Info, GetNodeId(), "Received Command Class Version report from node %d: CommandClass=%s, Version=%d", GetNodeId(), pCommandClass->GetCommandClassName().c_str(), _data[2] );
+				Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Command Class Version report from node %d: CommandClass=%s, Version=%d", GetNodeId(), pCommandClass->GetCommandClassName().c_str(), _data[2] );
 				pCommandClass->ClearStaticRequest( StaticRequest_Version );
 				pCommandClass->SetVersion( _data[2] );
 			}
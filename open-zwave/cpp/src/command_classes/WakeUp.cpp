@@ -181,15 +181,14 @@ bool WakeUp::HandleMsg
 {
 	if( WakeUpCmd_IntervalReport == (WakeUpCmd)_data[0] )
 	{	
-		if( ValueInt* value = static_cast<ValueInt*>( GetValue( _instance, 0 ) ) )
+		if( ValueInt* value = static_cast<ValueInt*>( BorrowValue( _instance, 0 ) ) )
 		{
 			// some interval reports received are validly formatted (proper checksum, etc.) but only have length
 			// of 3 (0x84 (classid), 0x06 (IntervalReport), 0x00).  Not sure what this means
 			if( _length < 6 )
 			{
 				Log::Write( LogLevel_Warning, "" );
-				Log::Write( LogLevel_Warning, GetNodeId(), "Unusual response: WakeUpCmd_IntervalReport with len = %d.  Ignored.", _length );
-				value->Release();
+				Log::Write( LogLevel_Warning, GetNodeId(), GetCommandClassId(), "Unusual response: WakeUpCmd_IntervalReport with len = %d.  Ignored.", _length );
 				return false;
 			}
 
@@ -199,7 +198,7 @@ bool WakeUp::HandleMsg
 
 			uint8 targetNodeId = _data[4];
 
-			Log::Write( LogLevel_Info, GetNodeId(), "Received Wakeup Interval report from node %d: Interval=%d, Target Node=%d", GetNodeId(), interval, targetNodeId );
+			Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Wakeup Interval report from node %d: Interval=%d, Target Node=%d", GetNodeId(), interval, targetNodeId );
 
 			value->OnValueRefreshed( (int32)interval );
 		
@@ -208,14 +207,13 @@ bool WakeUp::HandleMsg
 			{
 				SetValue( *value );	
 			}
-			value->Release();
  		}
 		return true;
 	}
 	else if( WakeUpCmd_Notification == (WakeUpCmd)_data[0] )
 	{	
 		// The device is awake.
-		Log::Write( LogLevel_Info, GetNodeId(), "Received Wakeup Notification from node %d", GetNodeId() );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Wakeup Notification from node %d", GetNodeId() );
 		m_notification = true;
 		SetAwake( true );				
 		return true;
@@ -226,25 +224,21 @@ bool WakeUp::HandleMsg
 		uint32 maxinterval = (((uint32)_data[4]) << 16) | (((uint32)_data[5]) << 8) | ((uint32)_data[6]);
 		uint32 definterval = (((uint32)_data[7]) << 16) | (((uint32)_data[8]) << 8) | ((uint32)_data[9]);
 		uint32 stepinterval = (((uint32)_data[10]) << 16) | (((uint32)_data[11]) << 8) | ((uint32)_data[12]);
-		Log::Write( LogLevel_Info, GetNodeId(), "Received Wakeup Interval Capability report from node %d: Min Interval=%d, Max Interval=%d, Default Interval=%d, Interval Step=%d", GetNodeId(), mininterval, maxinterval, definterval, stepinterval );
-		if( ValueInt* value = static_cast<ValueInt*>( GetValue( _instance, 1 ) ) )
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "Received Wakeup Interval Capability report from node %d: Min Interval=%d, Max Interval=%d, Default Interval=%d, Interval Step=%d", GetNodeId(), mininterval, maxinterval, definterval, stepinterval );
+		if( ValueInt* value = static_cast<ValueInt*>( BorrowValue( _instance, 1 ) ) )
 		{
-			value->Release();
 			value->OnValueRefreshed( (int32)mininterval );
 		}
-		if( ValueInt* value = static_cast<ValueInt*>( GetValue( _instance, 2 ) ) )
+		if( ValueInt* value = static_cast<ValueInt*>( BorrowValue( _instance, 2 ) ) )
 		{
-			value->Release();
 			value->OnValueRefreshed( (int32)maxinterval );
 		}
-		if( ValueInt* value = static_cast<ValueInt*>( GetValue( _instance, 3 ) ) )
+		if( ValueInt* value = static_cast<ValueInt*>( BorrowValue( _instance, 3 ) ) )
 		{
-			value->Release();
 			value->OnValueRefreshed( (int32)definterval );
 		}
-		if( ValueInt* value = static_cast<ValueInt*>( GetValue( _instance, 4 ) ) )
+		if( ValueInt* value = static_cast<ValueInt*>( BorrowValue( _instance, 4 ) ) )
 		{
-			value->Release();
 			value->OnValueRefreshed( (int32)stepinterval );
 		}
 	}
@@ -305,7 +299,11 @@ void WakeUp::SetAwake
 	if( m_awake != _state )
 	{
 		m_awake = _state;
-		Log::Write( LogLevel_Info, GetNodeId(), "  Node %d has been marked as %s", GetNodeId(), m_awake ? "awake" : "asleep" );
+		Log::Write( LogLevel_Info, GetNodeId(), GetCommandClassId(), "  Node %d has been marked as %s", GetNodeId(), m_awake ? "awake" : "asleep" );
+		if( Node* node = GetNodeUnsafe() )
+		{
+			node->TouchSnapshot();
+		}
 	}
 
 	if( m_awake )
@@ -371,7 +369,14 @@ void WakeUp::SendPending
 (
 )
 {
-	m_awake = true;
+	if( !m_awake )
+	{
+		m_awake = true;
+		if( Node* node = GetNodeUnsafe() )
+		{
+			node->TouchSnapshot();
+		}
+	}
 
 	m_mutex->Lock();
 	list<Driver::MsgQueueItem>::iterator it = m_pendingQueue.begin();
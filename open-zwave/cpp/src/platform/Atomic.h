@@ -0,0 +1,138 @@
+//-----------------------------------------------------------------------------
+//
+//	Atomic.h
+//
+//	Lock-free operations on integers shared between threads
+//
+//	Copyright (c) 2010 Mal Lansell <mal@lansell.org>
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _Atomic_H
+#define _Atomic_H
+
+#include "Defs.h"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#pragma intrinsic( _InterlockedExchangeAdd, _InterlockedExchange, _InterlockedCompareExchange, _InterlockedCompareExchange64, _ReadWriteBarrier )
+#endif
+
+namespace OpenZWave
+{
+	/** \brief Lock-free operations on integers that are shared between threads.
+	 *
+	 * Every operation is a full memory barrier, so a value written with one
+	 * of these functions can safely be used to publish other data to a thread
+	 * that reads it with another.  The 64-bit functions are atomic even on
+	 * 32-bit processors.
+	 */
+	class Atomic
+	{
+	public:
+		/**
+		 * Add to a value.
+		 * \return the new value.
+		 */
+		static uint32 Add( uint32 volatile* _value, uint32 const _amount )
+		{
+#ifdef _MSC_VER
+			return( (uint32)_InterlockedExchangeAdd( (long volatile*)_value, (long)_amount ) + _amount );
+#else
+			return __sync_add_and_fetch( _value, _amount );
+#endif
+		}
+
+		/**
+		 * Read a value.
+		 */
+		static uint32 Load( uint32 volatile const* _value )
+		{
+#ifdef _MSC_VER
+			uint32 result = *_value;
+			_ReadWriteBarrier();
+			return result;
+#else
+			return __sync_add_and_fetch( const_cast<uint32 volatile*>( _value ), 0 );
+#endif
+		}
+
+		/**
+		 * Replace a value.
+		 */
+		static void Store( uint32 volatile* _value, uint32 const _newValue )
+		{
+#ifdef _MSC_VER
+			_InterlockedExchange( (long volatile*)_value, (long)_newValue );
+#else
+			__sync_synchronize();
+			*_value = _newValue;
+			__sync_synchronize();
+#endif
+		}
+
+		/**
+		 * Replace a value, but only if it still holds the expected contents.
+		 * \return true if the value was replaced.
+		 */
+		static bool CompareExchange( uint32 volatile* _value, uint32 const _expected, uint32 const _newValue )
+		{
+#ifdef _MSC_VER
+			return( (uint32)_InterlockedCompareExchange( (long volatile*)_value, (long)_newValue, (long)_expected ) == _expected );
+#else
+			return __sync_bool_compare_and_swap( _value, _expected, _newValue );
+#endif
+		}
+
+		/**
+		 * Add to a 64-bit value.
+		 * \return the new value.
+		 */
+		static uint64 Add( uint64 volatile* _value, uint64 const _amount )
+		{
+#ifdef _MSC_VER
+			uint64 oldValue;
+			do
+			{
+				oldValue = *_value;
+			}
+			while( (uint64)_InterlockedCompareExchange64( (__int64 volatile*)_value, (__int64)( oldValue + _amount ), (__int64)oldValue ) != oldValue );
+			return( oldValue + _amount );
+#else
+			return __sync_add_and_fetch( _value, _amount );
+#endif
+		}
+
+		/**
+		 * Read a 64-bit value.
+		 */
+		static uint64 Load( uint64 volatile const* _value )
+		{
+#ifdef _MSC_VER
+			return (uint64)_InterlockedCompareExchange64( (__int64 volatile*)_value, 0, 0 );
+#else
+			return __sync_add_and_fetch( const_cast<uint64 volatile*>( _value ), 0 );
+#endif
+		}
+	};
+
+} // namespace OpenZWave
+
+#endif //_Atomic_H
@@ -39,6 +39,7 @@ namespace OpenZWave
 	class Event: public Wait
 	{
 		friend class SerialControllerImpl;
+		friend class LogWriter;
 		friend class Wait;
 
 	public:
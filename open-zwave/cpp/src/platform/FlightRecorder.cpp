@@ -0,0 +1,1011 @@
+//-----------------------------------------------------------------------------
+//
+//	FlightRecorder.cpp
+//
+//	Compact binary history of recent log messages
+//
+//	Copyright (c) 2010 Mal Lansell <mal@lansell.org>
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include <stddef.h>
+#include <vector>
+#include "Defs.h"
+#include "FlightRecorder.h"
+#include "TimeStamp.h"
+
+using namespace OpenZWave;
+
+static uint32 const c_maxPayload	= 512;		// Largest amount of argument data or frame bytes kept per record
+static uint32 const c_maxString		= 255;		// Longest string argument that is copied.  Longer ones mark the record as truncated.
+static uint32 const c_maxText		= 1024;		// Longest decoded message
+static char const c_fileMagic[8]	= { 'O', 'Z', 'W', 'F', 'R', '0', '0', '1' };
+
+//-----------------------------------------------------------------------------
+// Serialisation of argument values and saved files.  Values are always stored
+// little-endian, so that a saved file can be decoded on any machine.
+//-----------------------------------------------------------------------------
+static void Put16( uint8* _buffer, uint16 _value )
+{
+	_buffer[0] = (uint8)_value;
+	_buffer[1] = (uint8)( _value >> 8 );
+}
+
+static void Put64( uint8* _buffer, uint64 _value )
+{
+	for( uint32 i=0; i<8; ++i )
+	{
+		_buffer[i] = (uint8)( _value >> ( 8 * i ) );
+	}
+}
+
+static uint16 Get16( uint8 const* _buffer )
+{
+	return (uint16)( _buffer[0] | ( _buffer[1] << 8 ) );
+}
+
+static uint64 Get64( uint8 const* _buffer )
+{
+	uint64 value = 0;
+	for( uint32 i=0; i<8; ++i )
+	{
+		value |= ( (uint64)_buffer[i] ) << ( 8 * i );
+	}
+	return value;
+}
+
+//-----------------------------------------------------------------------------
+// Parsing of printf conversions.  The same parser is used when recording and
+// decoding, so that the arguments are always read back as they were written.
+//-----------------------------------------------------------------------------
+enum ArgType
+{
+	ArgType_Invalid = 0,		// Malformed conversion - the rest of the format is copied as it is
+	ArgType_Percent,		// %% - takes no argument
+	ArgType_Int,
+	ArgType_Unsigned,
+	ArgType_Double,
+	ArgType_String,
+	ArgType_Pointer
+};
+
+enum ArgSize
+{
+	ArgSize_Default = 0,
+	ArgSize_Char,
+	ArgSize_Short,
+	ArgSize_Long,
+	ArgSize_LongLong,
+	ArgSize_Size,
+	ArgSize_PtrDiff,
+	ArgSize_LongDouble
+};
+
+struct Conversion
+{
+	char	m_spec[32];		// The conversion rebuilt for snprintf, with a portable length modifier
+	uint32	m_numStars;		// Number of '*' width or precision arguments
+	ArgType	m_type;
+	ArgSize	m_size;
+	bool	m_bOutput;		// False for %n, which produces no text
+};
+
+//-----------------------------------------------------------------------------
+// <ParseConversion>
+// Parse the conversion that starts at the '%' pointed to by _format
+// Returns a pointer to the first character after the conversion
+//-----------------------------------------------------------------------------
+static char const* ParseConversion
+(
+	char const* _format,
+	Conversion* _conv
+)
+{
+	char const* p = _format + 1;
+	uint32 len = 0;
+
+	_conv->m_numStars = 0;
+	_conv->m_type = ArgType_Invalid;
+	_conv->m_size = ArgSize_Default;
+	_conv->m_bOutput = true;
+	_conv->m_spec[len++] = '%';
+
+	// Flags, width and precision are copied as they are
+	while( *p && strchr( "-+ #0", *p ) && ( len < 20 ) )
+	{
+		_conv->m_spec[len++] = *p++;
+	}
+	for( uint32 part=0; part<2; ++part )
+	{
+		if( part && ( *p == '.' ) )
+		{
+			_conv->m_spec[len++] = *p++;
+		}
+		if( *p == '*' )
+		{
+			++_conv->m_numStars;
+			_conv->m_spec[len++] = *p++;
+		}
+		else
+		{
+			while( ( *p >= '0' ) && ( *p <= '9' ) && ( len < 24 ) )
+			{
+				_conv->m_spec[len++] = *p++;
+			}
+		}
+	}
+
+	// Length modifier
+	if( ( p[0] == 'h' ) && ( p[1] == 'h' ) )			{ _conv->m_size = ArgSize_Char; p += 2; }
+	else if( p[0] == 'h' )						{ _conv->m_size = ArgSize_Short; ++p; }
+	else if( ( p[0] == 'l' ) && ( p[1] == 'l' ) )			{ _conv->m_size = ArgSize_LongLong; p += 2; }
+	else if( p[0] == 'l' )						{ _conv->m_size = ArgSize_Long; ++p; }
+	else if( ( p[0] == 'q' ) || ( p[0] == 'j' ) )			{ _conv->m_size = ArgSize_LongLong; ++p; }
+	else if( p[0] == 'z' )						{ _conv->m_size = ArgSize_Size; ++p; }
+	else if( p[0] == 't' )						{ _conv->m_size = ArgSize_PtrDiff; ++p; }
+	else if( p[0] == 'L' )						{ _conv->m_size = ArgSize_LongDouble; ++p; }
+	else if( ( p[0] == 'I' ) && ( p[1] == '6' ) && ( p[2] == '4' ) )	{ _conv->m_size = ArgSize_LongLong; p += 3; }
+	else if( ( p[0] == 'I' ) && ( p[1] == '3' ) && ( p[2] == '2' ) )	{ p += 3; }
+	else if( p[0] == 'I' )						{ _conv->m_size = ArgSize_Size; ++p; }
+
+	char conversion = *p;
+	switch( conversion )
+	{
+		case '%':
+		{
+			_conv->m_type = ArgType_Percent;
+			break;
+		}
+		case 'd':
+		case 'i':
+		{
+			_conv->m_type = ArgType_Int;
+			break;
+		}
+		case 'c':
+		{
+			// Wide characters are shown by value
+			_conv->m_type = ArgType_Int;
+			if( _conv->m_size == ArgSize_Long )
+			{
+				conversion = 'x';
+				_conv->m_type = ArgType_Unsigned;
+				_conv->m_size = ArgSize_Default;
+			}
+			break;
+		}
+		case 'o':
+		case 'u':
+		case 'x':
+		case 'X':
+		{
+			_conv->m_type = ArgType_Unsigned;
+			break;
+		}
+		case 'e':
+		case 'E':
+		case 'f':
+		case 'F':
+		case 'g':
+		case 'G':
+		case 'a':
+		case 'A':
+		{
+			_conv->m_type = ArgType_Double;
+			break;
+		}
+		case 's':
+		{
+			// Wide strings cannot be copied, so only their address is shown
+			_conv->m_type = ArgType_String;
+			if( _conv->m_size == ArgSize_Long )
+			{
+				conversion = 'p';
+				_conv->m_type = ArgType_Pointer;
+			}
+			break;
+		}
+		case 'p':
+		{
+			_conv->m_type = ArgType_Pointer;
+			break;
+		}
+		case 'n':
+		{
+			_conv->m_type = ArgType_Pointer;
+			_conv->m_bOutput = false;
+			break;
+		}
+		default:
+		{
+			return _format;
+		}
+	}
+
+	// Replace the length modifier with one that works everywhere.  Values
+	// narrower than int are cast back to their own type before formatting,
+	// so they need no modifier at all.
+	if( ( _conv->m_type == ArgType_Int ) || ( _conv->m_type == ArgType_Unsigned ) )
+	{
+		if( _conv->m_size == ArgSize_Long )
+		{
+			_conv->m_spec[len++] = 'l';
+		}
+		else if( ( _conv->m_size == ArgSize_LongLong ) || ( _conv->m_size == ArgSize_Size ) || ( _conv->m_size == ArgSize_PtrDiff ) )
+		{
+			_conv->m_spec[len++] = 'l';
+			_conv->m_spec[len++] = 'l';
+		}
+	}
+	_conv->m_spec[len++] = conversion;
+	_conv->m_spec[len] = 0;
+	return p + 1;
+}
+
+//-----------------------------------------------------------------------------
+// <FormatValue>
+// Format a single value, passing any '*' arguments first
+//-----------------------------------------------------------------------------
+template <class T>
+static void FormatValue
+(
+	char* _buffer,
+	uint32 _size,
+	Conversion const& _conv,
+	int32 const* _stars,
+	T _value
+)
+{
+	switch( _conv.m_numStars )
+	{
+		case 0:		snprintf( _buffer, _size, _conv.m_spec, _value );			break;
+		case 1:		snprintf( _buffer, _size, _conv.m_spec, _stars[0], _value );		break;
+		default:	snprintf( _buffer, _size, _conv.m_spec, _stars[0], _stars[1], _value );	break;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <AppendText>
+// Append as much of a string to the buffer as will fit
+//-----------------------------------------------------------------------------
+static void AppendText
+(
+	char* _buffer,
+	uint32 _size,
+	uint32* _pos,
+	char const* _text,
+	uint32 _length
+)
+{
+	if( *_pos + _length >= _size )
+	{
+		_length = _size - *_pos - 1;
+	}
+	memcpy( _buffer + *_pos, _text, _length );
+	*_pos += _length;
+	_buffer[*_pos] = 0;
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::FlightRecorder>
+// Constructor
+//-----------------------------------------------------------------------------
+FlightRecorder::FlightRecorder
+(
+	uint32 _size
+):
+	m_size( _size & ~7 ),
+	m_head( 0 ),
+	m_tail( 0 ),
+	m_count( 0 )
+{
+	m_buffer = new uint8[m_size];
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::~FlightRecorder>
+// Destructor
+//-----------------------------------------------------------------------------
+FlightRecorder::~FlightRecorder
+(
+)
+{
+	delete [] m_buffer;
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::Record>
+// Record a message and the raw values of its arguments
+//-----------------------------------------------------------------------------
+void FlightRecorder::Record
+(
+	LogLevel _level,
+	uint8 const _nodeId,
+	uint32 const _threadId,
+	char const* _format,
+	va_list _args
+)
+{
+	uint8 data[c_maxPayload];
+	bool bTruncated = false;
+
+	RecordHeader header;
+	header.m_level = (uint8)_level;
+	header.m_nodeId = _nodeId;
+	header.m_type = RecordType_Message;
+	header.m_dataLength = (uint16)CaptureArgs( _format, _args, data, sizeof(data), &bTruncated );
+	header.m_flags = bTruncated ? RecordFlag_Truncated : 0;
+	header.m_threadId = _threadId;
+	header.m_time = TimeStamp::GetWallClockTime();
+	header.m_format = _format;
+	Append( header, data );
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::RecordData>
+// Record a block of binary data
+//-----------------------------------------------------------------------------
+void FlightRecorder::RecordData
+(
+	LogLevel _level,
+	uint8 const _nodeId,
+	uint32 const _threadId,
+	char const* _label,
+	uint8 const* _data,
+	uint32 const _length
+)
+{
+	RecordHeader header;
+	header.m_level = (uint8)_level;
+	header.m_nodeId = _nodeId;
+	header.m_type = RecordType_Data;
+	header.m_dataLength = (uint16)( ( _length > c_maxPayload ) ? c_maxPayload : _length );
+	header.m_flags = ( _length > c_maxPayload ) ? RecordFlag_Truncated : 0;
+	header.m_threadId = _threadId;
+	header.m_time = TimeStamp::GetWallClockTime();
+	header.m_format = _label;
+	Append( header, _data );
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::Replay>
+// Decode every record, oldest first
+//-----------------------------------------------------------------------------
+void FlightRecorder::Replay
+(
+	pfnEntryCallback_t _callback,
+	void* _context
+)const
+{
+	uint32 pos = m_head;
+	for( uint32 i=0; i<m_count; ++i )
+	{
+		RecordHeader header;
+		pos = ReadHeader( pos, &header );
+		Decode( header, header.m_format, &m_buffer[pos + sizeof(header)], _callback, _context );
+
+		pos += header.m_length;
+		if( pos >= m_size )
+		{
+			pos = 0;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::Clear>
+// Discard all records
+//-----------------------------------------------------------------------------
+void FlightRecorder::Clear
+(
+)
+{
+	m_head = 0;
+	m_tail = 0;
+	m_count = 0;
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::Save>
+// Write the records to a file, replacing the format pointers with the text
+//-----------------------------------------------------------------------------
+bool FlightRecorder::Save
+(
+	string const& _filename
+)const
+{
+	FILE* pFile = fopen( _filename.c_str(), "wb" );
+	if( pFile == NULL )
+	{
+		return false;
+	}
+
+	uint8 buf[32];
+	memcpy( buf, c_fileMagic, sizeof(c_fileMagic) );
+	Put64( &buf[8], m_count );
+	bool res = ( fwrite( buf, 1, 16, pFile ) == 16 );
+
+	uint32 pos = m_head;
+	for( uint32 i=0; res && ( i<m_count ); ++i )
+	{
+		RecordHeader header;
+		pos = ReadHeader( pos, &header );
+
+		uint16 formatLength = (uint16)strlen( header.m_format );
+		Put16( &buf[0], header.m_dataLength );
+		buf[2] = header.m_level;
+		buf[3] = header.m_nodeId;
+		buf[4] = header.m_type;
+		buf[5] = header.m_flags;
+		Put16( &buf[6], formatLength );
+		Put64( &buf[8], header.m_threadId );
+		Put64( &buf[16], (uint64)header.m_time );
+		res = ( fwrite( buf, 1, 24, pFile ) == 24 )
+			&& ( fwrite( header.m_format, 1, formatLength, pFile ) == formatLength )
+			&& ( fwrite( &m_buffer[pos + sizeof(header)], 1, header.m_dataLength, pFile ) == header.m_dataLength );
+
+		pos += header.m_length;
+		if( pos >= m_size )
+		{
+			pos = 0;
+		}
+	}
+
+	if( fclose( pFile ) != 0 )
+	{
+		res = false;
+	}
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::Load>
+// Decode the records in a file written by Save
+//-----------------------------------------------------------------------------
+bool FlightRecorder::Load
+(
+	string const& _filename,
+	pfnEntryCallback_t _callback,
+	void* _context
+)
+{
+	FILE* pFile = fopen( _filename.c_str(), "rb" );
+	if( pFile == NULL )
+	{
+		return false;
+	}
+
+	uint8 buf[24];
+	bool res = ( fread( buf, 1, 16, pFile ) == 16 ) && !memcmp( buf, c_fileMagic, sizeof(c_fileMagic) );
+	uint64 count = res ? Get64( &buf[8] ) : 0;
+
+	vector<char> format( 65536 );
+	vector<uint8> data( 65536 );
+	for( uint64 i=0; res && ( i<count ); ++i )
+	{
+		res = ( fread( buf, 1, 24, pFile ) == 24 );
+		if( !res )
+		{
+			break;
+		}
+
+		RecordHeader header;
+		header.m_length = 0;
+		header.m_dataLength = Get16( &buf[0] );
+		header.m_level = buf[2];
+		header.m_nodeId = buf[3];
+		header.m_type = buf[4];
+		header.m_flags = buf[5];
+		uint16 formatLength = Get16( &buf[6] );
+		header.m_threadId = (uint32)Get64( &buf[8] );
+		header.m_time = (int64)Get64( &buf[16] );
+		header.m_format = &format[0];
+
+		res = ( fread( &format[0], 1, formatLength, pFile ) == formatLength )
+			&& ( fread( &data[0], 1, header.m_dataLength, pFile ) == header.m_dataLength );
+		if( res )
+		{
+			format[formatLength] = 0;
+			Decode( header, &format[0], &data[0], _callback, _context );
+		}
+	}
+
+	fclose( pFile );
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::FormatEntry>
+// Format an entry as a complete log line
+//-----------------------------------------------------------------------------
+void FlightRecorder::FormatEntry
+(
+	Entry const& _entry,
+	char* _buffer,
+	uint32 _size
+)
+{
+	char timeStr[32];
+	TimeStamp::FormatWallClockTime( _entry.m_time, timeStr, sizeof(timeStr) );
+
+	char nodeStr[16] = "";
+	if( _entry.m_nodeId == 255 )
+	{
+		snprintf( nodeStr, sizeof(nodeStr), "contrlr, " );
+	}
+	else if( _entry.m_nodeId )
+	{
+		snprintf( nodeStr, sizeof(nodeStr), "Node%03d, ", _entry.m_nodeId );
+	}
+
+	snprintf( _buffer, _size, "%s%08x %s%s", timeStr, _entry.m_threadId, nodeStr, _entry.m_text );
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::Append>
+// Add a record to the ring buffer, discarding the oldest to make room
+//-----------------------------------------------------------------------------
+void FlightRecorder::Append
+(
+	RecordHeader& _header,
+	uint8 const* _data
+)
+{
+	uint32 length = ( sizeof(RecordHeader) + _header.m_dataLength + 7 ) & ~7;
+	if( length > m_size )
+	{
+		return;
+	}
+	_header.m_length = (uint16)length;
+
+	if( m_tail + length > m_size )
+	{
+		// Not enough room before the end of the buffer, so mark the
+		// end and start again from the beginning.
+		DiscardRange( m_tail, m_size );
+		if( m_count )
+		{
+			Put16( &m_buffer[m_tail], 0 );
+		}
+		m_tail = 0;
+	}
+
+	DiscardRange( m_tail, m_tail + length );
+	if( !m_count )
+	{
+		m_head = m_tail;
+	}
+
+	memcpy( &m_buffer[m_tail], &_header, sizeof(RecordHeader) );
+	memcpy( &m_buffer[m_tail + sizeof(RecordHeader)], _data, _header.m_dataLength );
+	++m_count;
+
+	m_tail += length;
+	if( m_tail >= m_size )
+	{
+		m_tail = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::DiscardOldest>
+// Remove the oldest record
+//-----------------------------------------------------------------------------
+void FlightRecorder::DiscardOldest
+(
+)
+{
+	uint16 length;
+	memcpy( &length, &m_buffer[m_head], sizeof(length) );
+	if( !length )
+	{
+		// End of buffer marker rather than a record
+		m_head = 0;
+		return;
+	}
+
+	--m_count;
+	m_head += length;
+	if( m_head >= m_size )
+	{
+		m_head = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::ReadHeader>
+// Copy the header of the record at an offset, skipping over an end of buffer
+// marker.  The marker is only a length, and may be too close to the end of
+// the buffer for a whole header to be read there.
+// Returns the offset of the record
+//-----------------------------------------------------------------------------
+uint32 FlightRecorder::ReadHeader
+(
+	uint32 _pos,
+	RecordHeader* o_header
+)const
+{
+	uint16 length;
+	memcpy( &length, &m_buffer[_pos], sizeof(length) );
+	if( !length )
+	{
+		// End of buffer marker - the next record is at the start
+		_pos = 0;
+	}
+
+	memcpy( o_header, &m_buffer[_pos], sizeof(*o_header) );
+	return _pos;
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::DiscardRange>
+// Remove the oldest records until none start within a range of the buffer
+//-----------------------------------------------------------------------------
+void FlightRecorder::DiscardRange
+(
+	uint32 _start,
+	uint32 _end
+)
+{
+	while( m_count && ( m_head >= _start ) && ( m_head < _end ) )
+	{
+		DiscardOldest();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::CaptureArgs>
+// Store the values of the arguments referred to by a format string
+// Returns the number of bytes used
+//-----------------------------------------------------------------------------
+uint32 FlightRecorder::CaptureArgs
+(
+	char const* _format,
+	va_list _args,
+	uint8* _buffer,
+	uint32 _size,
+	bool* _bTruncated
+)
+{
+	uint32 pos = 0;
+	char const* p = _format;
+	while( ( p = strchr( p, '%' ) ) != NULL )
+	{
+		Conversion conv;
+		char const* next = ParseConversion( p, &conv );
+		if( conv.m_type == ArgType_Invalid )
+		{
+			break;
+		}
+		p = next;
+		if( conv.m_type == ArgType_Percent )
+		{
+			continue;
+		}
+
+		// Fetch the values
+		int32 stars[2] = { 0, 0 };
+		for( uint32 i=0; i<conv.m_numStars; ++i )
+		{
+			stars[i] = va_arg( _args, int );
+		}
+
+		uint64 value = 0;
+		char const* str = NULL;
+		uint32 strLength = 0;
+		switch( conv.m_type )
+		{
+			case ArgType_Int:
+			{
+				switch( conv.m_size )
+				{
+					case ArgSize_Long:		value = (uint64)(int64)va_arg( _args, long );		break;
+					case ArgSize_LongLong:		value = (uint64)va_arg( _args, int64 );		break;
+					case ArgSize_Size:		value = (uint64)(int64)va_arg( _args, ptrdiff_t );	break;
+					case ArgSize_PtrDiff:		value = (uint64)(int64)va_arg( _args, ptrdiff_t );	break;
+					default:			value = (uint64)(int64)va_arg( _args, int );		break;
+				}
+				break;
+			}
+			case ArgType_Unsigned:
+			{
+				switch( conv.m_size )
+				{
+					case ArgSize_Long:		value = (uint64)va_arg( _args, unsigned long );	break;
+					case ArgSize_LongLong:		value = va_arg( _args, uint64 );			break;
+					case ArgSize_Size:		value = (uint64)va_arg( _args, size_t );		break;
+					case ArgSize_PtrDiff:		value = (uint64)va_arg( _args, size_t );		break;
+					default:			value = (uint64)va_arg( _args, unsigned int );		break;
+				}
+				break;
+			}
+			case ArgType_Double:
+			{
+				double d = ( conv.m_size == ArgSize_LongDouble ) ? (double)va_arg( _args, long double ) : va_arg( _args, double );
+				memcpy( &value, &d, sizeof(value) );
+				break;
+			}
+			case ArgType_String:
+			{
+				str = va_arg( _args, char const* );
+				if( str == NULL )
+				{
+					str = "(null)";
+				}
+				strLength = (uint32)strlen( str );
+				if( strLength > c_maxString )
+				{
+					strLength = c_maxString;
+					*_bTruncated = true;
+				}
+				break;
+			}
+			default:
+			{
+				value = (uint64)(size_t)va_arg( _args, void* );
+				break;
+			}
+		}
+
+		// Store them, as long as there is room.  Strings are stored as
+		// a length followed by the characters, everything else in 8 bytes.
+		uint32 needed = ( 8 * conv.m_numStars ) + ( ( str != NULL ) ? ( 2 + strLength ) : 8 );
+		if( pos + needed > _size )
+		{
+			*_bTruncated = true;
+			break;
+		}
+
+		for( uint32 i=0; i<conv.m_numStars; ++i )
+		{
+			Put64( &_buffer[pos], (uint64)(int64)stars[i] );
+			pos += 8;
+		}
+		if( str != NULL )
+		{
+			Put16( &_buffer[pos], (uint16)strLength );
+			memcpy( &_buffer[pos + 2], str, strLength );
+			pos += 2 + strLength;
+		}
+		else
+		{
+			Put64( &_buffer[pos], value );
+			pos += 8;
+		}
+	}
+
+	return pos;
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::DecodeMessage>
+// Produce the text of a message from its format string and argument values
+//-----------------------------------------------------------------------------
+void FlightRecorder::DecodeMessage
+(
+	char const* _format,
+	uint8 const* _data,
+	uint32 _length,
+	char* _buffer,
+	uint32 _size
+)
+{
+	uint32 out = 0;
+	uint32 pos = 0;
+	char const* p = _format;
+	_buffer[0] = 0;
+
+	while( *p && ( out < _size - 1 ) )
+	{
+		char const* percent = strchr( p, '%' );
+		if( percent == NULL )
+		{
+			AppendText( _buffer, _size, &out, p, (uint32)strlen( p ) );
+			break;
+		}
+		AppendText( _buffer, _size, &out, p, (uint32)( percent - p ) );
+
+		Conversion conv;
+		p = ParseConversion( percent, &conv );
+		if( conv.m_type == ArgType_Invalid )
+		{
+			// Copy the rest of the format as it is
+			AppendText( _buffer, _size, &out, percent, (uint32)strlen( percent ) );
+			break;
+		}
+		if( conv.m_type == ArgType_Percent )
+		{
+			AppendText( _buffer, _size, &out, "%", 1 );
+			continue;
+		}
+
+		// Read back the values, stopping if the record was truncated
+		int32 stars[2] = { 0, 0 };
+		bool bAvailable = true;
+		for( uint32 i=0; i<conv.m_numStars; ++i )
+		{
+			if( pos + 8 > _length )
+			{
+				bAvailable = false;
+				break;
+			}
+			if( i < 2 )
+			{
+				stars[i] = (int32)(int64)Get64( &_data[pos] );
+			}
+			pos += 8;
+		}
+
+		char piece[c_maxString + 64];
+		piece[0] = 0;
+		if( bAvailable && ( conv.m_type == ArgType_String ) )
+		{
+			if( pos + 2 <= _length )
+			{
+				uint32 strLength = Get16( &_data[pos] );
+				if( pos + 2 + strLength > _length )
+				{
+					strLength = _length - pos - 2;
+				}
+				char str[c_maxString + 1];
+				memcpy( str, &_data[pos + 2], strLength );
+				str[strLength] = 0;
+				pos += 2 + strLength;
+				FormatValue( piece, sizeof(piece), conv, stars, (char const*)str );
+			}
+			else
+			{
+				bAvailable = false;
+			}
+		}
+		else if( bAvailable )
+		{
+			if( pos + 8 <= _length )
+			{
+				uint64 value = Get64( &_data[pos] );
+				pos += 8;
+				switch( conv.m_type )
+				{
+					case ArgType_Int:
+					{
+						switch( conv.m_size )
+						{
+							case ArgSize_Char:	FormatValue( piece, sizeof(piece), conv, stars, (int)(int8)value );		break;
+							case ArgSize_Short:	FormatValue( piece, sizeof(piece), conv, stars, (int)(int16)value );		break;
+							case ArgSize_Long:	FormatValue( piece, sizeof(piece), conv, stars, (long)(int64)value );		break;
+							case ArgSize_Default:	FormatValue( piece, sizeof(piece), conv, stars, (int)(int64)value );		break;
+							default:		FormatValue( piece, sizeof(piece), conv, stars, (int64)value );			break;
+						}
+						break;
+					}
+					case ArgType_Unsigned:
+					{
+						switch( conv.m_size )
+						{
+							case ArgSize_Char:	FormatValue( piece, sizeof(piece), conv, stars, (unsigned int)(uint8)value );	break;
+							case ArgSize_Short:	FormatValue( piece, sizeof(piece), conv, stars, (unsigned int)(uint16)value );	break;
+							case ArgSize_Long:	FormatValue( piece, sizeof(piece), conv, stars, (unsigned long)value );		break;
+							case ArgSize_Default:	FormatValue( piece, sizeof(piece), conv, stars, (unsigned int)value );		break;
+							default:		FormatValue( piece, sizeof(piece), conv, stars, value );			break;
+						}
+						break;
+					}
+					case ArgType_Double:
+					{
+						double d;
+						memcpy( &d, &value, sizeof(d) );
+						FormatValue( piece, sizeof(piece), conv, stars, d );
+						break;
+					}
+					default:
+					{
+						if( conv.m_bOutput )
+						{
+							FormatValue( piece, sizeof(piece), conv, stars, (void*)(size_t)value );
+						}
+						break;
+					}
+				}
+			}
+			else
+			{
+				bAvailable = false;
+			}
+		}
+
+		if( !bAvailable )
+		{
+			// The record ran out of room for arguments
+			AppendText( _buffer, _size, &out, "?", 1 );
+			pos = _length;
+			continue;
+		}
+		AppendText( _buffer, _size, &out, piece, (uint32)strlen( piece ) );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::FormatData>
+// Produce the text of a data record, as the label followed by hex bytes
+//-----------------------------------------------------------------------------
+void FlightRecorder::FormatData
+(
+	char const* _label,
+	uint8 const* _data,
+	uint32 _length,
+	bool _bTruncated,
+	char* _buffer,
+	uint32 _size
+)
+{
+	uint32 out = 0;
+	_buffer[0] = 0;
+	AppendText( _buffer, _size, &out, _label, (uint32)strlen( _label ) );
+	for( uint32 i=0; i<_length; ++i )
+	{
+		char byteStr[8];
+		snprintf( byteStr, sizeof(byteStr), i ? ", 0x%.2x" : "0x%.2x", _data[i] );
+		AppendText( _buffer, _size, &out, byteStr, (uint32)strlen( byteStr ) );
+	}
+	if( _bTruncated )
+	{
+		AppendText( _buffer, _size, &out, ", ...", 5 );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <FlightRecorder::Decode>
+// Decode a record and pass it to the callback
+//-----------------------------------------------------------------------------
+void FlightRecorder::Decode
+(
+	RecordHeader const& _header,
+	char const* _format,
+	uint8 const* _data,
+	pfnEntryCallback_t _callback,
+	void* _context
+)
+{
+	char text[c_maxText];
+	if( _header.m_type == RecordType_Data )
+	{
+		FormatData( _format, _data, _header.m_dataLength, ( _header.m_flags & RecordFlag_Truncated ) != 0, text, sizeof(text) );
+	}
+	else
+	{
+		DecodeMessage( _format, _data, _header.m_dataLength, text, sizeof(text) );
+		if( _header.m_flags & RecordFlag_Truncated )
+		{
+			// A string argument was cut short, or some arguments were lost
+			uint32 out = (uint32)strlen( text );
+			AppendText( text, sizeof(text), &out, " ...", 4 );
+		}
+	}
+
+	Entry entry;
+	entry.m_time = _header.m_time;
+	entry.m_level = (LogLevel)_header.m_level;
+	entry.m_nodeId = _header.m_nodeId;
+	entry.m_threadId = _header.m_threadId;
+	entry.m_text = text;
+	_callback( entry, _context );
+}
@@ -0,0 +1,205 @@
+//-----------------------------------------------------------------------------
+//
+//	FlightRecorder.h
+//
+//	Compact binary history of recent log messages
+//
+//	Copyright (c) 2010 Mal Lansell <mal@lansell.org>
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _FlightRecorder_H
+#define _FlightRecorder_H
+
+#include <stdarg.h>
+#include <string>
+#include "Defs.h"
+#include "Log.h"
+
+namespace OpenZWave
+{
+	/** \brief Keeps the most recent log messages in a fixed-size ring buffer.
+	 *
+	 * Messages are not formatted when they are recorded.  Instead each record
+	 * holds the time, level, node and thread, a pointer to the format string,
+	 * and the raw values of its arguments (or, for data records, the raw
+	 * bytes of a frame).  The text is only produced if the history is dumped,
+	 * so recording is cheap and the buffer holds many more messages than
+	 * the same amount of memory would as strings.  Once the buffer is full,
+	 * the oldest records are discarded to make room.
+	 *
+	 * Because only the pointer is kept, format strings and data labels must
+	 * remain valid for the life of the recorder - in practice they should be
+	 * string literals.  Arguments passed for %s are copied.
+	 *
+	 * The history can also be saved to a self-contained file, which can be
+	 * decoded later by Load, for example in a separate tool.
+	 *
+	 * The recorder is not thread-safe.  The caller must serialise access.
+	 */
+	class FlightRecorder
+	{
+	public:
+		/** \brief A decoded record, passed to a pfnEntryCallback_t.
+		 */
+		struct Entry
+		{
+			int64		m_time;				/**< Wall-clock time in milliseconds (see TimeStamp::GetWallClockTime) */
+			LogLevel	m_level;
+			uint8		m_nodeId;
+			uint32		m_threadId;
+			char const*	m_text;				/**< The formatted message */
+		};
+
+		typedef void (*pfnEntryCallback_t)( Entry const& _entry, void* _context );
+
+		enum
+		{
+			DefaultSize = 256 * 1024				/**< Holds several thousand typical records */
+		};
+
+		/**
+		 * Constructor.
+		 * \param _size size of the ring buffer in bytes.
+		 */
+		FlightRecorder( uint32 _size );
+
+		/**
+		 * Destructor.
+		 */
+		~FlightRecorder();
+
+		/**
+		 * Record a message.
+		 * \param _level level of the message.
+		 * \param _nodeId node the message is about, or zero.
+		 * \param _threadId identifies the thread that logged the message.
+		 * \param _format printf-style format string, which must outlive the recorder.
+		 * \param _args the arguments for the format string.
+		 */
+		void Record( LogLevel _level, uint8 const _nodeId, uint32 const _threadId, char const* _format, va_list _args );
+
+		/**
+		 * Record a block of binary data, such as a frame.
+		 * When decoded, the label is followed by the bytes in hex.
+		 * \param _level level of the message.
+		 * \param _nodeId node the data is about, or zero.
+		 * \param _threadId identifies the thread that logged the data.
+		 * \param _label text to show before the data, which must outlive the recorder.
+		 * \param _data the bytes to record.
+		 * \param _length number of bytes.
+		 */
+		void RecordData( LogLevel _level, uint8 const _nodeId, uint32 const _threadId, char const* _label, uint8 const* _data, uint32 const _length );
+
+		/**
+		 * Decode every record, oldest first.
+		 * \param _callback called once for each record.
+		 * \param _context passed to the callback.
+		 */
+		void Replay( pfnEntryCallback_t _callback, void* _context )const;
+
+		/**
+		 * Discard all records.
+		 */
+		void Clear();
+
+		/**
+		 * Write all records to a file, which can be decoded by Load.
+		 * \param _filename name of the file to create.
+		 * \return true if the file was written successfully.
+		 */
+		bool Save( string const& _filename )const;
+
+		/**
+		 * Decode a file written by Save.
+		 * \param _filename name of the file to read.
+		 * \param _callback called once for each record, oldest first.
+		 * \param _context passed to the callback.
+		 * \return true if the file was read successfully.
+		 */
+		static bool Load( string const& _filename, pfnEntryCallback_t _callback, void* _context );
+
+		/**
+		 * Format an entry as a complete log line, with time, thread and node.
+		 * \param _entry the entry to format.
+		 * \param _buffer receives the null-terminated result.
+		 * \param _size size of the buffer in bytes.
+		 */
+		static void FormatEntry( Entry const& _entry, char* _buffer, uint32 _size );
+
+		/**
+		 * Format a block of binary data as it appears in the log - the label
+		 * followed by the bytes in hex.
+		 * \param _label text to show before the data.
+		 * \param _data the bytes to format.
+		 * \param _length number of bytes.
+		 * \param _bTruncated if true, an ellipsis is added to show that there was more data.
+		 * \param _buffer receives the null-terminated result.
+		 * \param _size size of the buffer in bytes.
+		 */
+		static void FormatData( char const* _label, uint8 const* _data, uint32 _length, bool _bTruncated, char* _buffer, uint32 _size );
+
+	private:
+		FlightRecorder( FlightRecorder const& );				// prevent copy
+		FlightRecorder& operator = ( FlightRecorder const& );		// prevent assignment
+
+		enum RecordType
+		{
+			RecordType_Message = 0,
+			RecordType_Data
+		};
+
+		enum
+		{
+			RecordFlag_Truncated	= 0x01			// Some arguments or data would not fit
+		};
+
+		struct RecordHeader
+		{
+			uint16		m_length;			// Length of the whole record, or zero to mark the end of the buffer
+			uint8		m_level;
+			uint8		m_nodeId;
+			uint8		m_type;
+			uint8		m_flags;
+			uint16		m_dataLength;			// Length of the arguments or data that follow
+			uint32		m_threadId;
+			int64		m_time;
+			char const*	m_format;			// Format string or data label
+		};
+
+		void Append( RecordHeader& _header, uint8 const* _data );
+		void DiscardOldest();
+		uint32 ReadHeader( uint32 _pos, RecordHeader* o_header )const;
+		void DiscardRange( uint32 _start, uint32 _end );
+
+		static uint32 CaptureArgs( char const* _format, va_list _args, uint8* _buffer, uint32 _size, bool* _bTruncated );
+		static void DecodeMessage( char const* _format, uint8 const* _data, uint32 _length, char* _buffer, uint32 _size );
+		static void Decode( RecordHeader const& _header, char const* _format, uint8 const* _data, pfnEntryCallback_t _callback, void* _context );
+
+		uint8*		m_buffer;
+		uint32		m_size;
+		uint32		m_head;					// Offset of the oldest record
+		uint32		m_tail;					// Offset at which the next record will be written
+		uint32		m_count;				// Number of records in the buffer
+	};
+
+} // namespace OpenZWave
+
+#endif //_FlightRecorder_H
@@ -0,0 +1,423 @@
+//-----------------------------------------------------------------------------
+//
+//	Gzip.cpp
+//
+//	Compression of files into gzip format
+//
+//	Copyright (c) 2010 Mal Lansell <mal@lansell.org>
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <stdio.h>
+#include <string.h>
+#include "Defs.h"
+#include "Gzip.h"
+
+using namespace OpenZWave;
+
+// The input is compressed in independent chunks, each as one deflate block,
+// so that only a fixed amount of it has to be held in memory.
+static uint32 const c_chunkSize		= 256 * 1024;
+static uint32 const c_windowSize	= 32768;		// Furthest back that a match may be
+static uint32 const c_hashSize		= 32768;
+static uint32 const c_maxChain		= 64;			// Candidates tried for each match, trading speed for size
+static uint32 const c_minMatch		= 3;
+static uint32 const c_maxMatch		= 258;
+
+static uint16 const c_lengthBase[29] =	{ 3, 4, 5, 6, 7, 8, 9, 10, 11, 13, 15, 17, 19, 23, 27, 31, 35, 43, 51, 59, 67, 83, 99, 115, 131, 163, 195, 227, 258 };
+static uint8 const c_lengthExtra[29] =	{ 0, 0, 0, 0, 0, 0, 0, 0, 1, 1, 1, 1, 2, 2, 2, 2, 3, 3, 3, 3, 4, 4, 4, 4, 5, 5, 5, 5, 0 };
+static uint16 const c_distBase[30] =	{ 1, 2, 3, 4, 5, 7, 9, 13, 17, 25, 33, 49, 65, 97, 129, 193, 257, 385, 513, 769, 1025, 1537, 2049, 3073, 4097, 6145, 8193, 12289, 16385, 24577 };
+static uint8 const c_distExtra[30] =	{ 0, 0, 0, 0, 1, 1, 2, 2, 3, 3, 4, 4, 5, 5, 6, 6, 7, 7, 8, 8, 9, 9, 10, 10, 11, 11, 12, 12, 13, 13 };
+
+// Output of the compressor.  Deflate packs its bits starting with the
+// least significant bit of each byte.
+struct BitStream
+{
+	FILE*	m_file;
+	uint32	m_bits;				// Bits not yet making up a whole byte
+	uint32	m_count;			// Number of bits in m_bits
+	uint8	m_buffer[8192];
+	uint32	m_length;
+	bool	m_bError;
+};
+
+//-----------------------------------------------------------------------------
+// <FlushBytes>
+// Write out the buffered bytes
+//-----------------------------------------------------------------------------
+static void FlushBytes
+(
+	BitStream& _out
+)
+{
+	if( _out.m_length && ( fwrite( _out.m_buffer, 1, _out.m_length, _out.m_file ) != _out.m_length ) )
+	{
+		_out.m_bError = true;
+	}
+	_out.m_length = 0;
+}
+
+//-----------------------------------------------------------------------------
+// <PutByte>
+// Add a whole byte to the output
+//-----------------------------------------------------------------------------
+static void PutByte
+(
+	BitStream& _out,
+	uint8 const _byte
+)
+{
+	_out.m_buffer[_out.m_length++] = _byte;
+	if( _out.m_length == sizeof(_out.m_buffer) )
+	{
+		FlushBytes( _out );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <PutBits>
+// Add a value to the output, least significant bit first
+//-----------------------------------------------------------------------------
+static void PutBits
+(
+	BitStream& _out,
+	uint32 const _value,
+	uint32 const _numBits
+)
+{
+	_out.m_bits |= _value << _out.m_count;
+	_out.m_count += _numBits;
+	while( _out.m_count >= 8 )
+	{
+		PutByte( _out, (uint8)_out.m_bits );
+		_out.m_bits >>= 8;
+		_out.m_count -= 8;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <PutHuffman>
+// Add a Huffman code to the output.  These are packed most significant bit first.
+//-----------------------------------------------------------------------------
+static void PutHuffman
+(
+	BitStream& _out,
+	uint32 const _code,
+	uint32 const _numBits
+)
+{
+	uint32 reversed = 0;
+	for( uint32 i=0; i<_numBits; ++i )
+	{
+		reversed |= ( ( _code >> i ) & 1 ) << ( _numBits - 1 - i );
+	}
+	PutBits( _out, reversed, _numBits );
+}
+
+//-----------------------------------------------------------------------------
+// <AlignBits>
+// Pad the output to a whole number of bytes
+//-----------------------------------------------------------------------------
+static void AlignBits
+(
+	BitStream& _out
+)
+{
+	if( _out.m_count )
+	{
+		PutByte( _out, (uint8)_out.m_bits );
+		_out.m_bits = 0;
+		_out.m_count = 0;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <PutUint32>
+// Add a little-endian 32 bit value to the output
+//-----------------------------------------------------------------------------
+static void PutUint32
+(
+	BitStream& _out,
+	uint32 const _value
+)
+{
+	PutByte( _out, (uint8)_value );
+	PutByte( _out, (uint8)( _value >> 8 ) );
+	PutByte( _out, (uint8)( _value >> 16 ) );
+	PutByte( _out, (uint8)( _value >> 24 ) );
+}
+
+//-----------------------------------------------------------------------------
+// <PutSymbol>
+// Add a literal/length symbol using the fixed Huffman codes
+//-----------------------------------------------------------------------------
+static void PutSymbol
+(
+	BitStream& _out,
+	uint32 const _symbol
+)
+{
+	if( _symbol < 144 )
+	{
+		PutHuffman( _out, 0x30 + _symbol, 8 );
+	}
+	else if( _symbol < 256 )
+	{
+		PutHuffman( _out, 0x190 + _symbol - 144, 9 );
+	}
+	else if( _symbol < 280 )
+	{
+		PutHuffman( _out, _symbol - 256, 7 );
+	}
+	else
+	{
+		PutHuffman( _out, 0xc0 + _symbol - 280, 8 );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <PutMatch>
+// Add a back-reference to earlier data
+//-----------------------------------------------------------------------------
+static void PutMatch
+(
+	BitStream& _out,
+	uint32 const _length,
+	uint32 const _distance
+)
+{
+	int i = 28;
+	while( c_lengthBase[i] > _length )
+	{
+		--i;
+	}
+	PutSymbol( _out, 257 + i );
+	PutBits( _out, _length - c_lengthBase[i], c_lengthExtra[i] );
+
+	i = 29;
+	while( c_distBase[i] > _distance )
+	{
+		--i;
+	}
+	PutHuffman( _out, i, 5 );
+	PutBits( _out, _distance - c_distBase[i], c_distExtra[i] );
+}
+
+//-----------------------------------------------------------------------------
+// <Hash>
+// Hash the three bytes that start a possible match
+//-----------------------------------------------------------------------------
+static uint32 Hash
+(
+	uint8 const* _data
+)
+{
+	return( ( ( (uint32)_data[0] << 10 ) ^ ( (uint32)_data[1] << 5 ) ^ _data[2] ) & ( c_hashSize - 1 ) );
+}
+
+//-----------------------------------------------------------------------------
+// <DeflateChunk>
+// Compress a chunk of data as a single (non-final) fixed Huffman block
+//-----------------------------------------------------------------------------
+static void DeflateChunk
+(
+	BitStream& _out,
+	uint8 const* _data,
+	uint32 const _length,
+	int32* _head,
+	int32* _prev
+)
+{
+	PutBits( _out, 0, 1 );		// Not the final block
+	PutBits( _out, 1, 2 );		// Fixed Huffman codes
+
+	for( uint32 i=0; i<c_hashSize; ++i )
+	{
+		_head[i] = -1;
+	}
+
+	uint32 pos = 0;
+	uint32 inserted = 0;		// Positions below this are already in the hash chains
+	while( pos < _length )
+	{
+		uint32 bestLength = 0;
+		uint32 bestDistance = 0;
+		if( pos + c_minMatch <= _length )
+		{
+			uint32 maxLength = _length - pos;
+			if( maxLength > c_maxMatch )
+			{
+				maxLength = c_maxMatch;
+			}
+
+			int32 candidate = _head[Hash( &_data[pos] )];
+			uint32 chain = c_maxChain;
+			while( ( candidate >= 0 ) && ( pos - candidate <= c_windowSize ) && chain-- )
+			{
+				uint8 const* a = &_data[candidate];
+				uint8 const* b = &_data[pos];
+				if( a[bestLength] == b[bestLength] )
+				{
+					uint32 length = 0;
+					while( ( length < maxLength ) && ( a[length] == b[length] ) )
+					{
+						++length;
+					}
+					if( length > bestLength )
+					{
+						bestLength = length;
+						bestDistance = pos - candidate;
+						if( length == maxLength )
+						{
+							break;
+						}
+					}
+				}
+
+				// Chains only ever lead back in time.  Anything else is a
+				// stale entry from a slot that has since been reused.
+				int32 next = _prev[candidate & ( c_windowSize - 1 )];
+				if( next >= candidate )
+				{
+					break;
+				}
+				candidate = next;
+			}
+		}
+
+		uint32 advance = 1;
+		if( bestLength >= c_minMatch )
+		{
+			PutMatch( _out, bestLength, bestDistance );
+			advance = bestLength;
+		}
+		else
+		{
+			PutSymbol( _out, _data[pos] );
+		}
+
+		// Add the positions just covered to the hash chains
+		pos += advance;
+		while( ( inserted < pos ) && ( inserted + c_minMatch <= _length ) )
+		{
+			uint32 h = Hash( &_data[inserted] );
+			_prev[inserted & ( c_windowSize - 1 )] = _head[h];
+			_head[h] = (int32)inserted;
+			++inserted;
+		}
+	}
+
+	PutSymbol( _out, 256 );		// End of block
+}
+
+//-----------------------------------------------------------------------------
+// <Gzip::CompressFile>
+// Compress a file into gzip format
+//-----------------------------------------------------------------------------
+bool Gzip::CompressFile
+(
+	string const& _srcFilename,
+	string const& _dstFilename
+)
+{
+	FILE* src = fopen( _srcFilename.c_str(), "rb" );
+	if( src == NULL )
+	{
+		return false;
+	}
+
+	FILE* dst = fopen( _dstFilename.c_str(), "wb" );
+	if( dst == NULL )
+	{
+		fclose( src );
+		return false;
+	}
+
+	uint32 crcTable[256];
+	for( uint32 i=0; i<256; ++i )
+	{
+		uint32 c = i;
+		for( int j=0; j<8; ++j )
+		{
+			c = ( c & 1 ) ? ( 0xedb88320 ^ ( c >> 1 ) ) : ( c >> 1 );
+		}
+		crcTable[i] = c;
+	}
+
+	uint8* data = new uint8[c_chunkSize];
+	int32* head = new int32[c_hashSize];
+	int32* prev = new int32[c_windowSize];
+
+	BitStream* out = new BitStream;
+	out->m_file = dst;
+	out->m_bits = 0;
+	out->m_count = 0;
+	out->m_length = 0;
+	out->m_bError = false;
+
+	// Header: magic, deflate, no flags, no time, no extra flags, unknown OS
+	static uint8 const header[10] = { 0x1f, 0x8b, 8, 0, 0, 0, 0, 0, 0, 0xff };
+	for( int i=0; i<10; ++i )
+	{
+		PutByte( *out, header[i] );
+	}
+
+	uint32 crc = 0xffffffff;
+	uint32 totalLength = 0;
+	size_t length;
+	while( ( length = fread( data, 1, c_chunkSize, src ) ) > 0 )
+	{
+		for( size_t i=0; i<length; ++i )
+		{
+			crc = crcTable[( crc ^ data[i] ) & 0xff] ^ ( crc >> 8 );
+		}
+		totalLength += (uint32)length;
+
+		DeflateChunk( *out, data, (uint32)length, head, prev );
+	}
+
+	// An empty final block ends the stream
+	PutBits( *out, 1, 1 );
+	PutBits( *out, 1, 2 );
+	PutSymbol( *out, 256 );
+	AlignBits( *out );
+
+	PutUint32( *out, crc ^ 0xffffffff );
+	PutUint32( *out, totalLength );
+	FlushBytes( *out );
+
+	bool res = !out->m_bError && !ferror( src );
+	if( fclose( dst ) != 0 )
+	{
+		res = false;
+	}
+	fclose( src );
+
+	delete out;
+	delete [] prev;
+	delete [] head;
+	delete [] data;
+
+	if( !res )
+	{
+		remove( _dstFilename.c_str() );
+	}
+	return res;
+}
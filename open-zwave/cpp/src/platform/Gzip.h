@@ -0,0 +1,58 @@
+//-----------------------------------------------------------------------------
+//
+//	Gzip.h
+//
+//	Compression of files into gzip format
+//
+//	Copyright (c) 2010 Mal Lansell <mal@lansell.org>
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _Gzip_H
+#define _Gzip_H
+
+#include <string>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief Compresses files into the gzip format, without needing zlib.
+	 *
+	 * Only the fixed Huffman codes of the deflate format are used, which keeps
+	 * the encoder small at the cost of a little compression.  Text such as log
+	 * files still typically shrinks to a fifth of its size or less.  The output
+	 * can be read by gunzip, zcat and any other gzip decoder.
+	 */
+	class Gzip
+	{
+	public:
+		/**
+		 * Compress a file.
+		 * \param _srcFilename name of the file to compress.
+		 * \param _dstFilename name of the compressed file to create.
+		 * \return true if the compressed file was written successfully.  If not,
+		 * any partly written output is removed.
+		 */
+		static bool CompressFile( string const& _srcFilename, string const& _dstFilename );
+	};
+
+} // namespace OpenZWave
+
+#endif //_Gzip_H
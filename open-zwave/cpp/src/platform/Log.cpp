@@ -30,6 +30,7 @@
 #include "Defs.h"
 #include "Mutex.h"
 #include "Log.h"
+#include "FlightRecorder.h"
 
 #include "LogImpl.h"	// Platform-specific implementation of a log
 
@@ -38,6 +39,14 @@ using namespace OpenZWave;
 
 Log* Log::s_instance = NULL;
 i_LogImpl* Log::m_pImpl = NULL;
+LogLevel Log::s_saveLevel = LogLevel_None;
+LogLevel Log::s_queueLevel = LogLevel_None;
+LogLevel Log::s_dumpTrigger = LogLevel_None;
+LogLevel Log::s_enabledLevel = LogLevel_None;
+LogLevel Log::s_baseLevel = LogLevel_None;
+LogLevel Log::s_filterLevel = LogLevel_None;
+LogLevel Log::s_nodeLevel[256];
+LogLevel Log::s_commandClassLevel[256];
 static bool s_dologging;
 
 //-----------------------------------------------------------------------------
@@ -51,13 +60,18 @@ Log* Log::Create
 	bool const _bConsoleOutput,
 	LogLevel const _saveLevel,
 	LogLevel const _queueLevel,
-	LogLevel const _dumpTrigger
+	LogLevel const _dumpTrigger,
+	int32 const _flushInterval
 )
 {
 	if( NULL == s_instance )
 	{
-		s_instance = new Log( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger );
+		s_instance = new Log( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger, _flushInterval );
 		s_dologging = true; // default logging to true so no change to what people experience now
+		s_saveLevel = _saveLevel;
+		s_queueLevel = _queueLevel;
+		s_dumpTrigger = _dumpTrigger;
+		UpdateEnabledLevel();
 	}
 
 	return s_instance;
@@ -94,6 +108,7 @@ void Log::Destroy
 {
 	delete s_instance;
 	s_instance = NULL;
+	UpdateEnabledLevel();
 }
 
 //-----------------------------------------------------------------------------
@@ -107,6 +122,11 @@ bool Log::SetLoggingClass
 {
 	delete m_pImpl;
 	m_pImpl = LogClass;
+
+	// We cannot know which levels the new class is interested in
+	s_saveLevel = LogLevel_Debug;
+	s_queueLevel = LogLevel_Debug;
+	UpdateEnabledLevel();
 	return true;
 }
 
@@ -127,6 +147,7 @@ void Log::SetLoggingState
 {
 	bool prevLogging = s_dologging;
 	s_dologging = _dologging;
+	UpdateEnabledLevel();
 	
 	if (!prevLogging && s_dologging) Log::Write(LogLevel_Always, "Logging started\n\n");
 }
@@ -167,7 +188,12 @@ void Log::SetLoggingState
 	  	s_instance->m_logMutex->Lock();
 		s_instance->m_pImpl->SetLoggingState( _saveLevel, _queueLevel, _dumpTrigger );
 		s_instance->m_logMutex->Unlock();
+
+		s_saveLevel = _saveLevel;
+		s_queueLevel = _queueLevel;
+		s_dumpTrigger = _dumpTrigger;
 	}
+	UpdateEnabledLevel();
 	
 	if (!prevLogging && s_dologging) Log::Write(LogLevel_Always, "Logging started\n\n");
 }
@@ -183,6 +209,158 @@ bool Log::GetLoggingState
 	return s_dologging;
 }
 
+//-----------------------------------------------------------------------------
+//	<Log::GetLoggingState>
+//	Return the various logging levels
+//-----------------------------------------------------------------------------
+void Log::GetLoggingState
+(
+	LogLevel* _saveLevel,
+	LogLevel* _queueLevel,
+	LogLevel* _dumpTrigger
+)
+{
+	*_saveLevel = s_saveLevel;
+	*_queueLevel = s_queueLevel;
+	*_dumpTrigger = s_dumpTrigger;
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::UpdateEnabledLevel>
+//	Work out the least severe level of message that needs to reach the log
+//-----------------------------------------------------------------------------
+void Log::UpdateEnabledLevel
+(
+)
+{
+	LogLevel level = LogLevel_None;
+	if( s_instance && s_dologging )
+	{
+		level = s_saveLevel;
+		if( s_queueLevel > level )
+		{
+			level = s_queueLevel;
+		}
+		if( s_dumpTrigger > level )
+		{
+			level = s_dumpTrigger;
+		}
+	}
+	s_baseLevel = level;
+
+	if( s_instance && s_dologging && ( s_filterLevel > level ) )
+	{
+		level = s_filterLevel;
+	}
+	s_enabledLevel = level;
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::SetNodeLoggingLevel>
+//	Log messages about one node in more detail than the rest
+//-----------------------------------------------------------------------------
+void Log::SetNodeLoggingLevel
+(
+	uint8 const _nodeId,
+	LogLevel const _level
+)
+{
+	if( _nodeId != 0 )
+	{
+		s_nodeLevel[_nodeId] = _level;
+		UpdateFilterLevel();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::SetCommandClassLoggingLevel>
+//	Log messages about one command class in more detail than the rest
+//-----------------------------------------------------------------------------
+void Log::SetCommandClassLoggingLevel
+(
+	uint8 const _commandClassId,
+	LogLevel const _level
+)
+{
+	if( _commandClassId != 0 )
+	{
+		s_commandClassLevel[_commandClassId] = _level;
+		UpdateFilterLevel();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::ClearLoggingFilters>
+//	Remove all of the node and command class logging levels
+//-----------------------------------------------------------------------------
+void Log::ClearLoggingFilters
+(
+)
+{
+	for( int i=0; i<256; ++i )
+	{
+		s_nodeLevel[i] = LogLevel_None;
+		s_commandClassLevel[i] = LogLevel_None;
+	}
+	UpdateFilterLevel();
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::UpdateFilterLevel>
+//	Work out the least severe level asked for by any node or command class
+//-----------------------------------------------------------------------------
+void Log::UpdateFilterLevel
+(
+)
+{
+	LogLevel level = LogLevel_None;
+	for( int i=1; i<256; ++i )
+	{
+		if( s_nodeLevel[i] > level )
+		{
+			level = s_nodeLevel[i];
+		}
+		if( s_commandClassLevel[i] > level )
+		{
+			level = s_commandClassLevel[i];
+		}
+	}
+	s_filterLevel = level;
+	UpdateEnabledLevel();
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::IsEnabled>
+//	Test whether a message about a node and command class would be logged
+//-----------------------------------------------------------------------------
+bool Log::IsEnabled
+(
+	LogLevel _level,
+	uint8 const _nodeId,
+	uint8 const _commandClassId
+)
+{
+	if( _level > s_enabledLevel )
+	{
+		return false;
+	}
+	return( ( _level <= s_baseLevel ) || IsTraced( _level, _nodeId, _commandClassId ) );
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::IsTraced>
+//	Test whether a node or command class filter asks for a message
+//-----------------------------------------------------------------------------
+bool Log::IsTraced
+(
+	LogLevel _level,
+	uint8 const _nodeId,
+	uint8 const _commandClassId
+)
+{
+	return( ( _level <= s_nodeLevel[_nodeId] ) || ( _level <= s_commandClassLevel[_commandClassId] ) );
+}
+
 //-----------------------------------------------------------------------------
 //	<Log::Write>
 //	Write to the log
@@ -194,15 +372,10 @@ void Log::Write
 	...
 )
 {
-	if( s_instance && s_dologging && s_instance->m_pImpl )
-	{
-		s_instance->m_logMutex->Lock(); // double locks if recursive
-		va_list args;
-		va_start( args, _format );
-		s_instance->m_pImpl->Write( _level, 0, _format, args );
-		va_end( args );
-		s_instance->m_logMutex->Unlock();
-	}
+	va_list args;
+	va_start( args, _format );
+	WriteArgs( _level, 0, 0, _format, args );
+	va_end( args );
 }
 
 //-----------------------------------------------------------------------------
@@ -217,16 +390,117 @@ void Log::Write
 	...
 )
 {
+	va_list args;
+	va_start( args, _format );
+	WriteArgs( _level, _nodeId, 0, _format, args );
+	va_end( args );
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::Write>
+//	Write to the log
+//-----------------------------------------------------------------------------
+void Log::Write
+(
+	LogLevel _level,
+	uint8 const _nodeId,
+	uint8 const _commandClassId,
+	char const* _format,
+	...
+)
+{
+	va_list args;
+	va_start( args, _format );
+	WriteArgs( _level, _nodeId, _commandClassId, _format, args );
+	va_end( args );
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::WriteArgs>
+//	Pass a message on to the log implementation
+//-----------------------------------------------------------------------------
+void Log::WriteArgs
+(
+	LogLevel _level,
+	uint8 const _nodeId,
+	uint8 const _commandClassId,
+	char const* _format,
+	va_list _args
+)
+{
+	if( _level == LogLevel_Internal )	// queued messages are always dumped
+	{
+		if( s_instance && s_dologging && s_instance->m_pImpl )
+		{
+			s_instance->m_pImpl->Write( _level, _nodeId, _format, _args );
+		}
+		return;
+	}
+
+	if( !IsEnabled( _level ) )
+	{
+		return;
+	}
+
+	// Messages below the save level still reach the file if a filter asks for them
+	bool traced = ( _level > s_saveLevel ) && IsTraced( _level, _nodeId, _commandClassId );
+	if( !traced && ( _level > s_baseLevel ) )
+	{
+		return;
+	}
+
 	if( s_instance && s_dologging && s_instance->m_pImpl )
 	{
-		if( _level != LogLevel_Internal )
-		  	s_instance->m_logMutex->Lock();
-		va_list args;
-		va_start( args, _format );
-		s_instance->m_pImpl->Write( _level, _nodeId, _format, args );
-		va_end( args );
-		if( _level != LogLevel_Internal )
-			s_instance->m_logMutex->Unlock();
+		s_instance->m_logMutex->Lock(); // double locks if recursive
+		if( traced )
+		{
+			s_instance->m_pImpl->WriteTraced( _level, _nodeId, _format, _args );
+		}
+		else
+		{
+			s_instance->m_pImpl->Write( _level, _nodeId, _format, _args );
+		}
+		s_instance->m_logMutex->Unlock();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::WriteData>
+//	Write a block of binary data to the log
+//-----------------------------------------------------------------------------
+void Log::WriteData
+(
+	LogLevel _level,
+	uint8 const _nodeId,
+	char const* _label,
+	uint8 const* _data,
+	uint32 const _length,
+	uint8 const _commandClassId
+)
+{
+	if( !IsEnabled( _level ) )
+	{
+		return;
+	}
+
+	bool traced = ( _level > s_saveLevel ) && IsTraced( _level, _nodeId, _commandClassId );
+	if( !traced && ( _level > s_baseLevel ) )
+	{
+		return;
+	}
+
+	if( traced )
+	{
+		// The data has to be written out now, so there is nothing to gain from queueing it raw
+		char buf[1024];
+		FlightRecorder::FormatData( _label, _data, _length, false, buf, sizeof(buf) );
+		Write( _level, _nodeId, _commandClassId, "%s", buf );
+	}
+	else if( s_instance && s_dologging && s_instance->m_pImpl )
+	{
+		s_instance->m_logMutex->Lock();
+		s_instance->m_pImpl->WriteData( _level, _nodeId, _label, _data, _length );
+		s_instance->m_logMutex->Unlock();
 	}
 }
 
@@ -262,6 +536,45 @@ void Log::QueueClear
 	}
 }
 
+//-----------------------------------------------------------------------------
+//	<Log::QueueSave>
+//	Save the queued messages to a file (leaving the queue intact)
+//-----------------------------------------------------------------------------
+bool Log::QueueSave
+(
+	string const& _filename
+)
+{
+	bool res = false;
+	if( s_instance && s_instance->m_pImpl )
+	{
+	  	s_instance->m_logMutex->Lock();
+		res = s_instance->m_pImpl->QueueSave( _filename );
+		s_instance->m_logMutex->Unlock();
+	}
+	return res;
+}
+
+//-----------------------------------------------------------------------------
+//	<Log::SetLogRotation>
+//	Set when the log file should be rotated
+//-----------------------------------------------------------------------------
+void Log::SetLogRotation
+(
+	uint32 const _maxFileSize,
+	uint32 const _rotateInterval,
+	uint32 const _retainedFiles,
+	bool const _bCompress
+)
+{
+	if( s_instance && s_instance->m_pImpl )
+	{
+	  	s_instance->m_logMutex->Lock();
+		s_instance->m_pImpl->SetLogRotation( _maxFileSize, _rotateInterval, _retainedFiles, _bCompress );
+		s_instance->m_logMutex->Unlock();
+	}
+}
+
 //-----------------------------------------------------------------------------
 //	<Log::SetLogFileName>
 //	Change the name of the log file (will start writing a new file)
@@ -290,11 +603,12 @@ Log::Log
 	bool const _bConsoleOutput,
 	LogLevel const _saveLevel,
 	LogLevel const _queueLevel,
-	LogLevel const _dumpTrigger
+	LogLevel const _dumpTrigger,
+	int32 const _flushInterval
 ):
 	m_logMutex( new Mutex() )
 {
-	m_pImpl = new LogImpl( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger );
+	m_pImpl = new LogImpl( _filename, _bAppend, _bConsoleOutput, _saveLevel, _queueLevel, _dumpTrigger, _flushInterval );
 }
 
 //-----------------------------------------------------------------------------
@@ -305,6 +619,50 @@ Log::~Log
 (
 )
 {
+	// Detach the implementation first, so that anything logged while it
+	// shuts down (such as by its writer thread) is simply dropped.
+	m_logMutex->Lock();
+	i_LogImpl* pImpl = m_pImpl;
+	m_pImpl = NULL;
+	m_logMutex->Unlock();
+
+	delete pImpl;
 	m_logMutex->Release();
-	delete m_pImpl;
+}
+
+//-----------------------------------------------------------------------------
+//	<WriteFormatted>
+//	Pass variable arguments on to a log implementation
+//-----------------------------------------------------------------------------
+static void WriteFormatted
+(
+	i_LogImpl* _impl,
+	LogLevel _level,
+	uint8 const _nodeId,
+	char const* _format,
+	...
+)
+{
+	va_list args;
+	va_start( args, _format );
+	_impl->Write( _level, _nodeId, _format, args );
+	va_end( args );
+}
+
+//-----------------------------------------------------------------------------
+//	<i_LogImpl::WriteData>
+//	Default handling of binary data, for implementations that only take text
+//-----------------------------------------------------------------------------
+void i_LogImpl::WriteData
+(
+	LogLevel _level,
+	uint8 const _nodeId,
+	char const* _label,
+	uint8 const* _data,
+	uint32 const _length
+)
+{
+	char buf[1024];
+	FlightRecorder::FormatData( _label, _data, _length, false, buf, sizeof(buf) );
+	WriteFormatted( this, _level, _nodeId, "%s", buf );
 }
@@ -57,10 +57,15 @@ namespace OpenZWave
 		i_LogImpl() { } ;
 		virtual ~i_LogImpl() { } ;
 		virtual void Write( LogLevel _level, uint8 const _nodeId, char const* _format, va_list _args ) = 0;
+		virtual void WriteData( LogLevel _level, uint8 const _nodeId, char const* _label, uint8 const* _data, uint32 const _length );
+		/** Write a message that is below the save level, but which a node or command class filter has asked to see */
+		virtual void WriteTraced( LogLevel _level, uint8 const _nodeId, char const* _format, va_list _args ){ Write( _level, _nodeId, _format, _args ); }
 		virtual void QueueDump() = 0;
 		virtual void QueueClear() = 0;
+		virtual bool QueueSave( string const& _filename ){ return false; }
 		virtual void SetLoggingState( LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger ) = 0;
 		virtual void SetLogFileName( string _filename ) = 0;
+		virtual void SetLogRotation( uint32 const _maxFileSize, uint32 const _rotateInterval, uint32 const _retainedFiles, bool const _bCompress ){}
 	};
 
 	/** \brief Implements a platform-independent log...written to the console and, optionally, a file.
@@ -72,10 +77,13 @@ namespace OpenZWave
 		 * Create a log.
 		 * Creates the cross-platform logging singleton.
 		 * Any previous log will be cleared.
+		 * \param _flushInterval	Milliseconds for which log output may be held in memory before
+		 * being written to the file.  The file is written by a thread of its own, so that logging
+		 * never has to wait on the disk.  Errors are always written out straight away.
 		 * \return a pointer to the logging object.
 		 * \see Destroy, Write
 		 */
-		static Log* Create( string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel const _saveLevel, LogLevel const _queueLevel, LogLevel const _dumpTrigger );
+		static Log* Create( string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel const _saveLevel, LogLevel const _queueLevel, LogLevel const _dumpTrigger, int32 const _flushInterval = 0 );
 
 		/**
 		 * Create a log.
@@ -132,6 +140,54 @@ namespace OpenZWave
 		*/
 		static void GetLoggingState( LogLevel* _saveLevel, LogLevel* _queueLevel, LogLevel* _dumpTrigger );
 
+		/**
+		 * \brief Test whether messages of a given level might be logged at all.
+		 * This is cheap enough to call before doing any work to build up the
+		 * arguments of a message.  It allows for the node and command class
+		 * filters, so it can return true for a message that is then only logged
+		 * if it is about a particular node or command class.
+		 * \param _level	LogLevel of the message
+		 * \see OZW_LOG
+		*/
+		static bool IsEnabled( LogLevel _level ){ return( _level <= s_enabledLevel ); }
+
+		/**
+		 * \brief Test whether a message about a particular node and command class would be logged.
+		 * \param _level	LogLevel of the message
+		 * \param _nodeId	Node the message is about, or zero
+		 * \param _commandClassId	Command class the message is about, or zero
+		*/
+		static bool IsEnabled( LogLevel _level, uint8 const _nodeId, uint8 const _commandClassId = 0 );
+
+		/**
+		 * \brief Log messages about one node in more detail than the rest of the network.
+		 * Messages about the node down to this level are written out in real time, on top of
+		 * whatever SetLoggingState allows for everything else.  This makes it possible to
+		 * trace a single troublesome node at LogLevel_Detail without flooding the log.
+		 * \param _nodeId	The node to trace
+		 * \param _level	Least severe level of message to write about the node, or LogLevel_None
+		 * to go back to the normal levels.
+		 * \see SetCommandClassLoggingLevel, ClearLoggingFilters
+		*/
+		static void SetNodeLoggingLevel( uint8 const _nodeId, LogLevel const _level );
+
+		/**
+		 * \brief Log messages about one command class in more detail than the rest.
+		 * Works in the same way as SetNodeLoggingLevel, for messages from the command
+		 * class handlers and for the frames that carry the command class.
+		 * \param _commandClassId	The command class to trace
+		 * \param _level	Least severe level of message to write about the command class, or
+		 * LogLevel_None to go back to the normal levels.
+		 * \see SetNodeLoggingLevel, ClearLoggingFilters
+		*/
+		static void SetCommandClassLoggingLevel( uint8 const _commandClassId, LogLevel const _level );
+
+		/**
+		 * \brief Remove all node and command class logging levels.
+		 * \see SetNodeLoggingLevel, SetCommandClassLoggingLevel
+		*/
+		static void ClearLoggingFilters();
+
 		/**
 		 * \brief Change the log file name.  This will start a new log file (or potentially start appending
 		 * information to an existing one.  Developers might want to use this function, together with a timer
@@ -140,9 +196,24 @@ namespace OpenZWave
 		*/
 		static void SetLogFileName( string _filename );
 
+		/**
+		 * \brief Rotate the log file once it reaches a certain size or age.
+		 * The file is renamed by adding ".1" to its name (the previous ".1" becomes ".2",
+		 * and so on), and a new file is started.  All of this, including any compression,
+		 * is done by the thread that writes the log, so it never holds up the driver.
+		 * \param _maxFileSize	Rotate once the file reaches this many bytes, or zero for no limit.
+		 * \param _rotateInterval	Rotate once the file has been in use for this many milliseconds, or zero for no limit.
+		 * \param _retainedFiles	Number of old files to keep.  Older ones are deleted.
+		 * \param _bCompress	If true, old files are compressed with gzip and given a ".gz" extension.
+		 */
+		static void SetLogRotation( uint32 const _maxFileSize, uint32 const _rotateInterval, uint32 const _retainedFiles, bool const _bCompress );
+
 		/**
 		 * Write an entry to the log.
 		 * Writes a formatted string to the log.
+		 * Queued messages are stored unformatted, with only a pointer to the format
+		 * string, so the format should always be a string literal.  To log text
+		 * that has been built up at run time, pass it as an argument to "%s".
 		 * \param _level	Specifies the type of log message (Error, Warning, Debug, etc.)
 		 * \param _format.  A string formatted in the same manner as used with printf etc.
 		 * \param ... a variable number of arguments, to be included in the formatted string.
@@ -161,6 +232,32 @@ namespace OpenZWave
 		 */
 		static void Write( LogLevel _level, uint8 const _nodeId, char const* _format, ... );
 
+		/**
+		 * Write an entry to the log.
+		 * Writes a formatted string to the log.
+		 * \param _level	Specifies the type of log message (Error, Warning, Debug, etc.)
+		 * \param _nodeId	Node Id this entry is about.
+		 * \param _commandClassId	Command class this entry is about, for SetCommandClassLoggingLevel.
+		 * \param _format.  A string formatted in the same manner as used with printf etc.
+		 * \param ... a variable number of arguments, to be included in the formatted string.
+		 * \see Create, Destroy
+		 */
+		static void Write( LogLevel _level, uint8 const _nodeId, uint8 const _commandClassId, char const* _format, ... );
+
+		/**
+		 * Write a block of binary data, such as a message frame, to the log.
+		 * The data appears as the label followed by the bytes in hex.  When the
+		 * data is only queued, it is stored as raw bytes and not formatted unless
+		 * the queue is dumped.
+		 * \param _level	Specifies the type of log message (Error, Warning, Debug, etc.)
+		 * \param _nodeId	Node Id this entry is about.
+		 * \param _label	Text to show before the data.  As with a format string, this should be a string literal.
+		 * \param _data	The bytes to log.
+		 * \param _length	Number of bytes.
+		 * \param _commandClassId	Command class carried by the data, if any.
+		 */
+		static void WriteData( LogLevel _level, uint8 const _nodeId, char const* _label, uint8 const* _data, uint32 const _length, uint8 const _commandClassId = 0 );
+
 		/**
 		 * Send the queued log messages to the log output.
 		 */
@@ -171,14 +268,46 @@ namespace OpenZWave
 		 */
 		static void QueueClear();
 
+		/**
+		 * Save the queued log messages to a file, without removing them from the queue.
+		 * The file is in a compact binary form, and can be turned back into text
+		 * with the LogDecode tool.  This is useful for capturing the history that
+		 * led up to a problem, such as from a crash handler.
+		 * \param _filename	Name of the file to write.
+		 * \return true if the file was written.  Logging implementations that do not keep
+		 * a binary queue return false.
+		 */
+		static bool QueueSave( string const& _filename );
+
 	private:
-		Log( string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger );
+		Log( string const& _filename, bool const _bAppend, bool const _bConsoleOutput, LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger, int32 const _flushInterval );
 		~Log();
 
+		static void UpdateEnabledLevel();
+		static void UpdateFilterLevel();
+		static bool IsTraced( LogLevel _level, uint8 const _nodeId, uint8 const _commandClassId );
+		static void WriteArgs( LogLevel _level, uint8 const _nodeId, uint8 const _commandClassId, char const* _format, va_list _args );
+
 		static i_LogImpl*	m_pImpl;		/**< Pointer to an object that encapsulates the platform-specific logging implementation. */
 		static Log*	s_instance;
+		static LogLevel	s_saveLevel;
+		static LogLevel	s_queueLevel;
+		static LogLevel	s_dumpTrigger;
+		static LogLevel	s_enabledLevel;		/**< Least severe level that is written, queued or triggers a dump, for any node */
+		static LogLevel	s_baseLevel;		/**< As s_enabledLevel, but ignoring the node and command class filters */
+		static LogLevel	s_filterLevel;		/**< Least severe level asked for by any node or command class filter */
+		static LogLevel	s_nodeLevel[256];
+		static LogLevel	s_commandClassLevel[256];
 		Mutex*		m_logMutex;
 	};
 } // namespace OpenZWave
 
+/**
+ * Write an entry to the log, taking the same arguments as Log::Write.
+ * The remaining arguments are only evaluated if the level is enabled, so
+ * messages that call functions such as Msg::GetAsString cost nothing when
+ * they are not going to be logged.
+ */
+#define OZW_LOG( _level, ... )	do { if( OpenZWave::Log::IsEnabled( _level ) ) { OpenZWave::Log::Write( _level, __VA_ARGS__ ); } } while( 0 )
+
 #endif //_Log_H
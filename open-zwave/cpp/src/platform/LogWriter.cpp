@@ -0,0 +1,378 @@
+//-----------------------------------------------------------------------------
+//
+//	LogWriter.cpp
+//
+//	Background thread that writes log output to disk
+//
+//	Copyright (c) 2010 Mal Lansell <mal@lansell.org>
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <string.h>
+#include "Defs.h"
+#include "LogWriter.h"
+#include "Event.h"
+#include "Mutex.h"
+#include "Thread.h"
+#include "TimeStamp.h"
+#include "Gzip.h"
+
+using namespace OpenZWave;
+
+static size_t const c_flushThreshold	= 64 * 1024;	// Wake the writer early once this much is waiting
+static size_t const c_maxBuffered	= 1024 * 1024;	// Discard lines rather than buffer more than this
+
+//-----------------------------------------------------------------------------
+// <LogWriter::LogWriter>
+// Constructor
+//-----------------------------------------------------------------------------
+LogWriter::LogWriter
+(
+	string const& _filename,
+	bool const _bAppend,
+	int32 const _flushInterval
+):
+	m_writerThread( new Thread( "log" ) ),
+	m_bufferMutex( new Mutex() ),
+	m_wakeEvent( new Event() ),
+	m_flushEvent( new Event() ),
+	m_dropped( 0 ),
+	m_switchOffset( 0 ),
+	m_bExit( false ),
+	m_maxFileSize( 0 ),
+	m_rotateInterval( 0 ),
+	m_retainedFiles( 0 ),
+	m_bCompress( false ),
+	m_pFile( NULL ),
+	m_filename( _filename ),
+	m_flushInterval( _flushInterval ),
+	m_fileSize( 0 ),
+	m_openTime( 0 )
+{
+	OpenFile( _bAppend ? "a" : "w" );
+	m_writerThread->Start( LogWriter::WriterThreadEntryPoint, this );
+}
+
+//-----------------------------------------------------------------------------
+// <LogWriter::~LogWriter>
+// Destructor
+//-----------------------------------------------------------------------------
+LogWriter::~LogWriter
+(
+)
+{
+	m_bufferMutex->Lock();
+	m_bExit = true;
+	m_wakeEvent->Set();
+	m_flushEvent->Set();
+	m_bufferMutex->Unlock();
+
+	m_writerThread->Stop();
+	m_writerThread->Release();
+
+	// The thread flushes on its way out, but pick up anything that
+	// arrived after it did so.
+	Flush();
+	if( m_pFile != NULL )
+	{
+		fclose( m_pFile );
+	}
+
+	m_flushEvent->Release();
+	m_wakeEvent->Release();
+	m_bufferMutex->Release();
+}
+
+//-----------------------------------------------------------------------------
+// <LogWriter::Write>
+// Queue text to be written by the writer thread
+//-----------------------------------------------------------------------------
+void LogWriter::Write
+(
+	char const* _text,
+	bool const _bUrgent
+)
+{
+	size_t length = strlen( _text );
+
+	m_bufferMutex->Lock();
+	if( m_buffer.size() + length > c_maxBuffered )
+	{
+		++m_dropped;
+	}
+	else
+	{
+		if( m_buffer.empty() )
+		{
+			m_wakeEvent->Set();
+		}
+		m_buffer.append( _text, length );
+	}
+
+	if( _bUrgent || ( m_buffer.size() >= c_flushThreshold ) )
+	{
+		m_wakeEvent->Set();
+		m_flushEvent->Set();
+	}
+	m_bufferMutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <LogWriter::SetFileName>
+// Switch to a new file once the text already queued has been written
+//-----------------------------------------------------------------------------
+void LogWriter::SetFileName
+(
+	string const& _filename
+)
+{
+	m_bufferMutex->Lock();
+	m_newFilename = _filename;
+	m_switchOffset = m_buffer.size();
+	m_wakeEvent->Set();
+	m_flushEvent->Set();
+	m_bufferMutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <LogWriter::SetRotation>
+// Set when the writer thread should start a new file
+//-----------------------------------------------------------------------------
+void LogWriter::SetRotation
+(
+	uint32 const _maxFileSize,
+	uint32 const _rotateInterval,
+	uint32 const _retainedFiles,
+	bool const _bCompress
+)
+{
+	m_bufferMutex->Lock();
+	m_maxFileSize = _maxFileSize;
+	m_rotateInterval = _rotateInterval;
+	m_retainedFiles = _retainedFiles;
+	m_bCompress = _bCompress;
+	m_bufferMutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <LogWriter::WriterThreadEntryPoint>
+// Entry point of the thread that writes to disk
+//-----------------------------------------------------------------------------
+void LogWriter::WriterThreadEntryPoint
+(
+	Event* _exitEvent,
+	void* _context
+)
+{
+	LogWriter* writer = (LogWriter*)_context;
+	if( writer )
+	{
+		writer->WriterThreadProc();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <LogWriter::WriterThreadProc>
+// Write out the buffered text in batches
+//-----------------------------------------------------------------------------
+void LogWriter::WriterThreadProc
+(
+)
+{
+	// The events are waited on directly rather than through Wait::Multiple,
+	// since that logs every wait and so would keep waking this thread up.
+	bool bExit = false;
+	while( !bExit )
+	{
+		// Sleep until there is something to write
+		m_wakeEvent->Wait( Wait::Timeout_Infinite );
+
+		// Give more lines a chance to arrive, so that they can all be
+		// written together.  Urgent lines and exit cut this short.
+		if( m_flushInterval > 0 )
+		{
+			m_flushEvent->Wait( m_flushInterval );
+		}
+
+		m_bufferMutex->Lock();
+		bExit = m_bExit;
+		m_bufferMutex->Unlock();
+
+		Flush();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <LogWriter::Flush>
+// Take the buffered text and write it to the file
+//-----------------------------------------------------------------------------
+void LogWriter::Flush
+(
+)
+{
+	string batch;
+	string newFilename;
+	size_t switchOffset;
+	uint32 dropped;
+	uint32 maxFileSize;
+	uint32 rotateInterval;
+	uint32 retainedFiles;
+	bool bCompress;
+
+	m_bufferMutex->Lock();
+	batch.swap( m_buffer );
+	newFilename.swap( m_newFilename );
+	switchOffset = m_switchOffset;
+	m_switchOffset = 0;
+	dropped = m_dropped;
+	m_dropped = 0;
+	maxFileSize = m_maxFileSize;
+	rotateInterval = m_rotateInterval;
+	retainedFiles = m_retainedFiles;
+	bCompress = m_bCompress;
+	m_wakeEvent->Reset();
+	m_flushEvent->Reset();
+	m_bufferMutex->Unlock();
+
+	if( !newFilename.empty() )
+	{
+		Output( batch.c_str(), switchOffset );
+		m_filename = newFilename;
+		OpenFile( "a" );
+		Output( batch.c_str() + switchOffset, batch.size() - switchOffset );
+	}
+	else
+	{
+		Output( batch.c_str(), batch.size() );
+	}
+
+	if( dropped )
+	{
+		char buf[128];
+		snprintf( buf, sizeof(buf), "*** %u log lines were discarded because the log could not be written quickly enough\n", dropped );
+		Output( buf, strlen( buf ) );
+	}
+
+	if( m_pFile != NULL )
+	{
+		fflush( m_pFile );
+
+		if( ( maxFileSize && ( m_fileSize >= maxFileSize ) )
+			|| ( rotateInterval && ( TimeStamp::GetMonotonicTime() - m_openTime >= rotateInterval ) ) )
+		{
+			Rotate( retainedFiles, bCompress );
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <LogWriter::Output>
+// Write a block of text to the file
+//-----------------------------------------------------------------------------
+void LogWriter::Output
+(
+	char const* _data,
+	size_t _length
+)
+{
+	if( ( m_pFile != NULL ) && _length )
+	{
+		m_fileSize += (uint32)fwrite( _data, 1, _length, m_pFile );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <LogWriter::OpenFile>
+// Close the current file, if any, and open m_filename
+//-----------------------------------------------------------------------------
+void LogWriter::OpenFile
+(
+	char const* _mode
+)
+{
+	if( m_pFile != NULL )
+	{
+		fclose( m_pFile );
+		m_pFile = NULL;
+	}
+
+	m_fileSize = 0;
+	m_openTime = TimeStamp::GetMonotonicTime();
+	if( !m_filename.empty() )
+	{
+		m_pFile = fopen( m_filename.c_str(), _mode );
+		if( m_pFile != NULL )
+		{
+			fseek( m_pFile, 0, SEEK_END );
+			m_fileSize = (uint32)ftell( m_pFile );
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <LogWriter::Rotate>
+// Rename the current file out of the way and start a new one
+//-----------------------------------------------------------------------------
+void LogWriter::Rotate
+(
+	uint32 const _retainedFiles,
+	bool const _bCompress
+)
+{
+	fclose( m_pFile );
+	m_pFile = NULL;
+
+	if( _retainedFiles == 0 )
+	{
+		remove( m_filename.c_str() );
+	}
+	else
+	{
+		// Shuffle the old files up by one, dropping the oldest.  Both the plain
+		// and compressed names are handled, in case the setting has changed.
+		char suffix[16];
+		snprintf( suffix, sizeof(suffix), ".%u", _retainedFiles );
+		remove( ( m_filename + suffix ).c_str() );
+		remove( ( m_filename + suffix + ".gz" ).c_str() );
+
+		for( uint32 i=_retainedFiles-1; i>0; --i )
+		{
+			char newSuffix[16];
+			snprintf( suffix, sizeof(suffix), ".%u", i );
+			snprintf( newSuffix, sizeof(newSuffix), ".%u", i+1 );
+			rename( ( m_filename + suffix ).c_str(), ( m_filename + newSuffix ).c_str() );
+			rename( ( m_filename + suffix + ".gz" ).c_str(), ( m_filename + newSuffix + ".gz" ).c_str() );
+		}
+
+		string rotated = m_filename + ".1";
+		rename( m_filename.c_str(), rotated.c_str() );
+
+		// Start the new file before compressing, so that it is never missing for long
+		OpenFile( "w" );
+
+		if( _bCompress && Gzip::CompressFile( rotated, rotated + ".gz" ) )
+		{
+			remove( rotated.c_str() );
+		}
+		return;
+	}
+
+	OpenFile( "w" );
+}
@@ -0,0 +1,136 @@
+//-----------------------------------------------------------------------------
+//
+//	LogWriter.h
+//
+//	Background thread that writes log output to disk
+//
+//	Copyright (c) 2010 Mal Lansell <mal@lansell.org>
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _LogWriter_H
+#define _LogWriter_H
+
+#include <stdio.h>
+#include <string>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class Event;
+	class Mutex;
+	class Thread;
+
+	/** \brief Writes log lines to a file from a thread of its own.
+	 *
+	 * Callers only copy their text into an in-memory buffer, so a thread
+	 * that logs never has to wait on the disk.  The writer thread keeps the
+	 * file open, and periodically swaps the buffer for an empty one and
+	 * writes out the whole batch in a single call.  If the disk cannot keep
+	 * up, lines are discarded rather than letting the buffer grow without
+	 * limit, and a note of how many were lost is written in their place.
+	 *
+	 * The writer thread can also rotate the file once it reaches a certain
+	 * size or age, keeping a number of older files alongside it and
+	 * optionally compressing them.
+	 */
+	class LogWriter
+	{
+	public:
+		/**
+		 * Constructor.
+		 * Starts the writer thread.
+		 * \param _filename name of the log file.
+		 * \param _bAppend if false, any existing file of the same name is overwritten.
+		 * \param _flushInterval milliseconds for which lines may be held in memory
+		 * before being written.  Zero writes each line out as soon as the writer
+		 * thread can get to it.
+		 */
+		LogWriter( string const& _filename, bool const _bAppend, int32 const _flushInterval );
+
+		/**
+		 * Destructor.
+		 * Writes out anything still buffered and closes the file.
+		 */
+		~LogWriter();
+
+		/**
+		 * Queue text to be written to the file.
+		 * \param _text the text to write, including any line ending.
+		 * \param _bUrgent if true, the writer thread is woken to write the
+		 * text straight away rather than at the end of the flush interval.
+		 */
+		void Write( char const* _text, bool const _bUrgent = false );
+
+		/**
+		 * Switch to a different file.  Text that has already been queued is
+		 * still written to the old one.
+		 * \param _filename name of the new (or existing) file, which is appended to.
+		 */
+		void SetFileName( string const& _filename );
+
+		/**
+		 * Set when the file is rotated.  When that happens the file is renamed
+		 * by adding ".1" to its name (and ".1" becomes ".2", and so on), and a new
+		 * file is started.  Checks are made each time a batch of text is written,
+		 * so files can end up slightly larger than the limit.
+		 * \param _maxFileSize rotate once the file reaches this many bytes, or zero for no limit.
+		 * \param _rotateInterval rotate once the file has been written to for this many
+		 * milliseconds, or zero for no limit.
+		 * \param _retainedFiles number of old files to keep.  Older ones are deleted.
+		 * \param _bCompress if true, old files are compressed with gzip and given a
+		 * ".gz" extension.
+		 */
+		void SetRotation( uint32 const _maxFileSize, uint32 const _rotateInterval, uint32 const _retainedFiles, bool const _bCompress );
+
+	private:
+		LogWriter( LogWriter const& );					// prevent copy
+		LogWriter& operator = ( LogWriter const& );			// prevent assignment
+
+		static void WriterThreadEntryPoint( Event* _exitEvent, void* _context );
+		void WriterThreadProc();
+		void Flush();
+		void Output( char const* _data, size_t _length );
+		void OpenFile( char const* _mode );
+		void Rotate( uint32 const _retainedFiles, bool const _bCompress );
+
+		Thread*		m_writerThread;
+		Mutex*		m_bufferMutex;			// Protects the members below it, up to m_pFile
+		Event*		m_wakeEvent;			// Set when the buffer stops being empty
+		Event*		m_flushEvent;			// Set when the buffer must be written without waiting
+		string		m_buffer;			// Text waiting to be written
+		uint32		m_dropped;			// Lines discarded since the last batch was taken
+		string		m_newFilename;			// File to switch to, if not empty
+		size_t		m_switchOffset;			// Amount of m_buffer that belongs to the old file
+		bool		m_bExit;			// Set to make the writer thread finish
+		uint32		m_maxFileSize;			// Rotation settings (see SetRotation)
+		uint32		m_rotateInterval;
+		uint32		m_retainedFiles;
+		bool		m_bCompress;
+		FILE*		m_pFile;			// Only ever used by the writer thread once it is running
+		string		m_filename;
+		int32		m_flushInterval;
+		uint32		m_fileSize;			// Bytes in the current file
+		uint64		m_openTime;			// When the current file was opened (see TimeStamp::GetMonotonicTime)
+	};
+
+} // namespace OpenZWave
+
+#endif //_LogWriter_H
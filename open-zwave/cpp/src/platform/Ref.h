@@ -31,6 +31,7 @@
 #pragma once
 
 #include "Defs.h"
+#include "Atomic.h"
 
 namespace OpenZWave
 {
@@ -40,7 +41,8 @@ namespace OpenZWave
 	 * Derived classes must declare their destructor as protected virtual.
 	 * On construction, the reference count is set to one.  Calls to AddRef increment 
 	 * the count.  Calls to Release decrement the count.  When the count reaches
-	 * zero, the object is deleted.
+	 * zero, the object is deleted.  The count is updated atomically, so references
+	 * may be added and released on different threads.
 	 */
 	class Ref
 	{
@@ -58,7 +60,7 @@ namespace OpenZWave
 		 * to Release before the object will be deleted.
 		 * \see Release
 		 */
-		void AddRef(){ ++m_refs; }
+		void AddRef(){ Atomic::Add( &m_refs, 1 ); }
 
 		/**
 		 * Removes a reference to an object.
@@ -68,12 +70,13 @@ namespace OpenZWave
 		 */
 		int32 Release()
 		{
-			if( 0 >= ( --m_refs ) )
+			int32 refs = (int32)Atomic::Add( &m_refs, (uint32)-1 );
+			if( 0 >= refs )
 			{
 				delete this;
 				return 0;
 			}
-			return m_refs;
+			return refs;
 		}
 
 	protected:
@@ -81,7 +84,7 @@ namespace OpenZWave
 
 	private:
 		// Reference counting
-		int32	m_refs;
+		uint32 volatile	m_refs;
 
 	}; // class Ref
 
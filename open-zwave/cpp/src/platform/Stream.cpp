@@ -117,7 +117,7 @@ bool Stream::Get
 		m_tail += _size;
 	}
 
-	Log::Write( LogLevel_Debug, "      Stream::Get (provided to application)" );
+	OZW_LOG( LogLevel_Debug, "      Stream::Get (provided to application)" );
 	LogData( _buffer, _size, "      Get: ");
 
 	m_dataSize -= _size;
@@ -143,7 +143,7 @@ bool Stream::Put
 	}
 
 	m_mutex->Lock();
-	Log::Write( LogLevel_Debug, "      Stream::Put (received from controller)" );
+	OZW_LOG( LogLevel_Debug, "      Stream::Put (received from controller)" );
 	if( (m_head + _size) > m_bufferSize )
 	{
 		// We will have to wrap around
@@ -208,22 +208,10 @@ void Stream::LogData
 (
 	uint8* _buffer,
 	uint32 _length,
-	string _function
+	char const* _function
 )
 {
 	if( !_length ) return;
 
-	string str = "";
-	for( uint32 i=0; i<_length; ++i ) 
-	{
-		if( i )
-		{
-			str += ", ";
-		}
-			
-		char byteStr[8];
-		snprintf( byteStr, sizeof(byteStr), "0x%.2x", _buffer[i] );
-		str += byteStr;
-	}
-	Log::Write( LogLevel_Debug, "%s%s", _function.c_str(), str.c_str() );
+	Log::WriteData( LogLevel_Debug, 0, _function, _buffer, _length );
 }
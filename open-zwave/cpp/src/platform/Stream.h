@@ -103,7 +103,7 @@ namespace OpenZWave
 		 * \param _size number of valid bytes currently in the buffer
 		 * \param _function string containing text to display before the data
 		 */
-		void LogData( uint8* _buffer, uint32 _size, string _function );
+		void LogData( uint8* _buffer, uint32 _size, char const* _function );
 
 		/**
 		 * Used by the Wait class to test whether the buffer contains sufficient data.
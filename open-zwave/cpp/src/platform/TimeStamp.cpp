@@ -41,7 +41,7 @@ using namespace OpenZWave;
 TimeStamp::TimeStamp
 (
 ):
-	m_pImpl( new TimeStampImpl() )
+	m_stamp( TimeStampImpl::GetMonotonicTime() )
 {
 }
 
@@ -53,7 +53,6 @@ TimeStamp::~TimeStamp
 (
 )
 {
-	delete m_pImpl;
 }
 
 //-----------------------------------------------------------------------------
@@ -65,7 +64,7 @@ void TimeStamp::SetTime
 	int32 _milliseconds	// = 0
 )
 {
-	m_pImpl->SetTime( _milliseconds );
+	m_stamp = TimeStampImpl::GetMonotonicTime() + ( (int64)_milliseconds * 1000000 );
 }
 
 //-----------------------------------------------------------------------------
@@ -74,9 +73,9 @@ void TimeStamp::SetTime
 //-----------------------------------------------------------------------------
 int32 TimeStamp::TimeRemaining
 (
-)
+)const
 {
-	return m_pImpl->TimeRemaining();
+	return (int32)( (int64)( m_stamp - TimeStampImpl::GetMonotonicTime() ) / 1000000 );
 }
 
 //-----------------------------------------------------------------------------
@@ -85,10 +84,29 @@ int32 TimeStamp::TimeRemaining
 //-----------------------------------------------------------------------------
 string TimeStamp::GetAsString
 (
-)
+)const
 {
-	return m_pImpl->GetAsString();
+	char buf[32];
+	Format( buf, sizeof(buf) );
+	return buf;
 }
+
+//-----------------------------------------------------------------------------
+//	<TimeStamp::Format>
+//	Write the timestamp into a buffer as local wall-clock time
+//-----------------------------------------------------------------------------
+void TimeStamp::Format
+(
+	char* _buffer,
+	uint32 _size
+)const
+{
+	// Anchor the monotonic timestamp to the wall clock as it is right now,
+	// so that any steps in the system time since it was taken are honoured.
+	int64 age = (int64)( TimeStampImpl::GetMonotonicTime() - m_stamp );
+	TimeStampImpl::FormatWallClock( age, _buffer, _size );
+}
+
 //-----------------------------------------------------------------------------
 //	<TimeStamp::operator->
 //	Overload the subtract operator to get the difference between two 
@@ -97,7 +115,55 @@ string TimeStamp::GetAsString
 int32 TimeStamp::operator- 
 (
 	TimeStamp const& _other
+)const
+{
+	return (int32)( (int64)( m_stamp - _other.m_stamp ) / 1000000 );
+}
+
+//-----------------------------------------------------------------------------
+//	<TimeStamp::GetMonotonicTime>
+//	Milliseconds since an arbitrary fixed point, unaffected by clock changes
+//-----------------------------------------------------------------------------
+uint64 TimeStamp::GetMonotonicTime
+(
+)
+{
+	return TimeStampImpl::GetMonotonicTime() / 1000000;
+}
+
+//-----------------------------------------------------------------------------
+//	<TimeStamp::GetMonotonicTimeMicroseconds>
+//	Microseconds since the same point as GetMonotonicTime
+//-----------------------------------------------------------------------------
+uint64 TimeStamp::GetMonotonicTimeMicroseconds
+(
+)
+{
+	return TimeStampImpl::GetMonotonicTime() / 1000;
+}
+
+//-----------------------------------------------------------------------------
+//	<TimeStamp::GetWallClockTime>
+//	Milliseconds since the Unix epoch
+//-----------------------------------------------------------------------------
+int64 TimeStamp::GetWallClockTime
+(
+)
+{
+	return TimeStampImpl::GetWallClockTime();
+}
+
+//-----------------------------------------------------------------------------
+//	<TimeStamp::FormatWallClockTime>
+//	Write a wall-clock time into a buffer as local time
+//-----------------------------------------------------------------------------
+void TimeStamp::FormatWallClockTime
+(
+	int64 _milliseconds,
+	char* _buffer,
+	uint32 _size
 )
 {
-	return (int32)(m_pImpl - _other.m_pImpl);
+	int64 age = ( TimeStampImpl::GetWallClockTime() - _milliseconds ) * 1000000;
+	TimeStampImpl::FormatWallClock( age, _buffer, _size );
 }
@@ -28,20 +28,24 @@
 #ifndef _TimeStamp_H
 #define _TimeStamp_H
 
+#include <string>
 #include "Defs.h"
 
 namespace OpenZWave
 {
-	class TimeStampImpl;
-
 	/** \brief Implements a platform-independent TimeStamp.
+	 *
+	 * The time is held as a 64-bit count of nanoseconds on the monotonic
+	 * clock, so arithmetic on timestamps is cheap, needs no allocation, and
+	 * is unaffected by changes to the system time.  Conversion to wall-clock
+	 * time only happens when the timestamp is formatted for display.
 	 */
 	class TimeStamp
 	{
 	public:
 		/**
 		 * Constructor.
-		 * Creates a TimeStamp object.
+		 * Creates a TimeStamp object set to the current time.
 		 */
 		TimeStamp();
 
@@ -64,28 +68,59 @@ namespace OpenZWave
 		 * \return milliseconds remaining until we reach the timestamp.  The 
 		 * return value is negative if the timestamp is in the past.
 		 */
-		int32 TimeRemaining();
+		int32 TimeRemaining()const;
 
 		/**
 		 * Return as a string for output.
 		 * \return string
 		 */
-		string GetAsString();
+		string GetAsString()const;
+
+		/**
+		 * Format the timestamp as local wall-clock time without allocating.
+		 * \param _buffer receives the null-terminated result.
+		 * \param _size size of the buffer in bytes.  32 bytes is always enough.
+		 */
+		void Format( char* _buffer, uint32 _size )const;
 
 		/**
 		 * Overload the subtract operator to get the difference between
 		 * two timestamps in milliseconds.
 		 */
-		int32 operator- ( TimeStamp const& _other );
+		int32 operator- ( TimeStamp const& _other )const;
 
-	private:
-		TimeStamp( TimeStamp const& );					// prevent copy
-		TimeStamp& operator = ( TimeStamp const& );			// prevent assignment
+		/**
+		 * Read the monotonic clock.  Unlike the wall clock, this never jumps
+		 * when the system time is changed, so it is safe to use for timeouts.
+		 * \return milliseconds since an arbitrary fixed point in the past.
+		 */
+		static uint64 GetMonotonicTime();
+
+		/**
+		 * Read the monotonic clock with a finer resolution, for timing short events.
+		 * \return microseconds since the same point as GetMonotonicTime.
+		 */
+		static uint64 GetMonotonicTimeMicroseconds();
 
-		TimeStampImpl*	m_pImpl;					// Pointer to an object that encapsulates the platform-specific implementation of the TimeStamp.
+		/**
+		 * Read the wall clock.
+		 * \return milliseconds since 00:00 on 1 January 1970 UTC.
+		 */
+		static int64 GetWallClockTime();
+
+		/**
+		 * Format a wall-clock time, as returned by GetWallClockTime, as local
+		 * time in the same style as Format.
+		 * \param _milliseconds the time to format.
+		 * \param _buffer receives the null-terminated result.
+		 * \param _size size of the buffer in bytes.  32 bytes is always enough.
+		 */
+		static void FormatWallClockTime( int64 _milliseconds, char* _buffer, uint32 _size );
+
+	private:
+		uint64		m_stamp;					// Nanoseconds on the monotonic clock
 	};
 
 } // namespace OpenZWave
 
 #endif //_TimeStamp_H
-
@@ -0,0 +1,281 @@
+//-----------------------------------------------------------------------------
+//
+//	TimerWheel.cpp
+//
+//	Hierarchical timer wheel for scheduling timeouts
+//
+//	Copyright (c) 2010 Mal Lansell <mal@lansell.org>
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#include <string>
+#include "Defs.h"
+#include "TimerWheel.h"
+#include "TimeStamp.h"
+#include "Wait.h"
+
+using namespace OpenZWave;
+
+//-----------------------------------------------------------------------------
+// <TimerWheel::TimerWheel>
+// Constructor
+//-----------------------------------------------------------------------------
+TimerWheel::TimerWheel
+(
+):
+	m_nextTick( GetTick() ),
+	m_numPending( 0 )
+{
+}
+
+//-----------------------------------------------------------------------------
+// <TimerWheel::~TimerWheel>
+// Destructor
+//-----------------------------------------------------------------------------
+TimerWheel::~TimerWheel
+(
+)
+{
+	for( uint32 level=0; level<NumLevels; ++level )
+	{
+		for( uint32 slot=0; slot<NumSlots; ++slot )
+		{
+			Timer* head = &m_slots[level][slot];
+			while( head->m_next != head )
+			{
+				Cancel( head->m_next );
+			}
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <TimerWheel::Schedule>
+// Schedule a timer to fire after a delay
+//-----------------------------------------------------------------------------
+void TimerWheel::Schedule
+(
+	Timer* _timer,
+	int32 _milliseconds
+)
+{
+	Cancel( _timer );
+
+	uint64 now = TimeStamp::GetMonotonicTime();
+	if( !m_numPending )
+	{
+		// Nothing has needed servicing since the wheel went idle, so
+		// skip straight to the present rather than stepping through
+		// every tick that has elapsed in the meantime.
+		m_nextTick = now >> TickShift;
+	}
+
+	if( _milliseconds < 0 )
+	{
+		_milliseconds = 0;
+	}
+
+	// Round up so that the timer never fires early
+	_timer->m_expiry = ( now + _milliseconds + ( 1 << TickShift ) - 1 ) >> TickShift;
+	Insert( _timer );
+	++m_numPending;
+}
+
+//-----------------------------------------------------------------------------
+// <TimerWheel::Cancel>
+// Cancel a pending timer
+//-----------------------------------------------------------------------------
+bool TimerWheel::Cancel
+(
+	Timer* _timer
+)
+{
+	if( !_timer->IsPending() )
+	{
+		return false;
+	}
+
+	Unlink( _timer );
+	--m_numPending;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <TimerWheel::GetTimeout>
+// Get the time in milliseconds until the wheel next needs servicing
+//-----------------------------------------------------------------------------
+int32 TimerWheel::GetTimeout
+(
+)
+{
+	if( !m_numPending )
+	{
+		return Wait::Timeout_Infinite;
+	}
+
+	// Look for the next occupied slot in the lowest wheel.  We stop at the
+	// point where the higher wheels next cascade, since timers from those
+	// may then drop into slots we have already passed over.
+	uint64 tick = m_nextTick;
+	while( m_slots[0][tick & SlotMask].m_next == &m_slots[0][tick & SlotMask] )
+	{
+		++tick;
+		if( !( tick & SlotMask ) )
+		{
+			break;
+		}
+	}
+
+	int64 timeout = (int64)( tick << TickShift ) - (int64)TimeStamp::GetMonotonicTime();
+	return( ( timeout > 0 ) ? (int32)timeout : 0 );
+}
+
+//-----------------------------------------------------------------------------
+// <TimerWheel::Service>
+// Fire the callbacks of any timers that have expired
+//-----------------------------------------------------------------------------
+void TimerWheel::Service
+(
+)
+{
+	uint64 now = GetTick();
+	while( m_numPending && ( m_nextTick <= now ) )
+	{
+		uint32 slot = (uint32)( m_nextTick & SlotMask );
+		if( !slot )
+		{
+			// The lowest wheel has wrapped, so refill it from the one above.
+			// That one may have wrapped too, and so on up the hierarchy.
+			for( uint32 level=1; level<NumLevels; ++level )
+			{
+				if( !Cascade( level ) )
+				{
+					break;
+				}
+			}
+		}
+
+		// Move the expired timers onto a list of their own before advancing,
+		// so that callbacks may safely schedule or cancel any timer.
+		Timer expired;
+		Timer* head = &m_slots[0][slot];
+		if( head->m_next != head )
+		{
+			expired.m_next = head->m_next;
+			expired.m_prev = head->m_prev;
+			expired.m_next->m_prev = &expired;
+			expired.m_prev->m_next = &expired;
+			head->m_next = head;
+			head->m_prev = head;
+		}
+		++m_nextTick;
+
+		while( expired.m_next != &expired )
+		{
+			Timer* timer = expired.m_next;
+			Cancel( timer );
+			timer->m_callback( timer->m_context );
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <TimerWheel::GetTick>
+// Read the monotonic clock in ticks
+//-----------------------------------------------------------------------------
+uint64 TimerWheel::GetTick
+(
+)const
+{
+	return( TimeStamp::GetMonotonicTime() >> TickShift );
+}
+
+//-----------------------------------------------------------------------------
+// <TimerWheel::Insert>
+// Add a timer to the slot that covers its expiry time
+//-----------------------------------------------------------------------------
+void TimerWheel::Insert
+(
+	Timer* _timer
+)
+{
+	if( _timer->m_expiry < m_nextTick )
+	{
+		_timer->m_expiry = m_nextTick;
+	}
+
+	// Choose the lowest wheel that can hold the timer without wrapping
+	uint64 expiry = _timer->m_expiry;
+	uint64 delta = expiry - m_nextTick;
+	uint32 level = 0;
+	while( ( level < (NumLevels-1) ) && ( delta >= ( ((uint64)1) << ( SlotBits * ( level+1 ) ) ) ) )
+	{
+		++level;
+	}
+
+	if( delta >= ( ((uint64)1) << ( SlotBits * NumLevels ) ) )
+	{
+		// Beyond the range of the top wheel.  Park the timer in the furthest
+		// slot - it will be placed correctly once it cascades down.
+		expiry = m_nextTick + ( ((uint64)1) << ( SlotBits * NumLevels ) ) - 1;
+	}
+
+	Timer* head = &m_slots[level][( expiry >> ( SlotBits * level ) ) & SlotMask];
+	_timer->m_next = head;
+	_timer->m_prev = head->m_prev;
+	head->m_prev->m_next = _timer;
+	head->m_prev = _timer;
+}
+
+//-----------------------------------------------------------------------------
+// <TimerWheel::Unlink>
+// Remove a timer from whichever slot list it is in
+//-----------------------------------------------------------------------------
+void TimerWheel::Unlink
+(
+	Timer* _timer
+)
+{
+	_timer->m_next->m_prev = _timer->m_prev;
+	_timer->m_prev->m_next = _timer->m_next;
+	_timer->m_next = NULL;
+	_timer->m_prev = NULL;
+}
+
+//-----------------------------------------------------------------------------
+// <TimerWheel::Cascade>
+// Redistribute the timers in the current slot of a higher wheel
+// Returns the index of that slot, which is zero if this wheel has also wrapped
+//-----------------------------------------------------------------------------
+uint32 TimerWheel::Cascade
+(
+	uint32 _level
+)
+{
+	uint32 slot = (uint32)( ( m_nextTick >> ( SlotBits * _level ) ) & SlotMask );
+	Timer* head = &m_slots[_level][slot];
+	while( head->m_next != head )
+	{
+		Timer* timer = head->m_next;
+		Unlink( timer );
+		Insert( timer );
+	}
+	return slot;
+}
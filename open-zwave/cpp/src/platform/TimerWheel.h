@@ -0,0 +1,145 @@
+//-----------------------------------------------------------------------------
+//
+//	TimerWheel.h
+//
+//	Hierarchical timer wheel for scheduling timeouts
+//
+//	Copyright (c) 2010 Mal Lansell <mal@lansell.org>
+//	All rights reserved.
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+#ifndef _TimerWheel_H
+#define _TimerWheel_H
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief Hierarchical timer wheel driven by the monotonic clock.
+	 *
+	 * Timers are kept in intrusive lists hanging off a small number of
+	 * wheels, so that scheduling and cancelling are constant time no matter
+	 * how many timers are pending.  The wheel does not run a thread of its
+	 * own: the owner calls GetTimeout to find out how long it may sleep, and
+	 * Service to fire any timers that have expired.  It is not thread-safe,
+	 * so all calls must be made from the thread that services it.
+	 */
+	class TimerWheel
+	{
+	public:
+		typedef void (*pfnTimerCallback_t)( void* _context );
+
+		/** \brief A single timer that can be scheduled on a TimerWheel.
+		 *
+		 * The timer is owned by the caller, and must be cancelled (or
+		 * allowed to fire) before it is destroyed.
+		 */
+		class Timer
+		{
+			friend class TimerWheel;
+
+		public:
+			Timer( pfnTimerCallback_t _callback, void* _context ): m_next( NULL ), m_prev( NULL ), m_expiry( 0 ), m_callback( _callback ), m_context( _context ){}
+
+			/**
+			 * Test whether the timer is waiting to fire.
+			 */
+			bool IsPending()const{ return( m_prev != NULL ); }
+
+		private:
+			Timer(): m_next( this ), m_prev( this ), m_expiry( 0 ), m_callback( NULL ), m_context( NULL ){}	// Empty slot list head
+
+			Timer( Timer const& );					// prevent copy
+			Timer& operator = ( Timer const& );			// prevent assignment
+
+			Timer*			m_next;
+			Timer*			m_prev;
+			uint64			m_expiry;				// Tick at which the timer fires
+			pfnTimerCallback_t	m_callback;
+			void*			m_context;
+		};
+
+		/**
+		 * Constructor.
+		 * Creates an empty timer wheel.
+		 */
+		TimerWheel();
+
+		/**
+		 * Destructor.
+		 * Any timers still pending are cancelled without firing.
+		 */
+		~TimerWheel();
+
+		/**
+		 * Schedule a timer to fire after the specified delay.  If the timer
+		 * is already pending, it is rescheduled.
+		 * \param _timer the timer to schedule.
+		 * \param _milliseconds delay before the timer fires.  The timer may
+		 * fire up to one tick late, but never early.
+		 * \see Cancel
+		 */
+		void Schedule( Timer* _timer, int32 _milliseconds );
+
+		/**
+		 * Cancel a pending timer.
+		 * \param _timer the timer to cancel.
+		 * \return True if the timer was pending.
+		 * \see Schedule
+		 */
+		bool Cancel( Timer* _timer );
+
+		/**
+		 * Get the time until the wheel next needs servicing.
+		 * \return milliseconds, or Wait::Timeout_Infinite if no timers are pending.
+		 */
+		int32 GetTimeout();
+
+		/**
+		 * Fire the callbacks of all timers that have expired.
+		 */
+		void Service();
+
+	private:
+		TimerWheel( TimerWheel const& );				// prevent copy
+		TimerWheel& operator = ( TimerWheel const& );			// prevent assignment
+
+		enum
+		{
+			TickShift	= 3,					// Each tick is 8ms
+			SlotBits	= 6,
+			NumSlots	= 1 << SlotBits,
+			SlotMask	= NumSlots - 1,
+			NumLevels	= 4					// Covers about 37 hours before cascading from the top level
+		};
+
+		uint64 GetTick()const;
+		void Insert( Timer* _timer );
+		static void Unlink( Timer* _timer );
+		uint32 Cascade( uint32 _level );
+
+		Timer		m_slots[NumLevels][NumSlots];			// List heads for each slot
+		uint64		m_nextTick;					// Next tick to be processed by Service
+		uint32		m_numPending;
+	};
+
+} // namespace OpenZWave
+
+#endif //_TimerWheel_H
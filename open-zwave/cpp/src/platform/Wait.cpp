@@ -130,6 +130,7 @@ int32 Wait::Multiple
 	}
 
 	int32 res = -1;	// Default to timeout result
+	bool bLog = Log::IsEnabled( LogLevel_Debug );
 	string str = "";
 	if( waitEvent->Wait( _timeout ) )
 	{
@@ -141,13 +142,18 @@ int32 Wait::Multiple
 			{
 				if( res == -1 )
 					res = (int32)i;
+				if( !bLog )
+					break;
 				char buf[15];
 				snprintf(buf, sizeof(buf), "%d, ", i);
 				str += buf;
 			}
 		}
 	}
-	Log::Write( LogLevel_Debug, "Wait::Multiple res=%d num=%d >%s", res, _numObjects, str.c_str() );
+	if( bLog )
+	{
+		Log::Write( LogLevel_Debug, "Wait::Multiple res=%d num=%d >%s", res, _numObjects, str.c_str() );
+	}
 
 	// Remove the watchers
 	for( i=0; i<_numObjects; ++i )
@@ -30,6 +30,7 @@
 
 #include <stdio.h>
 #include <sys/time.h>
+#include <time.h>
 
 using namespace OpenZWave;
 
@@ -53,6 +54,11 @@ EventImpl::EventImpl
 	pthread_condattr_t ca;
 	pthread_condattr_init( &ca );
 	pthread_condattr_setpshared( &ca, PTHREAD_PROCESS_PRIVATE );
+#if defined(CLOCK_MONOTONIC) && !defined(__APPLE__)
+	// Measure timeouts against the monotonic clock so that they are not
+	// stretched or cut short when the wall clock is stepped (NTP, DST etc).
+	pthread_condattr_setclock( &ca, CLOCK_MONOTONIC );
+#endif
 	pthread_cond_init( &m_condition, &ca );
 	pthread_condattr_destroy( &ca );
 }
@@ -184,26 +190,30 @@ bool EventImpl::Wait
 	        }
 	        else if( _timeout > 0 )
 		{
-			struct timeval now;
 			struct timespec abstime;
 
-			gettimeofday(&now, NULL);
-            
-			abstime.tv_sec = now.tv_sec + (_timeout / 1000);
+#if defined(CLOCK_MONOTONIC) && !defined(__APPLE__)
+			clock_gettime( CLOCK_MONOTONIC, &abstime );
+#else
+			struct timeval now;
+			gettimeofday( &now, NULL );
+			abstime.tv_sec = now.tv_sec;
+			abstime.tv_nsec = now.tv_usec * 1000;
+#endif
+
+			abstime.tv_sec += (_timeout / 1000);
 
-			// Now add the remainder of our timeout to the microseconds part of 'now'
-			now.tv_usec += (_timeout % 1000) * 1000;
+			// Now add the remainder of our timeout to the nanoseconds part
+			abstime.tv_nsec += (_timeout % 1000) * 1000 * 1000;
 
 			// Careful now! Did it wrap?
-			while( now.tv_usec >= ( 1000 * 1000 ) )
+			while( abstime.tv_nsec >= ( 1000 * 1000 * 1000 ) )
 			{
 				// Yes it did so bump our seconds and subtract
-				now.tv_usec -= (1000 * 1000);
+				abstime.tv_nsec -= (1000 * 1000 * 1000);
 				abstime.tv_sec++;
 			}
-            
-			abstime.tv_nsec = now.tv_usec * 1000;
-            
+
 			while( !m_isSignaled )
 			{
 				int oldstate;
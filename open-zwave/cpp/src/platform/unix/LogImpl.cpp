@@ -27,8 +27,10 @@
 //-----------------------------------------------------------------------------
 #include <string>
 #include <cstring>
+#include <pthread.h>
 #include "Defs.h"
 #include "LogImpl.h"
+#include "LogWriter.h"
 
 using namespace OpenZWave;
 
@@ -43,23 +45,18 @@ LogImpl::LogImpl
 	bool const _bConsoleOutput,
 	LogLevel const _saveLevel,
 	LogLevel const _queueLevel,
-	LogLevel const _dumpTrigger
+	LogLevel const _dumpTrigger,
+	int32 const _flushInterval
 ):
 	m_filename( _filename ),					// name of log file
 	m_bConsoleOutput( _bConsoleOutput ),		// true to provide a copy of output to console
 	m_bAppendLog( _bAppendLog ),				// true to append (and not overwrite) any existing log
+	m_pQueue( new FlightRecorder( FlightRecorder::DefaultSize ) ),	// recent messages, to be dumped on an error
 	m_saveLevel( _saveLevel ),					// level of messages to log to file
 	m_queueLevel( _queueLevel ),				// level of messages to log to queue
-	m_dumpTrigger( _dumpTrigger )				// dump queued messages when this level is seen
+	m_dumpTrigger( _dumpTrigger ),				// dump queued messages when this level is seen
+	m_pWriter( new LogWriter( _filename, _bAppendLog, _flushInterval ) )	// writes to the file from a thread of its own
 {
-	if ( !m_bAppendLog )
-	{
-		FILE* pFile = fopen( m_filename.c_str(), "w" );
-		if( pFile != NULL )
-		{
-			fclose( pFile );
-		}
-	}
 	setlinebuf(stdout);	// To prevent buffering and lock contention issues
 }
 
@@ -71,6 +68,8 @@ LogImpl::~LogImpl
 (
 )
 {
+	delete m_pWriter;
+	delete m_pQueue;
 }
 
 //-----------------------------------------------------------------------------
@@ -85,97 +84,128 @@ void LogImpl::Write
 	va_list _args
 )
 {
-	// create a timestamp string
-	string timeStr = GetTimeStampString();
-	string nodeStr = GetNodeString( _nodeId );
+	WriteMessage( _logLevel, _nodeId, _format, _args, _logLevel <= m_saveLevel );
+}
 
+//-----------------------------------------------------------------------------
+//	<LogImpl::WriteTraced>
+//	Write a message that a node or command class filter has asked for
+//-----------------------------------------------------------------------------
+void LogImpl::WriteTraced
+( 
+	LogLevel _logLevel,
+	uint8 const _nodeId,
+	char const* _format, 
+	va_list _args
+)
+{
+	WriteMessage( _logLevel, _nodeId, _format, _args, true );
+}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::WriteMessage>
+//	Queue a message and, if required, save it to file
+//-----------------------------------------------------------------------------
+void LogImpl::WriteMessage
+( 
+	LogLevel _logLevel,
+	uint8 const _nodeId,
+	char const* _format, 
+	va_list _args,
+	bool const _bSave
+)
+{
 	// handle this message
-	if( (_logLevel <= m_queueLevel) || (_logLevel == LogLevel_Internal) )	// we're going to do something with this message...
+	if( (_logLevel <= m_queueLevel) || _bSave || (_logLevel == LogLevel_Internal) )	// we're going to do something with this message...
 	{
-		char lineBuf[1024] = {};
-		int lineLen = 0;
-		if( _format != NULL && _format[0] != '\0' )
+		if( _format == NULL )
+		{
+			_format = "";
+		}
+
+		// queue the message unformatted.  It is only turned into text if the queue is dumped.
+		if( _logLevel != LogLevel_Internal )
 		{
 			va_list saveargs;
 			va_copy( saveargs, _args );
-			lineLen = vsnprintf( lineBuf, sizeof(lineBuf), _format, _args );
+			m_pQueue->Record( _logLevel, _nodeId, GetThreadId(), _format, saveargs );
 			va_end( saveargs );
 		}
 
 		// should this message be saved to file (and possibly written to console?)
-		if( (_logLevel <= m_saveLevel) || (_logLevel == LogLevel_Internal) )
+		if( _bSave || (_logLevel == LogLevel_Internal) )
 		{
-			char outBuf[1124];
-			char *outBufPtr = outBuf;
-			// save to file
-			FILE* pFile = fopen( m_filename.c_str(), "a" );
-			if ( pFile != NULL || m_bConsoleOutput )
+			char lineBuf[1024] = {};
+			if( _format[0] != '\0' )
 			{
-				if( _logLevel != LogLevel_Internal )						// don't add a second timestamp to display of queued messages
-				{
-					strcpy( outBufPtr, timeStr.c_str() );
-					outBufPtr += timeStr.length();
-					strcpy( outBufPtr, nodeStr.c_str() );
-					outBufPtr += nodeStr.length();
-				}
-
-				if( lineLen > 0 )
-				{
-					uint32 len = ( outBufPtr - outBuf ) + lineLen;
-					if( len >= sizeof(outBuf) )
-					{
-						lineLen = sizeof(outBuf) - 3;
-					}
-					strncpy( outBufPtr, lineBuf, lineLen );
-					outBufPtr += lineLen;
-				}
-
-				*outBufPtr++ = '\n';
-				*outBufPtr = '\0';
-
-				// print message to file (and possibly screen)
-				if( pFile != NULL )
-				{
-					fputs( outBuf, pFile );
-					fclose( pFile );
-				}
-				if( m_bConsoleOutput )
-				{
-					fputs( outBuf, stdout );
-				}
+				vsnprintf( lineBuf, sizeof(lineBuf), _format, _args );
 			}
+			Output( _logLevel, _nodeId, lineBuf );
 		}
+	}
 
-		if( _logLevel != LogLevel_Internal )
+	// now check to see if the _dumpTrigger has been hit
+	if( (_logLevel <= m_dumpTrigger) && (_logLevel != LogLevel_Internal) && (_logLevel != LogLevel_Always) )
+		QueueDump();
+}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::WriteData>
+//	Write a block of binary data to the log
+//-----------------------------------------------------------------------------
+void LogImpl::WriteData
+( 
+	LogLevel _logLevel,
+	uint8 const _nodeId,
+	char const* _label,
+	uint8 const* _data,
+	uint32 const _length
+)
+{
+	if( _logLevel <= m_queueLevel )
+	{
+		m_pQueue->RecordData( _logLevel, _nodeId, GetThreadId(), _label, _data, _length );
+
+		if( _logLevel <= m_saveLevel )
 		{
-			char queueBuf[1024];
-			string threadStr = GetThreadId();
-			snprintf( queueBuf, sizeof(queueBuf), "%s%s%s", timeStr.c_str(), threadStr.c_str(), lineBuf );
-			Queue( queueBuf );
+			char lineBuf[1024];
+			FlightRecorder::FormatData( _label, _data, _length, false, lineBuf, sizeof(lineBuf) );
+			Output( _logLevel, _nodeId, lineBuf );
 		}
 	}
 
-	// now check to see if the _dumpTrigger has been hit
-	if( (_logLevel <= m_dumpTrigger) && (_logLevel != LogLevel_Internal) && (_logLevel != LogLevel_Always) )
+	if( (_logLevel <= m_dumpTrigger) && (_logLevel != LogLevel_Always) )
 		QueueDump();
 }
 
 //-----------------------------------------------------------------------------
-//	<LogImpl::Queue>
-//	Write to the log queue
+//	<LogImpl::Output>
+//	Send a line of text to the log file and console
 //-----------------------------------------------------------------------------
-void LogImpl::Queue
+void LogImpl::Output
 ( 
-	char const* _buffer
+	LogLevel _logLevel,
+	uint8 const _nodeId,
+	char const* _text
 )
 {
-	string bufStr = _buffer;
-	m_logQueue.push_back( bufStr );
+	char outBuf[1124];
+	if( _logLevel != LogLevel_Internal )						// don't add a second timestamp to display of queued messages
+	{
+		string timeStr = GetTimeStampString();
+		string nodeStr = GetNodeString( _nodeId );
+		snprintf( outBuf, sizeof(outBuf), "%s%s%s\n", timeStr.c_str(), nodeStr.c_str(), _text );
+	}
+	else
+	{
+		snprintf( outBuf, sizeof(outBuf), "%s\n", _text );
+	}
 
-	// rudimentary queue size management
-	if( m_logQueue.size() > 500 )
+	// hand message to the writer thread (and possibly print to screen)
+	m_pWriter->Write( outBuf, _logLevel <= LogLevel_Error );
+	if( m_bConsoleOutput )
 	{
-		m_logQueue.pop_front();
+		fputs( outBuf, stdout );
 	}
 }
 
@@ -187,20 +217,31 @@ void LogImpl::QueueDump
 ( 
 )
 {
-	Log::Write( LogLevel_Always, "" );
-	Log::Write( LogLevel_Always, "Dumping queued log messages");
-	Log::Write( LogLevel_Always, "" );
-	list<string>::iterator it = m_logQueue.begin();
-	while( it != m_logQueue.end() )
-	{
-		string strTemp = *it;
-		Log::Write( LogLevel_Internal, strTemp.c_str() );
-		it++;
-	}
-	m_logQueue.clear();
-	Log::Write( LogLevel_Always, "" );
-	Log::Write( LogLevel_Always, "End of queued log message dump");
-	Log::Write( LogLevel_Always, "" );
+	Output( LogLevel_Always, 0, "" );
+	Output( LogLevel_Always, 0, "Dumping queued log messages" );
+	Output( LogLevel_Always, 0, "" );
+	m_pQueue->Replay( QueueDumpCallback, this );
+	m_pQueue->Clear();
+	Output( LogLevel_Always, 0, "" );
+	Output( LogLevel_Always, 0, "End of queued log message dump" );
+	Output( LogLevel_Always, 0, "" );
+}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::QueueDumpCallback>
+//	Write out one of the queued messages
+//-----------------------------------------------------------------------------
+void LogImpl::QueueDumpCallback
+( 
+	FlightRecorder::Entry const& _entry,
+	void* _context
+)
+{
+	LogImpl* impl = (LogImpl*)_context;
+
+	char lineBuf[1124];
+	FlightRecorder::FormatEntry( _entry, lineBuf, sizeof(lineBuf) );
+	impl->Output( LogLevel_Internal, 0, lineBuf );
 }
 
 //-----------------------------------------------------------------------------
@@ -211,7 +252,19 @@ void LogImpl::QueueClear
 ( 
 )
 {
-	m_logQueue.clear();
+	m_pQueue->Clear();
+}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::QueueSave>
+//	Save the LogQueue to a file for later decoding
+//-----------------------------------------------------------------------------
+bool LogImpl::QueueSave
+( 
+	string const& _filename
+)
+{
+	return m_pQueue->Save( _filename );
 }
 
 //-----------------------------------------------------------------------------
@@ -281,16 +334,13 @@ string LogImpl::GetNodeString
 
 //-----------------------------------------------------------------------------
 //	<LogImpl::GetThreadId>
-//	Generate a string with formatted thread id
+//	Identify the calling thread
 //-----------------------------------------------------------------------------
-string LogImpl::GetThreadId
+uint32 LogImpl::GetThreadId
 ( 
 )
 {
-	char buf[20];
-	snprintf( buf, sizeof(buf), "%08x ", pthread_self() );
-	string str = buf;
-	return str;
+	return (uint32)(size_t)pthread_self();
 }
 
 //-----------------------------------------------------------------------------
@@ -303,4 +353,20 @@ void LogImpl::SetLogFileName
 )
 {
 	m_filename = _filename;
+	m_pWriter->SetFileName( _filename );
+}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::SetLogRotation>
+//	Pass the rotation settings on to the writer thread
+//-----------------------------------------------------------------------------
+void LogImpl::SetLogRotation
+( 
+	uint32 const _maxFileSize,
+	uint32 const _rotateInterval,
+	uint32 const _retainedFiles,
+	bool const _bCompress
+)
+{
+	m_pWriter->SetRotation( _maxFileSize, _rotateInterval, _retainedFiles, _bCompress );
 }
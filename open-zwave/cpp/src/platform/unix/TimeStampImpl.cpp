@@ -33,109 +33,59 @@
 using namespace OpenZWave;
 
 //-----------------------------------------------------------------------------
-//	<TimeStampImpl::TimeStampImpl>
-//	Constructor
+//	<TimeStampImpl::GetMonotonicTime>
+//	Nanoseconds since an arbitrary fixed point, unaffected by clock changes
 //-----------------------------------------------------------------------------
-TimeStampImpl::TimeStampImpl
+uint64 TimeStampImpl::GetMonotonicTime
 (
 )
 {
-	SetTime(0);
+#if defined(CLOCK_MONOTONIC) && !defined(__APPLE__)
+	struct timespec now;
+	clock_gettime( CLOCK_MONOTONIC, &now );
+	return ( (uint64)now.tv_sec * 1000000000 ) + now.tv_nsec;
+#else
+	// No monotonic clock available, so fall back on the time of day
+	struct timeval now;
+	gettimeofday( &now, NULL );
+	return ( (uint64)now.tv_sec * 1000000000 ) + ( (uint64)now.tv_usec * 1000 );
+#endif
 }
 
 //-----------------------------------------------------------------------------
-//	<TimeStampImpl::~TimeStampImpl>
-//	Destructor
+//	<TimeStampImpl::GetWallClockTime>
+//	Milliseconds since the Unix epoch
 //-----------------------------------------------------------------------------
-TimeStampImpl::~TimeStampImpl
+int64 TimeStampImpl::GetWallClockTime
 (
 )
 {
+	struct timeval now;
+	gettimeofday( &now, NULL );
+	return ( (int64)now.tv_sec * 1000 ) + ( now.tv_usec / 1000 );
 }
 
 //-----------------------------------------------------------------------------
-//	<TimeStampImpl::SetTime>
-//	Sets the timestamp to now, plus an offset in milliseconds
+//	<TimeStampImpl::FormatWallClock>
+//	Write a string representation of the local time _age nanoseconds ago
 //-----------------------------------------------------------------------------
-void TimeStampImpl::SetTime
+void TimeStampImpl::FormatWallClock
 (
-	int32 _milliseconds	// = 0
+	int64 _age,
+	char* _buffer,
+	uint32 _size
 )
 {
-    struct timeval now;
-    gettimeofday(&now, NULL);
-    
-    m_stamp.tv_sec = now.tv_sec + (_milliseconds / 1000);
-    
-    // Now add the remainder of our timeout to the microseconds part of 'now'
-    now.tv_usec += ((_milliseconds % 1000) * 1000);
-    
-    // Careful now! Did it wrap?
-    if(now.tv_usec >= 1000000)
-    {
-        // Yes it did so bump our seconds and modulo
-        now.tv_usec %= 1000000;
-        m_stamp.tv_sec++;
-    }
-    
-    m_stamp.tv_nsec = now.tv_usec * 1000;
-}
+	struct timeval now;
+	gettimeofday( &now, NULL );
 
-//-----------------------------------------------------------------------------
-//	<TimeStampImpl::TimeRemaining>
-//	Gets the difference between now and the timestamp time in milliseconds
-//-----------------------------------------------------------------------------
-int32 TimeStampImpl::TimeRemaining
-(
-)
-{
-    int32 diff;
-    
-    struct timeval now;   
-    gettimeofday(&now, NULL);
-    
-    // Seconds
-    diff = (int32)((m_stamp.tv_sec - now.tv_sec)*1000);
-    
-    // Milliseconds
-    diff += (((m_stamp.tv_nsec/1000)-now.tv_usec)/1000);
-    
-    return diff;
-}
+	int64 usecs = ( (int64)now.tv_sec * 1000000 ) + now.tv_usec - ( _age / 1000 );
+	time_t secs = (time_t)( usecs / 1000000 );
 
-//-----------------------------------------------------------------------------
-//	<TimeStampImpl::GetAsString>
-//	Return a string representation
-//-----------------------------------------------------------------------------
-string TimeStampImpl::GetAsString
-(
-)
-{
-	char str[100];
-	struct tm *tm;
-	tm = localtime( &m_stamp.tv_sec );
+	struct tm tm;
+	localtime_r( &secs, &tm );
 
-	snprintf( str, sizeof(str), "%04d-%02d-%02d %02d:%02d:%02d:%03d ", 
-		  tm->tm_year + 1900, tm->tm_mon + 1, tm->tm_mday,
-		  tm->tm_hour, tm->tm_min, tm->tm_sec, (int)(m_stamp.tv_nsec / (1000*1000)) );
-	return str;
-}
-
-//-----------------------------------------------------------------------------
-//	<TimeStampImpl::operator->
-//	Overload the subtract operator to get the difference between two 
-//	timestamps in milliseconds
-//-----------------------------------------------------------------------------
-int32 TimeStampImpl::operator- 
-(
-	TimeStampImpl const& _other
-)
-{
-    // Seconds
-    int32 diff = (int32)((m_stamp.tv_sec-_other.m_stamp.tv_sec)*1000);
-    
-    // Milliseconds
-    diff += ((m_stamp.tv_nsec - _other.m_stamp.tv_nsec)/1000000);
-    
-    return diff;  
+	snprintf( _buffer, _size, "%04d-%02d-%02d %02d:%02d:%02d:%03d ", 
+		  tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday,
+		  tm.tm_hour, tm.tm_min, tm.tm_sec, (int)( ( usecs % 1000000 ) / 1000 ) );
 }
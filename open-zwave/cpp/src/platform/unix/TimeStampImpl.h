@@ -35,57 +35,35 @@
 
 namespace OpenZWave
 {
-	/** \brief Windows implementation of a timestamp.
+	/** \brief Unix implementation of a timestamp.
 	 */
 	class TimeStampImpl
 	{
 	public:
 		/**
-		 * Constructor.
-		 * Creates a TimeStampImpl object.
+		 * Read the monotonic clock.
+		 * \return nanoseconds since an arbitrary fixed point in the past.
 		 */
-		TimeStampImpl();
+		static uint64 GetMonotonicTime();
 
 		/**
-		 * Destructor.
-		 * Destroys the TimeStampImpl object.
+		 * Read the wall clock.
+		 * \return milliseconds since 00:00 on 1 January 1970 UTC.
 		 */
-		~TimeStampImpl();
+		static int64 GetWallClockTime();
 
 		/**
-		 * SetTime.  Sets the timestamp to now, plus the offset in milliseconds.
-		 * \param _milliseconds positive or negative offset from 
-		 * now in milliseconds.
+		 * Format a point in time as local wall-clock time.
+		 * \param _age how long ago the point in time was, in nanoseconds.
+		 * \param _buffer receives the null-terminated result.
+		 * \param _size size of the buffer in bytes.
 		 */
-		void SetTime( int32 _milliseconds );
-
-		/**
-		 * TimeRemaining.  Gets the difference between now and the timestamp
-		 * time in milliseconds.
-		 * \return milliseconds remaining until we reach the timestamp.  The 
-		 * return value is negative if the timestamp is in the past.
-		 */
-		int32 TimeRemaining();
-
-		/**
-		 * Return as as string
-		 */
-		string GetAsString();
-
-		/**
-		 * Overload the subtract operator to get the difference between
-		 * two timestamps in milliseconds.
-		 */
-		int32 operator- ( TimeStampImpl const& _other );
+		static void FormatWallClock( int64 _age, char* _buffer, uint32 _size );
 
 	private:
-		TimeStampImpl( TimeStampImpl const& );					// prevent copy
-		TimeStampImpl& operator = ( TimeStampImpl const& );			// prevent assignment
-
-		struct timespec m_stamp;
+		TimeStampImpl();						// static methods only
 	};
 
 } // namespace OpenZWave
 
 #endif //_TimeStampImpl_H
-
@@ -29,6 +29,7 @@
 
 #include "Defs.h"
 #include "LogImpl.h"
+#include "LogWriter.h"
 
 using namespace OpenZWave;
 
@@ -43,35 +44,24 @@ LogImpl::LogImpl
 	bool const _bConsoleOutput,
 	LogLevel const _saveLevel,
 	LogLevel const _queueLevel,
-	LogLevel const _dumpTrigger
+	LogLevel const _dumpTrigger,
+	int32 const _flushInterval
 ):
 	m_filename( _filename ),					// name of log file
 	m_bAppendLog( _bAppendLog ),				// true to append (and not overwrite) any existing log
 	m_bConsoleOutput( _bConsoleOutput ),		// true to provide a copy of output to console
+	m_pQueue( new FlightRecorder( FlightRecorder::DefaultSize ) ),	// recent messages, to be dumped on an error
 	m_saveLevel( _saveLevel ),					// level of messages to log to file
 	m_queueLevel( _queueLevel ),				// level of messages to log to queue
-	m_dumpTrigger( _dumpTrigger )				// dump queued messages when this level is seen
+	m_dumpTrigger( _dumpTrigger ),				// dump queued messages when this level is seen
+	m_pWriter( new LogWriter( _filename, _bAppendLog, _flushInterval ) )	// writes to the file from a thread of its own
 {
-	string accessType;
-
-	// create an adjusted file name and timestamp string
+	// create a timestamp string
 	string timeStr = GetTimeStampString();
 
-	if ( m_bAppendLog )
-	{
-		accessType = "a";
-	}
-	else
-	{
-		accessType = "w";
-	}
-
-	FILE* pFile;
-	if( !fopen_s( &pFile, _filename.c_str(), accessType.c_str() ) )
-	{
-		fprintf( pFile, "\nLogging started %s\n\n", timeStr.c_str() );
-		fclose( pFile );
-	}
+	char buf[128];
+	sprintf_s( buf, sizeof(buf), "\nLogging started %s\n\n", timeStr.c_str() );
+	m_pWriter->Write( buf );
 }
 
 //-----------------------------------------------------------------------------
@@ -82,6 +72,8 @@ LogImpl::~LogImpl
 (
 )
 {
+	delete m_pWriter;
+	delete m_pQueue;
 }
 
 //-----------------------------------------------------------------------------
@@ -96,90 +88,136 @@ void LogImpl::Write
 	va_list _args
 )
 {
-	// create a timestamp string
-	string timeStr = GetTimeStampString();
-	string nodeStr = GetNodeString( _nodeId );
+	WriteMessage( _logLevel, _nodeId, _format, _args, _logLevel <= m_saveLevel );
+}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::WriteTraced>
+//	Write a message that a node or command class filter has asked for
+//-----------------------------------------------------------------------------
+void LogImpl::WriteTraced
+( 
+	LogLevel _logLevel,
+	uint8 const _nodeId,
+	char const* _format, 
+	va_list _args
+)
+{
+	WriteMessage( _logLevel, _nodeId, _format, _args, true );
+}
 
+//-----------------------------------------------------------------------------
+//	<LogImpl::WriteMessage>
+//	Queue a message and, if required, save it to file
+//-----------------------------------------------------------------------------
+void LogImpl::WriteMessage
+( 
+	LogLevel _logLevel,
+	uint8 const _nodeId,
+	char const* _format, 
+	va_list _args,
+	bool const _bSave
+)
+{
 	// handle this message
-	if( (_logLevel <= m_queueLevel) || (_logLevel == LogLevel_Internal) )	// we're going to do something with this message...
+	if( (_logLevel <= m_queueLevel) || _bSave || (_logLevel == LogLevel_Internal) )	// we're going to do something with this message...
 	{
-		char lineBuf[1024];
-		if( !_format || ( _format[0] == 0 ) )
+		if( !_format )
 		{
-			strcpy_s( lineBuf, 1024, "" );
+			_format = "";
 		}
-		else
+
+		// queue the message unformatted.  It is only turned into text if the queue is dumped.
+		if( _logLevel != LogLevel_Internal )
 		{
-			vsprintf_s( lineBuf, sizeof(lineBuf), _format, _args );
+			va_list saveargs;
+			va_copy( saveargs, _args );
+			m_pQueue->Record( _logLevel, _nodeId, GetThreadId(), _format, saveargs );
+			va_end( saveargs );
 		}
 
 		// should this message be saved to file (and possibly written to console?)
-		if( (_logLevel <= m_saveLevel) || (_logLevel == LogLevel_Internal) )
+		if( _bSave || (_logLevel == LogLevel_Internal) )
 		{
-			// save to file
-			FILE* pFile = NULL;
-			if( !fopen_s( &pFile, m_filename.c_str(), "a" ) || m_bConsoleOutput )
+			char lineBuf[1024];
+			if( _format[0] == 0 )
 			{
-				if( _logLevel != LogLevel_Internal )						// don't add a second timestamp to display of queued messages
-				{
-					if( pFile != NULL )
-					{
-						fprintf( pFile, "%s%s", timeStr.c_str(), nodeStr.c_str() );
-					}
-					if( m_bConsoleOutput )
-					{
-						printf( "%s%s", timeStr.c_str(), nodeStr.c_str() );
-					}
-				}
-
-				// print message to file (and possibly screen)
-				if( pFile != NULL )
-				{
-					fprintf( pFile, "%s", lineBuf );
-					fprintf( pFile, "\n" ); 
-					fclose( pFile );
-				}
-				if( m_bConsoleOutput )
-				{
-					printf( "%s", lineBuf );
-					printf( "\n" );
-				}
-
+				strcpy_s( lineBuf, 1024, "" );
+			}
+			else
+			{
+				vsprintf_s( lineBuf, sizeof(lineBuf), _format, _args );
 			}
+			Output( _logLevel, _nodeId, lineBuf );
 		}
+	}
 
-		if( _logLevel != LogLevel_Internal )
+	// now check to see if the _dumpTrigger has been hit
+	if( (_logLevel <= m_dumpTrigger) && (_logLevel != LogLevel_Internal) && (_logLevel != LogLevel_Always) )
+	{
+		QueueDump();
+	}
+}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::WriteData>
+//	Write a block of binary data to the log
+//-----------------------------------------------------------------------------
+void LogImpl::WriteData
+( 
+	LogLevel _logLevel,
+	uint8 const _nodeId,
+	char const* _label,
+	uint8 const* _data,
+	uint32 const _length
+)
+{
+	if( _logLevel <= m_queueLevel )
+	{
+		m_pQueue->RecordData( _logLevel, _nodeId, GetThreadId(), _label, _data, _length );
+
+		if( _logLevel <= m_saveLevel )
 		{
-			char queueBuf[1024];
-			string threadStr = GetThreadId();
-			sprintf_s( queueBuf, sizeof(queueBuf), "%s%s%s", timeStr.c_str(), threadStr.c_str(), lineBuf );
-			Queue( queueBuf );
+			char lineBuf[1024];
+			FlightRecorder::FormatData( _label, _data, _length, false, lineBuf, sizeof(lineBuf) );
+			Output( _logLevel, _nodeId, lineBuf );
 		}
 	}
 
-	// now check to see if the _dumpTrigger has been hit
-	if( (_logLevel <= m_dumpTrigger) && (_logLevel != LogLevel_Internal) && (_logLevel != LogLevel_Always) )
+	if( (_logLevel <= m_dumpTrigger) && (_logLevel != LogLevel_Always) )
 	{
 		QueueDump();
 	}
 }
 
 //-----------------------------------------------------------------------------
-//	<LogImpl::Queue>
-//	Write to the log queue
+//	<LogImpl::Output>
+//	Send a line of text to the log file and console
 //-----------------------------------------------------------------------------
-void LogImpl::Queue
+void LogImpl::Output
 ( 
-	char const* _buffer
+	LogLevel _logLevel,
+	uint8 const _nodeId,
+	char const* _text
 )
 {
-	string bufStr = _buffer;
-	m_logQueue.push_back( bufStr );
+	char outBuf[1124];
+	if( _logLevel != LogLevel_Internal )						// don't add a second timestamp to display of queued messages
+	{
+		string timeStr = GetTimeStampString();
+		string nodeStr = GetNodeString( _nodeId );
+		sprintf_s( outBuf, sizeof(outBuf), "%s%s%s\n", timeStr.c_str(), nodeStr.c_str(), _text );
+	}
+	else
+	{
+		sprintf_s( outBuf, sizeof(outBuf), "%s\n", _text );
+	}
 
-	// rudimentary queue size management
-	if( m_logQueue.size() > 500 )
+	// hand message to the writer thread (and possibly print to screen)
+	m_pWriter->Write( outBuf, _logLevel <= LogLevel_Error );
+	if( m_bConsoleOutput )
 	{
-		m_logQueue.pop_front();
+		printf( "%s", outBuf );
 	}
 }
 
@@ -191,16 +229,27 @@ void LogImpl::QueueDump
 ( 
 )
 {
-	Log::Write( LogLevel_Internal, "\n\nDumping queued log messages\n");
-	list<string>::iterator it = m_logQueue.begin();
-	while( it != m_logQueue.end() )
-	{
-		string strTemp = *it;
-		Log::Write( LogLevel_Internal, strTemp.c_str() );
-		it++;
-	}
-	m_logQueue.clear();
-	Log::Write( LogLevel_Internal, "\nEnd of queued log message dump\n\n");
+	Output( LogLevel_Internal, 0, "\n\nDumping queued log messages\n" );
+	m_pQueue->Replay( QueueDumpCallback, this );
+	m_pQueue->Clear();
+	Output( LogLevel_Internal, 0, "\nEnd of queued log message dump\n\n" );
+}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::QueueDumpCallback>
+//	Write out one of the queued messages
+//-----------------------------------------------------------------------------
+void LogImpl::QueueDumpCallback
+( 
+	FlightRecorder::Entry const& _entry,
+	void* _context
+)
+{
+	LogImpl* impl = (LogImpl*)_context;
+
+	char lineBuf[1124];
+	FlightRecorder::FormatEntry( _entry, lineBuf, sizeof(lineBuf) );
+	impl->Output( LogLevel_Internal, 0, lineBuf );
 }
 
 //-----------------------------------------------------------------------------
@@ -211,7 +260,19 @@ void LogImpl::QueueClear
 ( 
 )
 {
-	m_logQueue.clear();
+	m_pQueue->Clear();
+}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::QueueSave>
+//	Save the LogQueue to a file for later decoding
+//-----------------------------------------------------------------------------
+bool LogImpl::QueueSave
+( 
+	string const& _filename
+)
+{
+	return m_pQueue->Save( _filename );
 }
 
 //-----------------------------------------------------------------------------
@@ -277,17 +338,13 @@ string LogImpl::GetNodeString
 
 //-----------------------------------------------------------------------------
 //	<LogImpl::GetThreadId>
-//	Generate a string with formatted thread id
+//	Identify the calling thread
 //-----------------------------------------------------------------------------
-string LogImpl::GetThreadId
+uint32 LogImpl::GetThreadId
 ( 
 )
 {
-	char buf[20];
-	DWORD dwThread = ::GetCurrentThreadId();
-	sprintf_s( buf, sizeof(buf), "%04d ", dwThread );
-	string str = buf;
-	return str;
+	return (uint32)::GetCurrentThreadId();
 }
 
 //-----------------------------------------------------------------------------
@@ -300,4 +357,20 @@ void LogImpl::SetLogFileName
 )
 {
 	m_filename = _filename;
+	m_pWriter->SetFileName( _filename );
+}
+
+//-----------------------------------------------------------------------------
+//	<LogImpl::SetLogRotation>
+//	Pass the rotation settings on to the writer thread
+//-----------------------------------------------------------------------------
+void LogImpl::SetLogRotation
+( 
+	uint32 const _maxFileSize,
+	uint32 const _rotateInterval,
+	uint32 const _retainedFiles,
+	bool const _bCompress
+)
+{
+	m_pWriter->SetRotation( _maxFileSize, _rotateInterval, _retainedFiles, _bCompress );
 }
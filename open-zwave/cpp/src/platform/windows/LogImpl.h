@@ -31,10 +31,13 @@
 #include "Defs.h"
 #include <string>
 #include "Log.h"
+#include "FlightRecorder.h"
 #include "Windows.h"
 
 namespace OpenZWave
 {
+	class LogWriter;
+
 	/** \brief Windows-specific implementation of the Log class.
 	 */
 	class LogImpl : public i_LogImpl
@@ -42,27 +45,34 @@ namespace OpenZWave
 	private:
 		friend class Log;
 
-		LogImpl( string const& _filename, bool const _bAppendLog, bool const _bConsoleOutput, LogLevel const _saveLevel, LogLevel const _queueLevel, LogLevel const _dumpTrigger );
+		LogImpl( string const& _filename, bool const _bAppendLog, bool const _bConsoleOutput, LogLevel const _saveLevel, LogLevel const _queueLevel, LogLevel const _dumpTrigger, int32 const _flushInterval );
 		~LogImpl();
 
 		void Write( LogLevel _level, uint8 const _nodeId, char const* _format, va_list _args );
-		void Queue( char const* _buffer );
+		void WriteData( LogLevel _level, uint8 const _nodeId, char const* _label, uint8 const* _data, uint32 const _length );
+		void WriteTraced( LogLevel _level, uint8 const _nodeId, char const* _format, va_list _args );
 		void QueueDump();
 		void QueueClear();
+		bool QueueSave( string const& _filename );
 		void SetLoggingState( LogLevel _saveLevel, LogLevel _queueLevel, LogLevel _dumpTrigger );
 		void SetLogFileName( string _filename );
+		void SetLogRotation( uint32 const _maxFileSize, uint32 const _rotateInterval, uint32 const _retainedFiles, bool const _bCompress );
 
 		string GetTimeStampString();
 		string GetNodeString( uint8 const _nodeId );
-		string GetThreadId();
+		uint32 GetThreadId();
+		void WriteMessage( LogLevel _level, uint8 const _nodeId, char const* _format, va_list _args, bool const _bSave );
+		void Output( LogLevel _level, uint8 const _nodeId, char const* _text );
+		static void QueueDumpCallback( FlightRecorder::Entry const& _entry, void* _context );
 
 		string m_filename;						/**< filename specified by user (default is ozw_log.txt) */
 		bool m_bConsoleOutput;					/**< if true, send log output to console as well as to the file */
 		bool m_bAppendLog;						/**< if true, the log file should be appended to any with the same name */
-		list<string> m_logQueue;				/**< list of queued log messages */
+		FlightRecorder* m_pQueue;				/**< recent log messages, kept in binary form until they are dumped */
 		LogLevel m_saveLevel;
 		LogLevel m_queueLevel;
 		LogLevel m_dumpTrigger;
+		LogWriter* m_pWriter;					/**< writes log output to the file on a background thread */
 	};
 
 } // namespace OpenZWave
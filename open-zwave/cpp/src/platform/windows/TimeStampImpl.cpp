@@ -32,82 +32,63 @@
 using namespace OpenZWave;
 
 //-----------------------------------------------------------------------------
-//	<TimeStampImpl::TimeStampImpl>
-//	Constructor
+//	<TimeStampImpl::GetMonotonicTime>
+//	Nanoseconds since an arbitrary fixed point, unaffected by clock changes
 //-----------------------------------------------------------------------------
-TimeStampImpl::TimeStampImpl
+uint64 TimeStampImpl::GetMonotonicTime
 (
 )
 {
-	SetTime(0);
-}
+	static LARGE_INTEGER s_frequency = { 0 };
+	if( !s_frequency.QuadPart )
+	{
+		QueryPerformanceFrequency( &s_frequency );
+	}
 
-//-----------------------------------------------------------------------------
-//	<TimeStampImpl::~TimeStampImpl>
-//	Destructor
-//-----------------------------------------------------------------------------
-TimeStampImpl::~TimeStampImpl
-(
-)
-{
-}
+	LARGE_INTEGER now;
+	QueryPerformanceCounter( &now );
 
-//-----------------------------------------------------------------------------
-//	<TimeStampImpl::SetTime>
-//	Sets the timestamp to now, plus an offset in milliseconds
-//-----------------------------------------------------------------------------
-void TimeStampImpl::SetTime
-(
-	int32 _milliseconds	// = 0
-)
-{
-	int64 offset = ((int64)_milliseconds) * 10000i64;	// Timestamp is stored in 100ns steps.
-	
-	GetSystemTimeAsFileTime( (FILETIME*)&m_stamp );
-	m_stamp += offset;
+	// Split the division to avoid overflowing the counter when multiplying up
+	uint64 seconds = now.QuadPart / s_frequency.QuadPart;
+	uint64 remainder = now.QuadPart % s_frequency.QuadPart;
+	return ( seconds * 1000000000i64 ) + ( ( remainder * 1000000000i64 ) / s_frequency.QuadPart );
 }
 
 //-----------------------------------------------------------------------------
-//	<TimeStampImpl::TimeRemaining>
-//	Gets the difference between now and the timestamp time in milliseconds
+//	<TimeStampImpl::GetWallClockTime>
+//	Milliseconds since the Unix epoch
 //-----------------------------------------------------------------------------
-int32 TimeStampImpl::TimeRemaining
+int64 TimeStampImpl::GetWallClockTime
 (
 )
 {
-	int64 now;
-	GetSystemTimeAsFileTime( (FILETIME*)&now );
+	int64 stamp;
+	GetSystemTimeAsFileTime( (FILETIME*)&stamp );
 
-	return (int32)( ( m_stamp - now ) / 10000i64 );
+	// FILETIME counts 100ns steps from 1 January 1601
+	return ( stamp - 116444736000000000i64 ) / 10000i64;
 }
 
 //-----------------------------------------------------------------------------
-//	<TimeStampImpl::GetAsString>
-//	Return a string representation
+//	<TimeStampImpl::FormatWallClock>
+//	Write a string representation of the local time _age nanoseconds ago
 //-----------------------------------------------------------------------------
-string TimeStampImpl::GetAsString
+void TimeStampImpl::FormatWallClock
 (
+	int64 _age,
+	char* _buffer,
+	uint32 _size
 )
 {
-	// Convert m_stamp (FILETIME) to SYSTEMTIME for ease of use
-	SYSTEMTIME time;
-	::FileTimeToSystemTime( (FILETIME*)m_stamp, &time );
+	int64 stamp;
+	GetSystemTimeAsFileTime( (FILETIME*)&stamp );
+	stamp -= _age / 100i64;						// FILETIME is in 100ns steps.
 
-	char buf[100];
-	sprintf_s( buf, sizeof(buf), "%04d-%02d-%02d %02d:%02d:%02d:%03d ", time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond, time.wMilliseconds );
-	string str = buf;
-	return str;
-}
+	// Convert to local SYSTEMTIME for ease of use
+	FILETIME local;
+	SYSTEMTIME time;
+	::FileTimeToLocalFileTime( (FILETIME*)&stamp, &local );
+	::FileTimeToSystemTime( &local, &time );
 
-//-----------------------------------------------------------------------------
-//	<TimeStampImpl::operator->
-//	Overload the subtract operator to get the difference between two 
-//	timestamps in milliseconds
-//-----------------------------------------------------------------------------
-int32 TimeStampImpl::operator- 
-(
-	TimeStampImpl const& _other
-)
-{
-	return (int32)( ( m_stamp - _other.m_stamp ) / 10000i64 );
+	sprintf_s( _buffer, _size, "%04d-%02d-%02d %02d:%02d:%02d:%03d ", time.wYear, time.wMonth, time.wDay, time.wHour, time.wMinute, time.wSecond, time.wMilliseconds );
 }
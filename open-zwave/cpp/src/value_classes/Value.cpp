@@ -32,10 +32,15 @@
 #include "Notification.h"
 #include "Msg.h"
 #include "Value.h"
+#include "ValueDecimal.h"
 #include "Log.h"
 #include "CommandClass.h"
 #include <ctime>
+#include <string.h>
 #include "Options.h"
+#include "TimeStamp.h"
+#include "ValueHistory.h"
+#include "ValueLog.h"
 
 using namespace OpenZWave;
 
@@ -61,6 +66,10 @@ static char const* c_typeName[] =
 	"button"
 };
 
+// Read on every refresh, so looked up once rather than by name each time
+static Options::Handle<bool> s_suppressValueRefresh( "SuppressValueRefresh" );
+static Options::Handle<int32> s_valueHistorySize( "ValueHistorySize" );
+
 //-----------------------------------------------------------------------------
 // <Value::Value>
 // Constructor
@@ -83,18 +92,25 @@ Value::Value
 ):
 	m_min( 0 ),
 	m_max( 0 ),
+	m_reportTime( 0 ),
 	m_verifyChanges( false ),
 	m_id( _homeId, _nodeId, _genre, _commandClassId, _instance, _index, _type ),
 	m_label( _label ),
 	m_units( _units ),
-	m_help( "" ),
+	m_help(),
 	m_readOnly( _readOnly ),
 	m_writeOnly( _writeOnly ),
 	m_isSet( _isSet ),
 	m_affectsLength( 0 ),
 	m_affectsAll( false ),
 	m_checkChange( false ),
-	m_pollIntensity( _pollIntensity )
+	m_checkReads( 0 ),
+	m_checkVotes( 0 ),
+	m_originalVotes( 0 ),
+	m_pollIntensity( _pollIntensity ),
+	m_pollInterval( 0 ),
+	m_history( NULL ),
+	m_filter( NULL )
 {
 }
 
@@ -107,6 +123,7 @@ Value::Value
 ):
 	m_min( 0 ),
 	m_max( 0 ),
+	m_reportTime( 0 ),
 	m_verifyChanges( false ),
 	m_readOnly( false ),
 	m_writeOnly( false ),
@@ -114,8 +131,55 @@ Value::Value
 	m_affectsLength( 0 ),
 	m_affectsAll( false ),
 	m_checkChange( false ),
-	m_pollIntensity( 0 )
+	m_checkReads( 0 ),
+	m_checkVotes( 0 ),
+	m_originalVotes( 0 ),
+	m_pollIntensity( 0 ),
+	m_pollInterval( 0 ),
+	m_history( NULL ),
+	m_filter( NULL )
+{
+}
+
+//-----------------------------------------------------------------------------
+// <Value::Value>
+// Copy constructor
+//-----------------------------------------------------------------------------
+Value::Value
+(
+	Value const& _other
+):
+	Ref(),
+	m_min( _other.m_min ),
+	m_max( _other.m_max ),
+	m_refreshTime( _other.m_refreshTime ),
+	m_reportTime( _other.m_reportTime ),
+	m_verifyChanges( _other.m_verifyChanges ),
+	m_id( _other.m_id ),
+	m_label( _other.m_label ),
+	m_units( _other.m_units ),
+	m_help( _other.m_help ),
+	m_readOnly( _other.m_readOnly ),
+	m_writeOnly( _other.m_writeOnly ),
+	m_isSet( _other.m_isSet ),
+	m_affectsLength( _other.m_affectsLength ),
+	m_affects( NULL ),
+	m_affectsAll( _other.m_affectsAll ),
+	m_checkChange( _other.m_checkChange ),
+	m_checkReads( _other.m_checkReads ),
+	m_checkVotes( _other.m_checkVotes ),
+	m_originalVotes( _other.m_originalVotes ),
+	m_pollIntensity( _other.m_pollIntensity ),
+	m_pollInterval( _other.m_pollInterval ),
+	m_history( NULL ),
+	m_filter( NULL )
 {
+	// Both copies delete their own list of affected values
+	if( m_affectsLength > 0 )
+	{
+		m_affects = new uint8[m_affectsLength];
+		memcpy( m_affects, _other.m_affects, m_affectsLength );
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -130,6 +194,8 @@ Value::~Value
 	{
 		delete [] m_affects;
 	}
+	delete m_history;
+	delete m_filter;
 }
 
 //-----------------------------------------------------------------------------
@@ -192,6 +258,11 @@ void Value::ReadXML
 		m_pollIntensity = (uint8)intVal;
 	}
 
+	if( TIXML_SUCCESS == _valueElement->QueryIntAttribute( "poll_interval", &intVal ) )
+	{
+		m_pollInterval = intVal;
+	}
+
 	char const* affects = _valueElement->Attribute( "affects" );
 	if( affects )
 	{
@@ -243,6 +314,15 @@ void Value::ReadXML
 		m_verifyChanges = !strcmp( verifyChanges, "true" );
 	}
 
+	double deadband = 0;
+	_valueElement->QueryDoubleAttribute( "deadband", &deadband );
+	int32 minInterval = 0;
+	_valueElement->QueryIntAttribute( "min_interval", &minInterval );
+	if( ( deadband > 0 ) || ( minInterval > 0 ) )
+	{
+		SetChangeFilter( deadband, minInterval );
+	}
+
 	if( TIXML_SUCCESS == _valueElement->QueryIntAttribute( "min", &intVal ) )
 	{
 		m_min = intVal;
@@ -300,6 +380,24 @@ void Value::WriteXML
 	snprintf( str, sizeof(str), "%d", m_pollIntensity );
 	_valueElement->SetAttribute( "poll_intensity", str );
 
+	if( m_pollInterval != 0 )
+	{
+		snprintf( str, sizeof(str), "%d", m_pollInterval );
+		_valueElement->SetAttribute( "poll_interval", str );
+	}
+
+	if( GetChangeDeadband() > 0 )
+	{
+		snprintf( str, sizeof(str), "%g", GetChangeDeadband() );
+		_valueElement->SetAttribute( "deadband", str );
+	}
+
+	if( GetChangeMinInterval() > 0 )
+	{
+		snprintf( str, sizeof(str), "%d", GetChangeMinInterval() );
+		_valueElement->SetAttribute( "min_interval", str );
+	}
+
 	snprintf( str, sizeof(str), "%d", m_min );
 	_valueElement->SetAttribute( "min", str );
 
@@ -326,7 +424,7 @@ void Value::WriteXML
 		_valueElement->SetAttribute( "affects", s.c_str() );
 	}
 
-	if( m_help.length() > 0 )
+	if( !m_help.empty() )
 	{
 		TiXmlElement* helpElement = new TiXmlElement( "Help" );
 		_valueElement->LinkEndChild( helpElement );
@@ -404,9 +502,7 @@ void Value::OnValueRefreshed
 	{
 		m_isSet = true;
 
-		bool bSuppress;
-		Options::Get()->GetOptionAsBool( "SuppressValueRefresh", &bSuppress );
-		if( !bSuppress )
+		if( !s_suppressValueRefresh.Get() )
 		{
 			// Notify the watchers
 			Notification* notification = new Notification( Notification::Type_ValueRefreshed );
@@ -433,6 +529,11 @@ void Value::OnValueChanged
 	if( Driver* driver = Manager::Get()->GetDriver( m_id.GetHomeId() ) )
 	{
 		m_isSet = true;
+
+		if( ChangeFilter* filter = m_filter )
+		{
+			filter->m_lastChange = TimeStamp::GetMonotonicTime();
+		}
 	
 		// Notify the watchers
 		Notification* notification = new Notification( Notification::Type_ValueChanged );
@@ -515,6 +616,212 @@ char const* Value::GetTypeNameFromEnum
 	return c_typeName[_type];
 }
 
+//-----------------------------------------------------------------------------
+// <Value::RecordHistory>
+// Add the current value to the history and the value log, if they are kept
+//-----------------------------------------------------------------------------
+void Value::RecordHistory
+(
+)
+{
+	// The history is only kept if this value, or every value, has been given a size
+	double value;
+	if( ( ( m_history != NULL ) || ( s_valueHistorySize.Get() > 0 ) ) && GetAsDouble( &value ) )
+	{
+		if( ValueHistory* history = ValueHistory::Attach( &m_history, (uint32)s_valueHistorySize.Get() ) )
+		{
+			history->Add( TimeStamp::GetMonotonicTime(), value );
+		}
+	}
+
+	if( Driver* driver = Manager::Get()->GetDriver( m_id.GetHomeId() ) )
+	{
+		if( ValueLog* valueLog = driver->GetValueLog() )
+		{
+			valueLog->Record( this );
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Value::RecordReading>
+// Add a numeric reading that is not being stored in the value to the history and the value log
+//-----------------------------------------------------------------------------
+void Value::RecordReading
+(
+	void* _reading,
+	int _type
+)
+{
+	ValueDecimal::Fixed fixed;
+	switch( _type )
+	{
+	case 2:			// short
+		fixed = ValueDecimal::Fixed( *((short*)_reading), 0 );
+		break;
+	case 3:			// int32
+		fixed = ValueDecimal::Fixed( *((int32*)_reading), 0 );
+		break;
+	case 4:			// uint8
+		fixed = ValueDecimal::Fixed( *((uint8*)_reading), 0 );
+		break;
+	case 6:			// decimal
+		fixed = *((ValueDecimal::Fixed*)_reading);
+		break;
+	default:
+		return;
+	}
+
+	if( ( m_history != NULL ) || ( s_valueHistorySize.Get() > 0 ) )
+	{
+		if( ValueHistory* history = ValueHistory::Attach( &m_history, (uint32)s_valueHistorySize.Get() ) )
+		{
+			history->Add( TimeStamp::GetMonotonicTime(), ValueDecimal::ToFloat( fixed ) );
+		}
+	}
+
+	if( Driver* driver = Manager::Get()->GetDriver( m_id.GetHomeId() ) )
+	{
+		if( ValueLog* valueLog = driver->GetValueLog() )
+		{
+			valueLog->Record( m_id, fixed );
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Value::SetHistorySize>
+// Choose how many recent readings of this value to keep
+//-----------------------------------------------------------------------------
+bool Value::SetHistorySize
+(
+	uint32 const _samples
+)
+{
+	double value;
+	if( !GetAsDouble( &value ) )
+	{
+		// Only numbers can be kept
+		return false;
+	}
+
+	ValueHistory* history = ValueHistory::Attach( &m_history, 0 );
+	return( ( history != NULL ) && history->SetCapacity( _samples ) );
+}
+
+//-----------------------------------------------------------------------------
+// <Value::SetChangeFilter>
+// Choose which reported changes in this value are dropped
+//-----------------------------------------------------------------------------
+bool Value::SetChangeFilter
+(
+	double const _deadband,
+	int32 const _minInterval
+)
+{
+	if( ( _deadband < 0 ) || ( _minInterval < 0 ) )
+	{
+		return false;
+	}
+
+	if( !IsNumber() && ( ( _deadband > 0 ) || ( _minInterval > 0 ) ) )
+	{
+		// Changes in the state of a switch, list or string are never dropped, since
+		// an event-driven device may not report again to bring the value up to date
+		return false;
+	}
+
+	if( m_filter == NULL )
+	{
+		if( ( _deadband == 0 ) && ( _minInterval == 0 ) )
+		{
+			return true;
+		}
+
+		// The filter is read on the driver thread without the nodes locked, so it
+		// is filled in before it is published, and is never freed while the value exists.
+		ChangeFilter* filter = new ChangeFilter();
+		filter->m_deadband = _deadband;
+		filter->m_minInterval = _minInterval;
+		filter->m_lastChange = 0;
+		m_filter = filter;
+		return true;
+	}
+
+	m_filter->m_deadband = _deadband;
+	m_filter->m_minInterval = _minInterval;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <Value::IsNumber>
+// Check whether this value holds a quantity rather than a state
+//-----------------------------------------------------------------------------
+bool Value::IsNumber
+(
+)const
+{
+	switch( m_id.GetType() )
+	{
+		case ValueID::ValueType_Byte:
+		case ValueID::ValueType_Decimal:
+		case ValueID::ValueType_Int:
+		case ValueID::ValueType_Short:
+		{
+			return true;
+		}
+		default:
+		{
+			return false;
+		}
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <Value::IsChangeFiltered>
+// Check whether a refreshed reading should be dropped without notifying anyone
+//-----------------------------------------------------------------------------
+bool Value::IsChangeFiltered
+(
+	void* _originalValue,
+	void* _newValue,
+	int _type
+)
+{
+	ChangeFilter* filter = m_filter;
+	if( ( filter == NULL ) || !IsNumber() )
+	{
+		return false;
+	}
+
+	// An unchanged reading is only notified as a change when changes are not verified
+	if( m_verifyChanges && IsSameReading( _originalValue, _newValue, _type, 0 ) )
+	{
+		return false;
+	}
+
+	bool bFiltered = false;
+	if( ( filter->m_deadband > 0 ) && IsSameReading( _originalValue, _newValue, _type, filter->m_deadband ) )
+	{
+		OZW_LOG( LogLevel_Detail, m_id.GetNodeId(), "Change within deadband of %g--ignored", filter->m_deadband );
+		bFiltered = true;
+	}
+	else if( ( filter->m_minInterval > 0 ) && ( filter->m_lastChange != 0 ) && ( TimeStamp::GetMonotonicTime() - filter->m_lastChange < (uint64)filter->m_minInterval ) )
+	{
+		OZW_LOG( LogLevel_Detail, m_id.GetNodeId(), "Change within %dms of the last one--ignored", filter->m_minInterval );
+		bFiltered = true;
+	}
+
+	if( bFiltered )
+	{
+		if( Driver* driver = Manager::Get()->GetDriver( m_id.GetHomeId() ) )
+		{
+			++driver->m_changesFiltered;
+		}
+	}
+	return bFiltered;
+}
+
 //-----------------------------------------------------------------------------
 // <Value::VerifyRefreshedValue>
 // Check a refreshed value
@@ -533,10 +840,14 @@ int Value::VerifyRefreshedValue
 	// to be setting these values after the refesh or notification is sent.  With some
 	// focus on the actual variable storage, we should be able to accomplish this with
 	// memory functions.  It's really the strings that make things complicated(?).
+
+	// let the poll scheduler know the device has just told us about this value
+	m_reportTime = TimeStamp::GetMonotonicTime();
+
 	// if this is the first read of a value, assume it is valid (and notify as a change)
 	if( !IsSet() )
 	{
-		Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Initial read of value" );
+		OZW_LOG( LogLevel_Detail, m_id.GetNodeId(), "Initial read of value" );
 		Value::OnValueChanged();
 		return 2;		// confirmed change of value
 	}
@@ -545,19 +856,22 @@ int Value::VerifyRefreshedValue
 		switch( _type )
 		{
 		case 1:			// string
-			Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%s, new value=%s, type=%s", ((string*)_originalValue)->c_str(), ((string*)_newValue)->c_str(), "string" );
+			OZW_LOG( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%s, new value=%s, type=%s", ((string*)_originalValue)->c_str(), ((string*)_newValue)->c_str(), "string" );
 			break;
 		case 2:			// short
-            Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%d, new value=%d, type=%s", *((short*)_originalValue), *((short*)_newValue), "short");
+            OZW_LOG( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%d, new value=%d, type=%s", *((short*)_originalValue), *((short*)_newValue), "short");
 			break;
 		case 3:			// int32
-			Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%d, new value=%d, type=%s", *((int32*)_originalValue), *((int32*)_newValue), "int32" );
+			OZW_LOG( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%d, new value=%d, type=%s", *((int32*)_originalValue), *((int32*)_newValue), "int32" );
 			break;
 		case 4:			// uint8
-			Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%d, new value=%d, type=%s", *((uint8*)_originalValue), *((uint8*)_newValue), "uint8" );
+			OZW_LOG( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%d, new value=%d, type=%s", *((uint8*)_originalValue), *((uint8*)_newValue), "uint8" );
 			break;
 		case 5:			// bool
-			Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%s, new value=%s, type=%s", *((bool*)_originalValue)?"true":"false", *((uint8*)_newValue)?"true":"false", "bool" );
+			OZW_LOG( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%s, new value=%s, type=%s", *((bool*)_originalValue)?"true":"false", *((uint8*)_newValue)?"true":"false", "bool" );
+			break;
+		case 6:			// decimal
+			OZW_LOG( LogLevel_Detail, m_id.GetNodeId(), "Refreshed Value: old value=%s, new value=%s, type=%s", ValueDecimal::Format( *((ValueDecimal::Fixed*)_originalValue) ).c_str(), ValueDecimal::Format( *((ValueDecimal::Fixed*)_newValue) ).c_str(), "decimal" );
 			break;
 		default:
 			break;
@@ -565,9 +879,18 @@ int Value::VerifyRefreshedValue
 	}
 	m_refreshTime = time( NULL );	// update value refresh time
 
+	// drop changes too small to matter, or too soon after the last one, before anyone is notified.
+	// The reading still goes in the history and the value log, so trends keep their detail, but
+	// the value itself is left as it was.
+	if( !IsCheckingChange() && IsChangeFiltered( _originalValue, _newValue, _type ) )
+	{
+		RecordReading( _newValue, _type );
+		return 3;				// nothing for the caller to store
+	}
+
 	// check whether changes in this value should be verified (since some devices will report values that always
 	// change, where confirming changes is difficult or impossible)
-	Log::Write( LogLevel_Detail, m_id.GetNodeId(), "Changes to this value are %sverified", m_verifyChanges ? "" : "not " );
+	OZW_LOG( LogLevel_Detail, m_id.GetNodeId(), "Changes to this value are %sverified", m_verifyChanges ? "" : "not " );
 
 	if( !m_verifyChanges )
 	{
@@ -576,92 +899,202 @@ int Value::VerifyRefreshedValue
 		return 2;				// confirmed change of value
 	}
 
-	// see if the value has changed (result is used whether checking change or not)
-	bool bOriginalEqual = false;
-	switch( _type )
+	// the policy for verifying changes comes from the command class
+	CommandClass* cc = NULL;
+	if( Driver* driver = Manager::Get()->GetDriver( m_id.GetHomeId() ) )
 	{
-	case 1:			// string
-		bOriginalEqual = ( strcmp( ((string*)_originalValue)->c_str(), ((string*)_newValue)->c_str() ) == 0 );
-		break;
-	case 2:			// short
-		bOriginalEqual = ( *((short*)_originalValue) == *((short*)_newValue) );
-		break;
-	case 3:			// int32
-		bOriginalEqual = ( *((int32*)_originalValue) == *((int32*)_newValue) );
-		break;
-	case 4:			// uint8
-		bOriginalEqual = ( *((uint8*)_originalValue) == *((uint8*)_newValue) );
-		break;
-	case 5:			// bool
-		bOriginalEqual = ( *((bool*)_originalValue) == *((bool*)_newValue) );
-		break;
+		// we are on the driver thread, handling a message from the node, so the node cannot go away
+		if( Node* node = driver->GetNodeUnsafe( m_id.GetNodeId() ) )
+		{
+			cc = node->GetCommandClass( m_id.GetCommandClassId() );
+		}
+	}
+	CommandClass::VerifyPolicy policy;
+	if( cc != NULL )
+	{
+		policy = cc->GetVerifyPolicy();
 	}
 
-		// if this is the first refresh of the value, test to see if the value has changed
+	// if this is the first refresh of the value, test to see if the value has changed
 	if( !IsCheckingChange() )
 	{
-		if( bOriginalEqual )
+		if( IsSameReading( _originalValue, _newValue, _type, 0 ) )
 		{
 			// values are the same, so signal a refresh and return
 			Value::OnValueRefreshed();
 			return 0;			// value hasn't changed
 		}
 
-		// values are different, so flag this as a verification refresh and queue it
-		Log::Write( LogLevel_Info, m_id.GetNodeId(), "Changed value (possible)--rechecking" );
+		// small changes are believed without reading the value again
+		if( ( policy.m_threshold > 0 ) && IsSameReading( _originalValue, _newValue, _type, policy.m_threshold ) )
+		{
+			OZW_LOG( LogLevel_Info, m_id.GetNodeId(), "Changed value (within threshold)--accepted without checking" );
+			Value::OnValueChanged();
+			return 2;
+		}
+
+		// values are different, so flag this as a verification refresh and queue it.
+		// The value already held counts as one read in favour of the original.
+		OZW_LOG( LogLevel_Info, m_id.GetNodeId(), "Changed value (possible)--rechecking" );
 		SetCheckingChange( true );
-		Manager::Get()->RefreshValue( GetID() );
+		m_checkReads = 1;
+		m_checkVotes = 1;
+		m_originalVotes = 1;
+		RequestVerification( cc );
 		return 1;				// value has changed (to be confirmed)
 	}
-	else		// IsCheckingChange is true if this is the second read of a potentially changed value
+
+	// IsCheckingChange is true if this is a further read of a potentially changed value.
+	// Each read agrees with the changed value, agrees with the original value, or
+	// disagrees with both, in which case it counts against the changed value and
+	// replaces it once it has no reads left in its favour.
+	++m_checkReads;
+	bool bCandidateChanged = false;
+	if( IsSameReading( _checkValue, _newValue, _type, policy.m_tolerance ) )
+	{
+		++m_checkVotes;
+	}
+	else if( IsSameReading( _originalValue, _newValue, _type, policy.m_tolerance ) )
 	{
-		// if the second read is the same as the first read, the value really changed
-		bool bCheckEqual = false;
-		switch( _type )
+		++m_originalVotes;
+	}
+	else if( --m_checkVotes == 0 )
+	{
+		m_checkVotes = 1;
+		bCandidateChanged = true;
+	}
+
+	uint8 majority = policy.m_reads / 2 + 1;
+	if( !bCandidateChanged && ( m_checkVotes >= majority ) )
+	{
+		OZW_LOG( LogLevel_Info, m_id.GetNodeId(), "Changed value--confirmed after %d reads", m_checkReads );
+		SetCheckingChange( false );
+		if( cc != NULL )
 		{
-		case 1:			// string
-			bCheckEqual = ( strcmp( ((string*)_checkValue)->c_str(), ((string*)_newValue)->c_str() ) == 0 );
-			break;
-		case 2:			// short
-			bCheckEqual = ( *((short*)_checkValue) == *((short*)_newValue) );
-			break;
-		case 3:			// int32
-			bCheckEqual = ( *((int32*)_checkValue) == *((int32*)_newValue) );
-			break;
-		case 4:			// uint8
-			bCheckEqual = ( *((uint8*)_checkValue) == *((uint8*)_newValue) );
-			break;
-		case 5:			// bool
-			bCheckEqual = ( *((bool*)_checkValue) == *((bool*)_newValue) );
-			break;
+			cc->VerifyConfirmedCntIncr();
 		}
-		if( bCheckEqual )
-		{
-			Log::Write( LogLevel_Info, m_id.GetNodeId(), "Changed value--confirmed" );
-			SetCheckingChange( false );
 
-			// update the saved value and send notification
-			Value::OnValueChanged();
-			return 2;
+		// update the saved value and send notification
+		Value::OnValueChanged();
+		return 2;
+	}
+
+	// if enough reads agree with the original value, the change is assumed to have been in error.
+	// log this situation, but don't change the value or send a ValueChanged Notification
+	if( m_originalVotes >= majority )
+	{
+		OZW_LOG( LogLevel_Info, m_id.GetNodeId(), "Spurious value change was noted after %d reads.", m_checkReads );
+		SetCheckingChange( false );
+		if( cc != NULL )
+		{
+			cc->VerifySpuriousCntIncr();
 		}
+		Value::OnValueRefreshed();
+		return 0;
+	}
 
-		// if the second read is the same as the original value, the first read is assumed to have been in error
-		// log this situation, but don't change the value or send a ValueChanged Notification
-		if( bOriginalEqual )
+	if( m_checkReads >= policy.m_reads )
+	{
+		// no majority, so start again from the latest read
+		if( IsSameReading( _originalValue, _newValue, _type, 0 ) )
 		{
-			Log::Write( LogLevel_Info, m_id.GetNodeId(), "Spurious value change was noted." );
+			OZW_LOG( LogLevel_Info, m_id.GetNodeId(), "Spurious value change was noted." );
 			SetCheckingChange( false );
+			if( cc != NULL )
+			{
+				cc->VerifySpuriousCntIncr();
+			}
 			Value::OnValueRefreshed();
 			return 0;
 		}
 
-		// the second read is different than both the original value and the checked value...retry
-		// keep trying until we get the same value twice
-		Log::Write( LogLevel_Info, m_id.GetNodeId(), "Changed value (changed again)--rechecking" );
-		SetCheckingChange( true );
-
-		// save a temporary copy of value and re-read value from device
-		Manager::Get()->RefreshValue( GetID() );
+		OZW_LOG( LogLevel_Info, m_id.GetNodeId(), "Changed value (changed again)--rechecking" );
+		m_checkReads = 1;
+		m_checkVotes = 1;
+		m_originalVotes = 1;
+		RequestVerification( cc );
 		return 1;
 	}
+
+	// keep reading until there is a majority
+	if( bCandidateChanged )
+	{
+		OZW_LOG( LogLevel_Info, m_id.GetNodeId(), "Changed value (changed again)--rechecking" );
+	}
+	RequestVerification( cc );
+	return( bCandidateChanged ? 1 : 3 );
+}
+
+//-----------------------------------------------------------------------------
+// <Value::RequestVerification>
+// Queue another read of a value whose change is being verified
+//-----------------------------------------------------------------------------
+void Value::RequestVerification
+(
+	CommandClass* _cc
+)
+{
+	if( _cc == NULL )
+	{
+		return;
+	}
+
+	// The read is queued straight onto the send queue.  This is called on the driver
+	// thread while a report is being handled, so there is no need to lock the nodes,
+	// and the reply is handled when it arrives rather than being waited for.
+	OZW_LOG( LogLevel_Info, m_id.GetNodeId(), "Refreshing %s index = %d instance = %d (to confirm a reported change)", _cc->GetCommandClassName().c_str(), m_id.GetIndex(), m_id.GetInstance() );
+	_cc->VerifyReadCntIncr();
+	if( Driver* driver = Manager::Get()->GetDriver( m_id.GetHomeId() ) )
+	{
+		++driver->m_verifyReads;
+	}
+	_cc->RequestValue( 0, m_id.GetIndex(), m_id.GetInstance(), Driver::MsgQueue_Send );
+}
+
+//-----------------------------------------------------------------------------
+// <Value::IsSameReading>
+// Compare two readings of a value, allowing numbers to differ by a tolerance
+//-----------------------------------------------------------------------------
+bool Value::IsSameReading
+(
+	void* _a,
+	void* _b,
+	int _type,
+	double const _tolerance
+)
+{
+	double a = 0;
+	double b = 0;
+	switch( _type )
+	{
+	case 1:			// string
+		return( *((string*)_a) == *((string*)_b) );
+	case 2:			// short
+		a = *((short*)_a);
+		b = *((short*)_b);
+		break;
+	case 3:			// int32
+		a = *((int32*)_a);
+		b = *((int32*)_b);
+		break;
+	case 4:			// uint8
+		a = *((uint8*)_a);
+		b = *((uint8*)_b);
+		break;
+	case 5:			// bool
+		return( *((bool*)_a) == *((bool*)_b) );
+	case 6:			// decimal
+		if( *((ValueDecimal::Fixed*)_a) == *((ValueDecimal::Fixed*)_b) )
+		{
+			return true;
+		}
+		a = ValueDecimal::ToFloat( *((ValueDecimal::Fixed*)_a) );
+		b = ValueDecimal::ToFloat( *((ValueDecimal::Fixed*)_b) );
+		break;
+	default:
+		return false;
+	}
+
+	double diff = ( a > b ) ? ( a - b ) : ( b - a );
+	return( diff <= _tolerance );
 }
@@ -29,15 +29,19 @@
 #define _Value_H
 
 #include <string>
+#include <ctime>
 #include "Defs.h"
 #include "Ref.h"
 #include "ValueID.h"
+#include "InternedString.h"
 
 class TiXmlElement;
 
 namespace OpenZWave
 {
 	class Node;
+	class CommandClass;
+	class ValueHistory;
 
 	/** \brief Base class for values associated with a node.
 	 */
@@ -49,6 +53,7 @@ namespace OpenZWave
 	public:
 		Value( uint32 const _homeId, uint8 const _nodeId, ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint8 const _index, ValueID::ValueType const _type, string const& _label, string const& _units, bool const _readOnly, bool const _writeOnly, bool const _isset, uint8 const _pollIntensity );
 		Value();
+		Value( Value const& _other );			// Copies are made to send new values to the device, and don't share the history or change filter
 
 		virtual void ReadXML( uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, TiXmlElement const* _valueElement );
 		virtual void WriteXML( TiXmlElement* _valueElement );
@@ -71,13 +76,24 @@ namespace OpenZWave
 		uint8 const& GetPollIntensity()const{ return m_pollIntensity; }
 		void SetPollIntensity( uint8 const& _intensity ){ m_pollIntensity = _intensity; }
 
+		int32 GetPollInterval()const{ return m_pollInterval; }		// Milliseconds between polls, or zero to use the driver's poll interval
+		void SetPollInterval( int32 const _milliseconds ){ m_pollInterval = _milliseconds; }
+
 		int32 GetMin()const{ return m_min; }
 		int32 GetMax()const{ return m_max; }
 
 		void SetChangeVerified( bool _verify ){ m_verifyChanges = _verify; }
 
+		bool SetChangeFilter( double const _deadband, int32 const _minInterval );	// Drop reported changes no larger than the deadband, or less than _minInterval milliseconds after the last one
+		double GetChangeDeadband()const{ return( m_filter ? m_filter->m_deadband : 0 ); }
+		int32 GetChangeMinInterval()const{ return( m_filter ? m_filter->m_minInterval : 0 ); }
+
 		virtual string const GetAsString() const { return ""; }
 		virtual bool SetFromString( string const& _value ) { return false; }
+		virtual bool GetAsDouble( double* o_value ) const { return false; }		// False if the value is not a number
+
+		bool SetHistorySize( uint32 const _samples );		// Keep this many recent readings.  Zero stops keeping them.
+		ValueHistory const* GetHistory()const{ return m_history; }
 
 		bool Set();							// For the user to change a value in a device
 
@@ -96,18 +112,33 @@ namespace OpenZWave
 		void OnValueRefreshed();			// A value in a device has been refreshed
 		void OnValueChanged();				// The refreshed value actually changed
 		int VerifyRefreshedValue( void* _originalValue, void* _checkValue, void* _newValue, int _type );
+		void RecordHistory();				// Add the current value to the history and the value log, if they are kept
+		void RecordReading( void* _reading, int _type );	// Add a reading that is not being stored in the value, the same way
 
 		int32		m_min;
 		int32		m_max;
 
 		time_t		m_refreshTime;			// time_t identifying when this value was last refreshed
+		uint64		m_reportTime;			// monotonic time in ms when the device last reported this value (used by the poll scheduler)
 		bool		m_verifyChanges;		// if true, apparent changes are verified; otherwise, they're not
 
 	private:
+		struct ChangeFilter
+		{
+			double	m_deadband;				// Numeric changes no larger than this are dropped
+			int32	m_minInterval;			// Milliseconds after a change during which further changes are dropped
+			uint64	m_lastChange;			// Monotonic time in ms of the last change notified
+		};
+
+		void RequestVerification( CommandClass* _cc );	// Queue another read to confirm a change
+		bool IsChangeFiltered( void* _originalValue, void* _newValue, int _type );
+		bool IsNumber()const;				// True for the value types that change filters apply to
+		static bool IsSameReading( void* _a, void* _b, int _type, double const _tolerance );
+
 		ValueID		m_id;
-		string		m_label;
-		string		m_units;
-		string		m_help;
+		InternedString	m_label;
+		InternedString	m_units;
+		InternedString	m_help;
 		bool		m_readOnly;
 		bool		m_writeOnly;
 		bool		m_isSet;
@@ -115,7 +146,13 @@ namespace OpenZWave
 		uint8*		m_affects;
 		bool		m_affectsAll;
 		bool		m_checkChange;
+		uint8		m_checkReads;			// Reads made while verifying a change, counting the first
+		uint8		m_checkVotes;			// Reads in favour of the changed value, less those against it
+		uint8		m_originalVotes;		// Reads in favour of the original value, counting the value held
 		uint8		m_pollIntensity;
+		int32		m_pollInterval;
+		ValueHistory* volatile	m_history;	// Recent readings, or NULL if none are kept
+		ChangeFilter* volatile	m_filter;	// Deadband and minimum interval, or NULL if changes are not filtered
 	};
 
 } // namespace OpenZWave
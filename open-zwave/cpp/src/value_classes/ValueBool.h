@@ -54,6 +54,7 @@ namespace OpenZWave
 
 		// From Value
 		virtual string const GetAsString() const { return ( GetValue() ? "True" : "False" ); }
+		virtual bool GetAsDouble( double* o_value ) const { *o_value = GetValue() ? 1.0 : 0.0; return true; }
 		virtual bool SetFromString( string const& _value );
 		virtual void ReadXML( uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, TiXmlElement const* _valueElement );
 		virtual void WriteXML( TiXmlElement* _valueElement );
@@ -31,9 +31,20 @@
 #include "Log.h"
 #include "Manager.h"
 #include <ctime>
+#include <ctype.h>
+#include <math.h>
+#include <locale.h>
 
 using namespace OpenZWave;
 
+static uint8 const c_maxPlaces = 9;			// The most digits after the decimal point that will fit in an int32
+static uint8 const c_floatPlaces = 6;		// Digits kept after the decimal point when converting from a float
+
+static uint32 const c_powers[c_maxPlaces+1] =
+{
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
 
 //-----------------------------------------------------------------------------
 // <ValueDecimal::ValueDecimal>
@@ -55,7 +66,18 @@ ValueDecimal::ValueDecimal
 	uint8 const _pollIntensity
 ):
   	Value( _homeId, _nodeId, _genre, _commandClassId, _instance, _index, ValueID::ValueType_Decimal, _label, _units, _readOnly, _writeOnly, false, _pollIntensity ),
-	m_value( _value ),
+	m_precision( 0 )
+{
+	Parse( _value, &m_value );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::ValueDecimal>
+// Constructor (from XML)
+//-----------------------------------------------------------------------------
+ValueDecimal::ValueDecimal
+(
+):
 	m_precision( 0 )
 {
 }
@@ -77,7 +99,8 @@ void ValueDecimal::ReadXML
 	char const* str = _valueElement->Attribute( "value" );
 	if( str )
 	{
-		m_value = str;
+		// Values that had not been set are saved as an empty string, and keep their default
+		Parse( str, &m_value );
 	}
 	else
 	{
@@ -98,7 +121,7 @@ void ValueDecimal::WriteXML
 	if ( !IsSet() )
 		_valueElement->SetAttribute( "value", "" );
 	else
-		_valueElement->SetAttribute( "value", m_value.c_str() );
+		_valueElement->SetAttribute( "value", Format( m_value ).c_str() );
 }
 
 //-----------------------------------------------------------------------------
@@ -109,6 +132,23 @@ bool ValueDecimal::Set
 (
 	string const& _value
 )
+{
+	Fixed value;
+	if( !Parse( _value, &value ) )
+	{
+		return false;
+	}
+	return Set( value );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::Set>
+// Set a new value in the device
+//-----------------------------------------------------------------------------
+bool ValueDecimal::Set
+(
+	Fixed const& _value
+)
 {
 	// create a temporary copy of this value to be submitted to the Set() call and set its value to the function param
   	ValueDecimal* tempValue = new ValueDecimal( *this );
@@ -132,17 +172,210 @@ void ValueDecimal::OnValueRefreshed
 	string const& _value
 )
 {
-	switch( VerifyRefreshedValue( (void*) &m_value, (void*) &m_valueCheck, (void*) &_value, 1) )
+	Fixed value;
+	if( Parse( _value, &value ) )
+	{
+		OnValueRefreshed( value );
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::OnValueRefreshed>
+// A value in a device has been refreshed
+//-----------------------------------------------------------------------------
+void ValueDecimal::OnValueRefreshed
+(
+	Fixed const& _value
+)
+{
+	switch( VerifyRefreshedValue( (void*) &m_value, (void*) &m_valueCheck, (void*) &_value, 6) )
 	{
-	case 0:		// value hasn't changed, nothing to do
+	case 0:		// value hasn't changed, but the reading still goes in the history
+		RecordHistory();
 		break;
 	case 1:		// value has changed (not confirmed yet), save _value in m_valueCheck
 		m_valueCheck = _value;
 		break;
 	case 2:		// value has changed (confirmed), save _value in m_value
 		m_value = _value;
+		RecordHistory();
 		break;
-	case 3:		// all three values are different, so wait for next refresh to try again
+	case 3:		// still checking, or the change was filtered out (and recorded already), so there is nothing to store
 		break;
 	}
 }
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::GetAsDouble>
+// Get the value as a number, for the value's history
+//-----------------------------------------------------------------------------
+bool ValueDecimal::GetAsDouble
+(
+	double* o_value
+)const
+{
+	uint8 places = ( m_value.m_places > c_maxPlaces ) ? c_maxPlaces : m_value.m_places;
+	*o_value = (double)m_value.m_value / c_powers[places];
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::Format>
+// Write a decimal number as a string
+//-----------------------------------------------------------------------------
+string ValueDecimal::Format
+(
+	Fixed const& _value
+)
+{
+	// Work with the magnitude, so that the most negative number can be written too
+	bool negative = ( _value.m_value < 0 );
+	uint32 magnitude = negative ? ( 0u - (uint32)_value.m_value ) : (uint32)_value.m_value;
+
+	char str[32];
+	if( _value.m_places == 0 )
+	{
+		snprintf( str, sizeof(str), "%s%u", negative ? "-" : "", magnitude );
+	}
+	else
+	{
+		uint8 places = ( _value.m_places > c_maxPlaces ) ? c_maxPlaces : _value.m_places;
+		struct lconv const* locale = localeconv();
+		snprintf( str, sizeof(str), "%s%u%c%0*u", negative ? "-" : "", magnitude / c_powers[places], *(locale->decimal_point), (int)places, magnitude % c_powers[places] );
+	}
+	return str;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::Parse>
+// Read a decimal number from a string
+//-----------------------------------------------------------------------------
+bool ValueDecimal::Parse
+(
+	string const& _str,
+	Fixed* o_value
+)
+{
+	char const* pos = _str.c_str();
+	while( isspace( (uint8)*pos ) )
+	{
+		++pos;
+	}
+
+	bool negative = false;
+	if( ( *pos == '-' ) || ( *pos == '+' ) )
+	{
+		negative = ( *pos == '-' );
+		++pos;
+	}
+
+	int64 value = 0;
+	uint8 places = 0;
+	bool point = false;
+	bool digits = false;
+	for( ; *pos != 0; ++pos )
+	{
+		if( isdigit( (uint8)*pos ) )
+		{
+			if( point )
+			{
+				if( places == c_maxPlaces )
+				{
+					return false;
+				}
+				++places;
+			}
+			value = value * 10 + ( *pos - '0' );
+			if( value > 0x80000000LL )
+			{
+				return false;
+			}
+			digits = true;
+		}
+		else if( ( ( *pos == '.' ) || ( *pos == ',' ) ) && !point )
+		{
+			point = true;
+		}
+		else
+		{
+			break;
+		}
+	}
+
+	while( isspace( (uint8)*pos ) )
+	{
+		++pos;
+	}
+
+	if( !digits || ( *pos != 0 ) )
+	{
+		return false;
+	}
+
+	if( negative )
+	{
+		value = -value;
+	}
+	else if( value > 0x7fffffffLL )
+	{
+		return false;
+	}
+
+	o_value->m_value = (int32)value;
+	o_value->m_places = places;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::FromFloat>
+// Convert a floating point number to a decimal
+//-----------------------------------------------------------------------------
+bool ValueDecimal::FromFloat
+(
+	float const _value,
+	Fixed* o_value
+)
+{
+	double scaled = (double)_value * c_powers[c_floatPlaces];
+	if( !( fabs( scaled ) < 9.0e18 ) )
+	{
+		// Too large, or not a number at all
+		return false;
+	}
+
+	int64 value = (int64)( ( scaled < 0 ) ? -floor( 0.5 - scaled ) : floor( scaled + 0.5 ) );
+	uint8 places = c_floatPlaces;
+
+	// Drop trailing zeros, and then any digits that won't fit
+	while( ( places > 0 ) && ( ( value % 10 ) == 0 ) )
+	{
+		value /= 10;
+		--places;
+	}
+	while( ( places > 0 ) && ( ( value > 0x7fffffffLL ) || ( value < -0x80000000LL ) ) )
+	{
+		value = ( value + ( ( value < 0 ) ? -5 : 5 ) ) / 10;
+		--places;
+	}
+	if( ( value > 0x7fffffffLL ) || ( value < -0x80000000LL ) )
+	{
+		return false;
+	}
+
+	o_value->m_value = (int32)value;
+	o_value->m_places = places;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueDecimal::ToFloat>
+// Convert a decimal to a floating point number
+//-----------------------------------------------------------------------------
+float ValueDecimal::ToFloat
+(
+	Fixed const& _value
+)
+{
+	uint8 places = ( _value.m_places > c_maxPlaces ) ? c_maxPlaces : _value.m_places;
+	return (float)( (double)_value.m_value / c_powers[places] );
+}
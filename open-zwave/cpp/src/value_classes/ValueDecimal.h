@@ -40,6 +40,11 @@ namespace OpenZWave
 	class Node;
 
 	/** \brief Decimal value sent to/received from a node.
+	 *
+	 * The value is held as a fixed-point number, a whole number of units of
+	 * 10^-places, which is how Z-Wave devices send and receive decimals.  It is
+	 * only turned into a string when the application asks for one, or when the
+	 * value is written to the XML file.
 	 */
 	class ValueDecimal: public Value
 	{
@@ -49,28 +54,65 @@ namespace OpenZWave
 		friend class ThermostatSetpoint;
 
 	public:
+		/** \brief A fixed-point decimal number.
+		 */
+		struct Fixed
+		{
+			Fixed(): m_value( 0 ), m_places( 0 ){}
+			Fixed( int32 const _value, uint8 const _places ): m_value( _value ), m_places( _places ){}
+
+			int32	m_value;				// the number, multiplied by 10^m_places
+			uint8	m_places;				// digits after the decimal point
+
+			bool operator == ( Fixed const& _other )const{ return( ( m_value == _other.m_value ) && ( m_places == _other.m_places ) ); }
+		};
+
 		ValueDecimal( uint32 const _homeId, uint8 const _nodeId, ValueID::ValueGenre const _genre, uint8 const _commandClassId, uint8 const _instance, uint8 const _index, string const& _label, string const& _units, bool const _readOnly, bool const _writeOnly, string const& _value, uint8 const _pollIntensity );
-		ValueDecimal(): m_precision( 0 ){}
+		ValueDecimal();
 		virtual ~ValueDecimal(){}
 
 		bool Set( string const& _value );
+		bool Set( Fixed const& _value );
 		void OnValueRefreshed( string const& _value );
+		void OnValueRefreshed( Fixed const& _value );
 
 		// From Value
 		virtual string const GetAsString() const { return GetValue(); }
+		virtual bool GetAsDouble( double* o_value ) const;
 		virtual bool SetFromString( string const& _value ) { return Set( _value ); }
 		virtual void ReadXML( uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, TiXmlElement const* _valueElement );
 		virtual void WriteXML( TiXmlElement* _valueElement );
 
-		string GetValue()const{ return m_value; }
+		string GetValue()const{ return Format( m_value ); }
+		Fixed const& GetFixed()const{ return m_value; }
+		float GetAsFloat()const{ return ToFloat( m_value ); }
 		uint8 GetPrecision()const{ return m_precision; }
 
+		/**
+		 * Write a decimal number as a string, using the decimal point of the current locale.
+		 */
+		static string Format( Fixed const& _value );
+
+		/**
+		 * Read a decimal number from a string.  Either '.' or ',' may be used as the decimal point.
+		 * \return false if the string is not a number, or the number does not fit.
+		 */
+		static bool Parse( string const& _str, Fixed* o_value );
+
+		/**
+		 * Convert a floating point number to a decimal, keeping up to six digits
+		 * after the decimal point, and dropping any trailing zeros.
+		 * \return false if the number does not fit.
+		 */
+		static bool FromFloat( float const _value, Fixed* o_value );
+
+		static float ToFloat( Fixed const& _value );
+
 	private:
 		void SetPrecision( uint8 _precision ){ m_precision = _precision; }
 
-		string	m_value;				// the current value
-		string	m_valueCheck;			// the previous value (used for double-checking spurious value reads)
-		string	m_newValue;				// a new value to be set on the appropriate device
+		Fixed	m_value;				// the current value
+		Fixed	m_valueCheck;			// the previous value (used for double-checking spurious value reads)
         uint8	m_precision;
 	};
 
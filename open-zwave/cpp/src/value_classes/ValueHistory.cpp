@@ -0,0 +1,403 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueHistory.cpp
+//
+//	Recent readings of a value, for drawing trends
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#include "Defs.h"
+#include "ValueHistory.h"
+#include "Options.h"
+#include "Mutex.h"
+#include "Atomic.h"
+#include "Log.h"
+
+using namespace OpenZWave;
+
+Mutex* ValueHistory::s_mutex = NULL;
+uint32 volatile ValueHistory::s_reserved = 0;
+
+static Options::Handle<int32> s_maxSamples( "ValueHistoryMaxSamples" );
+
+//-----------------------------------------------------------------------------
+// <ValueHistory::Create>
+// Create the lock that protects the histories
+//-----------------------------------------------------------------------------
+void ValueHistory::Create
+(
+)
+{
+	if( s_mutex == NULL )
+	{
+		s_mutex = new Mutex();
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueHistory::Destroy>
+// Destroy the lock
+//-----------------------------------------------------------------------------
+void ValueHistory::Destroy
+(
+)
+{
+	if( s_mutex != NULL )
+	{
+		s_mutex->Release();
+		s_mutex = NULL;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueHistory::Attach>
+// Get a history, creating it if there isn't one yet
+//-----------------------------------------------------------------------------
+ValueHistory* ValueHistory::Attach
+(
+	ValueHistory* volatile* _history,
+	uint32 const _capacity
+)
+{
+	if( *_history != NULL )
+	{
+		return *_history;
+	}
+
+	if( s_mutex == NULL )
+	{
+		return NULL;
+	}
+
+	// Check again with the lock held, in case another thread got here first
+	s_mutex->Lock();
+	if( *_history == NULL )
+	{
+		ValueHistory* history = new ValueHistory();
+		if( !history->SetCapacity( _capacity ) )
+		{
+			Log::Write( LogLevel_Warning, "Value history not kept, as ValueHistoryMaxSamples readings are already being kept" );
+		}
+		*_history = history;
+	}
+	s_mutex->Unlock();
+
+	return *_history;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueHistory::ValueHistory>
+// Constructor
+//-----------------------------------------------------------------------------
+ValueHistory::ValueHistory
+(
+):
+	m_samples( NULL ),
+	m_capacity( 0 ),
+	m_count( 0 ),
+	m_first( 0 )
+{
+}
+
+//-----------------------------------------------------------------------------
+// <ValueHistory::~ValueHistory>
+// Destructor
+//-----------------------------------------------------------------------------
+ValueHistory::~ValueHistory
+(
+)
+{
+	Atomic::Add( &s_reserved, 0u - m_capacity );
+	delete [] m_samples;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueHistory::SetCapacity>
+// Change the number of readings kept
+//-----------------------------------------------------------------------------
+bool ValueHistory::SetCapacity
+(
+	uint32 const _capacity
+)
+{
+	if( _capacity == m_capacity )
+	{
+		return true;
+	}
+
+	// Reserve the extra readings before allocating them
+	if( _capacity > m_capacity )
+	{
+		uint32 extra = _capacity - m_capacity;
+		uint32 reserved = Atomic::Add( &s_reserved, extra );
+		int32 limit = s_maxSamples.Get();
+		if( ( reserved < extra ) || ( limit < 0 ) || ( reserved > (uint32)limit ) )
+		{
+			Atomic::Add( &s_reserved, 0u - extra );
+			return false;
+		}
+	}
+
+	Sample* samples = ( _capacity > 0 ) ? new Sample[_capacity] : NULL;
+
+	if( s_mutex )
+	{
+		s_mutex->Lock();
+	}
+
+	// Keep the most recent readings that will fit
+	uint32 count = ( m_count < _capacity ) ? m_count : _capacity;
+	for( uint32 i=0; i<count; ++i )
+	{
+		samples[i] = GetSample( m_count - count + i );
+	}
+
+	Sample* oldSamples = m_samples;
+	uint32 oldCapacity = m_capacity;
+	m_samples = samples;
+	m_capacity = _capacity;
+	m_count = count;
+	m_first = 0;
+
+	if( s_mutex )
+	{
+		s_mutex->Unlock();
+	}
+
+	if( _capacity < oldCapacity )
+	{
+		Atomic::Add( &s_reserved, 0u - ( oldCapacity - _capacity ) );
+	}
+	delete [] oldSamples;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueHistory::Add>
+// Add a reading, replacing the oldest if the history is full
+//-----------------------------------------------------------------------------
+void ValueHistory::Add
+(
+	uint64 const _time,
+	double const _value
+)
+{
+	if( ( s_mutex == NULL ) || ( m_capacity == 0 ) )
+	{
+		return;
+	}
+
+	s_mutex->Lock();
+	if( m_capacity > 0 )
+	{
+		Sample* sample;
+		if( m_count < m_capacity )
+		{
+			sample = &m_samples[( m_first + m_count ) % m_capacity];
+			++m_count;
+		}
+		else
+		{
+			sample = &m_samples[m_first];
+			m_first = ( m_first + 1 ) % m_capacity;
+		}
+		sample->m_time = _time;
+		sample->m_value = _value;
+	}
+	s_mutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <ValueHistory::Find>
+// Position, from the oldest, of the first reading at or after a time
+//-----------------------------------------------------------------------------
+uint32 ValueHistory::Find
+(
+	uint64 const _time
+)const
+{
+	// Readings are added in time order, so a binary search will do
+	uint32 low = 0;
+	uint32 high = m_count;
+	while( low < high )
+	{
+		uint32 mid = low + ( ( high - low ) >> 1 );
+		if( GetSample( mid ).m_time < _time )
+		{
+			low = mid + 1;
+		}
+		else
+		{
+			high = mid;
+		}
+	}
+	return low;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueHistory::GetSamples>
+// Get the readings from a range of time
+//-----------------------------------------------------------------------------
+void ValueHistory::GetSamples
+(
+	uint64 const _from,
+	uint64 const _to,
+	vector<Sample>* o_samples
+)const
+{
+	if( s_mutex == NULL )
+	{
+		return;
+	}
+
+	s_mutex->Lock();
+	for( uint32 i=Find( _from ); i<m_count; ++i )
+	{
+		Sample const& sample = GetSample( i );
+		if( sample.m_time >= _to )
+		{
+			break;
+		}
+		o_samples->push_back( sample );
+	}
+	s_mutex->Unlock();
+}
+
+//-----------------------------------------------------------------------------
+// <ValueHistory::GetSummary>
+// Summarize the readings from a range of time
+//-----------------------------------------------------------------------------
+bool ValueHistory::GetSummary
+(
+	uint64 const _from,
+	uint64 const _to,
+	Summary* o_summary
+)const
+{
+	if( s_mutex == NULL )
+	{
+		return false;
+	}
+
+	o_summary->m_count = 0;
+
+	s_mutex->Lock();
+	for( uint32 i=Find( _from ); i<m_count; ++i )
+	{
+		Sample const& sample = GetSample( i );
+		if( sample.m_time >= _to )
+		{
+			break;
+		}
+		AddToSummary( sample, o_summary );
+	}
+	s_mutex->Unlock();
+
+	if( o_summary->m_count == 0 )
+	{
+		return false;
+	}
+
+	o_summary->m_average /= o_summary->m_count;
+	return true;
+}
+
+//-----------------------------------------------------------------------------
+// <ValueHistory::GetDownsampled>
+// Summarize the readings in each interval of a range of time
+//-----------------------------------------------------------------------------
+void ValueHistory::GetDownsampled
+(
+	uint64 const _from,
+	uint64 const _to,
+	uint32 const _interval,
+	vector<Summary>* o_summaries
+)const
+{
+	if( ( s_mutex == NULL ) || ( _interval == 0 ) )
+	{
+		return;
+	}
+
+	s_mutex->Lock();
+	size_t first = o_summaries->size();
+	uint64 intervalEnd = 0;
+	for( uint32 i=Find( _from ); i<m_count; ++i )
+	{
+		Sample const& sample = GetSample( i );
+		if( sample.m_time >= _to )
+		{
+			break;
+		}
+
+		if( ( o_summaries->size() == first ) || ( sample.m_time >= intervalEnd ) )
+		{
+			// Start a summary for the interval that this reading falls in
+			intervalEnd = _from + ( ( sample.m_time - _from ) / _interval + 1 ) * _interval;
+			o_summaries->push_back( Summary() );
+			o_summaries->back().m_count = 0;
+		}
+		AddToSummary( sample, &o_summaries->back() );
+	}
+	s_mutex->Unlock();
+
+	for( size_t i=first; i<o_summaries->size(); ++i )
+	{
+		(*o_summaries)[i].m_average /= (*o_summaries)[i].m_count;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueHistory::AddToSummary>
+// Add a reading to a summary.  The average is left as a total.
+//-----------------------------------------------------------------------------
+void ValueHistory::AddToSummary
+(
+	Sample const& _sample,
+	Summary* _summary
+)
+{
+	if( _summary->m_count == 0 )
+	{
+		_summary->m_start = _sample.m_time;
+		_summary->m_min = _sample.m_value;
+		_summary->m_max = _sample.m_value;
+		_summary->m_average = 0;
+	}
+	else
+	{
+		if( _sample.m_value < _summary->m_min )
+		{
+			_summary->m_min = _sample.m_value;
+		}
+		if( _sample.m_value > _summary->m_max )
+		{
+			_summary->m_max = _sample.m_value;
+		}
+	}
+
+	_summary->m_end = _sample.m_time;
+	_summary->m_last = _sample.m_value;
+	_summary->m_average += _sample.m_value;
+	++_summary->m_count;
+}
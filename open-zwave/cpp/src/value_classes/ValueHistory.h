@@ -0,0 +1,141 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueHistory.h
+//
+//	Recent readings of a value, for drawing trends
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#ifndef _ValueHistory_H
+#define _ValueHistory_H
+
+#include <vector>
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	class Mutex;
+
+	/** \brief The most recent readings of a numeric value, so that applications
+	 * can draw trends without storing every report themselves.
+	 *
+	 * Readings are kept in a ring of fixed size, along with the time on the
+	 * monotonic clock (TimeStamp::GetMonotonicTime) at which they arrived, so
+	 * the oldest are forgotten as new ones arrive.  The total number of readings
+	 * kept for all values is limited by the ValueHistoryMaxSamples option.
+	 *
+	 * Readings are added on the driver thread and read by the application, so
+	 * every history is protected by a single lock, which is only held briefly.
+	 */
+	class ValueHistory
+	{
+	public:
+		struct Sample
+		{
+			uint64	m_time;					// Monotonic time of the reading, in milliseconds
+			double	m_value;
+		};
+
+		struct Summary
+		{
+			uint64	m_start;				// Time of the first reading summarized
+			uint64	m_end;					// Time of the last reading summarized
+			uint32	m_count;				// Number of readings
+			double	m_min;
+			double	m_max;
+			double	m_average;
+			double	m_last;					// The last reading
+		};
+
+		/**
+		 * Create the lock that protects the histories.  Until this is called,
+		 * no histories are kept.
+		 */
+		static void Create();
+
+		/**
+		 * Destroy the lock.  Every history must have been deleted first.
+		 */
+		static void Destroy();
+
+		/**
+		 * Get a history, creating it if there isn't one yet.  Safe to call from any thread.
+		 * \param _history where the history is kept.
+		 * \param _capacity number of readings a new history keeps.
+		 * \return the history, or NULL if histories are not being kept.
+		 */
+		static ValueHistory* Attach( ValueHistory* volatile* _history, uint32 const _capacity );
+
+		~ValueHistory();
+
+		/**
+		 * Change the number of readings kept.  The most recent readings are kept.
+		 * \return false if that would take more than ValueHistoryMaxSamples readings in all.
+		 */
+		bool SetCapacity( uint32 const _capacity );
+
+		void Add( uint64 const _time, double const _value );
+
+		/**
+		 * Get the readings from a range of time.
+		 * \param _from the start of the range.
+		 * \param _to the end of the range, which is not included.
+		 * \param o_samples vector to which the readings are added, oldest first.
+		 */
+		void GetSamples( uint64 const _from, uint64 const _to, vector<Sample>* o_samples )const;
+
+		/**
+		 * Summarize the readings from a range of time.
+		 * \return false if there are no readings in the range.
+		 */
+		bool GetSummary( uint64 const _from, uint64 const _to, Summary* o_summary )const;
+
+		/**
+		 * Divide a range of time into intervals, and summarize the readings in
+		 * each.  Intervals without any readings are left out.
+		 * \param _interval length of each interval, in milliseconds.
+		 * \param o_summaries vector to which a summary of each interval is added, oldest first.
+		 */
+		void GetDownsampled( uint64 const _from, uint64 const _to, uint32 const _interval, vector<Summary>* o_summaries )const;
+
+	private:
+		ValueHistory();
+		ValueHistory( ValueHistory const& );					// prevent copy
+		ValueHistory& operator = ( ValueHistory const& );		// prevent assignment
+
+		uint32 Find( uint64 const _time )const;					// Position, from the oldest, of the first reading at or after a time
+		Sample const& GetSample( uint32 const _pos )const{ return m_samples[( m_first + _pos ) % m_capacity]; }
+		static void AddToSummary( Sample const& _sample, Summary* _summary );
+
+		Sample*			m_samples;
+		uint32			m_capacity;
+		uint32			m_count;						// Number of readings held
+		uint32			m_first;						// Index of the oldest reading
+
+		static Mutex*			s_mutex;
+		static uint32 volatile	s_reserved;				// Readings that all the histories together may hold
+	};
+
+} // namespace OpenZWave
+
+#endif // _ValueHistory_H
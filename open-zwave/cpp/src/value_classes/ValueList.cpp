@@ -258,19 +258,39 @@ void ValueList::OnValueRefreshed
 
 	switch( VerifyRefreshedValue( (void*) &m_valueIdx, (void*) &m_valueIdxCheck, (void*) &index, 3) )
 	{
-	case 0:		// value hasn't changed, nothing to do
+	case 0:		// value hasn't changed, but the reading still goes in the history
+		RecordHistory();
 		break;
 	case 1:		// value has changed (not confirmed yet), save _value in m_valueCheck
 		m_valueIdxCheck = index;
 		break;
 	case 2:		// value has changed (confirmed), save _value in m_value
 		m_valueIdx = index;
+		RecordHistory();
 		break;
 	case 3:		// all three values are different, so wait for next refresh to try again
 		break;
 	}
 }
 
+//-----------------------------------------------------------------------------
+// <ValueList::GetAsDouble>
+// Get the value of the selected item, for the value's history
+//-----------------------------------------------------------------------------
+bool ValueList::GetAsDouble
+(
+	double* o_value
+)const
+{
+	if( ( m_valueIdx < 0 ) || ( m_valueIdx >= (int32)m_items.size() ) )
+	{
+		return false;
+	}
+
+	*o_value = m_items[m_valueIdx].m_value;
+	return true;
+}
+
 //-----------------------------------------------------------------------------
 // <ValueList::GetItemIdxByLabel>
 // Get the index of an item from its label
@@ -64,6 +64,7 @@ namespace OpenZWave
 
 		// From Value
 		virtual string const GetAsString() const { return GetItem().m_label; }
+		virtual bool GetAsDouble( double* o_value ) const;
 		virtual bool SetFromString( string const& _value ) { return SetByLabel( _value ); }
 		virtual void ReadXML( uint32 const _homeId, uint8 const _nodeId, uint8 const _commandClassId, TiXmlElement const* _valueElement );
 		virtual void WriteXML( TiXmlElement* _valueElement );
@@ -0,0 +1,114 @@
+//-----------------------------------------------------------------------------
+//
+//	ValueRef.h
+//
+//	Holds a reference to a value for as long as it is in scope
+//
+//	Copyright (c) 2010 Mal Lansell <openzwave@lansell.org>
+//
+//	SOFTWARE NOTICE AND LICENSE
+//
+//	This file is part of OpenZWave.
+//
+//	OpenZWave is free software: you can redistribute it and/or modify
+//	it under the terms of the GNU Lesser General Public License as published
+//	by the Free Software Foundation, either version 3 of the License,
+//	or (at your option) any later version.
+//
+//	OpenZWave is distributed in the hope that it will be useful,
+//	but WITHOUT ANY WARRANTY; without even the implied warranty of
+//	MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+//	GNU Lesser General Public License for more details.
+//
+//	You should have received a copy of the GNU Lesser General Public License
+//	along with OpenZWave.  If not, see <http://www.gnu.org/licenses/>.
+//
+//-----------------------------------------------------------------------------
+
+
+#ifndef _ValueRef_H
+#define _ValueRef_H
+
+#include "Defs.h"
+
+namespace OpenZWave
+{
+	/** \brief Holds a reference to a value, and releases it when it goes out of scope.
+	 *
+	 * GetValue on a node, command class or driver adds a reference to the value it
+	 * returns, which keeps the value alive after the nodes are unlocked.  A ValueRef
+	 * takes over that reference, so it is released on every path out of the code
+	 * that holds it.  Code that only uses the value while the nodes are locked, or
+	 * on the driver thread while handling a message, should use BorrowValue
+	 * instead, which does not touch the reference count at all.
+	 *
+	 * \code
+	 * ValueRef<ValueBool> value( static_cast<ValueBool*>( node->GetValue( id ) ) );
+	 * if( value )
+	 * {
+	 *     value->Set( true );
+	 * }
+	 * \endcode
+	 */
+	template<class T> class ValueRef
+	{
+	public:
+		/**
+		 * Take over a reference, such as one returned by GetValue.
+		 * \param _value the value, or NULL.
+		 */
+		explicit ValueRef( T* _value = NULL ): m_value( _value ){}
+
+		ValueRef( ValueRef const& _other ): m_value( _other.m_value )
+		{
+			if( m_value )
+			{
+				m_value->AddRef();
+			}
+		}
+
+		~ValueRef()
+		{
+			if( m_value )
+			{
+				m_value->Release();
+			}
+		}
+
+		ValueRef& operator = ( ValueRef const& _other )
+		{
+			// Add the new reference first, in case it is to the value already held
+			if( _other.m_value )
+			{
+				_other.m_value->AddRef();
+			}
+			Reset( _other.m_value );
+			return *this;
+		}
+
+		/**
+		 * Release the value held, and take over another reference.
+		 * \param _value the new value, or NULL.
+		 */
+		void Reset( T* _value = NULL )
+		{
+			T* old = m_value;
+			m_value = _value;
+			if( old )
+			{
+				old->Release();
+			}
+		}
+
+		T* Get()const{ return m_value; }
+		T* operator -> ()const{ return m_value; }
+		T& operator * ()const{ return *m_value; }
+		operator T* ()const{ return m_value; }
+
+	private:
+		T*	m_value;
+	};
+
+} // namespace OpenZWave
+
+#endif
@@ -163,15 +163,17 @@ void ValueShort::OnValueRefreshed
 {
 	switch( VerifyRefreshedValue( (void*) &m_value, (void*) &m_valueCheck, (void*) &_value, 2) )
 	{
-	case 0:		// value hasn't changed, nothing to do
+	case 0:		// value hasn't changed, but the reading still goes in the history
+		RecordHistory();
 		break;
 	case 1:		// value has changed (not confirmed yet), save _value in m_valueCheck
 		m_valueCheck = _value;
 		break;
 	case 2:		// value has changed (confirmed), save _value in m_value
 		m_value = _value;
+		RecordHistory();
 		break;
-	case 3:		// all three values are different, so wait for next refresh to try again
+	case 3:		// still checking, or the change was filtered out (and recorded already), so there is nothing to store
 		break;
 	}
 }
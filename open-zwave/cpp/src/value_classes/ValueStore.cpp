@@ -25,6 +25,8 @@
 //
 //-----------------------------------------------------------------------------
 
+
+#include <algorithm>
 #include "ValueStore.h"
 #include "Value.h"
 #include "Manager.h"
@@ -32,6 +34,27 @@
 
 using namespace OpenZWave;
 
+// Orders the values by key
+static bool KeyLess
+(
+	pair<uint32,Value*> const& _entry,
+	uint32 const _key
+)
+{
+	return( _entry.first < _key );
+}
+
+//-----------------------------------------------------------------------------
+// <ValueStore::ValueStore>
+// Constructor
+//-----------------------------------------------------------------------------
+ValueStore::ValueStore
+(
+):
+	m_indexShift( 32 )
+{
+	RebuildIndex();
+}
 
 //-----------------------------------------------------------------------------
 // <ValueStore::ValueStore>
@@ -41,12 +64,9 @@ ValueStore::~ValueStore
 (
 )
 {
-	map<uint32,Value*>::iterator it = m_values.begin();
-	while( !m_values.empty() )
+	for( vector< pair<uint32,Value*> >::iterator it = m_values.begin(); it != m_values.end(); ++it )
 	{
-		ValueID const& valueId = it->second->GetID();
-		RemoveValue( valueId.GetValueStoreKey() );
-		it = m_values.begin();
+		ReleaseValue( it->second );
 	}
 }
 
@@ -65,18 +85,20 @@ bool ValueStore::AddValue
 	}
 
 	uint32 key = _value->GetID().GetValueStoreKey();
-	map<uint32,Value*>::iterator it = m_values.find( key );
-	if( it != m_values.end() )
+	vector< pair<uint32,Value*> >::iterator it = lower_bound( m_values.begin(), m_values.end(), key, KeyLess );
+	if( ( it != m_values.end() ) && ( it->first == key ) )
 	{
 		// There is already a value in the store with this key, so we give up.
 		return false;
 	}
 
-	m_values[key] = _value;
+	m_values.insert( it, pair<uint32,Value*>( key, _value ) );
+	RebuildIndex();
 	_value->AddRef();
 
-	// Notify the watchers of the new value
-	if( Driver* driver = Manager::Get()->GetDriver( _value->GetID().GetHomeId() ) )
+	// Notify the watchers of the new value.  There are none if the store is
+	// being used without a Manager, as in the ValueStore benchmark.
+	if( Driver* driver = Manager::Get() ? Manager::Get()->GetDriver( _value->GetID().GetHomeId() ) : NULL )
 	{
 		Notification* notification = new Notification( Notification::Type_ValueAdded );
 		notification->SetValueId( _value->GetID() );
@@ -95,24 +117,13 @@ bool ValueStore::RemoveValue
 	uint32 const& _key
 )
 {
-	map<uint32,Value*>::iterator it = m_values.find( _key );
-	if( it != m_values.end() )
+	int32 pos = Find( _key );
+	if( pos >= 0 )
 	{
-		Value* value = it->second;
-		ValueID const& valueId = value->GetID();
-
-		// First notify the watchers
-		if( Driver* driver = Manager::Get()->GetDriver( valueId.GetHomeId() ) )
-		{
-			Notification* notification = new Notification( Notification::Type_ValueRemoved );
-			notification->SetValueId( valueId );
-			driver->QueueNotification( notification ); 
-		}
-
-		// Now release and remove the value from the store
-		value->Release();
-		m_values.erase( it );
-
+		Value* value = m_values[pos].second;
+		m_values.erase( m_values.begin() + pos );
+		RebuildIndex();
+		ReleaseValue( value );
 		return true;
 	}
 
@@ -139,32 +150,26 @@ void ValueStore::RemoveCommandClassValues
 	uint8 const _commandClassId
 )
 {
-	map<uint32,Value*>::iterator it = m_values.begin();
-	while( it != m_values.end() )
+	// Slide the values that are kept down over the ones that are removed
+	vector< pair<uint32,Value*> >::iterator kept = m_values.begin();
+	for( vector< pair<uint32,Value*> >::iterator it = m_values.begin(); it != m_values.end(); ++it )
 	{
-		Value* value = it->second;
-		ValueID const& valueId = value->GetID();
-		if( _commandClassId == valueId.GetCommandClassId() )
+		if( _commandClassId == it->second->GetID().GetCommandClassId() )
 		{
 			// The value belongs to the specified command class
-			
-			// First notify the watchers
-			if( Driver* driver = Manager::Get()->GetDriver( valueId.GetHomeId() ) )
-			{
-				Notification* notification = new Notification( Notification::Type_ValueRemoved );
-				notification->SetValueId( valueId );
-				driver->QueueNotification( notification ); 
-			}
-
-			// Now release and remove the value from the store
-			value->Release();
-			m_values.erase( it++ );
+			ReleaseValue( it->second );
 		}
 		else
 		{
-			++it;
+			*kept++ = *it;
 		}
 	}
+
+	if( kept != m_values.end() )
+	{
+		m_values.erase( kept, m_values.end() );
+		RebuildIndex();
+	}
 }
 
 //-----------------------------------------------------------------------------
@@ -178,10 +183,10 @@ Value* ValueStore::GetValue
 {
 	Value* value = NULL;
 
-	map<uint32,Value*>::const_iterator it = m_values.find( _key );
-	if( it != m_values.end() )
+	int32 pos = Find( _key );
+	if( pos >= 0 )
 	{
-		value = it->second;
+		value = m_values[pos].second;
 		if( value )
 		{
 			// Add a reference to the value.  The caller must
@@ -193,6 +198,19 @@ Value* ValueStore::GetValue
 	return value;
 }
 
+//-----------------------------------------------------------------------------
+// <ValueStore::BorrowValue>
+// Get a value from the store, for use while the nodes are locked
+//-----------------------------------------------------------------------------
+Value* ValueStore::BorrowValue
+(
+	uint32 const& _key
+)const
+{
+	int32 pos = Find( _key );
+	return( ( pos >= 0 ) ? m_values[pos].second : NULL );
+}
+
 ////-----------------------------------------------------------------------------
 //// <ValueStore::GetValue>
 //// Get a value from the store
@@ -202,3 +220,80 @@ Value* ValueStore::GetValue
 //	ValueID const& _id
 //)const
 
+//-----------------------------------------------------------------------------
+// <ValueStore::Find>
+// Get the position of a value in the vector, or -1 if it is not in the store
+//-----------------------------------------------------------------------------
+int32 ValueStore::Find
+(
+	uint32 const _key
+)const
+{
+	// Probe linearly from the slot the key hashes to, until the key or an
+	// empty slot is found.  The index is never more than half full.
+	uint32 mask = (uint32)m_index.size() - 1;
+	uint32 slot = Hash( _key ) >> m_indexShift;
+	while( true )
+	{
+		uint16 pos = m_index[slot];
+		if( pos == EmptySlot )
+		{
+			return -1;
+		}
+		if( m_values[pos].first == _key )
+		{
+			return pos;
+		}
+		slot = ( slot + 1 ) & mask;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueStore::RebuildIndex>
+// Recreate the hash table after values have been added or removed
+//-----------------------------------------------------------------------------
+void ValueStore::RebuildIndex
+(
+)
+{
+	// The table has a power of two slots, at least twice as many as there are values
+	uint32 size = 8;
+	m_indexShift = 29;
+	while( size < ( m_values.size() * 2 ) )
+	{
+		size <<= 1;
+		--m_indexShift;
+	}
+
+	m_index.assign( size, EmptySlot );
+	for( uint32 i=0; i<m_values.size(); ++i )
+	{
+		uint32 slot = Hash( m_values[i].first ) >> m_indexShift;
+		while( m_index[slot] != EmptySlot )
+		{
+			slot = ( slot + 1 ) & ( size - 1 );
+		}
+		m_index[slot] = (uint16)i;
+	}
+}
+
+//-----------------------------------------------------------------------------
+// <ValueStore::ReleaseValue>
+// Tell the watchers that a value is being removed, and release it
+//-----------------------------------------------------------------------------
+void ValueStore::ReleaseValue
+(
+	Value* _value
+)
+{
+	// First notify the watchers
+	if( Driver* driver = Manager::Get() ? Manager::Get()->GetDriver( _value->GetID().GetHomeId() ) : NULL )
+	{
+		Notification* notification = new Notification( Notification::Type_ValueRemoved );
+		notification->SetValueId( _value->GetID() );
+		driver->QueueNotification( notification ); 
+	}
+
+	// Now release the value
+	_value->Release();
+}
@@ -28,7 +28,7 @@
 #ifndef _ValueStore_H
 #define _ValueStore_H
 
-#include <map>
+#include <vector>
 #include "Defs.h"
 #include "ValueID.h"
 
@@ -39,27 +39,49 @@ namespace OpenZWave
 	class Value;
 
 	/** \brief Container that holds all of the values associated with a given node.
+	 *
+	 * The values are kept in a vector sorted by key, so they can be iterated
+	 * through in order without chasing pointers, and are found through a small
+	 * open-addressing hash table of their positions in the vector.  Every report
+	 * from a node looks up a value, but values are only added and removed while
+	 * the node is being set up, so the table is simply rebuilt when they change.
 	 */
 	class ValueStore
 	{
 	public:
 		
-		typedef map<uint32,Value*>::const_iterator Iterator;
+		typedef vector< pair<uint32,Value*> >::const_iterator Iterator;
 
 		Iterator Begin(){ return m_values.begin(); }
 		Iterator End(){ return m_values.end(); }
 		
-		ValueStore(){}
+		ValueStore();
 		~ValueStore();
 
 		bool AddValue( Value* _value );
 		bool RemoveValue( uint32 const& _key );
 		Value* GetValue( uint32 const& _key )const;
+		Value* BorrowValue( uint32 const& _key )const;					// Like GetValue, but without adding a reference.  Only valid while the nodes are locked, or on the driver thread.
+		Value const* FindValue( uint32 const& _key )const{ return BorrowValue( _key ); }
 
 		void RemoveCommandClassValues( uint8 const _commandClassId );		// Remove all the values associated with a command class
 
 	private:
-		map<uint32,Value*>	m_values;
+		enum
+		{
+			EmptySlot = 0xffff					// Marks an unused slot in the index
+		};
+
+		int32 Find( uint32 const _key )const;
+		void RebuildIndex();
+		void ReleaseValue( Value* _value );
+
+		// Fibonacci hashing spreads the keys, whose low four bits are always zero, across the top bits
+		static uint32 Hash( uint32 const _key ){ return _key * 2654435769u; }
+
+		vector< pair<uint32,Value*> >	m_values;		// Sorted by key
+		vector<uint16>					m_index;		// Positions in m_values, by the top bits of their keys' hashes
+		uint32							m_indexShift;	// Shift that leaves just the top bits of a hash
 	};
 
 } // namespace OpenZWave
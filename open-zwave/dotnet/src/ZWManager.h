@@ -421,6 +421,16 @@ namespace OpenZWaveDotNet
 		 */
 		bool EnablePoll( ZWValueID^ valueId ){ return Manager::Get()->EnablePoll(valueId->CreateUnmanagedValueID()); }
 
+		/**
+		 * \brief Enable the polling of a device's state at an interval of its own.
+		 *
+		 * \param valueId The ID of the value to start polling.
+		 * \param intensity Multiplies the poll interval when no interval is given.
+		 * \param milliseconds The time between polls of this value, or zero to use the poll interval.
+		 * \return True if polling was enabled.
+		 */
+		bool EnablePoll( ZWValueID^ valueId, uint8 intensity, int32 milliseconds ){ return Manager::Get()->EnablePoll(valueId->CreateUnmanagedValueID(), intensity, milliseconds); }
+
 		/**
 		 * \brief Disable the polling of a device's state.
 		 *